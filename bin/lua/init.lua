@@ -9,3 +9,10 @@ end
 function OnTick()
     -- tubekit.Logger("[lua] main OnTick")
 end
+
+-- routes are matched before static files, function(request) returns status, body, content_type
+-- request: method, url, path, params, headers, body
+-- each worker thread loads this file into its own vm for routes, OnInit runs only in main vm
+-- tubekit.Route("GET", "/lua/hello/:name", function(request)
+--     return 200, "hello " .. request.params.name .. "\n"
+-- end)
@@ -9,6 +9,7 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <endian.h>
+#include <unistd.h>
 #include <thread>
 #include <chrono>
 
@@ -142,8 +143,19 @@ int main(int argc, const char **argv)
                         std::string str;
                         exampleReq.SerializeToString(&str);
                         message.set_body(str);
+                        std::string message_str;
+                        message.SerializeToString(&message_str);
+                        // server stream_frame = varint, stream_frame_checksum = 0
                         std::string data;
-                        message.SerializeToString(&data);
+                        for (uint64_t n = message_str.size(); ; n >>= 7)
+                        {
+                            data.push_back((char)((n & 0x7f) | (n >= 0x80 ? 0x80 : 0)));
+                            if (n < 0x80)
+                            {
+                                break;
+                            }
+                        }
+                        data += message_str;
 
                         uint64_t packageLen = data.size();
 
@@ -200,10 +212,26 @@ int main(int argc, const char **argv)
                                 // printf("data_len[%u] += recv_len[%d]\n", data_len, recv_len);
                                 data_len += recv_len;
 
+                                // varint length prefix
+                                uint64_t frame_len = 0;
+                                uint32_t head_len = 0;
+                                while (head_len < data_len && head_len < 5)
+                                {
+                                    frame_len |= (uint64_t)(buffer[head_len] & 0x7f) << (7 * head_len);
+                                    if (!(buffer[head_len++] & 0x80))
+                                    {
+                                        break;
+                                    }
+                                }
+                                if (head_len == 0 || (buffer[head_len - 1] & 0x80) || data_len < head_len + frame_len)
+                                {
+                                    continue;
+                                }
+
                                 ProtoPackage protoPackage;
                                 // std::cout << "ParseFromArray recv_len[" << recv_len << "]"
                                 //           << "data_len=" << data_len << std::endl;
-                                if (!protoPackage.ParseFromArray(buffer, data_len))
+                                if (!protoPackage.ParseFromArray(buffer + head_len, frame_len))
                                 {
                                     // std::cout << "Failed" << std::endl;
                                     // std::cout << "ParseFromArray recv_len[" << recv_len << "]"
@@ -1,8 +1,10 @@
 #include "parser.h"
+#include "utf8.h"
 #include <stdexcept>
 
 using tubekit::json::json;
 using tubekit::json::parser;
+using tubekit::json::utf8_validator;
 
 parser::parser()
 {
@@ -63,25 +65,22 @@ json parser::parse_bool()
 
 json parser::parse_string()
 {
-    std::string out;
-    while (true)
+    size_t end = m_str.find_first_of("\"\\", m_idx);
+    if (end == std::string::npos)
+    {
+        throw std::logic_error("unexpected end of input in string");
+    }
+    if (m_str[end] == '\\')
     {
-        if (m_idx >= m_str.size())
-        {
-            throw std::logic_error("unexpected end of input in string");
-        }
-        char ch = m_str[m_idx++];
-        if (ch == '"')
-        {
-            return out;
-        }
-        if (ch != '\\')
-        {
-            out += ch;
-            continue;
-        }
         throw std::logic_error("not support escaped characters in string");
     }
+    if (!utf8_validator::validate(m_str.data() + m_idx, end - m_idx))
+    {
+        throw std::logic_error("invalid utf-8 in string");
+    }
+    std::string out = m_str.substr(m_idx, end - m_idx);
+    m_idx = end + 1;
+    return out;
 }
 
 json parser::parse_number()
@@ -0,0 +1,384 @@
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TUBEKIT_UTF8_X86 1
+#include <immintrin.h>
+#endif
+
+#include "utf8.h"
+
+using tubekit::json::utf8_validator;
+
+// length of a character by its first byte, 0 for continuation or invalid bytes
+static inline size_t char_length(uint8_t byte)
+{
+    if (byte < 0x80)
+    {
+        return 1;
+    }
+    if (byte < 0xc0)
+    {
+        return 0;
+    }
+    return byte < 0xe0 ? 2 : (byte < 0xf0 ? 3 : 4);
+}
+
+// the longest prefix that does not end inside a character, the rest is at most 3 bytes
+static inline size_t complete_prefix(const uint8_t *data, size_t len)
+{
+    for (size_t back = 1; back <= 3 && back <= len; back++)
+    {
+        size_t length = char_length(data[len - back]);
+        if (length == 0)
+        {
+            continue;
+        }
+        return length > back ? len - back : len;
+    }
+    return len;
+}
+
+#ifdef TUBEKIT_UTF8_X86
+
+// error bits of the lookup tables, a byte pair is invalid when all three lookups share a bit
+static constexpr uint8_t TOO_SHORT = 1 << 0;      // lead byte followed by a lead byte or ASCII
+static constexpr uint8_t TOO_LONG = 1 << 1;       // ASCII followed by continuation
+static constexpr uint8_t OVERLONG_3 = 1 << 2;     // E0 80..9F
+static constexpr uint8_t TOO_LARGE = 1 << 3;      // F4 90..BF, F5..FF
+static constexpr uint8_t SURROGATE = 1 << 4;      // ED A0..BF
+static constexpr uint8_t OVERLONG_2 = 1 << 5;     // C0, C1
+static constexpr uint8_t TOO_LARGE_1000 = 1 << 6; // F5..FF 80..8F
+static constexpr uint8_t OVERLONG_4 = 1 << 6;     // F0 80..8F
+static constexpr uint8_t TWO_CONTS = 1 << 7;      // continuation after continuation, checked by must23
+static constexpr uint8_t CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+#define TUBEKIT_UTF8_BYTE_1_HIGH                                          \
+    TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,                               \
+        TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,                           \
+        TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,                       \
+        TOO_SHORT | OVERLONG_2,                                           \
+        TOO_SHORT,                                                        \
+        TOO_SHORT | OVERLONG_3 | SURROGATE,                               \
+        TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+
+#define TUBEKIT_UTF8_BYTE_1_LOW                                                                      \
+    CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,                                                    \
+        CARRY | OVERLONG_2,                                                                          \
+        CARRY,                                                                                       \
+        CARRY,                                                                                       \
+        CARRY | TOO_LARGE,                                                                           \
+        CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,                      \
+        CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,                      \
+        CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,                      \
+        CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,                      \
+        CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,                                              \
+        CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000
+
+#define TUBEKIT_UTF8_BYTE_2_HIGH                                                        \
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,                                         \
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,                                     \
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,   \
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,                     \
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,                      \
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,                      \
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+
+__attribute__((target("sse4.1"))) static inline __m128i check_bytes_sse4(__m128i input, __m128i prev_input)
+{
+    const __m128i low_nibble = _mm_set1_epi8(0x0f);
+    const __m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+    const __m128i byte_1_high = _mm_shuffle_epi8(_mm_setr_epi8(TUBEKIT_UTF8_BYTE_1_HIGH), _mm_and_si128(_mm_srli_epi16(prev1, 4), low_nibble));
+    const __m128i byte_1_low = _mm_shuffle_epi8(_mm_setr_epi8(TUBEKIT_UTF8_BYTE_1_LOW), _mm_and_si128(prev1, low_nibble));
+    const __m128i byte_2_high = _mm_shuffle_epi8(_mm_setr_epi8(TUBEKIT_UTF8_BYTE_2_HIGH), _mm_and_si128(_mm_srli_epi16(input, 4), low_nibble));
+    const __m128i special = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+    // the 2nd continuation of a 3 or 4 byte character and the 3rd of a 4 byte one are expected, others are errors
+    const __m128i prev2 = _mm_alignr_epi8(input, prev_input, 14);
+    const __m128i prev3 = _mm_alignr_epi8(input, prev_input, 13);
+    const __m128i is_third = _mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xe0 - 0x80)));
+    const __m128i is_fourth = _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xf0 - 0x80)));
+    const __m128i must23 = _mm_and_si128(_mm_or_si128(is_third, is_fourth), _mm_set1_epi8(static_cast<char>(0x80)));
+    return _mm_xor_si128(must23, special);
+}
+
+__attribute__((target("sse4.1"))) static inline __m128i incomplete_sse4(__m128i input)
+{
+    // a lead byte in the last 3 bytes that needs more bytes than left
+    const __m128i max_value = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                            static_cast<char>(0xf0 - 1), static_cast<char>(0xe0 - 1), static_cast<char>(0xc0 - 1));
+    return _mm_subs_epu8(input, max_value);
+}
+
+__attribute__((target("sse4.1"))) static bool validate_sse4(const uint8_t *data, size_t len)
+{
+    __m128i error = _mm_setzero_si128();
+    __m128i prev_input = _mm_setzero_si128();
+    __m128i prev_incomplete = _mm_setzero_si128();
+    uint8_t tail[64];
+    for (size_t i = 0; i < len; i += 64)
+    {
+        const uint8_t *block = data + i;
+        if (len - i < 64)
+        {
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, block, len - i);
+            block = tail;
+        }
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + 16));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + 32));
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + 48));
+        if (0 == _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d))))
+        {
+            error = _mm_or_si128(error, prev_incomplete);
+            prev_incomplete = _mm_setzero_si128();
+        }
+        else
+        {
+            error = _mm_or_si128(error, check_bytes_sse4(a, prev_input));
+            error = _mm_or_si128(error, check_bytes_sse4(b, a));
+            error = _mm_or_si128(error, check_bytes_sse4(c, b));
+            error = _mm_or_si128(error, check_bytes_sse4(d, c));
+            prev_incomplete = incomplete_sse4(d);
+        }
+        prev_input = d;
+    }
+    error = _mm_or_si128(error, prev_incomplete);
+    return _mm_testz_si128(error, error);
+}
+
+__attribute__((target("avx2"))) static inline __m256i check_bytes_avx2(__m256i input, __m256i prev_input)
+{
+    const __m256i low_nibble = _mm256_set1_epi8(0x0f);
+    // bytes before input lane by lane, the high half of prev_input then the low half of input
+    const __m256i before = _mm256_permute2x128_si256(prev_input, input, 0x21);
+    const __m256i prev1 = _mm256_alignr_epi8(input, before, 15);
+    const __m256i byte_1_high = _mm256_shuffle_epi8(_mm256_setr_epi8(TUBEKIT_UTF8_BYTE_1_HIGH, TUBEKIT_UTF8_BYTE_1_HIGH), _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low_nibble));
+    const __m256i byte_1_low = _mm256_shuffle_epi8(_mm256_setr_epi8(TUBEKIT_UTF8_BYTE_1_LOW, TUBEKIT_UTF8_BYTE_1_LOW), _mm256_and_si256(prev1, low_nibble));
+    const __m256i byte_2_high = _mm256_shuffle_epi8(_mm256_setr_epi8(TUBEKIT_UTF8_BYTE_2_HIGH, TUBEKIT_UTF8_BYTE_2_HIGH), _mm256_and_si256(_mm256_srli_epi16(input, 4), low_nibble));
+    const __m256i special = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+    const __m256i prev2 = _mm256_alignr_epi8(input, before, 14);
+    const __m256i prev3 = _mm256_alignr_epi8(input, before, 13);
+    const __m256i is_third = _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xe0 - 0x80)));
+    const __m256i is_fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xf0 - 0x80)));
+    const __m256i must23 = _mm256_and_si256(_mm256_or_si256(is_third, is_fourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+    return _mm256_xor_si256(must23, special);
+}
+
+__attribute__((target("avx2"))) static inline __m256i incomplete_avx2(__m256i input)
+{
+    const __m256i max_value = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                               -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                               static_cast<char>(0xf0 - 1), static_cast<char>(0xe0 - 1), static_cast<char>(0xc0 - 1));
+    return _mm256_subs_epu8(input, max_value);
+}
+
+__attribute__((target("avx2"))) static bool validate_avx2(const uint8_t *data, size_t len)
+{
+    __m256i error = _mm256_setzero_si256();
+    __m256i prev_input = _mm256_setzero_si256();
+    __m256i prev_incomplete = _mm256_setzero_si256();
+    uint8_t tail[64];
+    for (size_t i = 0; i < len; i += 64)
+    {
+        const uint8_t *block = data + i;
+        if (len - i < 64)
+        {
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, block, len - i);
+            block = tail;
+        }
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + 32));
+        if (0 == _mm256_movemask_epi8(_mm256_or_si256(a, b)))
+        {
+            error = _mm256_or_si256(error, prev_incomplete);
+            prev_incomplete = _mm256_setzero_si256();
+        }
+        else
+        {
+            error = _mm256_or_si256(error, check_bytes_avx2(a, prev_input));
+            error = _mm256_or_si256(error, check_bytes_avx2(b, a));
+            prev_incomplete = incomplete_avx2(b);
+        }
+        prev_input = b;
+    }
+    error = _mm256_or_si256(error, prev_incomplete);
+    return _mm256_testz_si256(error, error);
+}
+
+#endif
+
+utf8_validator::utf8_validator()
+{
+}
+
+utf8_validator::~utf8_validator()
+{
+}
+
+void utf8_validator::reset()
+{
+    m_failed = false;
+    m_need = 0;
+    m_lower = 0x80;
+    m_upper = 0xbf;
+}
+
+bool utf8_validator::finish() const
+{
+    return !m_failed && m_need == 0;
+}
+
+bool utf8_validator::step(uint8_t byte)
+{
+    if (m_need > 0)
+    {
+        if (byte < m_lower || byte > m_upper)
+        {
+            m_failed = true;
+            return false;
+        }
+        m_need--;
+        m_lower = 0x80;
+        m_upper = 0xbf;
+        return true;
+    }
+    if (byte < 0x80)
+    {
+        return true;
+    }
+    // the second byte of some lead bytes has a narrower range (RFC 3629 4)
+    if (byte >= 0xc2 && byte <= 0xdf)
+    {
+        m_need = 1;
+    }
+    else if (byte >= 0xe0 && byte <= 0xef)
+    {
+        m_need = 2;
+        m_lower = byte == 0xe0 ? 0xa0 : 0x80;
+        m_upper = byte == 0xed ? 0x9f : 0xbf;
+    }
+    else if (byte >= 0xf0 && byte <= 0xf4)
+    {
+        m_need = 3;
+        m_lower = byte == 0xf0 ? 0x90 : 0x80;
+        m_upper = byte == 0xf4 ? 0x8f : 0xbf;
+    }
+    else
+    {
+        m_failed = true;
+        return false;
+    }
+    return true;
+}
+
+bool utf8_validator::update(const char *data, size_t len)
+{
+    static const level best_level = get_level();
+    return update(data, len, best_level);
+}
+
+bool utf8_validator::update(const char *data, size_t len, level use_level)
+{
+    if (m_failed)
+    {
+        return false;
+    }
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(data);
+    size_t done = 0;
+    // the character split from the last part
+    while (m_need > 0 && done < len)
+    {
+        if (!step(bytes[done++]))
+        {
+            return false;
+        }
+    }
+    bytes += done;
+    len -= done;
+    done = 0;
+
+#ifdef TUBEKIT_UTF8_X86
+    if (use_level != level::SCALAR)
+    {
+        // whole characters with SIMD, a split character at the end is kept for the next part
+        done = complete_prefix(bytes, len);
+        const bool valid = use_level == level::AVX2 ? validate_avx2(bytes, done) : validate_sse4(bytes, done);
+        if (!valid)
+        {
+            m_failed = true;
+            return false;
+        }
+    }
+#endif
+
+    while (done < len)
+    {
+        if (m_need == 0)
+        {
+            // skip ASCII 8 bytes at a time
+            uint64_t word;
+            while (done + 8 <= len)
+            {
+                memcpy(&word, bytes + done, 8);
+                if (word & 0x8080808080808080ULL)
+                {
+                    break;
+                }
+                done += 8;
+            }
+            if (done == len)
+            {
+                break;
+            }
+        }
+        if (!step(bytes[done++]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool utf8_validator::validate(const char *data, size_t len)
+{
+    static const level best_level = get_level();
+    return validate(data, len, best_level);
+}
+
+bool utf8_validator::validate(const char *data, size_t len, level use_level)
+{
+    utf8_validator validator;
+    return validator.update(data, len, use_level) && validator.finish();
+}
+
+utf8_validator::level utf8_validator::get_level()
+{
+#ifdef TUBEKIT_UTF8_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return level::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.1"))
+    {
+        return level::SSE4;
+    }
+#endif
+    return level::SCALAR;
+}
+
+const char *utf8_validator::level_name(level use_level)
+{
+    switch (use_level)
+    {
+    case level::AVX2:
+        return "avx2";
+    case level::SSE4:
+        return "sse4";
+    default:
+        return "scalar";
+    }
+}
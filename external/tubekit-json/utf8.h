@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace tubekit::json
+{
+    /**
+     * @brief UTF-8 validation (RFC 3629), no overlong forms, surrogates or code points above U+10FFFF,
+     *        64/32 bytes at a time with AVX2 or SSE4 chosen by runtime CPU detection (Keiser and Lemire lookup),
+     *        8 bytes at a time for ASCII on other CPUs
+     *
+     * an instance validates a stream given in parts, a character may be split between parts
+     */
+    class utf8_validator
+    {
+    public:
+        enum class level
+        {
+            SCALAR = 0,
+            SSE4 = 1,
+            AVX2 = 2
+        };
+
+    public:
+        utf8_validator();
+        ~utf8_validator();
+
+        /**
+         * @brief validate the next part of stream
+         *
+         * @param data
+         * @param len
+         * @return true
+         * @return false invalid, stays false until reset()
+         */
+        bool update(const char *data, size_t len);
+
+        /**
+         * @brief the stream ends here
+         *
+         * @return true every character is valid and complete
+         * @return false
+         */
+        bool finish() const;
+
+        void reset();
+
+        /**
+         * @brief validate a whole string
+         *
+         * @param data
+         * @param len
+         * @return true
+         * @return false
+         */
+        static bool validate(const char *data, size_t len);
+        static bool validate(const char *data, size_t len, level use_level);
+
+        /**
+         * @brief the best level supported by this CPU
+         *
+         * @return level
+         */
+        static level get_level();
+        static const char *level_name(level use_level);
+
+    private:
+        bool update(const char *data, size_t len, level use_level);
+        bool step(uint8_t byte);
+
+    private:
+        bool m_failed{false};
+        uint8_t m_need{0}; // continuation bytes still expected
+        uint8_t m_lower{0x80};
+        uint8_t m_upper{0xbf};
+    };
+};
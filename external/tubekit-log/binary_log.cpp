@@ -0,0 +1,732 @@
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <thread>
+#include <unordered_map>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "binary_log.h"
+
+using tubekit::log::binary_log;
+using tubekit::log::log_site;
+
+constexpr char binary_log::magic[8];
+std::mutex binary_log::s_sites_mutex;
+std::atomic<binary_log::site_info *> binary_log::s_sites[binary_log::max_sites];
+uint32_t binary_log::s_sites_size{0};
+
+// names of logger::flag
+static const char *s_level[] = {"DEBUG", "INFO", "WARN", "ERROR", "FATAL"};
+
+static int64_t realtime_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static int64_t steady_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint64_t binary_log::ticks()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return (uint64_t)steady_ns();
+#endif
+}
+
+bool binary_log::parse(const char *format, std::vector<spec> &specs)
+{
+    specs.clear();
+    for (size_t i = 0; format[i]; i++)
+    {
+        if (format[i] != '%')
+        {
+            continue;
+        }
+        spec item;
+        item.begin = i++;
+        if (format[i] == '%')
+        {
+            continue;
+        }
+        // flags
+        while (format[i] && strchr("-+ #0'", format[i]))
+        {
+            i++;
+        }
+        // width
+        if (format[i] == '*')
+        {
+            item.width_star = true;
+            i++;
+        }
+        else
+        {
+            while (format[i] >= '0' && format[i] <= '9')
+            {
+                i++;
+            }
+            if (format[i] == '$')
+            {
+                return false; // positional
+            }
+        }
+        // precision
+        if (format[i] == '.')
+        {
+            i++;
+            if (format[i] == '*')
+            {
+                item.precision_star = true;
+                i++;
+            }
+            else
+            {
+                item.precision = 0;
+                while (format[i] >= '0' && format[i] <= '9')
+                {
+                    item.precision = item.precision * 10 + (format[i] - '0');
+                    i++;
+                }
+            }
+        }
+        // length
+        bool wide = false;
+        while (format[i] && strchr("hlLqjzt", format[i]))
+        {
+            if (format[i] == 'L' || format[i] == 'q')
+            {
+                return false; // long double
+            }
+            wide = wide || format[i] != 'h';
+            i++;
+        }
+        item.conversion = format[i];
+        switch (format[i])
+        {
+        case 'd':
+        case 'i':
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+            item.kind = wide ? INT64 : INT32;
+            break;
+        case 'c':
+            item.kind = INT32;
+            break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            item.kind = DOUBLE;
+            break;
+        case 's':
+            if (wide)
+            {
+                return false;
+            }
+            item.kind = STRING;
+            break;
+        case 'p':
+            item.kind = POINTER;
+            break;
+        default:
+            return false; // %n, %m and unknown
+        }
+        item.end = i + 1;
+        specs.push_back(item);
+    }
+    return true;
+}
+
+uint32_t binary_log::register_site(log_site &site, const char *format)
+{
+    std::lock_guard<std::mutex> lock(s_sites_mutex);
+    uint32_t id = site.id.load(std::memory_order_acquire);
+    if (id != 0)
+    {
+        return id;
+    }
+
+    std::vector<spec> specs;
+    if (s_sites_size >= max_sites || !parse(format, specs))
+    {
+        site.id.store(text_site, std::memory_order_release);
+        return text_site;
+    }
+    site_info *info = new site_info;
+    info->file = site.file;
+    info->line = site.line;
+    info->level = site.level;
+    info->format = format;
+    for (const spec &item : specs)
+    {
+        if (item.width_star)
+        {
+            info->args.push_back({INT32, -1});
+        }
+        if (item.precision_star)
+        {
+            info->args.push_back({PRECISION, -1});
+        }
+        info->args.push_back({item.kind, item.kind == STRING ? item.precision : -1});
+    }
+    s_sites[s_sites_size].store(info, std::memory_order_release);
+    id = ++s_sites_size;
+    site.id.store(id, std::memory_order_release);
+    return id;
+}
+
+const binary_log::site_info *binary_log::get_site(uint32_t id)
+{
+    if (id == 0 || id > max_sites)
+    {
+        return nullptr;
+    }
+    return s_sites[id - 1].load(std::memory_order_acquire);
+}
+
+size_t binary_log::encode(const site_info &info, va_list arg_ptr, char *out, size_t capacity)
+{
+    size_t used = 0;
+    int precision = -1; // '*' before a string
+    for (const arg &item : info.args)
+    {
+        switch (item.kind)
+        {
+        case INT32:
+        case PRECISION:
+        {
+            const int32_t value = va_arg(arg_ptr, int);
+            if (used + sizeof(value) > capacity)
+            {
+                return used;
+            }
+            memcpy(out + used, &value, sizeof(value));
+            used += sizeof(value);
+            if (item.kind == PRECISION)
+            {
+                precision = value;
+            }
+            break;
+        }
+        case INT64:
+        {
+            const int64_t value = va_arg(arg_ptr, long long);
+            if (used + sizeof(value) > capacity)
+            {
+                return used;
+            }
+            memcpy(out + used, &value, sizeof(value));
+            used += sizeof(value);
+            break;
+        }
+        case DOUBLE:
+        {
+            const double value = va_arg(arg_ptr, double);
+            if (used + sizeof(value) > capacity)
+            {
+                return used;
+            }
+            memcpy(out + used, &value, sizeof(value));
+            used += sizeof(value);
+            break;
+        }
+        case POINTER:
+        {
+            const uint64_t value = (uint64_t)(uintptr_t)va_arg(arg_ptr, void *);
+            if (used + sizeof(value) > capacity)
+            {
+                return used;
+            }
+            memcpy(out + used, &value, sizeof(value));
+            used += sizeof(value);
+            break;
+        }
+        case STRING:
+        {
+            const char *value = va_arg(arg_ptr, const char *);
+            if (!value)
+            {
+                value = "(null)";
+            }
+            if (item.precision >= 0)
+            {
+                precision = item.precision;
+            }
+            uint32_t length = (uint32_t)(precision >= 0 ? strnlen(value, (size_t)precision) : strlen(value));
+            if (used + sizeof(length) > capacity)
+            {
+                return used;
+            }
+            if (length > capacity - used - sizeof(length))
+            {
+                length = (uint32_t)(capacity - used - sizeof(length));
+            }
+            memcpy(out + used, &length, sizeof(length));
+            memcpy(out + used + sizeof(length), value, length);
+            used += sizeof(length) + length;
+            precision = -1;
+            break;
+        }
+        }
+    }
+    return used;
+}
+
+bool binary_log::decode(const char *format, const char *args, size_t length, std::string &out)
+{
+    std::vector<spec> specs;
+    if (!parse(format, specs))
+    {
+        return false;
+    }
+    size_t pos = 0;
+    auto take = [&](void *value, size_t size) -> bool
+    {
+        if (pos + size > length)
+        {
+            return false;
+        }
+        memcpy(value, args + pos, size);
+        pos += size;
+        return true;
+    };
+
+    char buf[512];
+    std::string piece;
+    size_t literal_begin = 0;
+    for (const spec &item : specs)
+    {
+        // text before the conversion, %% included
+        for (size_t i = literal_begin; i < item.begin; i++)
+        {
+            out.push_back(format[i]);
+            if (format[i] == '%' && format[i + 1] == '%')
+            {
+                i++;
+            }
+        }
+        literal_begin = item.end;
+
+        int32_t width = 0;
+        int32_t precision = 0;
+        if ((item.width_star && !take(&width, sizeof(width))) || (item.precision_star && !take(&precision, sizeof(precision))))
+        {
+            return false;
+        }
+        piece.assign(format + item.begin, item.end - item.begin);
+        int written = 0;
+        switch (item.kind)
+        {
+        case INT32:
+        {
+            int32_t value = 0;
+            if (!take(&value, sizeof(value)))
+            {
+                return false;
+            }
+            written = item.width_star && item.precision_star ? snprintf(buf, sizeof(buf), piece.c_str(), width, precision, value)
+                      : item.width_star                      ? snprintf(buf, sizeof(buf), piece.c_str(), width, value)
+                      : item.precision_star                  ? snprintf(buf, sizeof(buf), piece.c_str(), precision, value)
+                                                             : snprintf(buf, sizeof(buf), piece.c_str(), value);
+            break;
+        }
+        case INT64:
+        case POINTER:
+        {
+            int64_t value = 0;
+            if (!take(&value, sizeof(value)))
+            {
+                return false;
+            }
+            if (item.kind == POINTER)
+            {
+                void *pointer = (void *)(uintptr_t)value;
+                written = item.width_star ? snprintf(buf, sizeof(buf), piece.c_str(), width, pointer) : snprintf(buf, sizeof(buf), piece.c_str(), pointer);
+                break;
+            }
+            written = item.width_star && item.precision_star ? snprintf(buf, sizeof(buf), piece.c_str(), width, precision, value)
+                      : item.width_star                      ? snprintf(buf, sizeof(buf), piece.c_str(), width, value)
+                      : item.precision_star                  ? snprintf(buf, sizeof(buf), piece.c_str(), precision, value)
+                                                             : snprintf(buf, sizeof(buf), piece.c_str(), value);
+            break;
+        }
+        case DOUBLE:
+        {
+            double value = 0;
+            if (!take(&value, sizeof(value)))
+            {
+                return false;
+            }
+            written = item.width_star && item.precision_star ? snprintf(buf, sizeof(buf), piece.c_str(), width, precision, value)
+                      : item.width_star                      ? snprintf(buf, sizeof(buf), piece.c_str(), width, value)
+                      : item.precision_star                  ? snprintf(buf, sizeof(buf), piece.c_str(), precision, value)
+                                                             : snprintf(buf, sizeof(buf), piece.c_str(), value);
+            break;
+        }
+        case STRING:
+        {
+            uint32_t size = 0;
+            if (!take(&size, sizeof(size)) || pos + size > length)
+            {
+                return false;
+            }
+            // kept bytes are not terminated, they are printed with their length as precision
+            const std::string value(args + pos, size);
+            pos += size;
+            written = item.width_star && item.precision_star ? snprintf(buf, sizeof(buf), piece.c_str(), width, precision, value.c_str())
+                      : item.width_star                      ? snprintf(buf, sizeof(buf), piece.c_str(), width, value.c_str())
+                      : item.precision_star                  ? snprintf(buf, sizeof(buf), piece.c_str(), precision, value.c_str())
+                                                             : snprintf(buf, sizeof(buf), piece.c_str(), value.c_str());
+            if (written >= (int)sizeof(buf))
+            {
+                // long strings are common, the rest is formatted without a buffer limit
+                std::string big(written + 1, '\0');
+                written = item.width_star && item.precision_star ? snprintf(&big[0], big.size(), piece.c_str(), width, precision, value.c_str())
+                          : item.width_star                      ? snprintf(&big[0], big.size(), piece.c_str(), width, value.c_str())
+                          : item.precision_star                  ? snprintf(&big[0], big.size(), piece.c_str(), precision, value.c_str())
+                                                                 : snprintf(&big[0], big.size(), piece.c_str(), value.c_str());
+                out.append(big.data(), written);
+                written = -1;
+            }
+            break;
+        }
+        default:
+            return false;
+        }
+        if (written > 0)
+        {
+            out.append(buf, (size_t)written < sizeof(buf) ? written : sizeof(buf) - 1);
+        }
+    }
+    for (size_t i = literal_begin; format[i]; i++)
+    {
+        out.push_back(format[i]);
+        if (format[i] == '%' && format[i + 1] == '%')
+        {
+            i++;
+        }
+    }
+    return true;
+}
+
+binary_log::writer::writer()
+{
+}
+
+binary_log::writer::~writer()
+{
+    close();
+}
+
+bool binary_log::writer::open(const std::string &path, uint64_t rotate_size, uint32_t keep)
+{
+    close();
+    m_path = path;
+    m_rotate_size = rotate_size;
+    m_keep = keep;
+
+    // ticks per ns, measured once and refined by every SYNC
+    m_base_ticks = ticks();
+    m_base_ns = steady_ns();
+#if defined(__x86_64__) || defined(__i386__)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    m_ticks_per_ns = (double)(ticks() - m_base_ticks) / (double)(steady_ns() - m_base_ns);
+#endif
+    return open_file();
+}
+
+void binary_log::writer::close()
+{
+    if (m_fp)
+    {
+        fflush(m_fp);
+        fclose(m_fp);
+        m_fp = nullptr;
+    }
+}
+
+void binary_log::writer::flush()
+{
+    if (m_fp)
+    {
+        fflush(m_fp);
+    }
+    if (m_rotate_size > 0 && m_size >= m_rotate_size)
+    {
+        rotate();
+    }
+}
+
+bool binary_log::writer::open_file()
+{
+    m_fp = fopen(m_path.c_str(), "ab");
+    if (!m_fp)
+    {
+        return false;
+    }
+    fseek(m_fp, 0, SEEK_END);
+    const long size = ftell(m_fp);
+    m_size = size > 0 ? (uint64_t)size : 0;
+    if (m_size == 0)
+    {
+        write(magic, sizeof(magic));
+    }
+    m_written_sites.clear();
+    write_sync(ticks());
+    return true;
+}
+
+void binary_log::writer::rotate()
+{
+    close();
+    if (m_keep == 0)
+    {
+        remove(m_path.c_str());
+    }
+    else
+    {
+        remove((m_path + "." + std::to_string(m_keep)).c_str());
+        for (uint32_t i = m_keep; i > 1; i--)
+        {
+            rename((m_path + "." + std::to_string(i - 1)).c_str(), (m_path + "." + std::to_string(i)).c_str());
+        }
+        rename(m_path.c_str(), (m_path + ".1").c_str());
+    }
+    open_file();
+}
+
+void binary_log::writer::write(const void *data, size_t length)
+{
+    if (m_fp && length > 0)
+    {
+        fwrite(data, 1, length, m_fp);
+        m_size += length;
+    }
+}
+
+void binary_log::writer::write_sync(uint64_t now)
+{
+    const int64_t now_ns = steady_ns();
+    if (now_ns - m_base_ns > 1000000000)
+    {
+        m_ticks_per_ns = (double)(now - m_base_ticks) / (double)(now_ns - m_base_ns);
+    }
+    const int64_t wall_ns = realtime_ns();
+    const uint8_t type = SYNC;
+    write(&type, sizeof(type));
+    write(&now, sizeof(now));
+    write(&wall_ns, sizeof(wall_ns));
+    write(&m_ticks_per_ns, sizeof(m_ticks_per_ns));
+    m_last_sync = now;
+}
+
+void binary_log::writer::sync(uint64_t now)
+{
+    if ((double)(now - m_last_sync) >= m_ticks_per_ns * 1e9)
+    {
+        write_sync(now);
+    }
+}
+
+void binary_log::writer::line(uint32_t id, uint64_t tsc, const char *args, uint32_t length)
+{
+    if (id >= m_written_sites.size())
+    {
+        m_written_sites.resize(id + 1, false);
+    }
+    if (!m_written_sites[id])
+    {
+        const site_info *info = get_site(id);
+        if (!info)
+        {
+            return;
+        }
+        const uint8_t type = SITE;
+        const uint8_t level = (uint8_t)info->level;
+        const uint32_t line = (uint32_t)info->line;
+        const uint16_t file_length = (uint16_t)strnlen(info->file, UINT16_MAX);
+        const uint32_t format_length = (uint32_t)strlen(info->format);
+        write(&type, sizeof(type));
+        write(&id, sizeof(id));
+        write(&level, sizeof(level));
+        write(&line, sizeof(line));
+        write(&file_length, sizeof(file_length));
+        write(info->file, file_length);
+        write(&format_length, sizeof(format_length));
+        write(info->format, format_length);
+        m_written_sites[id] = true;
+    }
+    const uint8_t type = LINE;
+    write(&type, sizeof(type));
+    write(&id, sizeof(id));
+    write(&tsc, sizeof(tsc));
+    write(&length, sizeof(length));
+    write(args, length);
+}
+
+void binary_log::writer::text(int level, uint64_t tsc, const char *file, int line, const char *text, uint32_t length)
+{
+    const uint8_t type = TEXT;
+    const uint8_t level_value = (uint8_t)level;
+    const uint32_t line_value = (uint32_t)line;
+    const uint16_t file_length = (uint16_t)strnlen(file, UINT16_MAX);
+    write(&type, sizeof(type));
+    write(&level_value, sizeof(level_value));
+    write(&tsc, sizeof(tsc));
+    write(&line_value, sizeof(line_value));
+    write(&file_length, sizeof(file_length));
+    write(file, file_length);
+    write(&length, sizeof(length));
+    write(text, length);
+}
+
+namespace
+{
+    struct decoded_site
+    {
+        uint8_t level{0};
+        uint32_t line{0};
+        std::string file{};
+        std::string format{};
+    };
+
+    class file_reader
+    {
+    public:
+        explicit file_reader(FILE *in) : m_in(in)
+        {
+        }
+
+        template <typename T>
+        bool get(T &value)
+        {
+            return 1 == fread(&value, sizeof(value), 1, m_in);
+        }
+
+        template <typename Length>
+        bool get_string(std::string &value)
+        {
+            Length length = 0;
+            if (!get(length))
+            {
+                return false;
+            }
+            value.resize(length);
+            return length == 0 || 1 == fread(&value[0], length, 1, m_in);
+        }
+
+    private:
+        FILE *m_in{nullptr};
+    };
+}
+
+int binary_log::decode_file(FILE *in, FILE *out)
+{
+    char head[sizeof(magic)];
+    if (1 != fread(head, sizeof(head), 1, in) || 0 != memcmp(head, magic, sizeof(magic)))
+    {
+        return -1;
+    }
+
+    file_reader reader(in);
+    std::unordered_map<uint32_t, decoded_site> sites;
+    uint64_t sync_ticks = 0;
+    int64_t sync_ns = 0;
+    double ticks_per_ns = 1.0;
+    char time_cache[32] = {0};
+    time_t time_cache_sec = -1;
+    std::string args;
+    std::string line_text;
+
+    // same layout as text log lines
+    auto print = [&](uint64_t tsc, uint8_t level, const std::string &file, uint32_t line, const std::string &text)
+    {
+        const int64_t ns = sync_ns + (int64_t)((double)(int64_t)(tsc - sync_ticks) / ticks_per_ns);
+        const time_t sec = (time_t)(ns / 1000000000);
+        if (sec != time_cache_sec)
+        {
+            struct tm tm_now;
+            localtime_r(&sec, &tm_now);
+            strftime(time_cache, sizeof(time_cache), "%Y-%m-%D %H:%M:%S  ", &tm_now);
+            time_cache_sec = sec;
+        }
+        fprintf(out, "%s  %s  %s:%u  %s\r\n", time_cache, level < sizeof(s_level) / sizeof(s_level[0]) ? s_level[level] : "?", file.c_str(), line, text.c_str());
+    };
+
+    uint8_t type = 0;
+    while (reader.get(type))
+    {
+        if (type == SYNC)
+        {
+            if (!reader.get(sync_ticks) || !reader.get(sync_ns) || !reader.get(ticks_per_ns))
+            {
+                return -2;
+            }
+            if (ticks_per_ns <= 0)
+            {
+                ticks_per_ns = 1.0;
+            }
+        }
+        else if (type == SITE)
+        {
+            uint32_t id = 0;
+            decoded_site site;
+            if (!reader.get(id) || !reader.get(site.level) || !reader.get(site.line) ||
+                !reader.get_string<uint16_t>(site.file) || !reader.get_string<uint32_t>(site.format))
+            {
+                return -2;
+            }
+            sites[id] = std::move(site);
+        }
+        else if (type == LINE)
+        {
+            uint32_t id = 0;
+            uint64_t tsc = 0;
+            if (!reader.get(id) || !reader.get(tsc) || !reader.get_string<uint32_t>(args))
+            {
+                return -2;
+            }
+            auto iter = sites.find(id);
+            if (iter == sites.end())
+            {
+                return -2;
+            }
+            line_text.clear();
+            if (!decode(iter->second.format.c_str(), args.data(), args.size(), line_text))
+            {
+                line_text = "<arguments do not match> " + iter->second.format;
+            }
+            print(tsc, iter->second.level, iter->second.file, iter->second.line, line_text);
+        }
+        else if (type == TEXT)
+        {
+            uint8_t level = 0;
+            uint64_t tsc = 0;
+            uint32_t line = 0;
+            std::string file;
+            if (!reader.get(level) || !reader.get(tsc) || !reader.get(line) ||
+                !reader.get_string<uint16_t>(file) || !reader.get_string<uint32_t>(line_text))
+            {
+                return -2;
+            }
+            print(tsc, level, file, line, line_text);
+        }
+        else
+        {
+            return -2;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,222 @@
+#pragma once
+#include <stdarg.h>
+#include <stdio.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+
+namespace tubekit
+{
+    namespace log
+    {
+        /**
+         * @brief a LOG_ call site, static in the expansion of the macro, registered with its format at the first line
+         *
+         */
+        struct log_site
+        {
+            const char *file;
+            int line;
+            int level;
+            std::atomic<uint32_t> id; // 0 not registered yet
+        };
+
+        /**
+         * @brief binary log, a line is the id of its call site, a TSC timestamp and the raw arguments,
+         *        formatting is left to the decoder
+         *
+         * file: magic, then records, each starts with a record_type byte, integers in host byte order
+         *   SYNC  tsc u64, realtime ns i64, ticks per ns f64
+         *   SITE  id u32, level u8, line u32, file (u16 length + bytes), format (u32 length + bytes)
+         *   LINE  id u32, tsc u64, arguments (u32 length + bytes)
+         *   TEXT  level u8, tsc u64, line u32, file (u16 length + bytes), text (u32 length + bytes)
+         * every file carries the SITE records it uses before them, so files are decoded alone
+         */
+        class binary_log
+        {
+        public:
+            enum record_type : uint8_t
+            {
+                SYNC = 1,
+                SITE = 2,
+                LINE = 3,
+                TEXT = 4,
+            };
+
+            static constexpr char magic[8] = {'T', 'K', 'B', 'L', 'O', 'G', '0', '1'};
+
+            // id of a site whose format can not be kept raw, its lines are formatted when logged and kept as TEXT
+            static constexpr uint32_t text_site = UINT32_MAX;
+
+            /**
+             * @brief how an argument is read from va_list and kept
+             *
+             */
+            enum arg_kind : uint8_t
+            {
+                INT32,     // int and smaller, width '*'
+                INT64,     // long, long long, size_t, intmax_t, ptrdiff_t
+                DOUBLE,    // float and double
+                STRING,    // u32 length + bytes
+                POINTER,   // u64
+                PRECISION, // int of precision '*', kept as INT32
+            };
+
+            struct arg
+            {
+                arg_kind kind{INT32};
+                int precision{-1}; // literal precision of STRING, bytes beyond it are not kept
+            };
+
+            struct site_info
+            {
+                const char *file{nullptr};
+                int line{0};
+                int level{0};
+                const char *format{nullptr};
+                std::vector<arg> args{};
+            };
+
+            /**
+             * @brief thread safe, the format must live as long as the process, such as a string literal
+             *
+             * @param site
+             * @param format
+             * @return uint32_t id of site, text_site when format has conversions not kept raw (%n, %m, %Lf, %ls, positional)
+             */
+            static uint32_t register_site(log_site &site, const char *format);
+
+            /**
+             * @brief thread safe
+             *
+             * @param id
+             * @return const site_info* nullptr when id is not registered
+             */
+            static const site_info *get_site(uint32_t id);
+
+            /**
+             * @brief raw arguments of a line, strings are cut to fit
+             *
+             * @param info
+             * @param arg_ptr
+             * @param out
+             * @param capacity
+             * @return size_t bytes written
+             */
+            static size_t encode(const site_info &info, va_list arg_ptr, char *out, size_t capacity);
+
+            /**
+             * @brief format a line like printf from its raw arguments
+             *
+             * @param format
+             * @param args
+             * @param length
+             * @param out
+             * @return true
+             * @return false arguments do not match format
+             */
+            static bool decode(const char *format, const char *args, size_t length, std::string &out);
+
+            /**
+             * @brief TSC on x86, steady clock ns elsewhere, invariant TSC is assumed to be synchronized among cores
+             *
+             * @return uint64_t
+             */
+            static uint64_t ticks();
+
+            /**
+             * @brief writes records into a file, rotated by size, used by one thread
+             *
+             */
+            class writer
+            {
+            public:
+                writer();
+                ~writer();
+
+                /**
+                 * @brief
+                 *
+                 * @param path current file, rotated ones are path.1 (newest) to path.keep
+                 * @param rotate_size bytes, 0 never rotates
+                 * @param keep
+                 * @return true
+                 * @return false
+                 */
+                bool open(const std::string &path, uint64_t rotate_size, uint32_t keep);
+                void close();
+                void flush();
+
+                /**
+                 * @brief SYNC record once a second at most, by the TSC of lines
+                 *
+                 * @param now ticks()
+                 */
+                void sync(uint64_t now);
+                void line(uint32_t id, uint64_t tsc, const char *args, uint32_t length);
+                void text(int level, uint64_t tsc, const char *file, int line, const char *text, uint32_t length);
+
+            private:
+                bool open_file();
+                void rotate();
+                void write(const void *data, size_t length);
+                void write_sync(uint64_t now);
+
+            private:
+                FILE *m_fp{nullptr};
+                std::string m_path{};
+                uint64_t m_rotate_size{0};
+                uint32_t m_keep{0};
+                uint64_t m_size{0};
+                std::vector<bool> m_written_sites{};
+                uint64_t m_last_sync{0};
+
+                // calibration of ticks
+                uint64_t m_base_ticks{0};
+                int64_t m_base_ns{0};
+                double m_ticks_per_ns{1.0};
+            };
+
+            /**
+             * @brief read a binary log and write it as text lines
+             *
+             * @param in
+             * @param out
+             * @return int 0 ok, -1 not a binary log, -2 truncated or broken record
+             */
+            static int decode_file(FILE *in, FILE *out);
+
+        private:
+            struct spec
+            {
+                size_t begin{0}; // '%'
+                size_t end{0};   // after the conversion
+                char conversion{0};
+                arg_kind kind{INT32};
+                bool width_star{false};
+                bool precision_star{false};
+                int precision{-1};
+            };
+
+            /**
+             * @brief
+             *
+             * @param format
+             * @param specs conversions other than %%
+             * @return true
+             * @return false a conversion is not kept raw
+             */
+            static bool parse(const char *format, std::vector<spec> &specs);
+
+        private:
+            // sites beyond it log TEXT
+            static constexpr uint32_t max_sites = 16384;
+
+            static std::mutex s_sites_mutex;
+            static std::atomic<site_info *> s_sites[max_sites]; // index id - 1, filled once
+            static uint32_t s_sites_size;                       // guarded by s_sites_mutex
+        };
+    }
+}
@@ -0,0 +1,44 @@
+#include <stdio.h>
+#include <string.h>
+#include <tubekit-log/binary_log.h>
+
+using tubekit::log::binary_log;
+
+// tubekit-log-decode log/tubekit.blog.2 log/tubekit.blog.1 log/tubekit.blog > tubekit.log
+int main(int argc, char **argv)
+{
+    if (argc < 2 || 0 == strcmp(argv[1], "-h") || 0 == strcmp(argv[1], "--help"))
+    {
+        fprintf(stderr, "usage: %s binary_log_file...\n", argv[0]);
+        fprintf(stderr, "  writes lines of files as text to stdout, oldest file first\n");
+        return argc < 2 ? 1 : 0;
+    }
+    int ret = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        FILE *in = 0 == strcmp(argv[i], "-") ? stdin : fopen(argv[i], "rb");
+        if (in == nullptr)
+        {
+            fprintf(stderr, "open %s failed\n", argv[i]);
+            ret = 1;
+            continue;
+        }
+        const int result = binary_log::decode_file(in, stdout);
+        if (result == -1)
+        {
+            fprintf(stderr, "%s is not a binary log\n", argv[i]);
+            ret = 1;
+        }
+        else if (result == -2)
+        {
+            // a file being written ends in the middle of a record
+            fprintf(stderr, "%s is truncated\n", argv[i]);
+            ret = 1;
+        }
+        if (in != stdin)
+        {
+            fclose(in);
+        }
+    }
+    return ret;
+}
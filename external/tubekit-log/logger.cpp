@@ -1,4 +1,5 @@
 #include <chrono>
+#include <strings.h>
 
 #include "logger.h"
 
@@ -12,6 +13,51 @@ const char *logger::s_flag[FLAG_COUNT] = {
     "FATAL",
 };
 
+// records are aligned to it, the end of ring always has room for a padding record size
+static constexpr size_t record_align = 8;
+// longer messages are cut in async mode
+static constexpr size_t max_message = 16 * 1024;
+// raw arguments of a binary line, longer strings are cut
+static constexpr size_t max_binary_args = 8 * 1024;
+// the flusher sleeps at most so long when nothing is queued
+static constexpr auto flusher_idle = std::chrono::milliseconds(10);
+
+namespace
+{
+    /**
+     * @brief ring of a thread, marked closed when the thread exits so the flusher frees it after draining
+     *
+     */
+    struct ring_holder
+    {
+        std::shared_ptr<void> ring{};
+        std::atomic<bool> *closed{nullptr};
+        ~ring_holder()
+        {
+            if (closed)
+            {
+                closed->store(true, std::memory_order_release);
+            }
+        }
+    };
+}
+
+logger::ring::ring(size_t size)
+{
+    size_t capacity = 4096;
+    while (capacity < size)
+    {
+        capacity <<= 1;
+    }
+    data = new char[capacity];
+    mask = capacity - 1;
+}
+
+logger::ring::~ring()
+{
+    delete[] data;
+}
+
 logger::logger() : m_fp(nullptr)
 {
 }
@@ -21,24 +67,87 @@ logger::~logger()
     close();
 }
 
+void logger::set_async(bool async, size_t ring_size, full_policy policy)
+{
+    m_async = async;
+    m_ring_size = ring_size;
+    m_policy = policy;
+}
+
+void logger::set_binary(bool binary, uint64_t rotate_size, uint32_t keep)
+{
+    m_binary = binary;
+    m_rotate_size = rotate_size;
+    m_keep = keep;
+}
+
+void logger::set_level(flag level)
+{
+    m_level.store(level, std::memory_order_relaxed);
+}
+
+bool logger::parse_level(const string &name, flag &level)
+{
+    for (int i = 0; i < FLAG_COUNT; i++)
+    {
+        if (0 == strcasecmp(name.c_str(), s_flag[i]))
+        {
+            level = (flag)i;
+            return true;
+        }
+    }
+    return false;
+}
+
 void logger::open(const string &log_file_path)
 {
     close();
-    m_fp = fopen(log_file_path.c_str(), "a+");
-    if (m_fp == nullptr)
+    if (m_binary)
     {
-        printf("open log file failed: %s\n", log_file_path.c_str());
-        exit(1);
+        if (!m_writer.open(log_file_path, m_rotate_size, m_keep))
+        {
+            printf("open log file failed: %s\n", log_file_path.c_str());
+            exit(1);
+        }
+    }
+    else
+    {
+        m_fp = fopen(log_file_path.c_str(), "a+");
+        if (m_fp == nullptr)
+        {
+            printf("open log file failed: %s\n", log_file_path.c_str());
+            exit(1);
+        }
+    }
+    if (m_async || m_binary)
+    {
+        m_running.store(true, std::memory_order_release);
+        m_flusher = std::thread(&logger::run_flusher, this);
     }
 }
 
 void logger::close()
 {
+    stop_flusher();
     if (m_fp != nullptr)
     {
         fclose(m_fp);
         m_fp = nullptr;
     }
+    m_writer.close();
+}
+
+void logger::flush()
+{
+    if (!m_running.load(std::memory_order_acquire))
+    {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(m_flush_mutex);
+    const uint64_t request = ++m_flush_request;
+    m_flush_cond.notify_one();
+    m_flushed_cond.wait(lock, [this, request]()
+                        { return m_flush_done >= request || !m_running.load(std::memory_order_acquire); });
 }
 
 void logger::debug(const char *file, int line, const char *format, ...)
@@ -79,30 +188,335 @@ void logger::fatal(const char *file, int line, const char *format, ...)
     va_start(arg_ptr, format);
     log(FATAL, file, line, format, arg_ptr);
     va_end(arg_ptr);
+    flush();
+}
+
+void logger::write(log_site &site, bool literal, const char *format, ...)
+{
+    va_list arg_ptr;
+    va_start(arg_ptr, format);
+    if (m_binary && literal)
+    {
+        log_binary(site, format, arg_ptr);
+    }
+    else
+    {
+        log((flag)site.level, site.file, site.line, format, arg_ptr);
+    }
+    va_end(arg_ptr);
+    if (site.level == FATAL)
+    {
+        flush();
+    }
+}
+
+void logger::log_binary(log_site &site, const char *format, va_list arg_ptr)
+{
+    uint32_t id = site.id.load(std::memory_order_acquire);
+    if (id == 0)
+    {
+        id = binary_log::register_site(site, format);
+    }
+    const binary_log::site_info *info = binary_log::get_site(id);
+    if (info == nullptr)
+    {
+        // formatted now, kept as text
+        log((flag)site.level, site.file, site.line, format, arg_ptr);
+        return;
+    }
+    if (!m_running.load(std::memory_order_acquire))
+    {
+        return;
+    }
+    ring *r = local_ring();
+    if (r == nullptr)
+    {
+        return;
+    }
+    thread_local char args[max_binary_args];
+    const size_t capacity = (r->mask + 1) / 2 - sizeof(record);
+    const size_t length = binary_log::encode(*info, arg_ptr, args, capacity < sizeof(args) ? capacity : sizeof(args));
+    push(r, (flag)site.level, site.file, site.line, (int64_t)binary_log::ticks(), args, length, id);
 }
 
 void logger::log(flag f, const char *file, int line, const char *format, va_list arg_ptr)
 {
-    if (m_fp == nullptr)
+    if (m_fp == nullptr && !m_binary)
     {
         printf("open log file failed: m_fp==nullptr\n");
         exit(1);
     }
-    // get time now
-    std::time_t ticks = chrono::system_clock::to_time_t(chrono::system_clock::now());
-    struct tm *ptm = std::localtime(&ticks);
-    char buf[32];
-    memset(buf, 0, sizeof(buf));
-    strftime(buf, sizeof(buf), "%Y-%m-%D %H:%M:%S  ", ptm);
-    // ensure safe using file in different thread
-    flockfile(m_fp); // print time
-    // using log file
-    fprintf(m_fp, "%s  ", buf);
-    fprintf(m_fp, "%s  ", s_flag[f]); // print flag
-    fprintf(m_fp, "%s:%d  ", file, line);
-    vfprintf(m_fp, format, arg_ptr); // formating print
-    fprintf(m_fp, "\r\n");
-    // free lock
+    const int64_t now = m_binary ? (int64_t)binary_log::ticks() : chrono::duration_cast<chrono::seconds>(chrono::system_clock::now().time_since_epoch()).count();
+
+    // the message is formatted here, its arguments do not live longer than the call
+    char buf[1024];
+    va_list arg_copy;
+    va_copy(arg_copy, arg_ptr);
+    int length = vsnprintf(buf, sizeof(buf), format, arg_copy);
+    va_end(arg_copy);
+    if (length < 0)
+    {
+        return;
+    }
+    const char *message = buf;
+    string long_message;
+    if ((size_t)length >= sizeof(buf))
+    {
+        long_message.resize(length + 1);
+        vsnprintf(&long_message[0], long_message.size(), format, arg_ptr);
+        long_message.resize(length);
+        message = long_message.c_str();
+    }
+
+    if (m_running.load(std::memory_order_acquire))
+    {
+        ring *r = local_ring();
+        if (r && push(r, f, file, line, now, message, (size_t)length < max_message ? length : max_message, binary_log::text_site))
+        {
+            return;
+        }
+        if (r && m_policy == DROP && m_running.load(std::memory_order_acquire))
+        {
+            return;
+        }
+    }
+    if (m_binary)
+    {
+        // no text is written into a binary file
+        return;
+    }
+
+    // sync mode, and lines of a thread without ring
+    thread_local char cache[32];
+    thread_local int64_t cache_time = -1;
+    flockfile(m_fp);
+    write_line(f, file, line, time_text(now, cache, cache_time), message, length);
     fflush(m_fp);
     funlockfile(m_fp);
 }
+
+logger::ring *logger::local_ring()
+{
+    thread_local ring_holder holder;
+    if (!holder.ring)
+    {
+        std::shared_ptr<ring> r;
+        try
+        {
+            r = std::make_shared<ring>(m_ring_size);
+        }
+        catch (const std::bad_alloc &)
+        {
+            return nullptr;
+        }
+        holder.closed = &r->closed;
+        holder.ring = r;
+        std::lock_guard<std::mutex> lock(m_rings_mutex);
+        m_rings.push_back(std::move(r));
+    }
+    return static_cast<ring *>(holder.ring.get());
+}
+
+bool logger::push(ring *r, flag f, const char *file, int line, int64_t now, const char *message, size_t length, uint32_t id)
+{
+    const size_t capacity = r->mask + 1;
+    const size_t size = (sizeof(record) + length + record_align - 1) & ~(record_align - 1);
+    if (size > capacity / 2)
+    {
+        length = capacity / 2 - sizeof(record);
+        return push(r, f, file, line, now, message, length, id);
+    }
+
+    const size_t tail = r->tail.load(std::memory_order_relaxed);
+    const size_t to_end = capacity - (tail & r->mask);
+    // a record never wraps, the rest of ring is skipped by a padding record
+    const size_t need = to_end < size ? to_end + size : size;
+    while (capacity - (tail - r->head.load(std::memory_order_acquire)) < need)
+    {
+        if (!m_running.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        if (m_policy == DROP)
+        {
+            r->dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        m_flush_cond.notify_one();
+        std::this_thread::yield();
+    }
+
+    size_t pos = tail;
+    if (to_end < size)
+    {
+        uint32_t padding = 0;
+        memcpy(r->data + (pos & r->mask), &padding, sizeof(padding));
+        pos += to_end;
+    }
+    record item{(uint32_t)size, (uint32_t)line, (uint32_t)length, (uint32_t)f, file, now, id};
+    char *dest = r->data + (pos & r->mask);
+    memcpy(dest, &item, sizeof(item));
+    memcpy(dest + sizeof(item), message, length);
+    r->tail.store(pos + size, std::memory_order_release);
+    return true;
+}
+
+const char *logger::time_text(int64_t now, char *cache, int64_t &cache_time)
+{
+    // localtime and strftime once a second
+    if (now != cache_time)
+    {
+        time_t ticks = (time_t)now;
+        struct tm tm_now;
+        localtime_r(&ticks, &tm_now);
+        strftime(cache, 32, "%Y-%m-%D %H:%M:%S  ", &tm_now);
+        cache_time = now;
+    }
+    return cache;
+}
+
+void logger::write_line(flag f, const char *file, int line, const char *time_now, const char *message, size_t length)
+{
+    fprintf(m_fp, "%s  %s  %s:%d  %.*s\r\n", time_now, s_flag[f], file, line, (int)length, message);
+}
+
+size_t logger::drain()
+{
+    std::vector<std::shared_ptr<ring>> rings;
+    {
+        std::lock_guard<std::mutex> lock(m_rings_mutex);
+        rings = m_rings;
+    }
+
+    size_t count = 0;
+    if (m_binary)
+    {
+        m_writer.sync(binary_log::ticks());
+    }
+    else
+    {
+        flockfile(m_fp);
+    }
+    for (auto &r : rings)
+    {
+        // closed before tail is read, nothing is pushed after an empty closed ring
+        const bool closed = r->closed.load(std::memory_order_acquire);
+        const size_t tail = r->tail.load(std::memory_order_acquire);
+        size_t head = r->head.load(std::memory_order_relaxed);
+        while (head != tail)
+        {
+            const char *src = r->data + (head & r->mask);
+            record item;
+            memcpy(&item.size, src, sizeof(item.size));
+            if (item.size == 0)
+            {
+                head += (r->mask + 1) - (head & r->mask);
+                continue;
+            }
+            memcpy(&item, src, sizeof(item));
+            if (!m_binary)
+            {
+                write_line((flag)item.f, item.file, item.line, time_text(item.time, m_time_cache, m_time_cache_sec), src + sizeof(item), item.length);
+            }
+            else if (item.id == binary_log::text_site)
+            {
+                m_writer.text(item.f, (uint64_t)item.time, item.file, item.line, src + sizeof(item), item.length);
+            }
+            else
+            {
+                m_writer.line(item.id, (uint64_t)item.time, src + sizeof(item), item.length);
+            }
+            head += item.size;
+            count++;
+        }
+        r->head.store(head, std::memory_order_release);
+
+        const uint64_t dropped = r->dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0)
+        {
+            char text[64];
+            const int length = snprintf(text, sizeof(text), "logger ring full, %llu lines dropped", (unsigned long long)dropped);
+            if (m_binary)
+            {
+                m_writer.text(WARN, binary_log::ticks(), __FILE__, __LINE__, text, length);
+            }
+            else
+            {
+                const int64_t now = chrono::duration_cast<chrono::seconds>(chrono::system_clock::now().time_since_epoch()).count();
+                write_line(WARN, __FILE__, __LINE__, time_text(now, m_time_cache, m_time_cache_sec), text, length);
+            }
+            count++;
+        }
+
+        if (closed)
+        {
+            std::lock_guard<std::mutex> lock(m_rings_mutex);
+            for (auto iter = m_rings.begin(); iter != m_rings.end(); ++iter)
+            {
+                if (iter->get() == r.get())
+                {
+                    m_rings.erase(iter);
+                    break;
+                }
+            }
+        }
+    }
+    if (m_binary)
+    {
+        if (count > 0)
+        {
+            m_writer.flush();
+        }
+        return count;
+    }
+    if (count > 0)
+    {
+        fflush(m_fp);
+    }
+    funlockfile(m_fp);
+    return count;
+}
+
+void logger::run_flusher()
+{
+    while (true)
+    {
+        uint64_t request = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_flush_mutex);
+            request = m_flush_request;
+        }
+        const bool running = m_running.load(std::memory_order_acquire);
+        const size_t count = drain();
+
+        std::unique_lock<std::mutex> lock(m_flush_mutex);
+        if (request > m_flush_done)
+        {
+            m_flush_done = request;
+            m_flushed_cond.notify_all();
+        }
+        if (!running)
+        {
+            break;
+        }
+        if (count == 0 && m_flush_request == m_flush_done)
+        {
+            m_flush_cond.wait_for(lock, flusher_idle);
+        }
+    }
+}
+
+void logger::stop_flusher()
+{
+    if (!m_flusher.joinable())
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_flush_mutex);
+        m_running.store(false, std::memory_order_release);
+        m_flush_cond.notify_one();
+    }
+    m_flusher.join();
+    m_flushed_cond.notify_all();
+}
@@ -3,8 +3,21 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include <cstdlib>
+#include <cstdint>
 #include <string>
 #include <cstring>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include "binary_log.h"
+
+// levels below it are compiled out, 0 DEBUG 1 INFO 2 WARN 3 ERROR 4 FATAL
+#ifndef TUBEKIT_LOG_MIN_LEVEL
+#define TUBEKIT_LOG_MIN_LEVEL 0
+#endif
 
 namespace tubekit
 {
@@ -34,7 +47,59 @@ namespace tubekit
             };
 
             /**
-             * @brief open log file
+             * @brief what a thread does when its ring buffer is full in async mode
+             *
+             */
+            enum full_policy
+            {
+                DROP,  // the line is counted and dropped, the count is written later
+                BLOCK, // the thread waits for the flusher
+            };
+
+            /**
+             * @brief lines are queued into a ring buffer of each thread and written by a background flusher,
+             *        call before open
+             *
+             * @param async
+             * @param ring_size bytes of ring buffer of each thread, rounded up to power of 2
+             * @param policy
+             */
+            void set_async(bool async, size_t ring_size = 1024 * 1024, full_policy policy = DROP);
+
+            /**
+             * @brief lines are written as binary_log records, formatted by tubekit-log-decode,
+             *        async mode is implied and lines are dropped instead of written in place, call before open
+             *
+             * @param binary
+             * @param rotate_size bytes of a file, 0 never rotates
+             * @param keep rotated files kept
+             */
+            void set_binary(bool binary, uint64_t rotate_size = 256 * 1024 * 1024, uint32_t keep = 8);
+
+            /**
+             * @brief thread safe, lines below level are skipped before being formatted
+             *
+             * @param level
+             */
+            void set_level(flag level);
+
+            /**
+             * @brief level of name such as "INFO"
+             *
+             * @param name
+             * @param level
+             * @return true
+             * @return false unknown name
+             */
+            static bool parse_level(const string &name, flag &level);
+
+            inline bool enabled(flag f) const
+            {
+                return f >= m_level.load(std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief open log file, the flusher starts in async mode
              *
              * @param log_file_path
              */
@@ -42,11 +107,17 @@ namespace tubekit
             void open(const string &log_file_path);
 
             /**
-             * @brief close log file
+             * @brief close log file, queued lines are written before
              *
              */
             void close();
 
+            /**
+             * @brief wait until lines queued before are written
+             *
+             */
+            void flush();
+
             /**
              * @brief out log in debug
              *
@@ -88,7 +159,7 @@ namespace tubekit
             void error(const char *file, int line, const char *format, ...);
 
             /**
-             * @brief out log in fatlal
+             * @brief out log in fatlal, written before return in async mode too
              *
              * @param file content
              * @param line line number
@@ -97,18 +168,119 @@ namespace tubekit
              */
             void fatal(const char *file, int line, const char *format, ...);
 
+            /**
+             * @brief out log of a LOG_ call site, in binary mode a literal format is registered once
+             *        and only its arguments are queued
+             *
+             * @param site
+             * @param literal format lives as long as the process
+             * @param format
+             * @param ... param
+             */
+            void write(log_site &site, bool literal, const char *format, ...);
+
         protected:
             void log(flag f, const char *file, int line, const char *format, va_list arg_ptr);
+            void log_binary(log_site &site, const char *format, va_list arg_ptr);
+
+        private:
+            /**
+             * @brief byte ring of one producer thread and the flusher
+             *
+             */
+            struct ring
+            {
+                explicit ring(size_t size);
+                ~ring();
+
+                char *data{nullptr};
+                size_t mask{0};
+                alignas(64) std::atomic<size_t> tail{0}; // written by producer
+                alignas(64) std::atomic<size_t> head{0}; // written by flusher
+                std::atomic<uint64_t> dropped{0};
+                std::atomic<bool> closed{false}; // producer thread exited
+            };
+
+            /**
+             * @brief a line in ring, message follows it
+             *
+             */
+            struct record
+            {
+                uint32_t size; // bytes of record and message, aligned, 0 for padding to the end of ring
+                uint32_t line;
+                uint32_t length; // message
+                uint32_t f;
+                const char *file;
+                int64_t time; // seconds since epoch, binary_log::ticks() in binary mode
+                uint32_t id;  // binary mode, site of raw arguments or binary_log::text_site for a message
+            };
+
+            /**
+             * @brief ring of calling thread, registered on first use
+             *
+             * @return ring*
+             */
+            ring *local_ring();
+            bool push(ring *r, flag f, const char *file, int line, int64_t now, const char *message, size_t length, uint32_t id = 0);
+            void write_line(flag f, const char *file, int line, const char *time_now, const char *message, size_t length);
+            static const char *time_text(int64_t now, char *cache, int64_t &cache_time);
+            size_t drain();
+            void run_flusher();
+            void stop_flusher();
 
         protected:
             FILE *m_fp{nullptr};
             static const char *s_flag[FLAG_COUNT];
+
+        private:
+            std::atomic<int> m_level{DEBUG};
+            bool m_async{false};
+            size_t m_ring_size{1024 * 1024};
+            full_policy m_policy{DROP};
+            bool m_binary{false};
+            uint64_t m_rotate_size{256 * 1024 * 1024};
+            uint32_t m_keep{8};
+
+            std::mutex m_rings_mutex;
+            std::vector<std::shared_ptr<ring>> m_rings;
+
+            std::thread m_flusher;
+            std::atomic<bool> m_running{false};
+            std::mutex m_flush_mutex;
+            std::condition_variable m_flush_cond;
+            std::condition_variable m_flushed_cond;
+            uint64_t m_flush_request{0}; // guarded by m_flush_mutex
+            uint64_t m_flush_done{0};
+
+            // flusher only
+            char m_time_cache[32]{};
+            int64_t m_time_cache_sec{-1};
+            binary_log::writer m_writer;
         };
     }
 }
 
-#define LOG_DEBUG(...) tubekit::log::logger::instance().debug(__FILE__, __LINE__, __VA_ARGS__)
-#define LOG_INFO(...) tubekit::log::logger::instance().info(__FILE__, __LINE__, __VA_ARGS__)
-#define LOG_WARN(...) tubekit::log::logger::instance().warn(__FILE__, __LINE__, __VA_ARGS__)
-#define LOG_ERROR(...) tubekit::log::logger::instance().error(__FILE__, __LINE__, __VA_ARGS__)
-#define LOG_FATAL(...) tubekit::log::logger::instance().fatal(__FILE__, __LINE__, __VA_ARGS__)
\ No newline at end of file
+// 1 when the format is a string literal, its arguments can be kept raw by the binary log
+#define TUBEKIT_LOG_FIRST(first, ...) first
+#ifdef __GNUC__
+#define TUBEKIT_LOG_LITERAL(...) __builtin_constant_p(TUBEKIT_LOG_FIRST(__VA_ARGS__, 0))
+#else
+#define TUBEKIT_LOG_LITERAL(...) 0
+#endif
+
+#define TUBEKIT_LOG(f, ...)                                                                                                            \
+    do                                                                                                                                 \
+    {                                                                                                                                  \
+        if ((int)tubekit::log::logger::f >= TUBEKIT_LOG_MIN_LEVEL && tubekit::log::logger::instance().enabled(tubekit::log::logger::f)) \
+        {                                                                                                                              \
+            static tubekit::log::log_site tubekit_log_site{__FILE__, __LINE__, tubekit::log::logger::f, {0}};                         \
+            tubekit::log::logger::instance().write(tubekit_log_site, TUBEKIT_LOG_LITERAL(__VA_ARGS__), __VA_ARGS__);                  \
+        }                                                                                                                              \
+    } while (0)
+
+#define LOG_DEBUG(...) TUBEKIT_LOG(DEBUG, __VA_ARGS__)
+#define LOG_INFO(...) TUBEKIT_LOG(INFO, __VA_ARGS__)
+#define LOG_WARN(...) TUBEKIT_LOG(WARN, __VA_ARGS__)
+#define LOG_ERROR(...) TUBEKIT_LOG(ERROR, __VA_ARGS__)
+#define LOG_FATAL(...) TUBEKIT_LOG(FATAL, __VA_ARGS__)
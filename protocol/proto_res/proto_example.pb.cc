@@ -0,0 +1,509 @@
+// Generated by the protocol buffer compiler.  DO NOT EDIT!
+// source: proto_example.proto
+
+#include "proto_example.pb.h"
+
+#include <algorithm>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/extension_set.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/generated_message_reflection.h>
+#include <google/protobuf/reflection_ops.h>
+#include <google/protobuf/wire_format.h>
+// @@protoc_insertion_point(includes)
+#include <google/protobuf/port_def.inc>
+
+PROTOBUF_PRAGMA_INIT_SEG
+
+namespace _pb = ::PROTOBUF_NAMESPACE_ID;
+namespace _pbi = _pb::internal;
+
+PROTOBUF_CONSTEXPR ProtoCSReqExample::ProtoCSReqExample(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.testcontext_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct ProtoCSReqExampleDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR ProtoCSReqExampleDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~ProtoCSReqExampleDefaultTypeInternal() {}
+  union {
+    ProtoCSReqExample _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 ProtoCSReqExampleDefaultTypeInternal _ProtoCSReqExample_default_instance_;
+PROTOBUF_CONSTEXPR ProtoCSResExample::ProtoCSResExample(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.testcontext_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct ProtoCSResExampleDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR ProtoCSResExampleDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~ProtoCSResExampleDefaultTypeInternal() {}
+  union {
+    ProtoCSResExample _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 ProtoCSResExampleDefaultTypeInternal _ProtoCSResExample_default_instance_;
+static ::_pb::Metadata file_level_metadata_proto_5fexample_2eproto[2];
+static constexpr ::_pb::EnumDescriptor const** file_level_enum_descriptors_proto_5fexample_2eproto = nullptr;
+static constexpr ::_pb::ServiceDescriptor const** file_level_service_descriptors_proto_5fexample_2eproto = nullptr;
+
+const uint32_t TableStruct_proto_5fexample_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::ProtoCSReqExample, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::ProtoCSReqExample, _impl_.testcontext_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::ProtoCSResExample, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::ProtoCSResExample, _impl_.testcontext_),
+};
+static const ::_pbi::MigrationSchema schemas[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
+  { 0, -1, -1, sizeof(::ProtoCSReqExample)},
+  { 7, -1, -1, sizeof(::ProtoCSResExample)},
+};
+
+static const ::_pb::Message* const file_default_instances[] = {
+  &::_ProtoCSReqExample_default_instance_._instance,
+  &::_ProtoCSResExample_default_instance_._instance,
+};
+
+const char descriptor_table_protodef_proto_5fexample_2eproto[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) =
+  "\n\023proto_example.proto\"(\n\021ProtoCSReqExamp"
+  "le\022\023\n\013testContext\030\001 \001(\014\"(\n\021ProtoCSResExa"
+  "mple\022\023\n\013testContext\030\001 \001(\014b\006proto3"
+  ;
+static ::_pbi::once_flag descriptor_table_proto_5fexample_2eproto_once;
+const ::_pbi::DescriptorTable descriptor_table_proto_5fexample_2eproto = {
+    false, false, 113, descriptor_table_protodef_proto_5fexample_2eproto,
+    "proto_example.proto",
+    &descriptor_table_proto_5fexample_2eproto_once, nullptr, 0, 2,
+    schemas, file_default_instances, TableStruct_proto_5fexample_2eproto::offsets,
+    file_level_metadata_proto_5fexample_2eproto, file_level_enum_descriptors_proto_5fexample_2eproto,
+    file_level_service_descriptors_proto_5fexample_2eproto,
+};
+PROTOBUF_ATTRIBUTE_WEAK const ::_pbi::DescriptorTable* descriptor_table_proto_5fexample_2eproto_getter() {
+  return &descriptor_table_proto_5fexample_2eproto;
+}
+
+// Force running AddDescriptors() at dynamic initialization time.
+PROTOBUF_ATTRIBUTE_INIT_PRIORITY2 static ::_pbi::AddDescriptorsRunner dynamic_init_dummy_proto_5fexample_2eproto(&descriptor_table_proto_5fexample_2eproto);
+
+// ===================================================================
+
+class ProtoCSReqExample::_Internal {
+ public:
+};
+
+ProtoCSReqExample::ProtoCSReqExample(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:ProtoCSReqExample)
+}
+ProtoCSReqExample::ProtoCSReqExample(const ProtoCSReqExample& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  ProtoCSReqExample* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.testcontext_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _impl_.testcontext_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.testcontext_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_testcontext().empty()) {
+    _this->_impl_.testcontext_.Set(from._internal_testcontext(), 
+      _this->GetArenaForAllocation());
+  }
+  // @@protoc_insertion_point(copy_constructor:ProtoCSReqExample)
+}
+
+inline void ProtoCSReqExample::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.testcontext_){}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.testcontext_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.testcontext_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+ProtoCSReqExample::~ProtoCSReqExample() {
+  // @@protoc_insertion_point(destructor:ProtoCSReqExample)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void ProtoCSReqExample::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.testcontext_.Destroy();
+}
+
+void ProtoCSReqExample::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void ProtoCSReqExample::Clear() {
+// @@protoc_insertion_point(message_clear_start:ProtoCSReqExample)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.testcontext_.ClearToEmpty();
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* ProtoCSReqExample::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // bytes testContext = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          auto str = _internal_mutable_testcontext();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* ProtoCSReqExample::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:ProtoCSReqExample)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // bytes testContext = 1;
+  if (!this->_internal_testcontext().empty()) {
+    target = stream->WriteBytesMaybeAliased(
+        1, this->_internal_testcontext(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:ProtoCSReqExample)
+  return target;
+}
+
+size_t ProtoCSReqExample::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:ProtoCSReqExample)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // bytes testContext = 1;
+  if (!this->_internal_testcontext().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+        this->_internal_testcontext());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData ProtoCSReqExample::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    ProtoCSReqExample::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*ProtoCSReqExample::GetClassData() const { return &_class_data_; }
+
+
+void ProtoCSReqExample::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<ProtoCSReqExample*>(&to_msg);
+  auto& from = static_cast<const ProtoCSReqExample&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:ProtoCSReqExample)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (!from._internal_testcontext().empty()) {
+    _this->_internal_set_testcontext(from._internal_testcontext());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void ProtoCSReqExample::CopyFrom(const ProtoCSReqExample& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:ProtoCSReqExample)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool ProtoCSReqExample::IsInitialized() const {
+  return true;
+}
+
+void ProtoCSReqExample::InternalSwap(ProtoCSReqExample* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.testcontext_, lhs_arena,
+      &other->_impl_.testcontext_, rhs_arena
+  );
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata ProtoCSReqExample::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_proto_5fexample_2eproto_getter, &descriptor_table_proto_5fexample_2eproto_once,
+      file_level_metadata_proto_5fexample_2eproto[0]);
+}
+
+// ===================================================================
+
+class ProtoCSResExample::_Internal {
+ public:
+};
+
+ProtoCSResExample::ProtoCSResExample(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:ProtoCSResExample)
+}
+ProtoCSResExample::ProtoCSResExample(const ProtoCSResExample& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  ProtoCSResExample* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.testcontext_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _impl_.testcontext_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.testcontext_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_testcontext().empty()) {
+    _this->_impl_.testcontext_.Set(from._internal_testcontext(), 
+      _this->GetArenaForAllocation());
+  }
+  // @@protoc_insertion_point(copy_constructor:ProtoCSResExample)
+}
+
+inline void ProtoCSResExample::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.testcontext_){}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.testcontext_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.testcontext_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+ProtoCSResExample::~ProtoCSResExample() {
+  // @@protoc_insertion_point(destructor:ProtoCSResExample)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void ProtoCSResExample::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.testcontext_.Destroy();
+}
+
+void ProtoCSResExample::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void ProtoCSResExample::Clear() {
+// @@protoc_insertion_point(message_clear_start:ProtoCSResExample)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.testcontext_.ClearToEmpty();
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* ProtoCSResExample::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // bytes testContext = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          auto str = _internal_mutable_testcontext();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* ProtoCSResExample::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:ProtoCSResExample)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // bytes testContext = 1;
+  if (!this->_internal_testcontext().empty()) {
+    target = stream->WriteBytesMaybeAliased(
+        1, this->_internal_testcontext(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:ProtoCSResExample)
+  return target;
+}
+
+size_t ProtoCSResExample::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:ProtoCSResExample)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // bytes testContext = 1;
+  if (!this->_internal_testcontext().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+        this->_internal_testcontext());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData ProtoCSResExample::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    ProtoCSResExample::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*ProtoCSResExample::GetClassData() const { return &_class_data_; }
+
+
+void ProtoCSResExample::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<ProtoCSResExample*>(&to_msg);
+  auto& from = static_cast<const ProtoCSResExample&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:ProtoCSResExample)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (!from._internal_testcontext().empty()) {
+    _this->_internal_set_testcontext(from._internal_testcontext());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void ProtoCSResExample::CopyFrom(const ProtoCSResExample& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:ProtoCSResExample)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool ProtoCSResExample::IsInitialized() const {
+  return true;
+}
+
+void ProtoCSResExample::InternalSwap(ProtoCSResExample* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.testcontext_, lhs_arena,
+      &other->_impl_.testcontext_, rhs_arena
+  );
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata ProtoCSResExample::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_proto_5fexample_2eproto_getter, &descriptor_table_proto_5fexample_2eproto_once,
+      file_level_metadata_proto_5fexample_2eproto[1]);
+}
+
+// @@protoc_insertion_point(namespace_scope)
+PROTOBUF_NAMESPACE_OPEN
+template<> PROTOBUF_NOINLINE ::ProtoCSReqExample*
+Arena::CreateMaybeMessage< ::ProtoCSReqExample >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::ProtoCSReqExample >(arena);
+}
+template<> PROTOBUF_NOINLINE ::ProtoCSResExample*
+Arena::CreateMaybeMessage< ::ProtoCSResExample >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::ProtoCSResExample >(arena);
+}
+PROTOBUF_NAMESPACE_CLOSE
+
+// @@protoc_insertion_point(global_scope)
+#include <google/protobuf/port_undef.inc>
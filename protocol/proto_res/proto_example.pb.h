@@ -0,0 +1,491 @@
+// Generated by the protocol buffer compiler.  DO NOT EDIT!
+// source: proto_example.proto
+
+#ifndef GOOGLE_PROTOBUF_INCLUDED_proto_5fexample_2eproto
+#define GOOGLE_PROTOBUF_INCLUDED_proto_5fexample_2eproto
+
+#include <limits>
+#include <string>
+
+#include <google/protobuf/port_def.inc>
+#if PROTOBUF_VERSION < 3021000
+#error This file was generated by a newer version of protoc which is
+#error incompatible with your Protocol Buffer headers. Please update
+#error your headers.
+#endif
+#if 3021012 < PROTOBUF_MIN_PROTOC_VERSION
+#error This file was generated by an older version of protoc which is
+#error incompatible with your Protocol Buffer headers. Please
+#error regenerate this file with a newer version of protoc.
+#endif
+
+#include <google/protobuf/port_undef.inc>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/arena.h>
+#include <google/protobuf/arenastring.h>
+#include <google/protobuf/generated_message_util.h>
+#include <google/protobuf/metadata_lite.h>
+#include <google/protobuf/generated_message_reflection.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/repeated_field.h>  // IWYU pragma: export
+#include <google/protobuf/extension_set.h>  // IWYU pragma: export
+#include <google/protobuf/unknown_field_set.h>
+// @@protoc_insertion_point(includes)
+#include <google/protobuf/port_def.inc>
+#define PROTOBUF_INTERNAL_EXPORT_proto_5fexample_2eproto
+PROTOBUF_NAMESPACE_OPEN
+namespace internal {
+class AnyMetadata;
+}  // namespace internal
+PROTOBUF_NAMESPACE_CLOSE
+
+// Internal implementation detail -- do not use these members.
+struct TableStruct_proto_5fexample_2eproto {
+  static const uint32_t offsets[];
+};
+extern const ::PROTOBUF_NAMESPACE_ID::internal::DescriptorTable descriptor_table_proto_5fexample_2eproto;
+class ProtoCSReqExample;
+struct ProtoCSReqExampleDefaultTypeInternal;
+extern ProtoCSReqExampleDefaultTypeInternal _ProtoCSReqExample_default_instance_;
+class ProtoCSResExample;
+struct ProtoCSResExampleDefaultTypeInternal;
+extern ProtoCSResExampleDefaultTypeInternal _ProtoCSResExample_default_instance_;
+PROTOBUF_NAMESPACE_OPEN
+template<> ::ProtoCSReqExample* Arena::CreateMaybeMessage<::ProtoCSReqExample>(Arena*);
+template<> ::ProtoCSResExample* Arena::CreateMaybeMessage<::ProtoCSResExample>(Arena*);
+PROTOBUF_NAMESPACE_CLOSE
+
+// ===================================================================
+
+class ProtoCSReqExample final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:ProtoCSReqExample) */ {
+ public:
+  inline ProtoCSReqExample() : ProtoCSReqExample(nullptr) {}
+  ~ProtoCSReqExample() override;
+  explicit PROTOBUF_CONSTEXPR ProtoCSReqExample(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  ProtoCSReqExample(const ProtoCSReqExample& from);
+  ProtoCSReqExample(ProtoCSReqExample&& from) noexcept
+    : ProtoCSReqExample() {
+    *this = ::std::move(from);
+  }
+
+  inline ProtoCSReqExample& operator=(const ProtoCSReqExample& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline ProtoCSReqExample& operator=(ProtoCSReqExample&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const ProtoCSReqExample& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const ProtoCSReqExample* internal_default_instance() {
+    return reinterpret_cast<const ProtoCSReqExample*>(
+               &_ProtoCSReqExample_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    0;
+
+  friend void swap(ProtoCSReqExample& a, ProtoCSReqExample& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(ProtoCSReqExample* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(ProtoCSReqExample* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  ProtoCSReqExample* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<ProtoCSReqExample>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const ProtoCSReqExample& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const ProtoCSReqExample& from) {
+    ProtoCSReqExample::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(ProtoCSReqExample* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "ProtoCSReqExample";
+  }
+  protected:
+  explicit ProtoCSReqExample(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kTestContextFieldNumber = 1,
+  };
+  // bytes testContext = 1;
+  void clear_testcontext();
+  const std::string& testcontext() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_testcontext(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_testcontext();
+  PROTOBUF_NODISCARD std::string* release_testcontext();
+  void set_allocated_testcontext(std::string* testcontext);
+  private:
+  const std::string& _internal_testcontext() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_testcontext(const std::string& value);
+  std::string* _internal_mutable_testcontext();
+  public:
+
+  // @@protoc_insertion_point(class_scope:ProtoCSReqExample)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr testcontext_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_proto_5fexample_2eproto;
+};
+// -------------------------------------------------------------------
+
+class ProtoCSResExample final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:ProtoCSResExample) */ {
+ public:
+  inline ProtoCSResExample() : ProtoCSResExample(nullptr) {}
+  ~ProtoCSResExample() override;
+  explicit PROTOBUF_CONSTEXPR ProtoCSResExample(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  ProtoCSResExample(const ProtoCSResExample& from);
+  ProtoCSResExample(ProtoCSResExample&& from) noexcept
+    : ProtoCSResExample() {
+    *this = ::std::move(from);
+  }
+
+  inline ProtoCSResExample& operator=(const ProtoCSResExample& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline ProtoCSResExample& operator=(ProtoCSResExample&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const ProtoCSResExample& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const ProtoCSResExample* internal_default_instance() {
+    return reinterpret_cast<const ProtoCSResExample*>(
+               &_ProtoCSResExample_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    1;
+
+  friend void swap(ProtoCSResExample& a, ProtoCSResExample& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(ProtoCSResExample* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(ProtoCSResExample* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  ProtoCSResExample* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<ProtoCSResExample>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const ProtoCSResExample& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const ProtoCSResExample& from) {
+    ProtoCSResExample::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(ProtoCSResExample* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "ProtoCSResExample";
+  }
+  protected:
+  explicit ProtoCSResExample(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kTestContextFieldNumber = 1,
+  };
+  // bytes testContext = 1;
+  void clear_testcontext();
+  const std::string& testcontext() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_testcontext(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_testcontext();
+  PROTOBUF_NODISCARD std::string* release_testcontext();
+  void set_allocated_testcontext(std::string* testcontext);
+  private:
+  const std::string& _internal_testcontext() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_testcontext(const std::string& value);
+  std::string* _internal_mutable_testcontext();
+  public:
+
+  // @@protoc_insertion_point(class_scope:ProtoCSResExample)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr testcontext_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_proto_5fexample_2eproto;
+};
+// ===================================================================
+
+
+// ===================================================================
+
+#ifdef __GNUC__
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wstrict-aliasing"
+#endif  // __GNUC__
+// ProtoCSReqExample
+
+// bytes testContext = 1;
+inline void ProtoCSReqExample::clear_testcontext() {
+  _impl_.testcontext_.ClearToEmpty();
+}
+inline const std::string& ProtoCSReqExample::testcontext() const {
+  // @@protoc_insertion_point(field_get:ProtoCSReqExample.testContext)
+  return _internal_testcontext();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void ProtoCSReqExample::set_testcontext(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.testcontext_.SetBytes(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:ProtoCSReqExample.testContext)
+}
+inline std::string* ProtoCSReqExample::mutable_testcontext() {
+  std::string* _s = _internal_mutable_testcontext();
+  // @@protoc_insertion_point(field_mutable:ProtoCSReqExample.testContext)
+  return _s;
+}
+inline const std::string& ProtoCSReqExample::_internal_testcontext() const {
+  return _impl_.testcontext_.Get();
+}
+inline void ProtoCSReqExample::_internal_set_testcontext(const std::string& value) {
+  
+  _impl_.testcontext_.Set(value, GetArenaForAllocation());
+}
+inline std::string* ProtoCSReqExample::_internal_mutable_testcontext() {
+  
+  return _impl_.testcontext_.Mutable(GetArenaForAllocation());
+}
+inline std::string* ProtoCSReqExample::release_testcontext() {
+  // @@protoc_insertion_point(field_release:ProtoCSReqExample.testContext)
+  return _impl_.testcontext_.Release();
+}
+inline void ProtoCSReqExample::set_allocated_testcontext(std::string* testcontext) {
+  if (testcontext != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.testcontext_.SetAllocated(testcontext, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.testcontext_.IsDefault()) {
+    _impl_.testcontext_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:ProtoCSReqExample.testContext)
+}
+
+// -------------------------------------------------------------------
+
+// ProtoCSResExample
+
+// bytes testContext = 1;
+inline void ProtoCSResExample::clear_testcontext() {
+  _impl_.testcontext_.ClearToEmpty();
+}
+inline const std::string& ProtoCSResExample::testcontext() const {
+  // @@protoc_insertion_point(field_get:ProtoCSResExample.testContext)
+  return _internal_testcontext();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void ProtoCSResExample::set_testcontext(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.testcontext_.SetBytes(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:ProtoCSResExample.testContext)
+}
+inline std::string* ProtoCSResExample::mutable_testcontext() {
+  std::string* _s = _internal_mutable_testcontext();
+  // @@protoc_insertion_point(field_mutable:ProtoCSResExample.testContext)
+  return _s;
+}
+inline const std::string& ProtoCSResExample::_internal_testcontext() const {
+  return _impl_.testcontext_.Get();
+}
+inline void ProtoCSResExample::_internal_set_testcontext(const std::string& value) {
+  
+  _impl_.testcontext_.Set(value, GetArenaForAllocation());
+}
+inline std::string* ProtoCSResExample::_internal_mutable_testcontext() {
+  
+  return _impl_.testcontext_.Mutable(GetArenaForAllocation());
+}
+inline std::string* ProtoCSResExample::release_testcontext() {
+  // @@protoc_insertion_point(field_release:ProtoCSResExample.testContext)
+  return _impl_.testcontext_.Release();
+}
+inline void ProtoCSResExample::set_allocated_testcontext(std::string* testcontext) {
+  if (testcontext != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.testcontext_.SetAllocated(testcontext, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.testcontext_.IsDefault()) {
+    _impl_.testcontext_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:ProtoCSResExample.testContext)
+}
+
+#ifdef __GNUC__
+  #pragma GCC diagnostic pop
+#endif  // __GNUC__
+// -------------------------------------------------------------------
+
+
+// @@protoc_insertion_point(namespace_scope)
+
+
+// @@protoc_insertion_point(global_scope)
+
+#include <google/protobuf/port_undef.inc>
+#endif  // GOOGLE_PROTOBUF_INCLUDED_GOOGLE_PROTOBUF_INCLUDED_proto_5fexample_2eproto
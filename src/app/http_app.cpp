@@ -3,21 +3,44 @@
 #include <vector>
 #include <filesystem>
 #include <tubekit-log/logger.h>
-#include <tuple>
+#include <fcntl.h>
+#include <unistd.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <climits>
 #include "server/server.h"
+#include "socket/admission.h"
 
 #include "utility/mime_type.h"
 #include "utility/url.h"
 #include "utility/singleton.h"
+#include "utility/http_range.h"
+#include "utility/time.h"
 #include "app/lua_plugin.h"
+#include "app/http_compress.h"
+#include "app/http_upload_sink.h"
+#include "app/http_router.h"
+#include "app/http_proxy.h"
+#include "thread/worker_pool.h"
 
 using std::string;
 using std::vector;
 using tubekit::app::http_app;
+using tubekit::app::http_compress;
+using tubekit::app::http_upload_sink;
+using tubekit::app::http_router;
+using tubekit::app::http_proxy;
+using tubekit::app::http_proxy_session;
 using tubekit::connection::http_connection;
+using tubekit::connection::http_response;
+using tubekit::thread::codel;
+using tubekit::thread::worker_pool;
 namespace fs = std::filesystem;
 namespace utility = tubekit::utility;
 
+// more ranges in one request are ignored and the whole file is served
+static constexpr size_t max_ranges = 16;
+
 class html_loader
 {
 public:
@@ -40,10 +63,65 @@ public:
     }
 };
 
+/**
+ * @brief overload_status_path route, shedding thresholds and state of every worker
+ *
+ * @param connection
+ */
+static void overload_status(http_connection &connection, const http_router::params &)
+{
+    tubekit::server::server *server_ptr = utility::singleton<tubekit::server::server>::instance();
+    worker_pool *pool = utility::singleton<worker_pool>::instance();
+    char item[160];
+    snprintf(item, sizeof(item), "{\"shedding\":%s,\"target_ms\":%zu,\"interval_ms\":%zu,\"workers\":[",
+             server_ptr->get_overload_shedding() ? "true" : "false", server_ptr->get_overload_target(), server_ptr->get_overload_interval());
+    string body = item;
+    for (size_t i = 0; i < pool->get_size(); i++)
+    {
+        const codel &worker_codel = pool->get_codel(i);
+        snprintf(item, sizeof(item), "%s{\"overloaded\":%s,\"sojourn_us\":%llu,\"overloads\":%llu,\"shed\":%llu}",
+                 i > 0 ? "," : "",
+                 worker_codel.get_overloaded() ? "true" : "false",
+                 (unsigned long long)worker_codel.get_sojourn(),
+                 (unsigned long long)worker_codel.get_overloads(),
+                 (unsigned long long)worker_codel.get_shed());
+        body += item;
+    }
+    body += "]}";
+    connection.response.set_status(200).add_header(http_response::CONTENT_TYPE, "application/json").set_content_length(body.size());
+    if (connection.request.method != "HEAD")
+    {
+        connection.response.add_body(std::move(body));
+    }
+    connection.response.commit();
+    connection.set_response_end(true);
+}
+
 int http_app::on_init()
 {
     LOG_ERROR("http_app::on_init()");
+    const string &overload_status_path = utility::singleton<server::server>::instance()->get_overload_status_path();
+    if (!overload_status_path.empty() && !utility::singleton<http_router>::instance()->add("GET", overload_status_path, overload_status))
+    {
+        LOG_ERROR("overload_status_path %s is not a valid route", overload_status_path.c_str());
+    }
+    // native routes are added by utility::singleton<http_router>::instance()->add before here, lua routes by tubekit.Route in init.lua
     utility::singleton<app::lua_plugin>::instance()->on_init();
+    if (!utility::singleton<http_router>::instance()->compile())
+    {
+        LOG_ERROR("http_router compile failed, conflict routes");
+    }
+    server::server *server_ptr = utility::singleton<server::server>::instance();
+    utility::singleton<app::http_compress>::instance()->init(server_ptr->get_http_gzip(),
+                                                            server_ptr->get_http_gzip_min_length(),
+                                                            server_ptr->get_http_gzip_types(),
+                                                            server_ptr->get_http_gzip_cache_size());
+    if (0 != utility::singleton<app::http_proxy>::instance()->init(server_ptr->get_http_proxy_pass(),
+                                                                   server_ptr->get_http_proxy_balance(),
+                                                                   server_ptr->get_http_proxy_keepalive()))
+    {
+        LOG_ERROR("http_proxy init failed, proxy disabled");
+    }
     return 0;
 }
 
@@ -69,34 +147,91 @@ int http_app::on_body(tubekit::connection::http_connection &m_http_connection)
     return 0;
 }
 
+struct http_app_file
+{
+    int fd{-1};
+    uint64_t size{0};
+    std::string content_type{};
+    std::shared_ptr<const std::string> memory_body{nullptr}; // compressed variant, replace fd when not null
+    std::vector<tubekit::utility::http_range::range> ranges{};
+    std::string boundary{}; // not empty when multipart/byteranges
+
+    ~http_app_file()
+    {
+        if (fd >= 0)
+        {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+
+    std::string part_head(const tubekit::utility::http_range::range &range) const
+    {
+        return "\r\n--" + boundary + "\r\nContent-Type: " + content_type +
+               "\r\nContent-Range: bytes " + std::to_string(range.first) + "-" + std::to_string(range.second) + "/" + std::to_string(size) + "\r\n\r\n";
+    }
+
+    std::string tail() const
+    {
+        return "\r\n--" + boundary + "--\r\n";
+    }
+
+    uint64_t content_length() const
+    {
+        uint64_t length = 0;
+        for (const auto &range : ranges)
+        {
+            length += range.second - range.first + 1;
+            if (!boundary.empty())
+            {
+                length += part_head(range).size();
+            }
+        }
+        if (!boundary.empty())
+        {
+            length += tail().size();
+        }
+        return length;
+    }
+};
+
 struct http_app_reponse
 {
     enum type
     {
-        DIR = 0,
         FD = 1,
         NONE = 2,
+        UPLOAD = 3,
+        PROXY = 4,
     };
 
     void *ptr{nullptr};
     type ptr_type{NONE};
 
-    typedef std::tuple<std::string, size_t> DIR_TYPE;
-    typedef FILE FD_TYPE;
+    typedef http_app_file FD_TYPE;
+    typedef http_upload_sink UPLOAD_TYPE;
+    typedef http_proxy_session PROXY_TYPE;
 
     inline void destory()
     {
         if (ptr && ptr_type == FD)
         {
             FD_TYPE *free_ptr = (FD_TYPE *)ptr;
-            ::fclose(free_ptr);
+            delete free_ptr;
             ptr = nullptr;
             return;
         }
-        else if (ptr && ptr_type == DIR)
+        else if (ptr && ptr_type == UPLOAD)
         {
-            DIR_TYPE *free_ptr = (DIR_TYPE *)ptr;
-            delete free_ptr;
+            UPLOAD_TYPE *free_ptr = (UPLOAD_TYPE *)ptr;
+            delete free_ptr; // unfinished upload is removed
+            ptr = nullptr;
+            return;
+        }
+        else if (ptr && ptr_type == PROXY)
+        {
+            PROXY_TYPE *free_ptr = (PROXY_TYPE *)ptr;
+            delete free_ptr; // upstream connection goes back to pool or is closed
             ptr = nullptr;
             return;
         }
@@ -108,23 +243,203 @@ struct http_app_reponse
     }
 };
 
-void http_app::process_connection(tubekit::connection::http_connection &m_http_connection)
+static void response_destory_callback(http_connection &m_connection)
 {
-    // load callback
-    m_http_connection.destory_callback = [](http_connection &m_connection) -> void
+    if (m_connection.ptr)
+    {
+        http_app_reponse *reponse_ptr = (http_app_reponse *)m_connection.ptr;
+        reponse_ptr->destory();
+        delete reponse_ptr;
+        m_connection.ptr = nullptr;
+    }
+}
+
+/**
+ * @brief respond before the request body is read, the connection is closed after it
+ *
+ * @param connection
+ * @param status such as 413
+ */
+static void early_response(http_connection &connection, int status)
+{
+    connection.response.set_status(status).add_header(http_response::CONNECTION, "close").set_content_length(0).commit();
+    connection.set_recv_end(true);
+    connection.set_process_end(true);
+    connection.set_response_end(true);
+}
+
+int http_app::on_headers_complete(tubekit::connection::http_connection &m_http_connection)
+{
+    // request tokens of the client address are used up
+    if (!utility::singleton<socket::admission>::instance()->allow_request(m_http_connection.get_socket_ptr()->get_admission()))
+    {
+        early_response(m_http_connection, 429);
+        return 0;
+    }
+
+    // the worker is shedding load, the status of it is still answered
+    thread::worker *worker_ptr = thread::worker::current();
+    if (worker_ptr && worker_ptr->get_codel().get_overloaded())
+    {
+        std::string_view path = m_http_connection.request.url;
+        path = path.substr(0, path.find('?'));
+        if (path != utility::singleton<server::server>::instance()->get_overload_status_path())
+        {
+            worker_ptr->get_codel().on_shed();
+            early_response(m_http_connection, 503);
+            return 0;
+        }
+    }
+
+    // proxied prefixes go before uploads, request and response are relayed as they arrive
+    http_proxy *proxy = utility::singleton<http_proxy>::instance();
+    if (proxy->get_enable())
+    {
+        std::string_view path = m_http_connection.request.url;
+        path = path.substr(0, path.find('?'));
+        http_proxy::upstream_group *group = proxy->match(path);
+        if (group)
+        {
+            auto response_ptr = new (std::nothrow) http_app_reponse;
+            if (!response_ptr)
+            {
+                return -1;
+            }
+            m_http_connection.ptr = response_ptr;
+            m_http_connection.destory_callback = response_destory_callback;
+            http_proxy_session *session = new (std::nothrow) http_proxy_session(*proxy->choose(*group));
+            if (!session)
+            {
+                return -1;
+            }
+            response_ptr->ptr_type = http_app_reponse::PROXY;
+            response_ptr->ptr = session;
+            session->start(m_http_connection);
+            return 0;
+        }
+    }
+
+    server::server *server_ptr = utility::singleton<server::server>::instance();
+    const string &upload_dir = server_ptr->get_http_upload_dir();
+    if (upload_dir.empty() || m_http_connection.request.method != "PUT")
+    {
+        return 0;
+    }
+
+    std::string_view url_view = m_http_connection.request.url;
+    url_view = url_view.substr(0, url_view.find('?'));
+    string url = utility::url::decode(string(url_view));
+    if (url.empty() || url.back() == '/' || string::npos != url.find(".."))
+    {
+        early_response(m_http_connection, 400);
+        return 0;
+    }
+
+    http_parser *parser = m_http_connection.get_parser();
+    const uint64_t max_size = server_ptr->get_http_upload_max_size();
+    const bool chunked = parser->flags & F_CHUNKED;
+    if (max_size > 0 && !chunked && parser->content_length != ULLONG_MAX && parser->content_length > max_size)
     {
-        if (m_connection.ptr)
+        early_response(m_http_connection, 413);
+        return 0;
+    }
+
+    auto response_ptr = new (std::nothrow) http_app_reponse;
+    if (!response_ptr)
+    {
+        return -1;
+    }
+    m_http_connection.ptr = response_ptr;
+    m_http_connection.destory_callback = response_destory_callback;
+    http_upload_sink *sink = new (std::nothrow) http_upload_sink;
+    if (!sink)
+    {
+        return -1;
+    }
+    response_ptr->ptr_type = http_app_reponse::UPLOAD;
+    response_ptr->ptr = sink;
+    if (!sink->open(upload_dir + url, max_size, m_http_connection.get_gid()))
+    {
+        early_response(m_http_connection, 403);
+        return 0;
+    }
+
+    m_http_connection.body_callback = [sink](http_connection &connection, const char *data, size_t len) -> int
+    {
+        int iret = sink->write(data, len);
+        if (-2 == iret)
+        {
+            early_response(connection, 413);
+        }
+        else if (0 != iret)
         {
-            http_app_reponse *reponse_ptr = (http_app_reponse *)m_connection.ptr;
-            reponse_ptr->destory();
-            delete reponse_ptr;
-            m_connection.ptr = nullptr;
+            early_response(connection, 500);
         }
+        return 0;
     };
+    // Content-Length body bypass user space
+    m_http_connection.set_body_splice(sink->get_fd());
+    return 0;
+}
+
+/**
+ * @brief upload body is received, move it to the target
+ *
+ * @param connection
+ */
+static void upload_process(http_connection &connection)
+{
+    http_upload_sink *sink = (http_upload_sink *)((http_app_reponse *)connection.ptr)->ptr;
+    const bool replaced = sink->get_replaced();
+    if (sink->commit())
+    {
+        if (replaced)
+        {
+            connection.response.set_status(204).commit();
+        }
+        else
+        {
+            connection.response.set_status(201).set_content_length(0).commit();
+        }
+    }
+    else
+    {
+        connection.response.set_status(500).set_content_length(0).commit();
+    }
+    connection.set_response_end(true);
+}
+
+void http_app::process_connection(tubekit::connection::http_connection &m_http_connection)
+{
+    // load callback
+    m_http_connection.destory_callback = response_destory_callback;
 
     m_http_connection.process_callback = [](http_connection &connection) -> void
     {
-        string url = utility::url::decode(connection.url);
+        if (connection.ptr && ((http_app_reponse *)connection.ptr)->ptr_type == http_app_reponse::UPLOAD)
+        {
+            upload_process(connection);
+            return;
+        }
+        if (connection.ptr && ((http_app_reponse *)connection.ptr)->ptr_type == http_app_reponse::PROXY)
+        {
+            // response is relayed by write_end_callback and upstream events
+            ((http_proxy_session *)((http_app_reponse *)connection.ptr)->ptr)->on_request_end(connection);
+            return;
+        }
+
+        // routes go before static files
+        std::string_view path = connection.request.url;
+        path = path.substr(0, path.find('?'));
+        http_router::params params;
+        const http_router::handler *route_handler = utility::singleton<http_router>::instance()->find(connection.request.method, path, params);
+        if (route_handler)
+        {
+            (*route_handler)(connection, params);
+            return;
+        }
+
+        string url = utility::url::decode(string(connection.request.url));
         auto find_res = url.find("..");
         if (std::string::npos != find_res)
         {
@@ -154,89 +469,185 @@ void http_app::process_connection(tubekit::connection::http_connection &m_http_c
             }
             connection.ptr = response_ptr;
             response_ptr->ptr_type = http_app_reponse::FD;
+            http_app_file *file = new (std::nothrow) http_app_file;
+            response_ptr->ptr = file;
+            if (!file)
+            {
+                connection.set_response_end(true);
+                return;
+            }
+
+            file->fd = ::open(t_path.c_str(), O_RDONLY);
+            struct stat file_stat;
+            if (file->fd < 0 || 0 != ::fstat(file->fd, &file_stat))
+            {
+                connection.set_response_end(true);
+                return;
+            }
+            file->size = file_stat.st_size;
 
-            std::string mime_type;
             try
             {
-                mime_type = utility::mime_type::get_type(t_path.string());
+                file->content_type = utility::mime_type::get_type(t_path.string());
             }
             catch (...)
             {
-                mime_type = "application/octet-stream";
+                file->content_type = "application/octet-stream";
             }
-            std::string response = "HTTP/1.1 200 OK\r\nServer: tubekit\r\n";
-            response += "Content-Type: ";
-            response += mime_type + "\r\n\r\n";
-            try
+
+            char etag[64]{0};
+            snprintf(etag, sizeof(etag), "\"%lx-%lx\"", (unsigned long)file_stat.st_mtime, (unsigned long)file_stat.st_size);
+            const string last_modified = utility::time::time::http_date(file_stat.st_mtime);
+
+            // Range is honored only when If-Range is absent or matches the current representation
+            std::string_view range_value = connection.request.get_header("Range");
+            std::string_view if_range_value = connection.request.get_header("If-Range");
+            if (range_value.data() && if_range_value.data() && if_range_value != etag && if_range_value != last_modified)
             {
-                connection.m_send_buffer.write(response.c_str(), response.size());
+                range_value = std::string_view();
             }
-            catch (const std::runtime_error &e)
+
+            utility::http_range::parse_result range_res = utility::http_range::IGNORE;
+            if (range_value.data() && (connection.request.method == "GET" || connection.request.method == "HEAD"))
             {
-                LOG_ERROR(e.what());
+                range_res = utility::http_range::parse(range_value, file->size, max_ranges, file->ranges);
             }
 
-            response_ptr->ptr = ::fopen(t_path.c_str(), "r");
-            if (response_ptr->ptr == nullptr)
+            http_response &response = connection.response;
+            char content_range[96]{0};
+            if (range_res == utility::http_range::NOT_SATISFIABLE)
             {
+                // ranges are checked against the identity length, nothing is compressed for it
+                snprintf(content_range, sizeof(content_range), "bytes */%llu", (unsigned long long)file->size);
+                response.set_status(416).add_header(http_response::CONTENT_RANGE, content_range).set_content_length(0).commit();
                 connection.set_response_end(true);
                 return;
             }
-            // Write when the contents of the buffer have been sent write_end_callback will be executed,
-            // and the response must be set response_end to true, then write after write_end_callback will be continuously recalled
-            connection.write_end_callback = [](http_connection &m_connection) -> void
+
+            // compressed variant, only when the whole representation is sent
+            http_compress *compress = utility::singleton<http_compress>::instance();
+            const bool compressible = compress->compressible(file->content_type, file->size);
+            http_compress::encoding encoding = http_compress::IDENTITY;
+            if (compressible && range_res == utility::http_range::IGNORE)
+            {
+                encoding = http_compress::choose(connection.request.get_header("Accept-Encoding"));
+            }
+            if (encoding == http_compress::GZIP)
             {
-                constexpr int buffer_size = 102400;
-                char buf[buffer_size] = {0};
-                int len = 0;
-                len = ::fread(buf, sizeof(char), buffer_size, (http_app_reponse::FD_TYPE *)((http_app_reponse *)m_connection.ptr)->ptr);
-                if (len > 0)
+                // precompressed sibling, used when not older than the file
+                string gz_path = t_path.string() + ".gz";
+                int gz_fd = ::open(gz_path.c_str(), O_RDONLY);
+                struct stat gz_stat;
+                if (gz_fd >= 0 && 0 == ::fstat(gz_fd, &gz_stat) && S_ISREG(gz_stat.st_mode) && gz_stat.st_mtime >= file_stat.st_mtime)
                 {
-                    try
-                    {
-                        m_connection.m_send_buffer.write(buf, len);
-                    }
-                    catch (const std::runtime_error &e)
+                    ::close(file->fd);
+                    file->fd = gz_fd;
+                    file->size = gz_stat.st_size;
+                }
+                else
+                {
+                    if (gz_fd >= 0)
                     {
-                        LOG_ERROR(e.what());
+                        ::close(gz_fd);
                     }
+                    gz_fd = -1;
+                    file->memory_body = compress->get_file(t_path.string(), file_stat, encoding);
                 }
-                else
+                if (gz_fd < 0 && !file->memory_body)
                 {
-                    m_connection.set_response_end(true);
+                    encoding = http_compress::IDENTITY;
                 }
-            };
-            connection.write_end_callback(connection);
-            return;
-        }
-        else if (fs::exists(t_path) && fs::is_directory(t_path))
-        {
-            auto response_ptr = new (std::nothrow) http_app_reponse;
-            if (!response_ptr)
+            }
+            else if (encoding == http_compress::DEFLATE)
             {
-                connection.set_response_end(true);
-                return;
+                file->memory_body = compress->get_file(t_path.string(), file_stat, encoding);
+                if (!file->memory_body)
+                {
+                    encoding = http_compress::IDENTITY;
+                }
             }
-            connection.ptr = response_ptr;
-            response_ptr->ptr_type = http_app_reponse::DIR;
-            response_ptr->ptr = new (std::nothrow) http_app_reponse::DIR_TYPE;
-            if (!response_ptr->ptr)
+            if (file->memory_body)
             {
-                connection.set_response_end(true);
-                return;
+                file->size = file->memory_body->size();
+            }
+            if (encoding != http_compress::IDENTITY)
+            {
+                // strong validators must differ between representations
+                etag[strlen(etag) - 1] = 0;
+                strncat(etag, encoding == http_compress::GZIP ? "-gzip\"" : "-deflate\"", sizeof(etag) - strlen(etag) - 1);
             }
-            auto dir_type_ptr = (http_app_reponse::DIR_TYPE *)response_ptr->ptr;
 
-            const char *response_head = "HTTP/1.1 200 OK\r\nServer: tubekit\r\nContent-Type: text/html; charset=UTF-8\r\n\r\n";
-            try
+            if (range_res == utility::http_range::OK)
+            {
+                response.set_status(206);
+                if (file->ranges.size() == 1)
+                {
+                    const auto &range = file->ranges[0];
+                    snprintf(content_range, sizeof(content_range), "bytes %llu-%llu/%llu", (unsigned long long)range.first, (unsigned long long)range.second, (unsigned long long)file->size);
+                    response.add_header(http_response::CONTENT_TYPE, file->content_type);
+                    response.add_header(http_response::CONTENT_RANGE, content_range);
+                }
+                else
+                {
+                    file->boundary = "tubekit_byteranges_" + std::to_string(connection.get_gid());
+                    response.add_header(http_response::CONTENT_TYPE, "multipart/byteranges; boundary=" + file->boundary);
+                }
+            }
+            else
+            {
+                file->ranges.clear();
+                if (file->size > 0)
+                {
+                    file->ranges.push_back({0, file->size - 1});
+                }
+                response.set_status(200).add_header(http_response::CONTENT_TYPE, file->content_type);
+            }
+            if (encoding != http_compress::IDENTITY)
+            {
+                response.add_header(http_response::CONTENT_ENCODING, http_compress::encoding_name(encoding));
+            }
+            else
             {
-                connection.m_send_buffer.write(response_head, strlen(response_head));
+                response.add_header(http_response::ACCEPT_RANGES, "bytes");
             }
-            catch (const std::runtime_error &e)
+            if (compressible)
             {
-                LOG_ERROR(e.what());
+                response.add_header(http_response::VARY, "Accept-Encoding");
             }
+            response.add_header(http_response::ETAG, etag);
+            response.add_header(http_response::LAST_MODIFIED, last_modified);
+            response.set_content_length(file->content_length());
 
+            // body parts are sent in order after head, file ranges by sendfile when possible
+            if (connection.request.method != "HEAD")
+            {
+                for (const auto &range : file->ranges)
+                {
+                    const uint64_t range_len = range.second - range.first + 1;
+                    if (!file->boundary.empty())
+                    {
+                        response.add_body(file->part_head(range));
+                    }
+                    if (file->memory_body)
+                    {
+                        response.add_body(file->memory_body, range.first, range_len);
+                    }
+                    else
+                    {
+                        response.add_file(file->fd, range.first, range_len);
+                    }
+                }
+                if (!file->boundary.empty())
+                {
+                    response.add_body(file->tail());
+                }
+            }
+            response.commit();
+            connection.set_response_end(true);
+            return;
+        }
+        else if (fs::exists(t_path) && fs::is_directory(t_path))
+        {
             //  generate dir list
             vector<string> a_tags;
             try
@@ -257,50 +668,34 @@ void http_app::process_connection(tubekit::connection::http_connection &m_http_c
             {
                 body += a_tag;
             }
-            std::get<0>(*dir_type_ptr) = html_loader::load(body);
-            std::get<1>(*dir_type_ptr) = 0;
+            body = html_loader::load(body);
 
-            connection.write_end_callback = [](http_connection &m_connection) -> void
+            http_response &response = connection.response;
+            response.set_status(200).add_header(http_response::CONTENT_TYPE, "text/html; charset=UTF-8");
+            http_compress *compress = utility::singleton<http_compress>::instance();
+            if (compress->compressible("text/html", body.size()))
             {
-                http_app_reponse *response_ptr = (http_app_reponse *)m_connection.ptr;
-                auto dir_type_ptr = (http_app_reponse::DIR_TYPE *)response_ptr->ptr;
-                const char *buffer_ptr = std::get<0>(*dir_type_ptr).c_str();
-                const size_t buffer_size = std::get<0>(*dir_type_ptr).size();
-                size_t &already_size = std::get<1>(*dir_type_ptr);
-
-                if (buffer_size > already_size)
+                http_compress::encoding encoding = http_compress::choose(connection.request.get_header("Accept-Encoding"));
+                string compressed;
+                if (encoding != http_compress::IDENTITY && http_compress::compress(body.data(), body.size(), encoding, compressed))
                 {
-                    try
-                    {
-                        size_t need_send = buffer_size - already_size;
-                        need_send = need_send > 102400 ? 102400 : need_send;
-                        m_connection.m_send_buffer.write(buffer_ptr, need_send);
-                        already_size += need_send;
-                    }
-                    catch (const std::runtime_error &e)
-                    {
-                        LOG_ERROR(e.what());
-                    }
+                    body = std::move(compressed);
+                    response.add_header(http_response::CONTENT_ENCODING, http_compress::encoding_name(encoding));
                 }
-                else
-                {
-                    m_connection.set_response_end(true);
-                }
-            };
-            connection.write_end_callback(connection);
+                response.add_header(http_response::VARY, "Accept-Encoding");
+            }
+            response.set_content_length(body.size());
+            if (connection.request.method != "HEAD")
+            {
+                response.add_body(std::move(body));
+            }
+            response.commit();
+            connection.set_response_end(true);
             return;
         }
         else
         {
-            const char *response = "HTTP/1.1 404 Not Found\r\nServer: tubekit\r\nContent-Type: text/text; charset=UTF-8\r\n\r\n";
-            try
-            {
-                connection.m_send_buffer.write(response, strlen(response));
-            }
-            catch (const std::runtime_error &e)
-            {
-                LOG_ERROR(e.what());
-            }
+            connection.response.set_status(404).add_header(http_response::CONTENT_TYPE, "text/text; charset=UTF-8").set_content_length(0).commit();
             connection.set_response_end(true);
         }
     };
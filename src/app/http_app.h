@@ -26,6 +26,14 @@ namespace tubekit
              */
             static int on_body(tubekit::connection::http_connection &m_http_connection);
 
+            /**
+             * @brief thread not safe, request line and headers are ready, set body_callback here to stream the body
+             *
+             * @param m_http_connection
+             * @return int 0 continue, -1 reject the request
+             */
+            static int on_headers_complete(tubekit::connection::http_connection &m_http_connection);
+
             /**
              * @brief thread safe
              *
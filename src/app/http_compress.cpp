@@ -0,0 +1,304 @@
+#include "app/http_compress.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <strings.h>
+#include <zlib/zlib.h>
+#include <tubekit-log/logger.h>
+
+#include "thread/auto_lock.h"
+
+using tubekit::app::http_compress;
+using tubekit::thread::auto_lock;
+
+static const char *default_types = "text/html,text/css,text/plain,text/xml,text/javascript,"
+                                   "application/javascript,application/json,application/xml,image/svg+xml";
+
+static inline std::string trim(const std::string &str)
+{
+    size_t begin = str.find_first_not_of(" \t");
+    if (begin == std::string::npos)
+    {
+        return "";
+    }
+    size_t end = str.find_last_not_of(" \t");
+    return str.substr(begin, end - begin + 1);
+}
+
+http_compress::http_compress()
+{
+}
+
+http_compress::~http_compress()
+{
+}
+
+int http_compress::init(bool enable, size_t min_length, const std::string &types, size_t cache_size)
+{
+    m_enable = enable;
+    m_min_length = min_length;
+    m_cache_size = cache_size;
+    m_types.clear();
+
+    std::string all_types = types.empty() ? default_types : types;
+    size_t pos = 0;
+    while (pos <= all_types.size())
+    {
+        size_t comma = all_types.find(',', pos);
+        if (comma == std::string::npos)
+        {
+            comma = all_types.size();
+        }
+        std::string type = trim(all_types.substr(pos, comma - pos));
+        if (!type.empty())
+        {
+            m_types.push_back(type);
+        }
+        pos = comma + 1;
+    }
+    return 0;
+}
+
+bool http_compress::get_enable() const
+{
+    return m_enable;
+}
+
+bool http_compress::compressible(const std::string &mime_type, uint64_t size) const
+{
+    if (!m_enable || size < m_min_length)
+    {
+        return false;
+    }
+    // "text/html; charset=utf-8;" -> "text/html"
+    std::string type = trim(mime_type.substr(0, mime_type.find(';')));
+    for (const auto &allow : m_types)
+    {
+        if (allow.size() >= 2 && allow.compare(allow.size() - 2, 2, "/*") == 0)
+        {
+            if (type.size() > allow.size() - 1 && 0 == strncasecmp(type.c_str(), allow.c_str(), allow.size() - 1))
+            {
+                return true;
+            }
+        }
+        else if (0 == strcasecmp(type.c_str(), allow.c_str()))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64_t http_compress::get_max_file_size() const
+{
+    // a single variant may take at most a quarter of the cache
+    return m_cache_size / 4;
+}
+
+std::shared_ptr<const std::string> http_compress::get_file(const std::string &path, const struct stat &file_stat, encoding enc)
+{
+    if (enc == IDENTITY || (uint64_t)file_stat.st_size > get_max_file_size())
+    {
+        return nullptr;
+    }
+
+    std::string key = path;
+    key.push_back('\n');
+    key += encoding_name(enc);
+
+    {
+        auto_lock lock(m_mutex);
+        auto iter = m_cache.find(key);
+        if (iter != m_cache.end())
+        {
+            auto entry_iter = iter->second;
+            if (entry_iter->mtime == file_stat.st_mtime && entry_iter->size == file_stat.st_size)
+            {
+                m_lru.splice(m_lru.begin(), m_lru, entry_iter);
+                return entry_iter->data;
+            }
+            // stale
+            m_cache_used -= entry_iter->data->size();
+            m_lru.erase(entry_iter);
+            m_cache.erase(iter);
+        }
+    }
+
+    // compress outside the lock, a racing miss on the same file only costs a duplicate compression
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+    std::string content;
+    content.resize(file_stat.st_size);
+    size_t readed = 0;
+    while (readed < content.size())
+    {
+        ssize_t len = ::pread(fd, &content[readed], content.size() - readed, readed);
+        if (len <= 0)
+        {
+            break;
+        }
+        readed += len;
+    }
+    ::close(fd);
+    if (readed != content.size())
+    {
+        LOG_ERROR("http_compress read %s failed", path.c_str());
+        return nullptr;
+    }
+
+    auto compressed = std::make_shared<std::string>();
+    if (!compress(content.data(), content.size(), enc, *compressed))
+    {
+        return nullptr;
+    }
+
+    cache_entry entry;
+    entry.key = std::move(key);
+    entry.mtime = file_stat.st_mtime;
+    entry.size = file_stat.st_size;
+    entry.data = compressed;
+    cache_insert(std::move(entry));
+    return compressed;
+}
+
+void http_compress::cache_insert(cache_entry &&entry)
+{
+    auto_lock lock(m_mutex);
+    size_t entry_size = entry.data->size();
+    if (entry_size > m_cache_size)
+    {
+        return;
+    }
+    auto iter = m_cache.find(entry.key);
+    if (iter != m_cache.end())
+    {
+        m_cache_used -= iter->second->data->size();
+        m_lru.erase(iter->second);
+        m_cache.erase(iter);
+    }
+    while (!m_lru.empty() && m_cache_used + entry_size > m_cache_size)
+    {
+        m_cache_used -= m_lru.back().data->size();
+        m_cache.erase(m_lru.back().key);
+        m_lru.pop_back();
+    }
+    m_lru.push_front(std::move(entry));
+    m_cache[m_lru.front().key] = m_lru.begin();
+    m_cache_used += entry_size;
+}
+
+http_compress::encoding http_compress::choose(std::string_view accept_encoding)
+{
+    if (accept_encoding.data() == nullptr)
+    {
+        return IDENTITY;
+    }
+    double gzip_q = 0.0, deflate_q = 0.0;
+    // '*' is the q of codings not named, a named q=0 stays refused
+    bool gzip_named = false, deflate_named = false;
+    double any_q = 0.0;
+    size_t pos = 0;
+    const std::string_view &value = accept_encoding;
+    while (pos <= value.size())
+    {
+        size_t comma = value.find(',', pos);
+        if (comma == std::string_view::npos)
+        {
+            comma = value.size();
+        }
+        std::string item(value.substr(pos, comma - pos));
+        pos = comma + 1;
+
+        double q = 1.0;
+        size_t semicolon = item.find(';');
+        if (semicolon != std::string::npos)
+        {
+            std::string param = trim(item.substr(semicolon + 1));
+            if (param.size() > 2 && (param[0] == 'q' || param[0] == 'Q') && param[1] == '=')
+            {
+                q = atof(param.c_str() + 2);
+            }
+            item = item.substr(0, semicolon);
+        }
+        item = trim(item);
+        if (0 == strcasecmp(item.c_str(), "gzip") || 0 == strcasecmp(item.c_str(), "x-gzip"))
+        {
+            gzip_q = gzip_named && gzip_q > q ? gzip_q : q;
+            gzip_named = true;
+        }
+        else if (0 == strcasecmp(item.c_str(), "deflate"))
+        {
+            deflate_q = q;
+            deflate_named = true;
+        }
+        else if (item == "*")
+        {
+            any_q = q;
+        }
+    }
+    if (!gzip_named)
+    {
+        gzip_q = any_q;
+    }
+    if (!deflate_named)
+    {
+        deflate_q = any_q;
+    }
+    if (gzip_q > 0.0 && gzip_q >= deflate_q)
+    {
+        return GZIP;
+    }
+    if (deflate_q > 0.0)
+    {
+        return DEFLATE;
+    }
+    return IDENTITY;
+}
+
+const char *http_compress::encoding_name(encoding enc)
+{
+    switch (enc)
+    {
+    case GZIP:
+        return "gzip";
+    case DEFLATE:
+        return "deflate";
+    default:
+        return "identity";
+    }
+}
+
+bool http_compress::compress(const char *data, size_t len, encoding enc, std::string &out)
+{
+    if (enc == IDENTITY)
+    {
+        return false;
+    }
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    // windowBits 15, +16 for gzip header and trailer
+    int window_bits = enc == GZIP ? 15 + 16 : 15;
+    if (Z_OK != deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, window_bits, 8, Z_DEFAULT_STRATEGY))
+    {
+        LOG_ERROR("deflateInit2 failed");
+        return false;
+    }
+    out.resize(deflateBound(&stream, len));
+    stream.next_in = (Bytef *)data;
+    stream.avail_in = len;
+    stream.next_out = (Bytef *)&out[0];
+    stream.avail_out = out.size();
+    int ret = deflate(&stream, Z_FINISH);
+    deflateEnd(&stream);
+    if (ret != Z_STREAM_END)
+    {
+        LOG_ERROR("deflate return %d", ret);
+        out.clear();
+        return false;
+    }
+    out.resize(stream.total_out);
+    return true;
+}
@@ -0,0 +1,117 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <sys/stat.h>
+
+#include "thread/mutex.h"
+
+namespace tubekit::app
+{
+    /**
+     * @brief Accept-Encoding aware compression for http_app, keeps compressed variants of hot files in memory
+     *
+     */
+    class http_compress
+    {
+    public:
+        enum encoding
+        {
+            IDENTITY = 0,
+            GZIP,
+            DEFLATE
+        };
+
+    public:
+        http_compress();
+        ~http_compress();
+
+        /**
+         * @brief thread safe, called once in http_app::on_init
+         *
+         * @param enable
+         * @param min_length smaller bodies are sent as is
+         * @param types comma separated mime types, a type ending with slash star matches the top-level type, empty use default list
+         * @param cache_size max bytes of compressed variants in memory
+         * @return int
+         */
+        int init(bool enable, size_t min_length, const std::string &types, size_t cache_size);
+
+        bool get_enable() const;
+
+        /**
+         * @brief whether the body of mime_type and size should be compressed
+         *
+         * @param mime_type value of Content-Type
+         * @param size
+         * @return true
+         * @return false
+         */
+        bool compressible(const std::string &mime_type, uint64_t size) const;
+
+        /**
+         * @brief the biggest file which will be compressed in memory
+         *
+         * @return uint64_t
+         */
+        uint64_t get_max_file_size() const;
+
+        /**
+         * @brief thread safe, compressed file content from cache, compressing and caching it when missed
+         *
+         * @param path
+         * @param file_stat stat of path, used to validate cached variant
+         * @param enc GZIP or DEFLATE
+         * @return std::shared_ptr<const std::string> nullptr when failed
+         */
+        std::shared_ptr<const std::string> get_file(const std::string &path, const struct stat &file_stat, encoding enc);
+
+    public:
+        /**
+         * @brief choose content-coding by Accept-Encoding value, gzip is preferred
+         *
+         * @param accept_encoding data() is nullptr when header not exist
+         * @return encoding
+         */
+        static encoding choose(std::string_view accept_encoding);
+
+        static const char *encoding_name(encoding enc);
+
+        /**
+         * @brief compress data with zlib in gzip (RFC 1952) or zlib (RFC 1950) format
+         *
+         * @param data
+         * @param len
+         * @param enc
+         * @param out
+         * @return true
+         * @return false
+         */
+        static bool compress(const char *data, size_t len, encoding enc, std::string &out);
+
+    private:
+        struct cache_entry
+        {
+            std::string key{};
+            time_t mtime{0};
+            off_t size{0};
+            std::shared_ptr<const std::string> data{nullptr};
+        };
+
+        void cache_insert(cache_entry &&entry);
+
+    private:
+        bool m_enable{false};
+        size_t m_min_length{0};
+        size_t m_cache_size{0};
+        std::vector<std::string> m_types{};
+
+        tubekit::thread::mutex m_mutex;
+        std::list<cache_entry> m_lru{}; // front is the most recently used
+        std::unordered_map<std::string, std::list<cache_entry>::iterator> m_cache{};
+        size_t m_cache_used{0};
+    };
+}
@@ -0,0 +1,795 @@
+#include <cstring>
+#include <strings.h>
+#include <cerrno>
+#include <cstdio>
+#include <climits>
+#include <algorithm>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <tubekit-log/logger.h>
+
+#include "app/http_proxy.h"
+#include "thread/auto_lock.h"
+#include "utility/singleton.h"
+#include "utility/object_pool.h"
+#include "socket/socket_handler.h"
+#include "server/server.h"
+
+using tubekit::app::http_proxy;
+using tubekit::app::http_proxy_session;
+using tubekit::connection::http_connection;
+using tubekit::connection::http_response;
+using tubekit::socket::socket_handler;
+using tubekit::thread::auto_lock;
+using tubekit::utility::object_pool;
+using tubekit::utility::singleton;
+
+// request bytes waiting for upstream, client body is paused above high and resumed below low
+static constexpr size_t out_high_water = 262144;
+static constexpr size_t out_low_water = 65536;
+// response bytes waiting for client, upstream is not read above it
+static constexpr size_t client_high_water = 262144;
+
+static bool equals_lower(std::string_view text, std::string_view lower)
+{
+    if (text.size() != lower.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        char c = text[i];
+        if (c >= 'A' && c <= 'Z')
+        {
+            c = c - 'A' + 'a';
+        }
+        if (c != lower[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// headers of one hop, not forwarded in either direction
+static bool hop_by_hop(std::string_view key)
+{
+    static constexpr std::string_view names[] = {"connection", "keep-alive", "proxy-connection", "transfer-encoding", "te", "trailer", "upgrade"};
+    for (std::string_view name : names)
+    {
+        if (equals_lower(key, name))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// whether key is listed in the value of Connection
+static bool connection_listed(std::string_view connection_value, std::string_view key)
+{
+    while (!connection_value.empty())
+    {
+        size_t comma = connection_value.find(',');
+        std::string_view token = connection_value.substr(0, comma);
+        connection_value = comma == std::string_view::npos ? std::string_view() : connection_value.substr(comma + 1);
+        while (!token.empty() && (token.front() == ' ' || token.front() == '\t'))
+        {
+            token.remove_prefix(1);
+        }
+        while (!token.empty() && (token.back() == ' ' || token.back() == '\t'))
+        {
+            token.remove_suffix(1);
+        }
+        if (token.size() == key.size() && 0 == strncasecmp(token.data(), key.data(), key.size()))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static std::string_view trim(std::string_view text)
+{
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+    {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t'))
+    {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+http_proxy::http_proxy()
+{
+}
+
+http_proxy::~http_proxy()
+{
+}
+
+int http_proxy::init(const std::string &pass, const std::string &balance_name, size_t keepalive)
+{
+    m_groups.clear();
+    m_enable = false;
+    m_balance = balance_name == "least_conn" ? LEAST_CONN : ROUND_ROBIN;
+    m_keepalive = keepalive;
+
+    std::string_view rest = pass;
+    while (!rest.empty())
+    {
+        size_t semicolon = rest.find(';');
+        std::string_view entry = trim(rest.substr(0, semicolon));
+        rest = semicolon == std::string_view::npos ? std::string_view() : rest.substr(semicolon + 1);
+        if (entry.empty())
+        {
+            continue;
+        }
+        size_t equal = entry.find('=');
+        if (equal == std::string_view::npos || equal == 0 || entry[0] != '/')
+        {
+            LOG_ERROR("http_proxy_pass invalid entry %s", std::string(entry).c_str());
+            return -1;
+        }
+        auto group = std::make_unique<upstream_group>();
+        group->prefix = std::string(trim(entry.substr(0, equal)));
+        std::string_view servers = entry.substr(equal + 1);
+        while (!servers.empty())
+        {
+            size_t comma = servers.find(',');
+            std::string_view address = trim(servers.substr(0, comma));
+            servers = comma == std::string_view::npos ? std::string_view() : servers.substr(comma + 1);
+            if (address.empty())
+            {
+                continue;
+            }
+            size_t colon = address.rfind(':');
+            std::string_view host = colon == std::string_view::npos ? std::string_view() : address.substr(0, colon);
+            if (host.size() >= 2 && host.front() == '[' && host.back() == ']')
+            {
+                host = host.substr(1, host.size() - 2);
+            }
+            const int port = colon == std::string_view::npos ? 0 : atoi(std::string(address.substr(colon + 1)).c_str());
+            if (host.empty() || port <= 0 || port > 65535)
+            {
+                LOG_ERROR("http_proxy_pass invalid upstream %s", std::string(address).c_str());
+                return -1;
+            }
+            auto server = std::make_unique<upstream_server>();
+            server->ip = std::string(host);
+            server->port = port;
+            group->servers.push_back(std::move(server));
+        }
+        if (group->servers.empty())
+        {
+            LOG_ERROR("http_proxy_pass %s has no upstream", group->prefix.c_str());
+            return -1;
+        }
+        m_groups.push_back(std::move(group));
+    }
+
+    std::stable_sort(m_groups.begin(), m_groups.end(), [](const std::unique_ptr<upstream_group> &a, const std::unique_ptr<upstream_group> &b)
+                     { return a->prefix.size() > b->prefix.size(); });
+    m_enable = !m_groups.empty();
+    return 0;
+}
+
+bool http_proxy::get_enable() const
+{
+    return m_enable;
+}
+
+http_proxy::upstream_group *http_proxy::match(std::string_view path)
+{
+    for (auto &group : m_groups)
+    {
+        if (0 == path.compare(0, group->prefix.size(), group->prefix))
+        {
+            return group.get();
+        }
+    }
+    return nullptr;
+}
+
+http_proxy::upstream_server *http_proxy::choose(upstream_group &group)
+{
+    const size_t count = group.servers.size();
+    const size_t start = group.next.fetch_add(1, std::memory_order_relaxed);
+    if (m_balance == ROUND_ROBIN || count == 1)
+    {
+        return group.servers[start % count].get();
+    }
+    // least connections, ties are rotated
+    upstream_server *best = nullptr;
+    size_t best_active = SIZE_MAX;
+    for (size_t i = 0; i < count; i++)
+    {
+        upstream_server *server = group.servers[(start + i) % count].get();
+        const size_t active = server->active.load(std::memory_order_relaxed);
+        if (active < best_active)
+        {
+            best = server;
+            best_active = active;
+        }
+    }
+    return best;
+}
+
+tubekit::socket::socket *http_proxy::acquire(upstream_server &server)
+{
+    while (true)
+    {
+        tubekit::socket::socket *socket_ptr = nullptr;
+        {
+            auto_lock lock(server.mutex);
+            if (server.idle.empty())
+            {
+                return nullptr;
+            }
+            socket_ptr = server.idle.back();
+            server.idle.pop_back();
+        }
+        // an idle connection has nothing to read, EOF or bytes mean it can not be used
+        char peek = 0;
+        ssize_t peeked = ::recv(socket_ptr->get_fd(), &peek, 1, MSG_PEEK | MSG_DONTWAIT);
+        if (peeked < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            return socket_ptr;
+        }
+        singleton<socket_handler>::instance()->push_wait_remove(socket_ptr);
+    }
+}
+
+void http_proxy::release(upstream_server &server, tubekit::socket::socket *socket_ptr, bool keep_alive)
+{
+    socket_handler *handler = singleton<socket_handler>::instance();
+    handler->detach(socket_ptr);
+    socket_ptr->set_gid(0);
+    if (keep_alive && m_keepalive > 0)
+    {
+        auto_lock lock(server.mutex);
+        if (server.idle.size() < m_keepalive)
+        {
+            server.idle.push_back(socket_ptr);
+            return;
+        }
+    }
+    if (socket_ptr->get_fd() <= 0)
+    {
+        // never opened, remove would not take it back
+        socket_ptr->close();
+        singleton<object_pool<tubekit::socket::socket>>::instance()->release(socket_ptr);
+        return;
+    }
+    handler->push_wait_remove(socket_ptr);
+}
+
+http_proxy_session::http_proxy_session(http_proxy::upstream_server &server) : m_server(server)
+{
+    m_server.active.fetch_add(1, std::memory_order_relaxed);
+    http_parser_init(&m_parser, HTTP_RESPONSE);
+    m_parser.data = this;
+}
+
+http_proxy_session::~http_proxy_session()
+{
+    close_upstream(false);
+    m_server.active.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool http_proxy_session::connect_upstream(bool allow_pooled)
+{
+    m_reused = false;
+    m_connecting = false;
+    if (allow_pooled)
+    {
+        m_upstream = singleton<http_proxy>::instance()->acquire(m_server);
+        m_reused = m_upstream != nullptr;
+    }
+    if (!m_upstream)
+    {
+        m_upstream = singleton<socket_handler>::instance()->alloc_socket();
+        if (!m_upstream)
+        {
+            LOG_ERROR("http_proxy alloc_socket failed");
+            return false;
+        }
+        int iret = m_upstream->connect_non_blocking(m_server.ip, m_server.port);
+        if (iret < 0)
+        {
+            close_upstream(false);
+            return false;
+        }
+        m_connecting = iret == 1;
+    }
+    m_upstream->set_gid(m_connection->get_gid());
+    m_upstream->set_upstream(true);
+    return true;
+}
+
+void http_proxy_session::close_upstream(bool keep_alive)
+{
+    if (m_upstream)
+    {
+        singleton<http_proxy>::instance()->release(m_server, m_upstream, keep_alive);
+        m_upstream = nullptr;
+    }
+}
+
+bool http_proxy_session::retry()
+{
+    if (!m_reused || m_response_started || m_out_trimmed)
+    {
+        return false;
+    }
+    close_upstream(false);
+    m_out_sent = 0;
+    return connect_upstream(false);
+}
+
+bool http_proxy_session::start(http_connection &connection)
+{
+    m_connection = &connection;
+    const tubekit::connection::http_request &request = connection.request;
+    http_parser *client_parser = connection.get_parser();
+    m_head_request = request.method == "HEAD";
+    const bool has_length = client_parser->content_length != ULLONG_MAX;
+    if (connection.framed)
+    {
+        // HTTP/2 DATA frames without content-length are sent chunked
+        m_request_chunked = !has_length && request.method != "GET" && !m_head_request;
+    }
+    else
+    {
+        m_request_chunked = client_parser->flags & F_CHUNKED;
+    }
+
+    m_out.reserve(1024);
+    m_out.append(request.method);
+    m_out.push_back(' ');
+    m_out.append(request.url);
+    m_out.append(" HTTP/1.1\r\n");
+    const std::string_view connection_value = request.get_header("Connection");
+    m_client_http11 = client_parser->http_major == 1 && client_parser->http_minor >= 1;
+    if (!connection.framed)
+    {
+        m_client_keep_alive = m_client_http11 ? !(connection_value.data() && connection_listed(connection_value, "close"))
+                                              : connection_value.data() && connection_listed(connection_value, "keep-alive");
+        m_request_bodyless = !m_request_chunked && (0 == client_parser->content_length || !has_length);
+    }
+    std::string forwarded_for;
+    for (size_t i = 0; i < request.get_header_count(); i++)
+    {
+        const auto &header = request.get_header_at(i);
+        if (hop_by_hop(header.key) || equals_lower(header.key, "expect") || (connection_value.data() && connection_listed(connection_value, header.key)))
+        {
+            continue;
+        }
+        if (equals_lower(header.key, "x-forwarded-for"))
+        {
+            forwarded_for.append(forwarded_for.empty() ? "" : ", ").append(header.value);
+            continue;
+        }
+        if (m_request_chunked && equals_lower(header.key, "content-length"))
+        {
+            continue;
+        }
+        m_out.append(header.key);
+        m_out.append(": ");
+        m_out.append(header.value);
+        m_out.append("\r\n");
+    }
+
+    // client address is appended to X-Forwarded-For
+    struct sockaddr_storage peer;
+    socklen_t peer_len = sizeof(peer);
+    char peer_ip[INET6_ADDRSTRLEN]{0};
+    if (0 == getpeername(connection.get_socket_ptr()->get_fd(), (struct sockaddr *)&peer, &peer_len))
+    {
+        if (peer.ss_family == AF_INET6)
+        {
+            inet_ntop(AF_INET6, &((struct sockaddr_in6 *)&peer)->sin6_addr, peer_ip, sizeof(peer_ip));
+        }
+        else
+        {
+            inet_ntop(AF_INET, &((struct sockaddr_in *)&peer)->sin_addr, peer_ip, sizeof(peer_ip));
+        }
+    }
+    if (peer_ip[0])
+    {
+        forwarded_for.append(forwarded_for.empty() ? "" : ", ").append(peer_ip);
+    }
+    if (!forwarded_for.empty())
+    {
+        m_out.append("X-Forwarded-For: ").append(forwarded_for).append("\r\n");
+    }
+    m_out.append("X-Forwarded-Proto: ").append(singleton<tubekit::server::server>::instance()->get_use_ssl() ? "https" : "http").append("\r\n");
+    if (m_request_chunked)
+    {
+        m_out.append("Transfer-Encoding: chunked\r\n");
+    }
+    m_out.append("Connection: keep-alive\r\n\r\n");
+
+    connection.body_callback = [this](http_connection &connection, const char *data, size_t len) -> int
+    {
+        return on_body(connection, data, len);
+    };
+    connection.event_callback = [this](http_connection &connection)
+    {
+        pump(connection);
+    };
+    connection.write_end_callback = [this](http_connection &connection)
+    {
+        pump(connection);
+        if (!connection.get_response_end() && !connection.has_pending_send())
+        {
+            connection.pause_send(); // upstream events drive the connection again
+        }
+    };
+
+    if (!connect_upstream(true))
+    {
+        LOG_ERROR("http_proxy connect %s:%d failed", m_server.ip.c_str(), m_server.port);
+        fail(connection, 502);
+        return false;
+    }
+    pump(connection);
+    return true;
+}
+
+int http_proxy_session::on_body(http_connection &connection, const char *data, size_t len)
+{
+    if (m_failed || !m_upstream || m_request_dropped || 0 == len)
+    {
+        return 0; // request body is not needed anymore
+    }
+    if (m_request_chunked)
+    {
+        char chunk_size[24];
+        int size_len = snprintf(chunk_size, sizeof(chunk_size), "%zx\r\n", len);
+        m_out.append(chunk_size, size_len);
+        m_out.append(data, len);
+        m_out.append("\r\n");
+    }
+    else
+    {
+        m_out.append(data, len);
+    }
+    pump(connection);
+    if (m_upstream && m_out.size() - m_out_sent > out_high_water)
+    {
+        // resumed by pump when upstream takes it, bytes of an HTTP/2 stream already in flight still arrive within its window
+        connection.pause_recv();
+    }
+    return 0;
+}
+
+void http_proxy_session::on_request_end(http_connection &connection)
+{
+    if (m_request_end)
+    {
+        return;
+    }
+    m_request_end = true;
+    if (m_upstream && !m_failed && !m_request_dropped && m_request_chunked)
+    {
+        m_out.append("0\r\n\r\n");
+    }
+    pump(connection);
+}
+
+void http_proxy_session::pump(http_connection &connection)
+{
+    if (m_failed || !m_upstream)
+    {
+        return;
+    }
+    m_connection = &connection;
+
+    if (m_connecting)
+    {
+        int err = m_upstream->get_connect_error();
+        if (err == EINPROGRESS)
+        {
+            singleton<socket_handler>::instance()->attach(m_upstream, true);
+            return;
+        }
+        if (err != 0)
+        {
+            LOG_ERROR("http_proxy connect %s:%d errno=%d errstr=%s", m_server.ip.c_str(), m_server.port, err, strerror(err));
+            fail(connection, 502);
+            return;
+        }
+        m_connecting = false;
+    }
+
+    // request
+    while (m_out_sent < m_out.size())
+    {
+        int oper_errno = 0;
+        int sended = m_upstream->send(m_out.data() + m_out_sent, m_out.size() - m_out_sent, oper_errno);
+        if (sended > 0)
+        {
+            m_out_sent += sended;
+            continue;
+        }
+        if (sended < 0 && oper_errno == EINTR)
+        {
+            continue;
+        }
+        if (sended < 0 && oper_errno == EAGAIN)
+        {
+            break;
+        }
+        if (retry())
+        {
+            pump(connection);
+            return;
+        }
+        if (!m_response_started)
+        {
+            LOG_ERROR("http_proxy send to %s:%d errno=%d", m_server.ip.c_str(), m_server.port, oper_errno);
+            fail(connection, 502);
+            return;
+        }
+        // upstream answered early and stopped reading, the rest of request is dropped
+        m_out.clear();
+        m_out_sent = 0;
+        m_out_trimmed = true;
+        m_request_dropped = true;
+        break;
+    }
+    // a request on a reused connection is kept until response starts, to be sent again on a fresh one
+    if (m_out_sent > 0 && (!m_reused || m_response_started || m_out.size() > out_high_water))
+    {
+        m_out.erase(0, m_out_sent);
+        m_out_sent = 0;
+        m_out_trimmed = true;
+    }
+    if (connection.get_recv_paused() && m_out.size() - m_out_sent < out_low_water)
+    {
+        connection.resume_recv();
+    }
+
+    // response
+    static const http_parser_settings settings = []()
+    {
+        http_parser_settings init;
+        http_parser_settings_init(&init);
+        init.on_status = http_proxy_session::on_response_status;
+        init.on_header_field = http_proxy_session::on_response_header_field;
+        init.on_header_value = http_proxy_session::on_response_header_value;
+        init.on_headers_complete = http_proxy_session::on_response_headers_complete;
+        init.on_body = http_proxy_session::on_response_body;
+        init.on_message_complete = http_proxy_session::on_response_message_complete;
+        return init;
+    }();
+    bool upstream_closed = false;
+    while (!m_response_complete && connection.m_send_buffer.can_readable_size() < client_high_water)
+    {
+        char buf[16384];
+        int oper_errno = 0;
+        int recv_len = m_upstream->recv(buf, sizeof(buf), oper_errno);
+        if (recv_len == -1 && oper_errno == EAGAIN)
+        {
+            break;
+        }
+        else if (recv_len == -1 && oper_errno == EINTR)
+        {
+            continue;
+        }
+        else if (recv_len > 0)
+        {
+            m_response_started = true;
+            size_t nparsed = http_parser_execute(&m_parser, &settings, buf, recv_len);
+            if (HTTP_PARSER_ERRNO(&m_parser) != HPE_PAUSED && nparsed != (size_t)recv_len)
+            {
+                LOG_ERROR("http_proxy response from %s:%d %s", m_server.ip.c_str(), m_server.port, http_errno_name(HTTP_PARSER_ERRNO(&m_parser)));
+                fail(connection, 502);
+                return;
+            }
+            continue;
+        }
+        // EOF ends a body without length
+        upstream_closed = true;
+        if (recv_len == 0)
+        {
+            http_parser_execute(&m_parser, &settings, nullptr, 0);
+        }
+        if (!m_response_complete)
+        {
+            if (retry())
+            {
+                pump(connection);
+                return;
+            }
+            LOG_ERROR("http_proxy %s:%d closed before response end", m_server.ip.c_str(), m_server.port);
+            fail(connection, 502);
+            return;
+        }
+        break;
+    }
+
+    if (m_response_complete)
+    {
+        const bool keep_alive = !upstream_closed && m_request_end && !m_request_dropped && m_out_sent == m_out.size() && http_should_keep_alive(&m_parser);
+        close_upstream(keep_alive);
+        connection.set_recv_end(true); // the rest of request body is not needed
+        connection.set_response_end(true);
+        return;
+    }
+
+    // wait for upstream, not read while client is slow, client write end pumps again
+    const bool want_send = m_out_sent < m_out.size();
+    if (want_send || connection.m_send_buffer.can_readable_size() < client_high_water)
+    {
+        singleton<socket_handler>::instance()->attach(m_upstream, want_send);
+    }
+}
+
+void http_proxy_session::fail(http_connection &connection, int status)
+{
+    close_upstream(false);
+    m_failed = true;
+    if (m_response_head_sent)
+    {
+        connection.set_everything_end(true); // response is cut, client sees the connection closed
+        return;
+    }
+    connection.response.set_status(status).add_header(http_response::CONNECTION, "close").set_content_length(0).commit();
+    connection.set_recv_end(true);
+    connection.set_response_end(true);
+}
+
+void http_proxy_session::flush_header()
+{
+    if (!hop_by_hop(m_field))
+    {
+        m_head.append(m_field);
+        m_head.append(": ");
+        m_head.append(m_value);
+        m_head.append("\r\n");
+    }
+    m_field.clear();
+    m_value.clear();
+    m_in_value = false;
+}
+
+int http_proxy_session::on_response_status(http_parser *parser, const char *at, size_t length)
+{
+    http_proxy_session *session = static_cast<http_proxy_session *>(parser->data);
+    session->m_reason.append(at, length);
+    return 0;
+}
+
+int http_proxy_session::on_response_header_field(http_parser *parser, const char *at, size_t length)
+{
+    http_proxy_session *session = static_cast<http_proxy_session *>(parser->data);
+    if (session->m_in_value)
+    {
+        session->flush_header();
+    }
+    session->m_field.append(at, length);
+    return 0;
+}
+
+int http_proxy_session::on_response_header_value(http_parser *parser, const char *at, size_t length)
+{
+    http_proxy_session *session = static_cast<http_proxy_session *>(parser->data);
+    session->m_in_value = true;
+    session->m_value.append(at, length);
+    return 0;
+}
+
+int http_proxy_session::on_response_headers_complete(http_parser *parser)
+{
+    http_proxy_session *session = static_cast<http_proxy_session *>(parser->data);
+    if (session->m_in_value)
+    {
+        session->flush_header();
+    }
+    session->m_status = parser->status_code;
+    if (session->m_status < 200)
+    {
+        // interim response is not relayed
+        session->m_head.clear();
+        session->m_reason.clear();
+        return 0;
+    }
+
+    // a body with length or a chunked one keeps the client connection, only a body ended by close of upstream ends it too
+    tubekit::connection::http_connection *connection = session->m_connection;
+    const bool chunked = parser->flags & F_CHUNKED;
+    const bool no_body = session->m_head_request || session->m_status == 204 || session->m_status == 304;
+    session->m_response_chunked = chunked && !no_body && !connection->framed && session->m_client_http11;
+    const bool delimited = no_body || session->m_response_chunked || (!chunked && parser->content_length != ULLONG_MAX);
+    // the rest of a request body would be left unread on the connection
+    connection->keep_alive = delimited && session->m_client_keep_alive && (session->m_request_end || session->m_request_bodyless);
+
+    std::string line;
+    line.reserve(session->m_head.size() + 64);
+    line.append("HTTP/1.1 ").append(std::to_string(session->m_status)).push_back(' ');
+    line.append(session->m_reason.empty() ? http_response::reason(session->m_status) : session->m_reason).append("\r\n");
+    line.append(session->m_head);
+    if (session->m_response_chunked)
+    {
+        line.append("Transfer-Encoding: chunked\r\n");
+    }
+    if (!connection->framed && !connection->keep_alive)
+    {
+        line.append("Connection: close\r\n");
+    }
+    else if (!connection->framed && !session->m_client_http11)
+    {
+        line.append("Connection: keep-alive\r\n");
+    }
+    line.append("\r\n");
+    try
+    {
+        session->m_connection->m_send_buffer.write(line.data(), line.size());
+    }
+    catch (const std::runtime_error &e)
+    {
+        LOG_ERROR(e.what());
+        return -1;
+    }
+    session->m_response_head_sent = true;
+    session->m_head.clear();
+    return session->m_head_request ? 1 : 0; // 1 tells parser there is no body
+}
+
+int http_proxy_session::on_response_body(http_parser *parser, const char *at, size_t length)
+{
+    http_proxy_session *session = static_cast<http_proxy_session *>(parser->data);
+    try
+    {
+        if (session->m_response_chunked)
+        {
+            char chunk_size[24];
+            int size_len = snprintf(chunk_size, sizeof(chunk_size), "%zx\r\n", length);
+            session->m_connection->m_send_buffer.write(chunk_size, size_len);
+            session->m_connection->m_send_buffer.write(at, length);
+            session->m_connection->m_send_buffer.write("\r\n", 2);
+        }
+        else
+        {
+            session->m_connection->m_send_buffer.write(at, length);
+        }
+    }
+    catch (const std::runtime_error &e)
+    {
+        LOG_ERROR(e.what());
+        return -1;
+    }
+    return 0;
+}
+
+int http_proxy_session::on_response_message_complete(http_parser *parser)
+{
+    http_proxy_session *session = static_cast<http_proxy_session *>(parser->data);
+    if (session->m_status < 200)
+    {
+        session->m_status = 0;
+        return 0;
+    }
+    if (session->m_response_chunked)
+    {
+        // trailers of upstream are not relayed
+        try
+        {
+            session->m_connection->m_send_buffer.write("0\r\n\r\n", 5);
+        }
+        catch (const std::runtime_error &e)
+        {
+            LOG_ERROR(e.what());
+            return -1;
+        }
+    }
+    session->m_response_complete = true;
+    http_parser_pause(parser, 1);
+    return 0;
+}
@@ -0,0 +1,199 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <http-parser/http_parser.h>
+
+#include "thread/mutex.h"
+#include "socket/socket.h"
+#include "connection/http_connection.h"
+
+namespace tubekit::app
+{
+    /**
+     * @brief reverse proxy of http_app, url prefixes are relayed to groups of upstream servers,
+     *        upstream connections are non-blocking sockets in the same event_poller and kept alive in per-server pools
+     *
+     */
+    class http_proxy
+    {
+    public:
+        enum balance
+        {
+            ROUND_ROBIN = 0,
+            LEAST_CONN
+        };
+
+        struct upstream_server
+        {
+            std::string ip{};
+            int port{0};
+            std::atomic<size_t> active{0}; // sessions using this server now
+            tubekit::thread::mutex mutex;
+            std::vector<tubekit::socket::socket *> idle{}; // keep-alive connections, detached from epoll
+        };
+
+        struct upstream_group
+        {
+            std::string prefix{};
+            std::vector<std::unique_ptr<upstream_server>> servers{};
+            std::atomic<size_t> next{0};
+        };
+
+    public:
+        http_proxy();
+        ~http_proxy();
+
+        /**
+         * @brief thread safe, called once in http_app::on_init
+         *
+         * @param pass such as /api/=127.0.0.1:8080,127.0.0.1:8081;/img/=[::1]:8082, empty disables proxy
+         * @param balance_name round_robin or least_conn
+         * @param keepalive max idle connections kept for each upstream server
+         * @return int 0 success, -1 invalid pass
+         */
+        int init(const std::string &pass, const std::string &balance_name, size_t keepalive);
+
+        bool get_enable() const;
+
+        /**
+         * @brief the group with the longest prefix of path
+         *
+         * @param path url path without query
+         * @return upstream_group* nullptr when not proxied
+         */
+        upstream_group *match(std::string_view path);
+
+        /**
+         * @brief thread safe, pick a server of group by balance
+         *
+         * @param group
+         * @return upstream_server*
+         */
+        upstream_server *choose(upstream_group &group);
+
+        /**
+         * @brief thread safe, an idle keep-alive connection of server which is still open
+         *
+         * @param server
+         * @return tubekit::socket::socket* nullptr when pool is empty
+         */
+        tubekit::socket::socket *acquire(upstream_server &server);
+
+        /**
+         * @brief thread safe, put connection back to pool, or close it when keep_alive is false or pool is full
+         *
+         * @param server
+         * @param socket_ptr
+         * @param keep_alive
+         */
+        void release(upstream_server &server, tubekit::socket::socket *socket_ptr, bool keep_alive);
+
+    private:
+        bool m_enable{false};
+        balance m_balance{ROUND_ROBIN};
+        size_t m_keepalive{0};
+        std::vector<std::unique_ptr<upstream_group>> m_groups{}; // longer prefix first
+    };
+
+    /**
+     * @brief one proxied request, request body and response body are relayed as they arrive with bounded buffers
+     *
+     * request body is paused when too much is waiting for upstream, upstream is not read when too much is waiting for client,
+     * an HTTP/2 stream is paused by withholding its WINDOW_UPDATE so the client stops at the stream window
+     */
+    class http_proxy_session
+    {
+    public:
+        http_proxy_session(http_proxy::upstream_server &server);
+        ~http_proxy_session();
+
+        /**
+         * @brief take an upstream connection, queue request head and set hooks of connection
+         *
+         * @param connection
+         * @return true
+         * @return false no upstream connection, 502 is queued
+         */
+        bool start(tubekit::connection::http_connection &connection);
+
+        /**
+         * @brief body_callback of connection
+         *
+         * @param connection
+         * @param data
+         * @param len
+         * @return int 0
+         */
+        int on_body(tubekit::connection::http_connection &connection, const char *data, size_t len);
+
+        /**
+         * @brief the whole request body is received
+         *
+         * @param connection
+         */
+        void on_request_end(tubekit::connection::http_connection &connection);
+
+        /**
+         * @brief connect, send queued request bytes, relay response bytes into m_send_buffer, and wait upstream events
+         *
+         * @param connection
+         */
+        void pump(tubekit::connection::http_connection &connection);
+
+    private:
+        bool connect_upstream(bool allow_pooled);
+        void close_upstream(bool keep_alive);
+        /**
+         * @brief a reused keep-alive connection was closed by upstream before responding, send the request again
+         *
+         * @return true retried
+         * @return false
+         */
+        bool retry();
+        void fail(tubekit::connection::http_connection &connection, int status);
+        void flush_header();
+
+        static int on_response_status(http_parser *parser, const char *at, size_t length);
+        static int on_response_header_field(http_parser *parser, const char *at, size_t length);
+        static int on_response_header_value(http_parser *parser, const char *at, size_t length);
+        static int on_response_headers_complete(http_parser *parser);
+        static int on_response_body(http_parser *parser, const char *at, size_t length);
+        static int on_response_message_complete(http_parser *parser);
+
+    private:
+        http_proxy::upstream_server &m_server;
+        tubekit::socket::socket *m_upstream{nullptr};
+        tubekit::connection::http_connection *m_connection{nullptr}; // valid during pump
+        bool m_connecting{false};
+        bool m_reused{false};
+        bool m_failed{false};
+
+        // request to upstream
+        std::string m_out{};
+        size_t m_out_sent{0};
+        bool m_out_trimmed{false}; // bytes of request are gone, it can not be sent again
+        bool m_request_chunked{false};
+        bool m_request_end{false};
+        bool m_request_dropped{false}; // upstream stopped reading after an early response
+        bool m_head_request{false};
+        bool m_client_http11{false};
+        bool m_client_keep_alive{false}; // HTTP/1.x client allows another request on its connection
+        bool m_request_bodyless{false};  // HTTP/1.x request without body, it is whole once the head is parsed
+
+        // response from upstream
+        http_parser m_parser;
+        bool m_response_started{false};
+        bool m_response_head_sent{false};
+        bool m_response_complete{false};
+        bool m_response_chunked{false}; // chunked body of upstream is chunked again to client
+        bool m_in_value{false};
+        int m_status{0};
+        std::string m_reason{};
+        std::string m_field{};
+        std::string m_value{};
+        std::string m_head{};
+    };
+}
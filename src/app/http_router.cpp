@@ -0,0 +1,274 @@
+#include "app/http_router.h"
+
+using tubekit::app::http_router;
+
+std::string_view http_router::params::get(std::string_view name) const
+{
+    for (size_t i = 0; i < m_size; i++)
+    {
+        if (m_params[i].first == name)
+        {
+            return m_params[i].second;
+        }
+    }
+    return std::string_view();
+}
+
+size_t http_router::params::size() const
+{
+    return m_size;
+}
+
+const std::pair<std::string_view, std::string_view> &http_router::params::at(size_t idx) const
+{
+    return m_params[idx];
+}
+
+http_router::http_router()
+{
+}
+
+http_router::~http_router()
+{
+}
+
+bool http_router::add(std::string_view method, std::string_view pattern, handler route_handler)
+{
+    if (m_compiled || method.empty() || pattern.empty() || pattern[0] != '/' || !route_handler)
+    {
+        return false;
+    }
+
+    // validate params
+    size_t param_count = 0;
+    for (size_t i = 0; i < pattern.size(); i++)
+    {
+        if (pattern[i] != ':' && pattern[i] != '*')
+        {
+            continue;
+        }
+        if (pattern[i - 1] != '/')
+        {
+            return false;
+        }
+        size_t name_end = pattern.find('/', i);
+        if (name_end == std::string_view::npos)
+        {
+            name_end = pattern.size();
+        }
+        if (name_end == i + 1 || ++param_count > max_params)
+        {
+            return false;
+        }
+        if (pattern[i] == '*' && name_end != pattern.size())
+        {
+            return false;
+        }
+        i = name_end - 1;
+    }
+
+    auto new_route = std::make_unique<route>();
+    new_route->method = method;
+    new_route->pattern = pattern;
+    new_route->route_handler = std::move(route_handler);
+    m_routes.push_back(std::move(new_route));
+    return true;
+}
+
+bool http_router::compile()
+{
+    if (m_compiled)
+    {
+        return false;
+    }
+    m_root = std::make_unique<node>();
+    for (const auto &item : m_routes)
+    {
+        if (!insert(*item))
+        {
+            m_root.reset();
+            return false;
+        }
+    }
+    m_compiled = true;
+    return true;
+}
+
+bool http_router::get_compiled() const
+{
+    return m_compiled;
+}
+
+bool http_router::insert(const route &new_route)
+{
+    node *now = m_root.get();
+    std::string_view pattern = new_route.pattern;
+    while (!pattern.empty())
+    {
+        if (pattern[0] == ':')
+        {
+            size_t name_end = pattern.find('/');
+            std::string_view name = pattern.substr(1, name_end == std::string_view::npos ? std::string_view::npos : name_end - 1);
+            if (!now->param_child)
+            {
+                now->param_name = name;
+                now->param_child = std::make_unique<node>();
+            }
+            else if (now->param_name != name)
+            {
+                return false;
+            }
+            now = now->param_child.get();
+            pattern = name_end == std::string_view::npos ? std::string_view() : pattern.substr(name_end);
+            continue;
+        }
+        if (pattern[0] == '*')
+        {
+            std::string_view name = pattern.substr(1);
+            if (!now->wildcard_child)
+            {
+                now->wildcard_name = name;
+                now->wildcard_child = std::make_unique<node>();
+            }
+            else if (now->wildcard_name != name)
+            {
+                return false;
+            }
+            now = now->wildcard_child.get();
+            break;
+        }
+
+        // static text until next param
+        size_t static_end = pattern.find_first_of(":*");
+        std::string_view static_part = pattern.substr(0, static_end);
+        size_t idx = now->indices.find(static_part[0]);
+        if (idx == std::string::npos)
+        {
+            auto child = std::make_unique<node>();
+            child->prefix = static_part;
+            now->indices.push_back(static_part[0]);
+            now->children.push_back(std::move(child));
+            now = now->children.back().get();
+            pattern = pattern.substr(static_part.size());
+            continue;
+        }
+
+        node *child = now->children[idx].get();
+        size_t common = 0;
+        while (common < child->prefix.size() && common < static_part.size() && child->prefix[common] == static_part[common])
+        {
+            common++;
+        }
+        if (common < child->prefix.size())
+        {
+            // split child at common prefix
+            auto middle = std::make_unique<node>();
+            middle->prefix = child->prefix.substr(0, common);
+            std::unique_ptr<node> old_child = std::move(now->children[idx]);
+            old_child->prefix.erase(0, common);
+            middle->indices.push_back(old_child->prefix[0]);
+            middle->children.push_back(std::move(old_child));
+            now->children[idx] = std::move(middle);
+            child = now->children[idx].get();
+        }
+        now = child;
+        pattern = pattern.substr(common);
+    }
+
+    for (const route *exist : now->routes)
+    {
+        if (exist->method == new_route.method)
+        {
+            return false;
+        }
+    }
+    now->routes.push_back(&new_route);
+    return true;
+}
+
+const http_router::handler *http_router::find(std::string_view method, std::string_view path, params &out_params) const
+{
+    out_params.m_size = 0;
+    if (!m_compiled || path.empty())
+    {
+        return nullptr;
+    }
+    const route *found = match(m_root.get(), method, path, out_params);
+    return found ? &found->route_handler : nullptr;
+}
+
+const http_router::route *http_router::match(const node *now, std::string_view method, std::string_view path, params &out_params) const
+{
+    if (path.empty())
+    {
+        const route *found = match_method(now, method);
+        if (found)
+        {
+            return found;
+        }
+    }
+    else
+    {
+        size_t idx = now->indices.find(path[0]);
+        if (idx != std::string::npos)
+        {
+            const node *child = now->children[idx].get();
+            if (path.size() >= child->prefix.size() && 0 == path.compare(0, child->prefix.size(), child->prefix))
+            {
+                const route *found = match(child, method, path.substr(child->prefix.size()), out_params);
+                if (found)
+                {
+                    return found;
+                }
+            }
+        }
+
+        if (now->param_child)
+        {
+            size_t segment_end = path.find('/');
+            if (segment_end == std::string_view::npos)
+            {
+                segment_end = path.size();
+            }
+            if (segment_end > 0)
+            {
+                const size_t saved_size = out_params.m_size;
+                out_params.m_params[out_params.m_size++] = {now->param_name, path.substr(0, segment_end)};
+                const route *found = match(now->param_child.get(), method, path.substr(segment_end), out_params);
+                if (found)
+                {
+                    return found;
+                }
+                out_params.m_size = saved_size;
+            }
+        }
+    }
+
+    if (now->wildcard_child)
+    {
+        const route *found = match_method(now->wildcard_child.get(), method);
+        if (found)
+        {
+            out_params.m_params[out_params.m_size++] = {now->wildcard_name, path};
+            return found;
+        }
+    }
+    return nullptr;
+}
+
+const http_router::route *http_router::match_method(const node *now, std::string_view method)
+{
+    const route *any = nullptr;
+    for (const route *item : now->routes)
+    {
+        if (item->method == method)
+        {
+            return item;
+        }
+        if (item->method == "*" || (!any && method == "HEAD" && item->method == "GET"))
+        {
+            any = item;
+        }
+    }
+    return any;
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <utility>
+
+namespace tubekit::connection
+{
+    class http_connection;
+}
+
+namespace tubekit::app
+{
+    /**
+     * @brief method and path pattern router for http_app, routes are compiled into a radix tree at startup,
+     *        lookup walks the path once without allocation
+     *
+     * patterns: static text, ":name" matches one non-empty segment, "*name" matches the rest of path and must be last,
+     * static text is preferred to ":name" which is preferred to "*name" at the same position
+     */
+    class http_router
+    {
+    public:
+        static constexpr size_t max_params = 8;
+
+        /**
+         * @brief captured path params, views into pattern names and request path
+         *
+         */
+        class params
+        {
+        public:
+            std::string_view get(std::string_view name) const;
+            size_t size() const;
+            const std::pair<std::string_view, std::string_view> &at(size_t idx) const;
+
+        private:
+            friend class http_router;
+            std::pair<std::string_view, std::string_view> m_params[max_params]{};
+            size_t m_size{0};
+        };
+
+        using handler = std::function<void(tubekit::connection::http_connection &connection, const params &params)>;
+
+    public:
+        http_router();
+        ~http_router();
+
+        /**
+         * @brief register a route before compile
+         *
+         * @param method such as GET, "*" matches any method, HEAD falls back to GET
+         * @param pattern must start with '/'
+         * @param route_handler
+         * @return true
+         * @return false bad pattern, conflict param name or already compiled
+         */
+        bool add(std::string_view method, std::string_view pattern, handler route_handler);
+
+        /**
+         * @brief build the radix tree from added routes, called once at startup
+         *
+         * @return true
+         * @return false
+         */
+        bool compile();
+
+        bool get_compiled() const;
+
+        /**
+         * @brief thread safe after compile
+         *
+         * @param method
+         * @param path without query string
+         * @param out_params
+         * @return const handler* nullptr when no route matches
+         */
+        const handler *find(std::string_view method, std::string_view path, params &out_params) const;
+
+    private:
+        struct route
+        {
+            std::string method;
+            std::string pattern;
+            handler route_handler;
+        };
+
+        struct node
+        {
+            std::string prefix{};
+            std::string indices{}; // first char of each static child
+            std::vector<std::unique_ptr<node>> children{};
+            std::string param_name{};
+            std::unique_ptr<node> param_child{nullptr};
+            std::string wildcard_name{};
+            std::unique_ptr<node> wildcard_child{nullptr};
+            std::vector<const route *> routes{};
+        };
+
+        bool insert(const route &new_route);
+        const route *match(const node *now, std::string_view method, std::string_view path, params &out_params) const;
+        static const route *match_method(const node *now, std::string_view method);
+
+    private:
+        std::vector<std::unique_ptr<route>> m_routes{};
+        std::unique_ptr<node> m_root{nullptr};
+        bool m_compiled{false};
+    };
+}
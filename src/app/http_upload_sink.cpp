@@ -0,0 +1,125 @@
+#include "app/http_upload_sink.h"
+#include <filesystem>
+#include <system_error>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <tubekit-log/logger.h>
+
+using tubekit::app::http_upload_sink;
+namespace fs = std::filesystem;
+
+http_upload_sink::http_upload_sink()
+{
+}
+
+http_upload_sink::~http_upload_sink()
+{
+    abort();
+}
+
+bool http_upload_sink::open(const std::string &path, uint64_t max_size, uint64_t unique)
+{
+    fs::path target(path);
+    std::error_code ec;
+    if (target.has_parent_path())
+    {
+        fs::create_directories(target.parent_path(), ec);
+        if (ec)
+        {
+            LOG_ERROR("create_directories %s %s", target.parent_path().c_str(), ec.message().c_str());
+            return false;
+        }
+    }
+    m_replaced = fs::exists(target, ec);
+    if (m_replaced && !fs::is_regular_file(target, ec))
+    {
+        return false;
+    }
+
+    m_path = path;
+    m_temp_path = path + ".tubekit_upload_" + std::to_string(unique);
+    m_fd = ::open(m_temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (m_fd < 0)
+    {
+        LOG_ERROR("open %s errno %d", m_temp_path.c_str(), errno);
+        m_temp_path.clear();
+        return false;
+    }
+    m_max_size = max_size;
+    m_written = 0;
+    return true;
+}
+
+int http_upload_sink::write(const char *data, size_t len)
+{
+    if (m_fd < 0)
+    {
+        return -1;
+    }
+    if (m_max_size > 0 && m_written + len > m_max_size)
+    {
+        LOG_ERROR("upload %s oversize %llu bytes", m_path.c_str(), m_max_size);
+        return -2;
+    }
+    size_t offset = 0;
+    while (offset < len)
+    {
+        ssize_t written = ::write(m_fd, data + offset, len - offset);
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            LOG_ERROR("write %s errno %d", m_temp_path.c_str(), errno);
+            return -1;
+        }
+        offset += written;
+    }
+    m_written += len;
+    return 0;
+}
+
+bool http_upload_sink::commit()
+{
+    if (m_fd < 0)
+    {
+        return false;
+    }
+    int fd = m_fd;
+    m_fd = -1;
+    if (0 != ::close(fd) || 0 != ::rename(m_temp_path.c_str(), m_path.c_str()))
+    {
+        LOG_ERROR("commit %s errno %d", m_path.c_str(), errno);
+        ::unlink(m_temp_path.c_str());
+        m_temp_path.clear();
+        return false;
+    }
+    m_temp_path.clear();
+    return true;
+}
+
+void http_upload_sink::abort()
+{
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    if (!m_temp_path.empty())
+    {
+        ::unlink(m_temp_path.c_str());
+        m_temp_path.clear();
+    }
+}
+
+int http_upload_sink::get_fd() const
+{
+    return m_fd;
+}
+
+bool http_upload_sink::get_replaced() const
+{
+    return m_replaced;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <string>
+#include <cstdint>
+
+namespace tubekit::app
+{
+    /**
+     * @brief receive an upload into a temporary file beside the target, renamed to the target on commit
+     *
+     */
+    class http_upload_sink
+    {
+    public:
+        http_upload_sink();
+        ~http_upload_sink();
+
+        /**
+         * @brief create parent directories and the temporary file
+         *
+         * @param path target file
+         * @param max_size bytes limit of body, 0 for unlimited
+         * @param unique make temporary file name unique
+         * @return true
+         * @return false
+         */
+        bool open(const std::string &path, uint64_t max_size, uint64_t unique);
+
+        /**
+         * @brief append body bytes
+         *
+         * @param data
+         * @param len
+         * @return int 0 success, -1 write failed, -2 oversize
+         */
+        int write(const char *data, size_t len);
+
+        /**
+         * @brief close and rename temporary file to target
+         *
+         * @return true
+         * @return false
+         */
+        bool commit();
+
+        /**
+         * @brief close and remove temporary file, be called by destructor when not committed
+         *
+         */
+        void abort();
+
+        int get_fd() const;
+
+        /**
+         * @brief whether target existed before open
+         *
+         * @return true
+         * @return false
+         */
+        bool get_replaced() const;
+
+    private:
+        int m_fd{-1};
+        std::string m_path{};
+        std::string m_temp_path{};
+        uint64_t m_max_size{0};
+        uint64_t m_written{0};
+        bool m_replaced{false};
+    };
+}
@@ -1,25 +1,53 @@
 #include "app/lua_plugin.h"
 #include <string>
+#include <vector>
 #include <iostream>
 
 #include "server/server.h"
 #include "utility/singleton.h"
 #include "tubekit-log/logger.h"
+#include "thread/auto_lock.h"
+#include "connection/http_connection.h"
 
 using std::string;
+using tubekit::app::http_router;
 using tubekit::app::lua_plugin;
+using tubekit::connection::http_connection;
+using tubekit::thread::auto_lock;
 using tubekit::server::server;
 using tubekit::utility::singleton;
 
+// lua vm of a worker thread, route functions are refs in order of tubekit.Route
+struct lua_worker_vm
+{
+    ~lua_worker_vm()
+    {
+        if (state)
+        {
+            lua_close(state);
+        }
+    }
+    lua_State *state{nullptr};
+    bool failed{false};
+    std::vector<int> routes{};
+};
+
+static thread_local lua_worker_vm worker_vm_local;
+// routes of the worker vm loading init.lua, nullptr when the main vm loads it
+static thread_local std::vector<int> *loading_routes{nullptr};
+
 lua_plugin::lua_plugin() : lua_state(nullptr)
 {
 }
 
 void lua_plugin::on_init()
 {
+    auto_lock lock(m_mutex);
     // init lua vm
     lua_state = luaL_newstate();
     luaL_openlibs(lua_state);
+    // tubekit functions are usable while loading, such as tubekit.Route
+    mount(lua_state);
     // exe lua file
     string filename = singleton<server::server>::instance()->get_lua_dir() + "/init.lua";
     int isok = luaL_dofile(lua_state, filename.data());
@@ -27,7 +55,7 @@ void lua_plugin::on_init()
     if (isok == 0)
     {
         LOG_ERROR("init.lua load succ");
-        mount();
+        m_running = true;
         exe_OnInit();
     }
     else
@@ -39,18 +67,26 @@ void lua_plugin::on_init()
 
 void lua_plugin::on_exit()
 {
-    // close lua vm
+    // close lua vm, vms of workers are closed when their threads exit
+    m_running = false;
+    auto_lock lock(m_mutex);
     if (lua_state)
     {
         exe_OnExit();
         lua_close(lua_state);
+        lua_state = nullptr;
     }
     LOG_ERROR("lua_plugin on_exit");
 }
 
 void lua_plugin::on_tick()
 {
-    exe_OnTick();
+    // routes run in vms of workers, a slow route does not hold the reactor thread here
+    auto_lock lock(m_mutex);
+    if (lua_state)
+    {
+        exe_OnTick();
+    }
 }
 
 void lua_plugin::exe_OnInit()
@@ -73,13 +109,40 @@ void lua_plugin::exe_OnExit()
     }
 }
 
-void lua_plugin::mount()
+void lua_plugin::mount(lua_State *state)
 {
     static luaL_Reg lulibs[] = {
         {"Logger", Logger},
+        {"Route", Route},
         {NULL, NULL}};
-    luaL_newlib(lua_state, lulibs);
-    lua_setglobal(lua_state, "tubekit");
+    luaL_newlib(state, lulibs);
+    lua_setglobal(state, "tubekit");
+}
+
+lua_State *lua_plugin::worker_vm()
+{
+    if (worker_vm_local.state || worker_vm_local.failed)
+    {
+        return worker_vm_local.state;
+    }
+    // OnInit is not called again, globals set by it are only in main vm
+    lua_State *state = luaL_newstate();
+    luaL_openlibs(state);
+    mount(state);
+    string filename = singleton<server::server>::instance()->get_lua_dir() + "/init.lua";
+    loading_routes = &worker_vm_local.routes;
+    int isok = luaL_dofile(state, filename.data());
+    loading_routes = nullptr;
+    if (isok != 0 || worker_vm_local.routes.size() != m_route_count)
+    {
+        LOG_ERROR("init.lua load failed in worker, %s", isok != 0 ? lua_tostring(state, -1) : "routes differ from main vm");
+        lua_close(state);
+        worker_vm_local.routes.clear();
+        worker_vm_local.failed = true;
+        return nullptr;
+    }
+    worker_vm_local.state = state;
+    return state;
 }
 
 int lua_plugin::Logger(lua_State *lua_state)
@@ -112,4 +175,118 @@ void lua_plugin::exe_OnTick()
     {
         LOG_ERROR("exe_OnTick failed %s", lua_tostring(lua_state, -1));
     }
-}
\ No newline at end of file
+}
+int lua_plugin::Route(lua_State *lua_state)
+{
+    if (lua_gettop(lua_state) != 3 || !lua_isstring(lua_state, 1) || !lua_isstring(lua_state, 2))
+    {
+        return luaL_error(lua_state, "tubekit.Route(method, pattern, function)");
+    }
+    if (lua_type(lua_state, 3) == LUA_TSTRING)
+    {
+        lua_getglobal(lua_state, lua_tostring(lua_state, 3));
+        lua_replace(lua_state, 3);
+    }
+    if (lua_type(lua_state, 3) != LUA_TFUNCTION)
+    {
+        return luaL_error(lua_state, "tubekit.Route handler is not a function");
+    }
+    if (loading_routes)
+    {
+        lua_pushvalue(lua_state, 3);
+        loading_routes->push_back(luaL_ref(lua_state, LUA_REGISTRYINDEX));
+        lua_pushboolean(lua_state, true);
+        return 1;
+    }
+
+    string method = lua_tostring(lua_state, 1);
+    string pattern = lua_tostring(lua_state, 2);
+    // the index is taken even if adding fails, to stay in step with worker vms
+    const size_t route_index = singleton<lua_plugin>::instance()->m_route_count++;
+    bool added = singleton<http_router>::instance()->add(method, pattern, [route_index](http_connection &connection, const http_router::params &params)
+                                                         { singleton<lua_plugin>::instance()->exe_Route(route_index, connection, params); });
+    if (!added)
+    {
+        LOG_ERROR("tubekit.Route %s %s failed", method.c_str(), pattern.c_str());
+    }
+    lua_pushboolean(lua_state, added);
+    return 1;
+}
+
+void lua_plugin::exe_Route(size_t route_index, http_connection &connection, const http_router::params &params)
+{
+    int status = 500;
+    string body = "Internal Server Error";
+    string content_type = "text/plain; charset=utf-8";
+    if (!m_running)
+    {
+        connection.set_response_end(true);
+        return;
+    }
+    lua_State *lua_state = worker_vm();
+    if (lua_state)
+    {
+        body.clear();
+        const int top = lua_gettop(lua_state);
+        lua_rawgeti(lua_state, LUA_REGISTRYINDEX, worker_vm_local.routes[route_index]);
+
+        // request table
+        std::string_view url = connection.request.url;
+        std::string_view path = url.substr(0, url.find('?'));
+        lua_createtable(lua_state, 0, 6);
+        lua_pushlstring(lua_state, connection.request.method.data(), connection.request.method.size());
+        lua_setfield(lua_state, -2, "method");
+        lua_pushlstring(lua_state, url.data(), url.size());
+        lua_setfield(lua_state, -2, "url");
+        lua_pushlstring(lua_state, path.data(), path.size());
+        lua_setfield(lua_state, -2, "path");
+        lua_createtable(lua_state, 0, params.size());
+        for (size_t i = 0; i < params.size(); i++)
+        {
+            lua_pushlstring(lua_state, params.at(i).first.data(), params.at(i).first.size());
+            lua_pushlstring(lua_state, params.at(i).second.data(), params.at(i).second.size());
+            lua_settable(lua_state, -3);
+        }
+        lua_setfield(lua_state, -2, "params");
+        lua_createtable(lua_state, 0, connection.request.get_header_count());
+        for (size_t i = 0; i < connection.request.get_header_count(); i++)
+        {
+            const auto &header = connection.request.get_header_at(i);
+            lua_pushlstring(lua_state, header.key.data(), header.key.size());
+            lua_pushlstring(lua_state, header.value.data(), header.value.size());
+            lua_settable(lua_state, -3);
+        }
+        lua_setfield(lua_state, -2, "headers");
+        lua_pushlstring(lua_state, connection.body.data(), connection.body.size());
+        lua_setfield(lua_state, -2, "body");
+
+        if (0 != lua_pcall(lua_state, 1, 3, 0))
+        {
+            LOG_ERROR("exe_Route failed %s", lua_tostring(lua_state, -1));
+            body = "Internal Server Error";
+        }
+        else
+        {
+            status = lua_isinteger(lua_state, -3) ? (int)lua_tointeger(lua_state, -3) : 200;
+            if (lua_isstring(lua_state, -2))
+            {
+                size_t len = 0;
+                const char *str = lua_tolstring(lua_state, -2, &len);
+                body.assign(str, len);
+            }
+            if (lua_isstring(lua_state, -1))
+            {
+                content_type = lua_tostring(lua_state, -1);
+            }
+        }
+        lua_settop(lua_state, top);
+    }
+
+    connection.response.set_status(status).add_header(tubekit::connection::http_response::CONTENT_TYPE, content_type).set_content_length(body.size());
+    if (connection.request.method != "HEAD")
+    {
+        connection.response.add_body(std::move(body));
+    }
+    connection.response.commit();
+    connection.set_response_end(true);
+}
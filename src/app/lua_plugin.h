@@ -6,6 +6,11 @@ extern "C"
 #include "lua/lualib.h"
 }
 
+#include <atomic>
+
+#include "app/http_router.h"
+#include "thread/mutex.h"
+
 namespace tubekit::app
 {
     class lua_plugin
@@ -20,12 +25,37 @@ namespace tubekit::app
         void exe_OnExit();
         void exe_OnTick();
 
-        void mount();
+        void mount(lua_State *state);
+
+        /**
+         * @brief thread safe, call lua function registered by tubekit.Route and write its response,
+         *        it runs in the lua vm of the calling worker, which loads init.lua on its first route
+         *
+         * @param route_index order of tubekit.Route calls in init.lua
+         * @param connection
+         * @param params
+         */
+        void exe_Route(size_t route_index, tubekit::connection::http_connection &connection, const http_router::params &params);
 
     public:
         static int Logger(lua_State *lua_state);
+        /**
+         * @brief tubekit.Route(method, pattern, function or global function name), called when init.lua loading,
+         *        function(request) returns status, body, content_type,
+         *        the main vm adds routes to http_router, a worker vm keeps its functions in the same order
+         *
+         * @param lua_state
+         * @return int
+         */
+        static int Route(lua_State *lua_state);
+
+    private:
+        lua_State *worker_vm();
 
     private:
-        lua_State *lua_state{nullptr};
+        lua_State *lua_state{nullptr}; // main vm of OnInit, OnExit and OnTick
+        tubekit::thread::mutex m_mutex;
+        size_t m_route_count{0};
+        std::atomic<bool> m_running{false}; // routes may run, init.lua of main vm is loaded
     };
 }
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "app/proxy_app.h"
+#include <tubekit-log/logger.h>
+#include <string_view>
+#include <cstdlib>
+#include "utility/singleton.h"
+#include "server/server.h"
+
+using tubekit::app::proxy_app;
+using tubekit::connection::proxy_connection;
+using tubekit::utility::singleton;
+
+namespace tubekit::app
+{
+    std::vector<std::pair<std::string, int>> proxy_app::upstreams{};
+    std::atomic<size_t> proxy_app::upstream_next{0};
+    std::atomic<uint64_t> proxy_app::total_bytes_up{0};
+    std::atomic<uint64_t> proxy_app::total_bytes_down{0};
+};
+
+int proxy_app::on_init()
+{
+    LOG_ERROR("proxy_app::on_init()");
+    server::server *server_ptr = singleton<server::server>::instance();
+    if (server_ptr->get_use_ssl())
+    {
+        LOG_ERROR("PROXY_TASK relays raw bytes by splice, use_ssl must be 0");
+        return -1;
+    }
+
+    // ip:port,ip:port, ipv6 as [::1]:port
+    upstreams.clear();
+    std::string_view rest = server_ptr->get_proxy_upstream();
+    while (!rest.empty())
+    {
+        size_t comma = rest.find(',');
+        std::string_view address = rest.substr(0, comma);
+        rest = comma == std::string_view::npos ? std::string_view() : rest.substr(comma + 1);
+        while (!address.empty() && address.front() == ' ')
+        {
+            address.remove_prefix(1);
+        }
+        while (!address.empty() && address.back() == ' ')
+        {
+            address.remove_suffix(1);
+        }
+        if (address.empty())
+        {
+            continue;
+        }
+        size_t colon = address.rfind(':');
+        std::string_view host = colon == std::string_view::npos ? std::string_view() : address.substr(0, colon);
+        if (host.size() >= 2 && host.front() == '[' && host.back() == ']')
+        {
+            host = host.substr(1, host.size() - 2);
+        }
+        const int port = colon == std::string_view::npos ? 0 : atoi(std::string(address.substr(colon + 1)).c_str());
+        if (host.empty() || port <= 0 || port > 65535)
+        {
+            LOG_ERROR("proxy_upstream invalid upstream %s", std::string(address).c_str());
+            return -1;
+        }
+        upstreams.emplace_back(std::string(host), port);
+    }
+    if (upstreams.empty())
+    {
+        LOG_ERROR("proxy_upstream is empty");
+        return -1;
+    }
+    return 0;
+}
+
+void proxy_app::on_stop()
+{
+    LOG_ERROR("proxy_app::on_stop() bytes up %llu down %llu", (unsigned long long)total_bytes_up.load(), (unsigned long long)total_bytes_down.load());
+}
+
+void proxy_app::on_tick()
+{
+}
+
+void proxy_app::on_new_connection(proxy_connection &m_proxy_connection)
+{
+}
+
+void proxy_app::on_close_connection(proxy_connection &m_proxy_connection)
+{
+    total_bytes_up += m_proxy_connection.get_bytes_up();
+    total_bytes_down += m_proxy_connection.get_bytes_down();
+}
+
+bool proxy_app::choose_upstream(std::string &ip, int &port)
+{
+    if (upstreams.empty())
+    {
+        return false;
+    }
+    const auto &upstream = upstreams[upstream_next.fetch_add(1, std::memory_order_relaxed) % upstreams.size()];
+    ip = upstream.first;
+    port = upstream.second;
+    return true;
+}
+
+uint64_t proxy_app::get_total_bytes_up()
+{
+    return total_bytes_up;
+}
+
+uint64_t proxy_app::get_total_bytes_down()
+{
+    return total_bytes_down;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <utility>
+#include <atomic>
+#include "connection/proxy_connection.h"
+
+// thread not safe : The function will be called by multiple threads simultaneously.
+// thread safe : The function can only be called by the main thread or can be used in any thread.
+
+namespace tubekit
+{
+    namespace app
+    {
+        class proxy_app
+        {
+        public:
+            /**
+             * @brief thread not safe
+             *
+             * @param m_proxy_connection
+             */
+            static void on_new_connection(tubekit::connection::proxy_connection &m_proxy_connection);
+
+            /**
+             * @brief thread not safe, byte counters of both directions are final here
+             *
+             * @param m_proxy_connection
+             */
+            static void on_close_connection(tubekit::connection::proxy_connection &m_proxy_connection);
+
+            /**
+             * @brief thread safe, parse server proxy_upstream
+             *
+             * @return int
+             */
+            static int on_init();
+
+            /**
+             * @brief thread safe
+             *
+             */
+            static void on_stop();
+
+            /**
+             * @brief thread safe
+             *
+             */
+            static void on_tick();
+
+            /**
+             * @brief thread safe, upstreams are used round robin
+             *
+             * @param ip
+             * @param port
+             * @return true
+             * @return false no upstream configured
+             */
+            static bool choose_upstream(std::string &ip, int &port);
+
+            /**
+             * @brief thread safe, bytes relayed by closed connections since start
+             *
+             * @return uint64_t
+             */
+            static uint64_t get_total_bytes_up();
+            static uint64_t get_total_bytes_down();
+
+        private:
+            static std::vector<std::pair<std::string, int>> upstreams;
+            static std::atomic<size_t> upstream_next;
+            static std::atomic<uint64_t> total_bytes_up;
+            static std::atomic<uint64_t> total_bytes_down;
+        };
+    }
+}
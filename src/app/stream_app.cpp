@@ -1,20 +1,27 @@
 #include "app/stream_app.h"
 #include "proto_res/proto_cmd.pb.h"
 #include "proto_res/proto_example.pb.h"
-#include "proto_res/proto_message_head.pb.h"
 #include <tubekit-log/logger.h>
 #include <string>
+#include <string_view>
 #include "utility/singleton.h"
 #include "connection/connection_mgr.h"
 #include "socket/socket.h"
 #include "socket/socket_handler.h"
+#include "socket/admission.h"
 #include "app/lua_plugin.h"
+#include "app/stream_dispatch.h"
+#include "thread/worker_pool.h"
 
+using google::protobuf::Arena;
 using tubekit::app::stream_app;
+using tubekit::app::stream_dispatch;
 using tubekit::connection::connection_mgr;
 using tubekit::connection::stream_connection;
 using tubekit::socket::socket;
 using tubekit::socket::socket_handler;
+using tubekit::thread::letter;
+using tubekit::thread::worker_pool;
 using tubekit::utility::singleton;
 
 namespace tubekit::app
@@ -26,42 +33,28 @@ namespace tubekit::app
 template <typename T>
 static inline bool send_protocol(tubekit::connection::stream_connection *p_conn, ProtoCmd cmd, const T &pack, uint64_t gid = 0)
 {
-    ProtoPackage message;
-    message.set_cmd(cmd);
-    std::string body_str;
-    body_str.resize(pack.ByteSizeLong());
-    pack.SerializeToString(&body_str);
-    message.set_body(body_str);
-    std::string data;
-    message.SerializeToString(&data);
-    return tubekit::app::stream_app::send_packet(p_conn, data.c_str(), data.size(), gid);
+    std::string frame;
+    stream_dispatch::pack_package(*p_conn, cmd, pack, frame);
+    return tubekit::app::stream_app::send_frame(p_conn, frame.data(), frame.size(), gid);
 }
 
-static int process_protocol(tubekit::connection::stream_connection &m_stream_connection, ProtoPackage &package)
+// EXAMPLE_REQ
+static int on_example_req(tubekit::connection::stream_connection &m_stream_connection, ProtoCSReqExample &exampleReq, Arena &arena)
 {
-    // EXAMPLE_REQ
-    if (package.cmd() == ProtoCmd::CS_REQ_EXAMPLE)
+    ProtoCSResExample *exampleRes = Arena::CreateMessage<ProtoCSResExample>(&arena);
+    exampleRes->mutable_testcontext()->swap(*exampleReq.mutable_testcontext());
+    bool send_res = send_protocol(&m_stream_connection, ProtoCmd::CS_RES_EXAMPLE, *exampleRes);
+    if (!send_res)
     {
-        ProtoCSReqExample exampleReq;
-        if (exampleReq.ParseFromString(package.body()))
-        {
-            ProtoCSResExample exampleRes;
-            exampleRes.set_testcontext(exampleReq.testcontext());
-            bool send_res = send_protocol(&m_stream_connection, ProtoCmd::CS_RES_EXAMPLE, exampleRes);
-            if (!send_res)
-            {
-                LOG_ERROR("send example res failed");
-            }
-        }
-        else
-        {
-            return -1;
-        }
-        return 0;
+        LOG_ERROR("send example res failed");
     }
-    return -1;
+    return 0;
 }
 
+// ProtoCmd to handler, one line for each request
+using stream_routes = stream_dispatch::table<
+    stream_dispatch::route<ProtoCmd::CS_REQ_EXAMPLE, ProtoCSReqExample, on_example_req>>;
+
 int stream_app::on_init()
 {
     LOG_ERROR("stream_app::on_init()");
@@ -91,34 +84,42 @@ void stream_app::process_connection(tubekit::connection::stream_connection &m_st
 
     const char *all_data_buffer = m_stream_connection.m_recv_buffer.force_get_read_ptr();
     uint64_t offset = 0;
+    tubekit::socket::admission *const admission_ptr = singleton<tubekit::socket::admission>::instance();
+    const int32_t admission_index = m_stream_connection.get_socket_ptr()->get_admission();
 
-    do
+    // every frame is parsed once, when all of it has arrived
+    const bool unframed = !m_stream_connection.codec.framed();
+    while (offset < all_data_len)
     {
-        const char *tmp_buffer = all_data_buffer + offset;
-        uint64_t data_len = all_data_len - offset;
-        if (data_len == 0)
+        size_t consumed = 0;
+        std::string_view payload;
+        int res = m_stream_connection.codec.next(all_data_buffer + offset, all_data_len - offset, consumed, payload);
+        if (res == tubekit::connection::stream_codec::NEED_MORE)
         {
             break;
         }
 
-        ProtoPackage protoPackage;
-        if (!protoPackage.ParseFromArray(tmp_buffer, data_len))
+        stream_dispatch::package_view package;
+        // a bare packet is parsed again when more of it arrives, as before framing
+        if (unframed && res == tubekit::connection::stream_codec::FRAME && !stream_dispatch::parse_package(payload.data(), payload.size(), package))
         {
-            // std::cout << "protoPackage.ParseFromArray failed" << std::endl;
             break;
         }
-
-        if (0 != process_protocol(m_stream_connection, protoPackage))
+        if (res == tubekit::connection::stream_codec::FAILED ||
+            !admission_ptr->allow_request(admission_index) ||
+            (!unframed && !stream_dispatch::parse_package(payload.data(), payload.size(), package)) ||
+            0 != stream_routes::dispatch(m_stream_connection, package))
         {
             // std::cout << "process_protocol failed" << std::endl;
+            stream_dispatch::reset_arena();
             m_stream_connection.mark_close();
             m_stream_connection.m_recv_buffer.clear();
-            break;
+            return;
         }
-        // std::cout << "datalen " << data_len << " package size " << protoPackage.ByteSizeLong() << std::endl;
-        offset += protoPackage.ByteSizeLong();
-
-    } while (true);
+        offset += consumed;
+    }
+    // messages of this batch are freed together
+    stream_dispatch::reset_arena();
 
     if (!m_stream_connection.m_recv_buffer.read_ptr_move_n(offset))
     {
@@ -143,6 +144,27 @@ void stream_app::on_new_connection(tubekit::connection::stream_connection &m_str
 }
 
 bool stream_app::send_packet(tubekit::connection::stream_connection *m_stream_connection, const char *data, size_t data_len, uint64_t gid /*= 0*/)
+{
+    if (!data || data_len == 0 || (!m_stream_connection && 0 == gid))
+    {
+        return false;
+    }
+    std::string frame;
+    if (m_stream_connection)
+    {
+        m_stream_connection->codec.encode(data, data_len, frame);
+    }
+    else
+    {
+        // every stream connection frames the same way, as configured for server
+        tubekit::connection::stream_codec codec;
+        tubekit::connection::stream_connection::init_codec(codec);
+        codec.encode(data, data_len, frame);
+    }
+    return send_frame(m_stream_connection, frame.data(), frame.size(), gid);
+}
+
+bool stream_app::send_frame(tubekit::connection::stream_connection *m_stream_connection, const char *data, size_t data_len, uint64_t gid /*= 0*/)
 {
     if (!data || data_len == 0)
     {
@@ -154,17 +176,29 @@ bool stream_app::send_packet(tubekit::connection::stream_connection *m_stream_co
     }
     else
     {
-        bool res = false;
-        singleton<connection_mgr>::instance()->if_exist(
-            gid,
-            [&res, &data, &data_len](uint64_t key, std::pair<tubekit::socket::socket *, tubekit::connection::connection *> value)
-            {
-                tubekit::connection::stream_connection *p_streamconn = (tubekit::connection::stream_connection *)(value.second);
-                res = p_streamconn->send(data, data_len);
-            },
-            nullptr);
-        return res;
+        // the connection of gid is written only by its own worker
+        letter item;
+        item.gid = gid;
+        item.deliver = deliver_frame;
+        item.data.assign(data, data_len);
+        if (!singleton<worker_pool>::instance()->post(std::move(item)))
+        {
+            LOG_ERROR("mailbox full, frame to gid[%llu] dropped", gid);
+            return false;
+        }
+        return true;
     }
 
     return false;
+}
+
+void stream_app::deliver_frame(tubekit::thread::letter &item)
+{
+    singleton<connection_mgr>::instance()->if_exist(
+        item.gid,
+        [&item](uint64_t key, std::pair<tubekit::socket::socket *, tubekit::connection::connection *> value)
+        {
+            tubekit::connection::stream_connection *p_streamconn = (tubekit::connection::stream_connection *)(value.second);
+            p_streamconn->send(item.data.data(), item.data.size());
+        });
 }
\ No newline at end of file
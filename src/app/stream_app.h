@@ -4,6 +4,11 @@
 #include <set>
 #include "thread/mutex.h"
 
+namespace tubekit::thread
+{
+    struct letter;
+}
+
 // thread not safe : The function will be called by multiple threads simultaneously.
 // thread safe : The function can only be called by the main thread or can be used in any thread.
 
@@ -54,8 +59,35 @@ namespace tubekit
              */
             static void on_tick();
 
+            /**
+             * @brief thread safe, data is framed by codec of m_stream_connection,
+             *        or by the server-wide stream framing when m_stream_connection is nullptr
+             *
+             * @param m_stream_connection nullptr is allowed when gid is not 0
+             * @param data
+             * @param data_len
+             * @param gid 0 send to m_stream_connection, others send to connection of gid
+             * @return true
+             * @return false
+             */
             static bool send_packet(tubekit::connection::stream_connection *m_stream_connection, const char *data, size_t data_len, uint64_t gid = 0);
 
+            /**
+             * @brief thread safe, data is whole frames already,
+             *        frames to gid are posted to the mailbox of its worker, true means queued
+             *
+             */
+            static bool send_frame(tubekit::connection::stream_connection *m_stream_connection, const char *data, size_t data_len, uint64_t gid = 0);
+
+        private:
+            /**
+             * @brief runs on the worker of item.gid
+             *
+             * @param item
+             */
+            static void deliver_frame(tubekit::thread::letter &item);
+
+        public:
             static std::set<uint64_t> global_player;
             static tubekit::thread::mutex global_player_mutex;
         };
@@ -0,0 +1,109 @@
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+
+#include "app/stream_dispatch.h"
+#include "connection/stream_connection.h"
+
+using google::protobuf::Arena;
+using google::protobuf::io::CodedInputStream;
+using google::protobuf::io::CodedOutputStream;
+using google::protobuf::internal::WireFormatLite;
+using tubekit::app::stream_dispatch;
+using tubekit::connection::stream_connection;
+
+// ProtoPackage fields
+static constexpr int package_cmd_field{1};
+static constexpr int package_body_field{2};
+
+// first block of every worker arena, a batch of small packets does not touch malloc
+static constexpr size_t arena_block_size{64 * 1024};
+
+bool stream_dispatch::parse_package(const char *data, size_t len, package_view &out)
+{
+    out = package_view{};
+    CodedInputStream input(reinterpret_cast<const uint8_t *>(data), (int)len);
+    while (true)
+    {
+        const uint32_t tag = input.ReadTag();
+        if (tag == 0)
+        {
+            return input.CurrentPosition() == (int)len;
+        }
+        const int field = WireFormatLite::GetTagFieldNumber(tag);
+        const WireFormatLite::WireType wire_type = WireFormatLite::GetTagWireType(tag);
+        if (field == package_cmd_field && wire_type == WireFormatLite::WIRETYPE_VARINT)
+        {
+            uint64_t cmd = 0;
+            if (!input.ReadVarint64(&cmd))
+            {
+                return false;
+            }
+            out.cmd = (int32_t)cmd;
+        }
+        else if (field == package_body_field && wire_type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED)
+        {
+            uint32_t size = 0;
+            if (!input.ReadVarint32(&size))
+            {
+                return false;
+            }
+            const int position = input.CurrentPosition();
+            if (!input.Skip((int)size))
+            {
+                return false;
+            }
+            out.body = std::string_view(data + position, size);
+        }
+        else if (!WireFormatLite::SkipField(&input, tag))
+        {
+            return false;
+        }
+    }
+}
+
+char *stream_dispatch::begin_package(stream_connection &connection, ProtoCmd cmd, size_t body_len, std::string &frame, size_t &payload_offset, size_t &payload_len)
+{
+    // proto3 leaves out default values
+    const int32_t cmd_value = cmd;
+    payload_len = (cmd_value != 0 ? 1 + CodedOutputStream::VarintSize32SignExtended(cmd_value) : 0) +
+                  (body_len > 0 ? 1 + CodedOutputStream::VarintSize32((uint32_t)body_len) + body_len : 0);
+    payload_offset = connection.codec.begin_frame(frame, payload_len);
+    uint8_t *pos = reinterpret_cast<uint8_t *>(&frame[payload_offset]);
+    if (cmd_value != 0)
+    {
+        *pos++ = WireFormatLite::MakeTag(package_cmd_field, WireFormatLite::WIRETYPE_VARINT);
+        pos = CodedOutputStream::WriteVarint32SignExtendedToArray(cmd_value, pos);
+    }
+    if (body_len > 0)
+    {
+        *pos++ = WireFormatLite::MakeTag(package_body_field, WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+        pos = CodedOutputStream::WriteVarint32ToArray((uint32_t)body_len, pos);
+    }
+    return reinterpret_cast<char *>(pos);
+}
+
+void stream_dispatch::end_package(stream_connection &connection, std::string &frame, size_t payload_offset, size_t payload_len)
+{
+    connection.codec.end_frame(frame, payload_offset, payload_len);
+}
+
+static google::protobuf::ArenaOptions arena_options(char *block, size_t size)
+{
+    google::protobuf::ArenaOptions options;
+    options.initial_block = block;
+    options.initial_block_size = size;
+    options.start_block_size = arena_block_size;
+    return options;
+}
+
+Arena &stream_dispatch::get_arena()
+{
+    alignas(8) thread_local char block[arena_block_size];
+    thread_local Arena arena(arena_options(block, sizeof(block)));
+    return arena;
+}
+
+void stream_dispatch::reset_arena()
+{
+    get_arena().Reset();
+}
@@ -0,0 +1,169 @@
+#pragma once
+#include <array>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <google/protobuf/arena.h>
+
+#include "proto_res/proto_cmd.pb.h"
+
+namespace tubekit::connection
+{
+    class stream_connection;
+}
+
+namespace tubekit::app
+{
+    /**
+     * @brief ProtoPackage decoding and ProtoCmd dispatch of stream_app
+     *
+     * ProtoPackage is read as a view, its body is never copied, the request is parsed from the body into a message
+     * on the arena of the worker thread, which is reset after each batch of packets,
+     * routes are listed as template arguments and compiled into a dense table indexed by ProtoCmd
+     */
+    class stream_dispatch
+    {
+    public:
+        /**
+         * @brief fields of ProtoPackage, body is a view into packet
+         *
+         */
+        struct package_view
+        {
+            int32_t cmd{0};
+            std::string_view body{};
+        };
+
+        using handler = int (*)(tubekit::connection::stream_connection &connection, std::string_view body, google::protobuf::Arena &arena);
+
+        /**
+         * @brief route of cmd to handler, Req is parsed on arena from body
+         *
+         * @tparam Cmd
+         * @tparam Req request message
+         * @tparam Handler returns 0 or closes connection
+         */
+        template <ProtoCmd Cmd, typename Req, int (*Handler)(tubekit::connection::stream_connection &, Req &, google::protobuf::Arena &)>
+        struct route
+        {
+            static constexpr ProtoCmd cmd = Cmd;
+
+            static int invoke(tubekit::connection::stream_connection &connection, std::string_view body, google::protobuf::Arena &arena)
+            {
+                Req *request = google::protobuf::Arena::CreateMessage<Req>(&arena);
+                if (!request->ParseFromArray(body.data(), (int)body.size()))
+                {
+                    return -1;
+                }
+                return Handler(connection, *request, arena);
+            }
+        };
+
+        /**
+         * @brief dense table of routes
+         *
+         * @tparam Routes route<...>, a cmd can be routed once
+         */
+        template <typename... Routes>
+        class table
+        {
+        public:
+            /**
+             * @brief
+             *
+             * @param connection
+             * @param package
+             * @return int -1 no route or handler failed
+             */
+            static int dispatch(tubekit::connection::stream_connection &connection, const package_view &package)
+            {
+                static_assert(unique(), "a ProtoCmd is routed more than once");
+                static constexpr std::array<handler, ProtoCmd_ARRAYSIZE> handlers = make();
+                if (package.cmd < 0 || package.cmd >= ProtoCmd_ARRAYSIZE || !handlers[package.cmd])
+                {
+                    return -1;
+                }
+                return handlers[package.cmd](connection, package.body, get_arena());
+            }
+
+        private:
+            static constexpr std::array<handler, ProtoCmd_ARRAYSIZE> make()
+            {
+                std::array<handler, ProtoCmd_ARRAYSIZE> result{};
+                ((result[Routes::cmd] = &Routes::invoke), ...);
+                return result;
+            }
+
+            static constexpr bool unique()
+            {
+                std::array<int, ProtoCmd_ARRAYSIZE> count{};
+                ((count[Routes::cmd]++), ...);
+                for (int n : count)
+                {
+                    if (n > 1)
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+        };
+
+    public:
+        /**
+         * @brief read cmd and body of a serialized ProtoPackage without copying, unknown fields are skipped
+         *
+         * @param data
+         * @param len
+         * @param out
+         * @return true
+         * @return false malformed
+         */
+        static bool parse_package(const char *data, size_t len, package_view &out);
+
+        /**
+         * @brief ProtoPackage of cmd and message is serialized straight into a stream_codec frame,
+         *        message is not serialized into a body string first
+         *
+         * @tparam T
+         * @param connection its codec frames the package
+         * @param cmd
+         * @param message
+         * @param frame
+         * @return true
+         * @return false
+         */
+        template <typename T>
+        static bool pack_package(tubekit::connection::stream_connection &connection, ProtoCmd cmd, const T &message, std::string &frame)
+        {
+            const size_t body_len = message.ByteSizeLong();
+            size_t payload_offset = 0;
+            size_t payload_len = 0;
+            char *body = begin_package(connection, cmd, body_len, frame, payload_offset, payload_len);
+            if (body_len > 0)
+            {
+                // sizes are cached by ByteSizeLong
+                message.SerializeWithCachedSizesToArray(reinterpret_cast<uint8_t *>(body));
+            }
+            end_package(connection, frame, payload_offset, payload_len);
+            return true;
+        }
+
+        /**
+         * @brief arena of the calling worker thread
+         *
+         * @return google::protobuf::Arena&
+         */
+        static google::protobuf::Arena &get_arena();
+
+        /**
+         * @brief free messages of the calling worker thread, its first block is kept
+         *
+         */
+        static void reset_arena();
+
+    private:
+        static char *begin_package(tubekit::connection::stream_connection &connection, ProtoCmd cmd, size_t body_len, std::string &frame, size_t &payload_offset, size_t &payload_len);
+        static void end_package(tubekit::connection::stream_connection &connection, std::string &frame, size_t payload_offset, size_t payload_len);
+    };
+}
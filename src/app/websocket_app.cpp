@@ -5,10 +5,14 @@
 #include "connection/connection_mgr.h"
 #include <arpa/inet.h>
 #include "app/lua_plugin.h"
+#include "thread/worker_pool.h"
+#include "socket/admission.h"
 
 using namespace tubekit::app;
 using namespace tubekit::utility;
 using namespace tubekit::connection;
+using tubekit::thread::letter;
+using tubekit::thread::worker_pool;
 
 namespace tubekit::app
 {
@@ -119,136 +123,77 @@ void websocket_app::on_tick()
 void websocket_app::process_connection(tubekit::connection::websocket_connection &m_websocket_connection)
 {
     // LOG_ERROR("process_connection");
-    uint64_t all_data_len = m_websocket_connection.m_recv_buffer.can_readable_size();
-    if (all_data_len == 0)
+    websocket_decoder &decoder = m_websocket_connection.decoder;
+    while (!m_websocket_connection.everything_end)
     {
-        // LOG_ERROR("all_data_len <= 0");
-        return;
-    }
-    const char *data = m_websocket_connection.m_recv_buffer.force_get_read_ptr();
-
-    size_t index = 0;
+        uint64_t all_data_len = m_websocket_connection.m_recv_buffer.can_readable_size();
+        char *data = m_websocket_connection.m_recv_buffer.force_get_read_ptr();
 
-    while (true)
-    {
-        if (index >= all_data_len)
+        size_t consumed = 0;
+        websocket_decoder::message message;
+        int res = decoder.next(data, all_data_len, consumed, message);
+        if (res == websocket_decoder::FAILED)
         {
+            LOG_ERROR("websocket frame error, close %d", decoder.get_close_code());
+            send_close(m_websocket_connection, decoder.get_close_code());
+            m_websocket_connection.everything_end = true;
             break;
         }
-
-        size_t start_index = index;
-
-        websocket_frame frame;
-        uint8_t opcode = (uint8_t)data[index] & 0x0f;
-        websocket_frame_type type = n_2_websocket_frame_type(opcode);
-
-        if (type != websocket_frame_type::TEXT_FRAME && type != websocket_frame_type::BINARY_FRAME)
+        if (res == websocket_decoder::NEED_MORE)
         {
-            m_websocket_connection.mark_close();
+            m_websocket_connection.m_recv_buffer.read_ptr_move_n(consumed);
             break;
         }
 
-        frame.fin = (data[index] & 0x80) != 0;
-        frame.opcode = data[index] & 0x0F;
-        index++;
-        if (index >= all_data_len)
+        if (res == websocket_decoder::CONTROL)
         {
-            LOG_ERROR("index[%llu] >= all_data_len[%llu]", index, all_data_len);
-            break;
+            process_control(m_websocket_connection, message);
         }
-
-        frame.mask = (data[index] & 0x80) != 0;
-        frame.payload_length = data[index] & 0x7F;
-        index++;
-        if (index >= all_data_len)
+        else if (!singleton<socket::admission>::instance()->allow_request(m_websocket_connection.get_socket_ptr()->get_admission()))
         {
-            LOG_ERROR("index[%llu] >= all_data_len[%llu]", index, all_data_len);
+            // request tokens of the client address are used up
+            send_close(m_websocket_connection, 1008);
+            m_websocket_connection.everything_end = true;
             break;
         }
-
-        if (frame.payload_length == 126)
-        {
-            frame.payload_length = 0;
-            if (index + 2 >= all_data_len)
-            {
-                LOG_ERROR("index[%llu] >= all_data_len[%llu]", index + 2, all_data_len);
-                break;
-            }
-            uint16_t tmp = 0;
-            u_char *ph;
-            ph = (u_char *)&tmp;
-            *ph++ = data[index];
-            *ph++ = data[index + 1];
-            tmp = ntohs(tmp);
-            frame.payload_length = tmp;
-            index += 2;
-        }
-        else if (frame.payload_length == 127)
+        else
         {
-            frame.payload_length = 0;
-            if (index + 8 >= all_data_len)
-            {
-                LOG_ERROR("index[%llu] >= all_data_len[%llu]", index + 8, all_data_len);
-                break;
-            }
-            uint32_t tmp = 0;
-            u_char *ph = (u_char *)&tmp;
-            *ph++ = data[index++];
-            *ph++ = data[index++];
-            *ph++ = data[index++];
-            *ph++ = data[index++];
-            frame.payload_length = ntohl(tmp);
-            frame.payload_length = frame.payload_length << 32;
-            ph = (u_char *)&tmp;
-            *ph++ = data[index++];
-            *ph++ = data[index++];
-            *ph++ = data[index++];
-            *ph++ = data[index++];
-            tmp = ntohl(tmp);
-            frame.payload_length = frame.payload_length | tmp;
+            websocket_frame frame;
+            frame.fin = 1;
+            frame.opcode = message.opcode;
+            frame.mask = 1;
+            frame.payload_length = message.payload.size();
+            frame.payload_data = message.payload;
+            process_frame(m_websocket_connection, frame);
         }
+        // the payload view is no longer used
+        m_websocket_connection.m_recv_buffer.read_ptr_move_n(consumed);
+    }
+}
 
-        if (frame.payload_length == 0)
-        {
-            break;
-        }
-
-        if (frame.mask)
-        {
-            if (index + 4 >= all_data_len)
-            {
-                LOG_ERROR("index[%llu] >= all_data_len[%llu]", index + 3, all_data_len);
-                break;
-            }
-            frame.masking_key = {(uint8_t)data[index], (uint8_t)data[index + 1], (uint8_t)data[index + 2], (uint8_t)data[index + 3]};
-            index += 4;
-        }
-        // payload data [data+index,data+index+frame.payload_length]
-        if (index >= all_data_len)
-        {
-            LOG_ERROR("index[%llu] >= all_data_len[%llu]", index, all_data_len);
-            break;
-        }
-        if (index - 1 + frame.payload_length >= all_data_len)
-        {
-            // LOG_ERROR("index - 1 + frame.payload_length=[%llu] >= all_data_len[%llu]", index - 1 + frame.payload_length, all_data_len);
-            break;
-        }
-        std::string payload_data(data + index, frame.payload_length);
-        if (frame.mask)
-        {
-            for (size_t i = 0; i < payload_data.size(); ++i)
-            {
-                payload_data[i] ^= frame.masking_key[i % 4];
-            }
-        }
-        frame.payload_data = std::move(payload_data);
-
-        process_frame(m_websocket_connection, frame);
-
-        m_websocket_connection.m_recv_buffer.read_ptr_move_n(index - start_index + frame.payload_length);
-        index += frame.payload_length;
+void websocket_app::process_control(tubekit::connection::websocket_connection &m_websocket_connection,
+                                    const tubekit::connection::websocket_decoder::message &message)
+{
+    if (message.opcode == websocket_decoder::PING)
+    {
+        uint8_t first_byte = 0x80 | websocket_frame_type_2_n(websocket_frame_type::PONG);
+        send_packet(&m_websocket_connection, first_byte, message.payload.data(), message.payload.size());
     }
+    else if (message.opcode == websocket_decoder::CLOSE)
+    {
+        // echo the status code, then close after it is sent
+        uint8_t first_byte = 0x80 | websocket_frame_type_2_n(websocket_frame_type::CONNECTION_CLOSE_FRAME);
+        send_packet(&m_websocket_connection, first_byte, message.payload.data(), message.payload.size() >= 2 ? 2 : 0);
+        m_websocket_connection.everything_end = true;
+    }
+    // PONG needs nothing
+}
+
+void websocket_app::send_close(tubekit::connection::websocket_connection &m_websocket_connection, uint16_t code)
+{
+    const char payload[2] = {(char)(code >> 8), (char)(code & 0xff)};
+    uint8_t first_byte = 0x80 | websocket_frame_type_2_n(websocket_frame_type::CONNECTION_CLOSE_FRAME);
+    send_packet(&m_websocket_connection, first_byte, payload, sizeof(payload));
 }
 
 void websocket_app::process_frame(tubekit::connection::websocket_connection &m_websocket_connection,
@@ -260,12 +205,8 @@ void websocket_app::process_frame(tubekit::connection::websocket_connection &m_w
     global_player_copy = global_player;
     global_player_mutex.unlock();
 
-    uint8_t first_byte = 0x80 | websocket_frame_type_2_n(websocket_frame_type::TEXT_FRAME);
-
-    for (auto player : global_player_copy)
-    {
-        websocket_app::send_packet(nullptr, first_byte, frame.payload_data.c_str(), frame.payload_length, player);
-    }
+    uint8_t first_byte = 0x80 | frame.opcode;
+    websocket_app::broadcast(first_byte, frame.payload_data.data(), frame.payload_data.size(), global_player_copy);
 }
 
 void websocket_app::on_close_connection(tubekit::connection::websocket_connection &m_websocket_connection)
@@ -294,48 +235,75 @@ bool websocket_app::send_packet(tubekit::connection::websocket_connection *m_web
     {
         return false;
     }
-    size_t message_length = data_len;
-    std::vector<uint8_t> frame;
-    frame.push_back(first_byte);
 
-    if (message_length <= 125)
-    {
-        frame.push_back(static_cast<uint8_t>(message_length));
-    }
-    else if (message_length <= 0xFFFF)
+    if (0 == gid && m_websocket_connection)
     {
-        frame.push_back(126);
-        frame.push_back((message_length >> 8) & 0xFF);
-        frame.push_back(message_length & 0xFF);
+        return m_websocket_connection->send_message(first_byte, data, data_len);
     }
     else
     {
-        frame.push_back(127);
-        for (int i = 7; i >= 0; --i)
+        // the connection of gid is written only by its own worker
+        letter item;
+        item.gid = gid;
+        item.deliver = deliver_message;
+        item.data.assign(data, data_len);
+        item.flag = first_byte;
+        if (!singleton<worker_pool>::instance()->post(std::move(item)))
         {
-            frame.push_back((message_length >> (8 * i)) & 0xFF);
+            LOG_ERROR("mailbox full, message to gid[%llu] dropped", gid);
+            return false;
         }
+        return true;
     }
 
-    frame.insert(frame.end(), data, data + data_len);
+    return false;
+}
 
-    if (0 == gid && m_websocket_connection)
+size_t websocket_app::broadcast(uint8_t first_byte, const char *data, size_t data_len, const std::set<uint64_t> &gids)
+{
+    if (!data && data_len > 0)
     {
-        return m_websocket_connection->send((const char *)frame.data(), frame.size());
+        return 0;
     }
-    else
+
+    auto message = std::make_shared<broadcast_message>();
+    message->first_byte = first_byte;
+    message->payload.assign(data, data_len);
+
+    size_t queued = 0;
+    for (auto gid : gids)
     {
-        bool res = false;
-        singleton<connection_mgr>::instance()->if_exist(
-            gid,
-            [&res, &frame](uint64_t key, std::pair<tubekit::socket::socket *, tubekit::connection::connection *> value)
-            {
-                tubekit::connection::websocket_connection *p_wsconn = (tubekit::connection::websocket_connection *)(value.second);
-                res = p_wsconn->send((const char *)frame.data(), frame.size());
-            },
-            nullptr);
-        return res;
+        letter item;
+        item.gid = gid;
+        item.deliver = deliver_message;
+        item.shared = message;
+        if (singleton<worker_pool>::instance()->post(std::move(item)))
+        {
+            queued++;
+        }
+    }
+    if (queued < gids.size())
+    {
+        LOG_ERROR("mailbox full, broadcast to %llu of %llu players", queued, gids.size());
     }
+    return queued;
+}
 
-    return false;
+void websocket_app::deliver_message(tubekit::thread::letter &item)
+{
+    singleton<connection_mgr>::instance()->if_exist(
+        item.gid,
+        [&item](uint64_t key, std::pair<tubekit::socket::socket *, tubekit::connection::connection *> value)
+        {
+            tubekit::connection::websocket_connection *p_wsconn = (tubekit::connection::websocket_connection *)(value.second);
+            if (item.shared)
+            {
+                broadcast_message *message = (broadcast_message *)item.shared.get();
+                p_wsconn->send_message(message->first_byte, message->payload.data(), message->payload.size(), &message->cache);
+            }
+            else
+            {
+                p_wsconn->send_message(item.flag, item.data.data(), item.data.size());
+            }
+        });
 }
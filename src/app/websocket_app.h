@@ -1,10 +1,16 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <cstdint>
 #include "connection/websocket_connection.h"
 #include <set>
 #include "thread/mutex.h"
 
+namespace tubekit::thread
+{
+    struct letter;
+}
+
 // thread not safe : The function will be called by multiple threads simultaneously.
 // thread safe : The function can only be called by the main thread or can be used in any thread.
 
@@ -17,12 +23,12 @@ namespace tubekit
         public:
             struct websocket_frame
             {
-                uint8_t fin;
-                uint8_t opcode;
-                uint8_t mask;
-                uint64_t payload_length;
-                std::vector<uint8_t> masking_key;
-                std::string payload_data;
+                uint8_t fin{0};
+                uint8_t opcode{0};
+                uint8_t mask{0};
+                uint64_t payload_length{0};
+                uint8_t masking_key[4]{0};
+                std::string_view payload_data{}; // unmasked in place, valid until process_frame returns
             };
 
             enum class websocket_frame_type
@@ -58,6 +64,23 @@ namespace tubekit
             static void process_frame(tubekit::connection::websocket_connection &m_websocket_connection,
                                       websocket_frame &frame);
 
+            /**
+             * @brief thread not safe, ping is answered with pong and close is echoed, the app is not involved
+             *
+             * @param m_websocket_connection
+             * @param message
+             */
+            static void process_control(tubekit::connection::websocket_connection &m_websocket_connection,
+                                        const tubekit::connection::websocket_decoder::message &message);
+
+            /**
+             * @brief thread not safe, queue a close frame with status code
+             *
+             * @param m_websocket_connection
+             * @param code such as 1002
+             */
+            static void send_close(tubekit::connection::websocket_connection &m_websocket_connection, uint16_t code);
+
             /**
              * @brief thread not safe
              *
@@ -73,7 +96,7 @@ namespace tubekit
             static void on_new_connection(tubekit::connection::websocket_connection &m_websocket_connection);
 
             /**
-             * @brief thread safe
+             * @brief thread safe, messages to gid are posted to the mailbox of its worker, true means queued
              *
              * @param m_websocket_connection
              * @param first_byte
@@ -89,6 +112,17 @@ namespace tubekit
                                     size_t data_len,
                                     uint64_t gid = 0);
 
+            /**
+             * @brief thread safe, the message is shared by letters to all gids, its frames are built or compressed once
+             *
+             * @param first_byte
+             * @param data
+             * @param data_len
+             * @param gids
+             * @return size_t number of letters queued
+             */
+            static size_t broadcast(uint8_t first_byte, const char *data, size_t data_len, const std::set<uint64_t> &gids);
+
             /**
              * @brief thread safe
              *
@@ -108,6 +142,23 @@ namespace tubekit
              */
             static void on_tick();
 
+        private:
+            // message of broadcast, shared by its letters
+            struct broadcast_message
+            {
+                uint8_t first_byte{0};
+                std::string payload{};
+                tubekit::connection::websocket_connection::frame_cache cache;
+            };
+
+            /**
+             * @brief runs on the worker of item.gid
+             *
+             * @param item
+             */
+            static void deliver_message(tubekit::thread::letter &item);
+
+        public:
             static std::set<uint64_t> global_player;
             static tubekit::thread::mutex global_player_mutex;
         };
@@ -1,6 +1,12 @@
 #include "connection/connection.h"
+#include "socket/socket_handler.h"
+#include "utility/singleton.h"
 
 using tubekit::connection::connection;
+using tubekit::socket::socket_handler;
+using tubekit::utility::singleton;
+
+thread_local connection *connection::corked{nullptr};
 
 connection::connection(tubekit::socket::socket *socket_ptr) : close_flag(false),
                                                               socket_ptr(socket_ptr)
@@ -44,6 +50,7 @@ void connection::reuse()
     this->close_flag = false;
     this->socket_ptr = nullptr;
     this->gid = 0;
+    this->flush_pending = false;
 }
 
 void connection::set_gid(uint64_t gid)
@@ -54,4 +61,33 @@ void connection::set_gid(uint64_t gid)
 uint64_t connection::get_gid()
 {
     return this->gid;
+}
+
+void connection::schedule_flush()
+{
+    if (corked == this)
+    {
+        return;
+    }
+    // the pending task flushes whatever is queued when it runs
+    if (flush_pending.exchange(true))
+    {
+        return;
+    }
+    singleton<socket_handler>::instance()->do_task(get_gid(), false, true);
+}
+
+void connection::cork()
+{
+    corked = this;
+    // data queued from now on may be after the flush of pending task
+    flush_pending = false;
+}
+
+void connection::uncork()
+{
+    if (corked == this)
+    {
+        corked = nullptr;
+    }
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include <atomic>
 #include "socket/socket.h"
 
 namespace tubekit
@@ -33,9 +34,26 @@ namespace tubekit
             void set_gid(uint64_t gid);
             uint64_t get_gid();
 
+            /**
+             * @brief after queueing data to send, let a task of this connection flush it,
+             *        at most one flush task is pending, and none is needed while corked on the calling thread
+             *
+             */
+            void schedule_flush();
+
+            /**
+             * @brief called by the task of this connection around processing, on its worker thread,
+             *        sends made meanwhile are flushed together by the task after uncork
+             *
+             */
+            void cork();
+            void uncork();
+
         private:
             bool close_flag{false};
             uint64_t gid{0};
+            std::atomic<bool> flush_pending{false};
+            static thread_local connection *corked; // connection whose task runs on this thread
 
         protected:
             tubekit::socket::socket *socket_ptr{nullptr};
@@ -2,6 +2,7 @@
 #include "thread/auto_lock.h"
 #include "app/stream_app.h"
 #include "app/websocket_app.h"
+#include "app/proxy_app.h"
 #include "task/task_type.h"
 #include "utility/object_pool.h"
 #include "utility/singleton.h"
@@ -11,10 +12,12 @@
 
 using tubekit::app::stream_app;
 using tubekit::app::websocket_app;
+using tubekit::app::proxy_app;
 using tubekit::connection::connection;
 using tubekit::connection::connection_mgr;
 using tubekit::connection::http_connection;
-using tubekit::connection::safe_mapping;
+using tubekit::connection::proxy_connection;
+using tubekit::connection::handle_table;
 using tubekit::connection::stream_connection;
 using tubekit::connection::websocket_connection;
 using tubekit::task::task_type;
@@ -22,129 +25,112 @@ using tubekit::utility::object_pool;
 using tubekit::utility::singleton;
 using tubekit::thread::auto_lock;
 
-safe_mapping::safe_mapping()
+handle_table::handle_table()
 {
 }
 
-safe_mapping::~safe_mapping()
+handle_table::~handle_table()
 {
+    if (m_slots)
+    {
+        delete[] m_slots;
+    }
 }
 
-void safe_mapping::if_exist(uint64_t gid,
-                            std::function<void(uint64_t, std::pair<socket::socket *, connection *>)> succ_callback,
-                            std::function<void(uint64_t)> failed_callback)
+void handle_table::init(uint32_t capacity)
 {
-    auto_lock raiilock(lock);
-    auto iter = gid2pair.find(gid);
-    if (iter != gid2pair.end())
-    {
-        if (succ_callback)
-        {
-            succ_callback(iter->first, iter->second);
-        }
-    }
-    else
+    m_capacity = capacity;
+    m_slots = new slot[capacity];
+    m_free_slots.init(capacity);
+    for (uint32_t i = 0; i < capacity; i++)
     {
-        if (failed_callback)
-        {
-            failed_callback(gid);
-        }
+        m_free_slots.push(std::move(i));
     }
 }
 
-void safe_mapping::remove(uint64_t gid,
-                          std::function<void(uint64_t, std::pair<socket::socket *, connection *>)> succ_callback,
-                          std::function<void(uint64_t)> failed_callback)
+uint64_t handle_table::insert(std::pair<socket::socket *, connection *> value)
 {
-    auto_lock raiilock(lock);
-    auto iter = gid2pair.find(gid);
-    if (iter != gid2pair.end())
-    {
-        auto first = iter->first;
-        auto second = iter->second;
-        gid2pair.erase(iter);
-        if (succ_callback)
-        {
-            succ_callback(first, second);
-        }
+    uint32_t index = 0;
+    if (!m_free_slots.pop(index))
+    {
+        return 0;
     }
-    else
+    slot &item = m_slots[index];
+    // 0 is not a gid
+    if (0 == ++item.generation)
     {
-        if (failed_callback)
-        {
-            failed_callback(gid);
-        }
+        item.generation = 1;
     }
+    const uint64_t gid = ((uint64_t)item.generation << 32) | index;
+    item.socket_ptr = value.first;
+    item.connection_ptr = value.second;
+    value.first->set_gid(gid);
+    value.second->set_gid(gid);
+    item.gid.store(gid, std::memory_order_release);
+    return gid;
 }
 
-void safe_mapping::insert(uint64_t gid,
-                          std::pair<socket::socket *, connection *> value,
-                          std::function<void(uint64_t, std::pair<socket::socket *, connection *>)> succ_callback,
-                          std::function<void(uint64_t, std::pair<socket::socket *, connection *>)> failed_callback)
+bool handle_table::erase(uint64_t gid, std::pair<socket::socket *, connection *> &value)
 {
-    auto_lock raiilock(lock);
-    auto iter = gid2pair.find(gid);
-    if (iter != gid2pair.end())
+    const uint64_t index = gid & 0xffffffff;
+    if (index >= m_capacity || 0 == gid)
     {
-        if (failed_callback)
-        {
-            failed_callback(gid, value);
-        }
+        return false;
     }
-    else
+    slot &item = m_slots[index];
+    uint64_t expected = gid;
+    if (!item.gid.compare_exchange_strong(expected, 0, std::memory_order_acq_rel))
     {
-        gid2pair[gid] = value;
-        if (succ_callback)
-        {
-            succ_callback(gid, value);
-        }
+        return false;
     }
+    value = {item.socket_ptr, item.connection_ptr};
+    return true;
 }
 
-void connection_mgr::if_exist(uint64_t gid,
-                              std::function<void(uint64_t, std::pair<socket::socket *, connection *>)> succ_callback,
-                              std::function<void(uint64_t)> failed_callback)
+void handle_table::free(uint64_t gid)
 {
-    uint64_t hash_idx = gid % m_thread_size;
-    m_safe_mapping[hash_idx].if_exist(gid, succ_callback, failed_callback);
+    uint32_t index = (uint32_t)(gid & 0xffffffff);
+    // a slot is in the mailbox at most once, it never gets full
+    m_free_slots.push(std::move(index));
 }
 
-void connection_mgr::remove(uint64_t gid,
-                            std::function<void(uint64_t, std::pair<socket::socket *, connection *>)> succ_callback,
-                            std::function<void(uint64_t)> failed_callback)
+void connection_mgr::on_remove(uint64_t gid, std::pair<socket::socket *, connection *> value)
 {
-    uint64_t hash_idx = gid % m_thread_size;
-    m_safe_mapping[hash_idx].remove(
-        gid,
-        [&succ_callback](uint64_t key, std::pair<socket::socket *, connection *> value)
+    try
+    {
+        if (is_stream(value.second))
         {
-            try
-            {
-                if (is_stream(value.second))
-                {
-                    stream_app::on_close_connection(*convert_to_stream(value.second));
-                }
-                if (is_websocket(value.second))
-                {
-                    websocket_app::on_close_connection(*convert_to_websocket(value.second));
-                }
-                succ_callback(key, value);
-            }
-            catch (const std::exception &e)
-            {
-                LOG_ERROR(e.what());
-            }
-        },
-        failed_callback);
+            stream_app::on_close_connection(*convert_to_stream(value.second));
+        }
+        if (is_websocket(value.second))
+        {
+            websocket_app::on_close_connection(*convert_to_websocket(value.second));
+        }
+        if (is_proxy(value.second))
+        {
+            proxy_app::on_close_connection(*convert_to_proxy(value.second));
+        }
+    }
+    catch (const std::exception &e)
+    {
+        LOG_ERROR(e.what());
+    }
+}
+
+uint64_t connection_mgr::insert(std::pair<socket::socket *, connection *> value)
+{
+    return m_handles.insert(value);
 }
 
-void connection_mgr::insert(uint64_t gid,
-                            std::pair<socket::socket *, connection *> value,
-                            std::function<void(uint64_t, std::pair<socket::socket *, connection *>)> succ_callback,
-                            std::function<void(uint64_t, std::pair<socket::socket *, connection *>)> failed_callback)
+bool connection_mgr::discard(uint64_t gid)
 {
-    uint64_t hash_idx = gid % m_thread_size;
-    m_safe_mapping[hash_idx].insert(gid, value, succ_callback, failed_callback);
+    std::pair<socket::socket *, connection *> value;
+    if (!m_handles.erase(gid, value))
+    {
+        return false;
+    }
+    m_handles.free(gid);
+    return true;
 }
 
 connection_mgr::connection_mgr()
@@ -153,10 +139,6 @@ connection_mgr::connection_mgr()
 
 connection_mgr::~connection_mgr()
 {
-    if (m_safe_mapping)
-    {
-        delete[] m_safe_mapping;
-    }
 }
 
 void connection_mgr::on_new_connection(uint64_t gid)
@@ -175,13 +157,16 @@ void connection_mgr::on_new_connection(uint64_t gid)
                 {
                     websocket_app::on_new_connection(*convert_to_websocket(value.second));
                 }
+                if (is_proxy(value.second))
+                {
+                    proxy_app::on_new_connection(*convert_to_proxy(value.second));
+                }
             }
             catch (const std::exception &e)
             {
                 LOG_ERROR(e.what());
             }
-        },
-        nullptr);
+        });
 }
 
 void connection_mgr::mark_close(uint64_t gid)
@@ -191,8 +176,7 @@ void connection_mgr::mark_close(uint64_t gid)
         [](uint64_t key, std::pair<tubekit::socket::socket *, tubekit::connection::connection *> value)
         {
             value.second->mark_close();
-        },
-        nullptr);
+        });
 }
 
 http_connection *connection_mgr::convert_to_http(connection *conn_ptr)
@@ -273,11 +257,36 @@ bool connection_mgr::is_websocket(connection *conn_ptr)
     return false;
 }
 
-int connection_mgr::init(tubekit::task::task_type task_type, uint32_t thread_size)
+proxy_connection *connection_mgr::convert_to_proxy(connection *conn_ptr)
+{
+    if (nullptr == conn_ptr)
+    {
+        return nullptr;
+    }
+    if (is_proxy(conn_ptr))
+    {
+        return (proxy_connection *)conn_ptr;
+    }
+    return nullptr;
+}
+
+bool connection_mgr::is_proxy(connection *conn_ptr)
+{
+    if (nullptr == conn_ptr)
+    {
+        return false;
+    }
+    if (typeid(*conn_ptr) == typeid(proxy_connection))
+    {
+        return true;
+    }
+    return false;
+}
+
+int connection_mgr::init(tubekit::task::task_type task_type, uint32_t capacity)
 {
     m_task_type = task_type;
-    m_thread_size = thread_size;
-    m_safe_mapping = new safe_mapping[thread_size];
+    m_handles.init(capacity);
     return 0;
 }
 
@@ -307,6 +316,11 @@ void connection_mgr::release(connection *connection_ptr)
         // LOG_DEBUG("connection space:%d", singleton<object_pool<websocket_connection>>::instance()->space());
         break;
     }
+    case task_type::PROXY_TASK:
+    {
+        singleton<object_pool<proxy_connection>>::instance()->release(dynamic_cast<proxy_connection *>(connection_ptr));
+        break;
+    }
     default:
         break;
     }
@@ -332,6 +346,11 @@ connection *connection_mgr::create()
         p_connection = singleton<object_pool<websocket_connection>>::instance()->allocate();
         break;
     }
+    case task_type::PROXY_TASK:
+    {
+        p_connection = singleton<object_pool<proxy_connection>>::instance()->allocate();
+        break;
+    }
     default:
         break;
     }
@@ -1,40 +1,100 @@
 #pragma once
 
-#include <map>
-#include <unordered_map>
-#include <vector>
-#include <functional>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <stdexcept>
+#include <tubekit-log/logger.h>
 #include "thread/mutex.h"
+#include "thread/mailbox.h"
 #include "connection/connection.h"
 #include "connection/http_connection.h"
 #include "connection/stream_connection.h"
 #include "connection/websocket_connection.h"
+#include "connection/proxy_connection.h"
 #include "task/task_type.h"
 #include "socket/socket.h"
 
 namespace tubekit::connection
 {
-    class safe_mapping
+    /**
+     * @brief slots of connections, gid = generation << 32 | slot index,
+     *        a slot gets a new generation each time it is used so a gid of a closed connection never matches again
+     *
+     * insert runs on the main thread, remove on the worker of gid, lookups are atomic loads without lock,
+     * the pointers of a slot are written before its gid is published and only by insert
+     */
+    class handle_table
     {
-    private:
-        friend class connection_mgr;
-        safe_mapping();
-        ~safe_mapping();
-        void if_exist(uint64_t gid,
-                      std::function<void(uint64_t, std::pair<socket::socket *, connection *>)> succ_callback,
-                      std::function<void(uint64_t)> failed_callback);
-
-        void remove(uint64_t gid,
-                    std::function<void(uint64_t, std::pair<socket::socket *, connection *>)> succ_callback,
-                    std::function<void(uint64_t)> failed_callback);
-
-        void insert(uint64_t gid,
-                    std::pair<socket::socket *, connection *> value,
-                    std::function<void(uint64_t, std::pair<socket::socket *, connection *>)> succ_callback,
-                    std::function<void(uint64_t, std::pair<socket::socket *, connection *>)> failed_callback);
-
-        std::unordered_map<uint64_t, std::pair<socket::socket *, connection *>> gid2pair{};
-        tubekit::thread::mutex lock;
+    public:
+        handle_table();
+        ~handle_table();
+
+        /**
+         * @brief not thread safe
+         *
+         * @param capacity
+         */
+        void init(uint32_t capacity);
+
+        /**
+         * @brief main thread only
+         *
+         * @param value
+         * @return uint64_t gid, 0 when full
+         */
+        uint64_t insert(std::pair<socket::socket *, connection *> value);
+
+        /**
+         * @brief
+         *
+         * @param gid
+         * @param value
+         * @return true
+         * @return false gid is closed or never existed
+         */
+        inline bool find(uint64_t gid, std::pair<socket::socket *, connection *> &value) const
+        {
+            const uint64_t index = gid & 0xffffffff;
+            if (index >= m_capacity || m_slots[index].gid.load(std::memory_order_acquire) != gid || 0 == gid)
+            {
+                return false;
+            }
+            value = {m_slots[index].socket_ptr, m_slots[index].connection_ptr};
+            return true;
+        }
+
+        /**
+         * @brief worker of gid only, the slot is not used again before free is called
+         *
+         * @param gid
+         * @param value
+         * @return true
+         * @return false
+         */
+        bool erase(uint64_t gid, std::pair<socket::socket *, connection *> &value);
+
+        /**
+         * @brief slot of an erased gid can be used by insert
+         *
+         * @param gid
+         */
+        void free(uint64_t gid);
+
+    protected:
+        // protected so tests can move a generation near its wrap
+        struct slot
+        {
+            std::atomic<uint64_t> gid{0}; // 0 when free
+            socket::socket *socket_ptr{nullptr};
+            connection *connection_ptr{nullptr};
+            uint32_t generation{0};
+        };
+
+        slot *m_slots{nullptr};
+        uint32_t m_capacity{0};
+        // freed by workers, taken by main thread
+        tubekit::thread::mailbox<uint32_t> m_free_slots;
     };
 
     class connection_mgr
@@ -43,28 +103,80 @@ namespace tubekit::connection
         connection_mgr();
         ~connection_mgr();
 
-        // need lock method
     public:
-        void if_exist(uint64_t gid,
-                      std::function<void(uint64_t, std::pair<socket::socket *, connection *>)> succ_callback,
-                      std::function<void(uint64_t)> failed_callback);
-
-        void remove(uint64_t gid,
-                    std::function<void(uint64_t, std::pair<socket::socket *, connection *>)> succ_callback,
-                    std::function<void(uint64_t)> failed_callback);
-
-        void insert(uint64_t gid,
-                    std::pair<socket::socket *, connection *> value,
-                    std::function<void(uint64_t, std::pair<socket::socket *, connection *>)> succ_callback,
-                    std::function<void(uint64_t, std::pair<socket::socket *, connection *>)> failed_callback);
+        /**
+         * @brief thread safe, visitor(gid, {socket, connection}) is called when gid is alive,
+         *        connections are removed only by the worker of gid, so it is safe to use them there
+         *
+         * @tparam Visitor
+         * @param gid
+         * @param visitor
+         * @return true
+         * @return false
+         */
+        template <typename Visitor>
+        bool if_exist(uint64_t gid, Visitor &&visitor)
+        {
+            std::pair<socket::socket *, connection *> value;
+            if (!m_handles.find(gid, value))
+            {
+                return false;
+            }
+            visitor(gid, value);
+            return true;
+        }
+
+        /**
+         * @brief worker of gid only, on_close_connection of app runs before visitor
+         *
+         * @tparam Visitor
+         * @param gid
+         * @param visitor
+         * @return true
+         * @return false
+         */
+        template <typename Visitor>
+        bool remove(uint64_t gid, Visitor &&visitor)
+        {
+            std::pair<socket::socket *, connection *> value;
+            if (!m_handles.erase(gid, value))
+            {
+                return false;
+            }
+            on_remove(gid, value);
+            try
+            {
+                visitor(gid, value);
+            }
+            catch (const std::exception &e)
+            {
+                LOG_ERROR(e.what());
+            }
+            m_handles.free(gid);
+            return true;
+        }
+
+        /**
+         * @brief main thread only, gid is given to socket and connection before they can be found
+         *
+         * @param value
+         * @return uint64_t gid, 0 when no slot is free
+         */
+        uint64_t insert(std::pair<socket::socket *, connection *> value);
+        /**
+         * @brief main thread only, gid inserted but given to no worker yet is dropped without on_close_connection of app,
+         *        its socket and connection are still to be released by the caller
+         *
+         * @param gid
+         * @return true
+         * @return false
+         */
+        bool discard(uint64_t gid);
         void on_new_connection(uint64_t gid);
         void mark_close(uint64_t gid);
 
-        safe_mapping *m_safe_mapping{nullptr};
-        uint32_t m_thread_size{0};
-
     public:
-        int init(tubekit::task::task_type task_type, uint32_t thread_size);
+        int init(tubekit::task::task_type task_type, uint32_t capacity);
 
     public:
         connection *create();
@@ -74,11 +186,17 @@ namespace tubekit::connection
         static http_connection *convert_to_http(connection *conn_ptr);
         static stream_connection *convert_to_stream(connection *conn_ptr);
         static websocket_connection *convert_to_websocket(connection *conn_ptr);
+        static proxy_connection *convert_to_proxy(connection *conn_ptr);
         static bool is_http(connection *conn_ptr);
         static bool is_stream(connection *conn_ptr);
         static bool is_websocket(connection *conn_ptr);
+        static bool is_proxy(connection *conn_ptr);
+
+    private:
+        void on_remove(uint64_t gid, std::pair<socket::socket *, connection *> value);
 
     private:
+        handle_table m_handles;
         tubekit::task::task_type m_task_type{tubekit::task::task_type::NONE};
         tubekit::thread::mutex m_mutex;
     };
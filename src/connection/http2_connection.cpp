@@ -0,0 +1,942 @@
+#include "connection/http2_connection.h"
+
+#include <cstring>
+#include <climits>
+#include <new>
+#include <stdexcept>
+#include <tubekit-log/logger.h>
+
+#include "connection/http_connection.h"
+#include "server/server.h"
+#include "socket/admission.h"
+#include "thread/worker.h"
+#include "utility/singleton.h"
+
+using tubekit::connection::http2_connection;
+using tubekit::connection::http_connection;
+using tubekit::utility::hpack;
+using tubekit::utility::singleton;
+
+namespace
+{
+    enum frame_type : uint8_t
+    {
+        DATA = 0x0,
+        HEADERS = 0x1,
+        PRIORITY = 0x2,
+        RST_STREAM = 0x3,
+        SETTINGS = 0x4,
+        PUSH_PROMISE = 0x5,
+        PING = 0x6,
+        GOAWAY = 0x7,
+        WINDOW_UPDATE = 0x8,
+        CONTINUATION = 0x9
+    };
+
+    enum frame_flag : uint8_t
+    {
+        END_STREAM = 0x1,
+        ACK = 0x1,
+        END_HEADERS = 0x4,
+        PADDED = 0x8,
+        PRIORITY_FLAG = 0x20
+    };
+
+    enum settings_id : uint16_t
+    {
+        HEADER_TABLE_SIZE = 0x1,
+        ENABLE_PUSH = 0x2,
+        MAX_CONCURRENT_STREAMS = 0x3,
+        INITIAL_WINDOW_SIZE = 0x4,
+        MAX_FRAME_SIZE = 0x5
+    };
+
+    constexpr int64_t max_window = 0x7fffffff;
+    constexpr size_t frame_header_size = 9;
+
+    inline uint32_t read_u32(const uint8_t *at)
+    {
+        return ((uint32_t)at[0] << 24) | ((uint32_t)at[1] << 16) | ((uint32_t)at[2] << 8) | (uint32_t)at[3];
+    }
+
+    inline void put_u32(uint8_t *at, uint32_t value)
+    {
+        at[0] = (uint8_t)(value >> 24);
+        at[1] = (uint8_t)(value >> 16);
+        at[2] = (uint8_t)(value >> 8);
+        at[3] = (uint8_t)value;
+    }
+
+    /**
+     * @brief copy into the unused part of stream recv_buffer, request views point there like HTTP/1.1
+     *
+     * @param conn
+     * @param value
+     * @return std::string_view data() is nullptr when recv_buffer is full
+     */
+    std::string_view keep(http_connection &conn, std::string_view value)
+    {
+        if (value.size() > conn.recv_buffer_size - conn.recv_buffer_used)
+        {
+            return std::string_view();
+        }
+        char *at = conn.recv_buffer + conn.recv_buffer_used;
+        memcpy(at, value.data(), value.size());
+        conn.recv_buffer_used += value.size();
+        return std::string_view(at, value.size());
+    }
+
+    // connection-specific header fields are not allowed in HTTP/2
+    bool connection_specific(std::string_view name)
+    {
+        return name == "connection" || name == "keep-alive" || name == "proxy-connection" || name == "transfer-encoding" || name == "upgrade";
+    }
+}
+
+http2_connection::http2_connection(http_connection &owner) : m_owner(owner)
+{
+    uint8_t settings[18];
+    const std::pair<uint16_t, uint32_t> items[] = {
+        {MAX_CONCURRENT_STREAMS, max_concurrent_streams},
+        {INITIAL_WINDOW_SIZE, initial_window_size},
+        {MAX_FRAME_SIZE, max_frame_size}};
+    size_t offset = 0;
+    for (const auto &item : items)
+    {
+        settings[offset] = (uint8_t)(item.first >> 8);
+        settings[offset + 1] = (uint8_t)item.first;
+        put_u32(settings + offset + 2, item.second);
+        offset += 6;
+    }
+    write_frame(SETTINGS, 0, 0, settings, sizeof(settings));
+    write_window_update(0, connection_window_size - 65535);
+}
+
+http2_connection::~http2_connection()
+{
+    while (!m_streams.empty())
+    {
+        close_stream(m_streams.begin()->first);
+    }
+}
+
+std::string_view http2_connection::get_out() const
+{
+    return std::string_view(m_out).substr(m_out_sent);
+}
+
+void http2_connection::out_sent(size_t len)
+{
+    m_out_sent += len;
+    if (m_out_sent == m_out.size())
+    {
+        m_out.clear();
+        m_out_sent = 0;
+    }
+}
+
+bool http2_connection::is_finished() const
+{
+    return m_failed || (m_goaway_received && m_streams.empty());
+}
+
+int http2_connection::on_recv(const char *data, size_t len)
+{
+    if (m_failed)
+    {
+        return -1;
+    }
+    size_t offset = 0;
+    while (m_preface_matched < preface.size() && offset < len)
+    {
+        if (data[offset] != preface[m_preface_matched])
+        {
+            return connection_error(PROTOCOL_ERROR);
+        }
+        m_preface_matched++;
+        offset++;
+    }
+    m_in.append(data + offset, len - offset);
+
+    size_t pos = 0;
+    while (m_in.size() - pos >= frame_header_size)
+    {
+        const uint8_t *at = (const uint8_t *)m_in.data() + pos;
+        const uint32_t frame_len = ((uint32_t)at[0] << 16) | ((uint32_t)at[1] << 8) | (uint32_t)at[2];
+        const uint8_t type = at[3];
+        const uint8_t flags = at[4];
+        const uint32_t stream_id = read_u32(at + 5) & 0x7fffffff;
+        if (frame_len > max_frame_size)
+        {
+            return connection_error(FRAME_SIZE_ERROR);
+        }
+        if (m_in.size() - pos < frame_header_size + frame_len)
+        {
+            break;
+        }
+        if (!m_settings_received && type != SETTINGS)
+        {
+            return connection_error(PROTOCOL_ERROR);
+        }
+        if (m_header_stream_id != 0 && (type != CONTINUATION || stream_id != m_header_stream_id))
+        {
+            return connection_error(PROTOCOL_ERROR);
+        }
+        if (0 != on_frame(type, flags, stream_id, at + frame_header_size, frame_len))
+        {
+            m_in.clear();
+            return -1;
+        }
+        pos += frame_header_size + frame_len;
+    }
+    m_in.erase(0, pos);
+    return 0;
+}
+
+int http2_connection::on_frame(uint8_t type, uint8_t flags, uint32_t stream_id, const uint8_t *payload, size_t len)
+{
+    switch (type)
+    {
+    case DATA:
+    {
+        if (stream_id == 0)
+        {
+            return connection_error(PROTOCOL_ERROR);
+        }
+        // padding counts against windows too
+        const size_t frame_len = len;
+        if ((int64_t)frame_len > m_recv_window)
+        {
+            return connection_error(FLOW_CONTROL_ERROR);
+        }
+        m_recv_window -= frame_len;
+        size_t pad = 0;
+        if (flags & PADDED)
+        {
+            if (len < 1 || payload[0] >= len)
+            {
+                return connection_error(PROTOCOL_ERROR);
+            }
+            pad = payload[0];
+            payload++;
+            len--;
+        }
+        auto iter = m_streams.find(stream_id);
+        if (iter == m_streams.end() || iter->second.remote_closed)
+        {
+            // frames in flight to a stream closed by us are ignored, their bytes are given back to the connection
+            if (stream_id > m_last_stream_id)
+            {
+                return connection_error(PROTOCOL_ERROR);
+            }
+            m_recv_consumed += frame_len;
+            credit(nullptr, false);
+            return 0;
+        }
+        stream &now = iter->second;
+        if ((int64_t)frame_len > now.recv_window)
+        {
+            m_recv_consumed += frame_len;
+            credit(nullptr, false);
+            reset_stream(stream_id, FLOW_CONTROL_ERROR);
+            return 0;
+        }
+        now.recv_window -= frame_len;
+        const int res = on_data(now, (const char *)payload, len - pad, flags & END_STREAM);
+
+        // consumed by app now, stream may be closed by on_data
+        m_recv_consumed += frame_len;
+        credit(nullptr, false);
+        iter = m_streams.find(stream_id);
+        if (iter != m_streams.end() && !iter->second.remote_closed)
+        {
+            iter->second.recv_consumed += frame_len;
+            credit(&iter->second, false);
+        }
+        return res;
+    }
+    case HEADERS:
+    {
+        if (stream_id == 0 || stream_id % 2 == 0)
+        {
+            return connection_error(PROTOCOL_ERROR);
+        }
+        if (flags & PADDED)
+        {
+            if (len < 1 || payload[0] >= len)
+            {
+                return connection_error(PROTOCOL_ERROR);
+            }
+            len -= 1 + payload[0];
+            payload++;
+        }
+        if (flags & PRIORITY_FLAG)
+        {
+            if (len < 5)
+            {
+                return connection_error(FRAME_SIZE_ERROR);
+            }
+            payload += 5;
+            len -= 5;
+        }
+        m_header_block.assign((const char *)payload, len);
+        m_header_end_stream = flags & END_STREAM;
+        if (flags & END_HEADERS)
+        {
+            return on_headers(stream_id, m_header_end_stream);
+        }
+        m_header_stream_id = stream_id;
+        return 0;
+    }
+    case CONTINUATION:
+    {
+        m_header_block.append((const char *)payload, len);
+        if (m_header_block.size() > max_header_block_size)
+        {
+            return connection_error(ENHANCE_YOUR_CALM);
+        }
+        if (flags & END_HEADERS)
+        {
+            m_header_stream_id = 0;
+            return on_headers(stream_id, m_header_end_stream);
+        }
+        return 0;
+    }
+    case PRIORITY:
+        return 0; // streams are served round robin
+    case RST_STREAM:
+    {
+        if (stream_id == 0)
+        {
+            return connection_error(PROTOCOL_ERROR);
+        }
+        if (len != 4)
+        {
+            return connection_error(FRAME_SIZE_ERROR);
+        }
+        close_stream(stream_id);
+        return 0;
+    }
+    case SETTINGS:
+    {
+        if (stream_id != 0)
+        {
+            return connection_error(PROTOCOL_ERROR);
+        }
+        return on_settings(flags, payload, len);
+    }
+    case PUSH_PROMISE:
+        return connection_error(PROTOCOL_ERROR);
+    case PING:
+    {
+        if (stream_id != 0)
+        {
+            return connection_error(PROTOCOL_ERROR);
+        }
+        if (len != 8)
+        {
+            return connection_error(FRAME_SIZE_ERROR);
+        }
+        if (!(flags & ACK))
+        {
+            write_frame(PING, ACK, 0, payload, len);
+        }
+        return 0;
+    }
+    case GOAWAY:
+        m_goaway_received = true;
+        return 0;
+    case WINDOW_UPDATE:
+    {
+        if (len != 4)
+        {
+            return connection_error(FRAME_SIZE_ERROR);
+        }
+        const uint32_t increment = read_u32(payload) & 0x7fffffff;
+        if (stream_id == 0)
+        {
+            if (increment == 0 || m_send_window + increment > max_window)
+            {
+                return connection_error(increment == 0 ? PROTOCOL_ERROR : FLOW_CONTROL_ERROR);
+            }
+            m_send_window += increment;
+            return 0;
+        }
+        auto iter = m_streams.find(stream_id);
+        if (iter == m_streams.end())
+        {
+            return 0;
+        }
+        if (increment == 0 || iter->second.send_window + increment > max_window)
+        {
+            reset_stream(stream_id, increment == 0 ? PROTOCOL_ERROR : FLOW_CONTROL_ERROR);
+            return 0;
+        }
+        iter->second.send_window += increment;
+        return 0;
+    }
+    default:
+        return 0; // unknown frame types are ignored
+    }
+}
+
+int http2_connection::on_settings(uint8_t flags, const uint8_t *payload, size_t len)
+{
+    if (flags & ACK)
+    {
+        return len == 0 ? 0 : connection_error(FRAME_SIZE_ERROR);
+    }
+    if (len % 6 != 0)
+    {
+        return connection_error(FRAME_SIZE_ERROR);
+    }
+    for (size_t offset = 0; offset < len; offset += 6)
+    {
+        const uint16_t id = ((uint16_t)payload[offset] << 8) | payload[offset + 1];
+        const uint32_t value = read_u32(payload + offset + 2);
+        switch (id)
+        {
+        case ENABLE_PUSH:
+            if (value > 1)
+            {
+                return connection_error(PROTOCOL_ERROR);
+            }
+            break;
+        case INITIAL_WINDOW_SIZE:
+        {
+            if (value > max_window)
+            {
+                return connection_error(FLOW_CONTROL_ERROR);
+            }
+            const int64_t delta = (int64_t)value - m_peer_initial_window;
+            for (auto &item : m_streams)
+            {
+                item.second.send_window += delta;
+            }
+            m_peer_initial_window = value;
+            break;
+        }
+        case MAX_FRAME_SIZE:
+            if (value < 16384 || value > 16777215)
+            {
+                return connection_error(PROTOCOL_ERROR);
+            }
+            m_peer_max_frame_size = value;
+            break;
+        default:
+            break; // HEADER_TABLE_SIZE does not matter, responses are never indexed
+        }
+    }
+    m_settings_received = true;
+    write_frame(SETTINGS, ACK, 0, nullptr, 0);
+    return 0;
+}
+
+int http2_connection::on_headers(uint32_t stream_id, bool end_stream)
+{
+    auto iter = m_streams.find(stream_id);
+    if (iter != m_streams.end() || stream_id <= m_last_stream_id)
+    {
+        // trailers, or a block to a stream gone already, decoded to keep the dynamic table in sync and dropped
+        if (0 != m_hpack.decode((const uint8_t *)m_header_block.data(), m_header_block.size(), [](std::string_view, std::string_view) -> bool
+                                { return true; }))
+        {
+            return connection_error(COMPRESSION_ERROR);
+        }
+        if (iter == m_streams.end())
+        {
+            // in flight to a stream closed or refused by us, ignored like its DATA
+            return 0;
+        }
+        if (!end_stream || iter->second.remote_closed)
+        {
+            reset_stream(stream_id, PROTOCOL_ERROR);
+            return 0;
+        }
+        return on_data(iter->second, nullptr, 0, true);
+    }
+    m_last_stream_id = stream_id;
+
+    http_connection *conn = nullptr;
+    // refused like an excess stream when request tokens of the client address are used up or the worker is shedding load
+    thread::worker *worker_ptr = thread::worker::current();
+    const bool shedding = worker_ptr && worker_ptr->get_codel().get_overloaded();
+    if (shedding)
+    {
+        worker_ptr->get_codel().on_shed();
+    }
+    if (!m_goaway_sent && m_streams.size() < max_concurrent_streams && !shedding &&
+        singleton<socket::admission>::instance()->allow_request(m_owner.get_socket_ptr()->get_admission()))
+    {
+        conn = new (std::nothrow) http_connection(m_owner.get_socket_ptr());
+    }
+
+    const bool request_view = singleton<server::server>::instance()->get_http_request_view();
+    std::string_view method, path, scheme, authority;
+    bool malformed = false;
+    bool oversize = false;
+    bool regular_seen = false;
+    bool host_seen = false;
+    int decode_res = m_hpack.decode((const uint8_t *)m_header_block.data(), m_header_block.size(), [&](std::string_view name, std::string_view value) -> bool
+                                    {
+        if (!conn || malformed || oversize)
+        {
+            return true; // the rest is still decoded for the dynamic table
+        }
+        std::string_view kept_name = keep(*conn, name);
+        std::string_view kept_value = keep(*conn, value);
+        if (!kept_name.data() || !kept_value.data())
+        {
+            oversize = true;
+            return true;
+        }
+        if (!name.empty() && name[0] == ':')
+        {
+            std::string_view *pseudo = name == ":method" ? &method : name == ":path" ? &path : name == ":scheme" ? &scheme : name == ":authority" ? &authority : nullptr;
+            if (regular_seen || !pseudo || pseudo->data())
+            {
+                malformed = true;
+            }
+            else
+            {
+                *pseudo = kept_value;
+            }
+            return true;
+        }
+        regular_seen = true;
+        for (char c : name)
+        {
+            if (c >= 'A' && c <= 'Z')
+            {
+                malformed = true;
+            }
+        }
+        if (connection_specific(name) || (name == "te" && value != "trailers"))
+        {
+            malformed = true;
+        }
+        host_seen = host_seen || name == "host";
+        conn->request.add_header(kept_name, kept_value);
+        if (!request_view)
+        {
+            conn->add_header(std::string(name), std::string(value));
+        }
+        return true; });
+
+    if (decode_res != 0)
+    {
+        delete conn;
+        return connection_error(COMPRESSION_ERROR);
+    }
+    if (!conn)
+    {
+        reset_stream(stream_id, REFUSED_STREAM);
+        return 0;
+    }
+    if (!oversize && (malformed || method.empty() || (method != "CONNECT" && (path.empty() || scheme.empty()))))
+    {
+        delete conn;
+        reset_stream(stream_id, PROTOCOL_ERROR);
+        return 0;
+    }
+
+    conn->set_gid(m_owner.get_gid());
+    conn->framed = true;
+    conn->m_send_buffer.set_limit_max(1048576);
+    conn->headers_complete = true;
+    conn->recv_buffer_pinned = conn->recv_buffer_used;
+    conn->get_parser()->content_length = ULLONG_MAX;
+    stream &now = m_streams[stream_id];
+    now.id = stream_id;
+    now.conn = conn;
+    now.send_window = m_peer_initial_window;
+    now.recv_window = initial_window_size;
+
+    if (oversize)
+    {
+        const char *response = "HTTP/1.1 431 Request Header Fields Too Large\r\nServer: tubekit\r\nContent-Length: 0\r\n\r\n";
+        try
+        {
+            conn->m_send_buffer.write(response, strlen(response));
+        }
+        catch (const std::runtime_error &e)
+        {
+            LOG_ERROR(e.what());
+        }
+        conn->set_recv_end(true);
+        conn->set_process_end(true);
+        conn->set_response_end(true);
+        now.remote_closed = end_stream;
+        return 0;
+    }
+
+    conn->request.method = method;
+    conn->request.url = path;
+    if (!host_seen && !authority.empty())
+    {
+        conn->request.add_header("host", authority);
+    }
+    if (!request_view)
+    {
+        conn->method = std::string(method);
+        conn->url = std::string(path);
+    }
+    std::string_view content_length = conn->request.get_header("content-length");
+    if (content_length.data() && !content_length.empty())
+    {
+        conn->get_parser()->content_length = strtoull(std::string(content_length).c_str(), nullptr, 10);
+    }
+
+    if (on_stream_headers && 0 != on_stream_headers(*conn))
+    {
+        reset_stream(stream_id, INTERNAL_ERROR);
+        return 0;
+    }
+    if (end_stream)
+    {
+        return on_data(now, nullptr, 0, true);
+    }
+    return 0;
+}
+
+int http2_connection::on_data(stream &now, const char *data, size_t len, bool end_stream)
+{
+    http_connection *conn = now.conn;
+    if (len > 0 && !conn->get_recv_end() && on_stream_body && 0 != on_stream_body(*conn, data, len))
+    {
+        reset_stream(now.id, CANCEL);
+        return 0;
+    }
+    if (end_stream)
+    {
+        now.remote_closed = true;
+        if (!conn->get_recv_end())
+        {
+            conn->set_recv_end(true);
+        }
+        if (now.local_closed)
+        {
+            close_stream(now.id);
+        }
+    }
+    return 0;
+}
+
+void http2_connection::credit(stream *now, bool force)
+{
+    if (m_goaway_sent)
+    {
+        return;
+    }
+    if (!now)
+    {
+        if (m_recv_consumed >= window_update_threshold || (force && m_recv_consumed > 0))
+        {
+            write_window_update(0, m_recv_consumed);
+            m_recv_window += m_recv_consumed;
+            m_recv_consumed = 0;
+        }
+        return;
+    }
+    // a paused app is not ready for more, the client is held by the stream window until it resumes
+    if (now->remote_closed || now->conn->get_recv_paused())
+    {
+        return;
+    }
+    if (now->recv_consumed >= window_update_threshold || (force && now->recv_consumed > 0))
+    {
+        write_window_update(now->id, now->recv_consumed);
+        now->recv_window += now->recv_consumed;
+        now->recv_consumed = 0;
+    }
+}
+
+bool http2_connection::process()
+{
+    for (auto iter = m_streams.begin(); iter != m_streams.end();)
+    {
+        http_connection *conn = iter->second.conn;
+        const uint32_t stream_id = iter->first;
+        stream &now = iter->second;
+        ++iter;
+        if (conn->event_callback && !conn->get_everything_end())
+        {
+            try
+            {
+                conn->event_callback(*conn);
+            }
+            catch (const std::exception &e)
+            {
+                LOG_ERROR(e.what());
+                conn->set_everything_end(true);
+            }
+            if (conn->get_everything_end())
+            {
+                reset_stream(stream_id, INTERNAL_ERROR);
+                continue;
+            }
+        }
+        // a sink resumed after draining
+        credit(&now, true);
+        if (conn->get_recv_end() && !conn->get_process_end())
+        {
+            conn->set_process_end(true);
+            if (on_stream_process)
+            {
+                on_stream_process(*conn);
+            }
+            if (conn->get_everything_end())
+            {
+                reset_stream(stream_id, INTERNAL_ERROR);
+            }
+        }
+    }
+
+    bool progress = true;
+    while (progress && m_out.size() - m_out_sent < out_limit)
+    {
+        progress = false;
+        for (auto iter = m_streams.begin(); iter != m_streams.end();)
+        {
+            stream &now = iter->second;
+            ++iter; // now may be closed by pump
+            progress = pump(now) || progress;
+        }
+    }
+    return progress;
+}
+
+bool http2_connection::pump(stream &now)
+{
+    http_connection *conn = now.conn;
+    if (now.local_closed || !conn->get_process_end())
+    {
+        return false;
+    }
+    if (conn->get_everything_end())
+    {
+        reset_stream(now.id, INTERNAL_ERROR);
+        return true;
+    }
+
+    if (conn->buffer_start_use == conn->buffer_used_len)
+    {
+        if (conn->has_pending_send())
+        {
+            conn->fill_buffer(); // framed stream, file parts are read into buffer
+            return true;
+        }
+        if (!conn->get_response_end())
+        {
+            try
+            {
+                if (conn->write_end_callback)
+                {
+                    conn->write_end_callback(*conn);
+                }
+                else
+                {
+                    conn->set_response_end(true);
+                }
+            }
+            catch (const std::exception &e)
+            {
+                LOG_ERROR(e.what());
+                reset_stream(now.id, INTERNAL_ERROR);
+                return true;
+            }
+            return conn->get_response_end() || conn->has_pending_send();
+        }
+        // app finished the response
+        if (!now.head_sent)
+        {
+            reset_stream(now.id, INTERNAL_ERROR);
+            return true;
+        }
+        write_frame(DATA, END_STREAM, now.id, nullptr, 0);
+        now.local_closed = true;
+        if (now.remote_closed)
+        {
+            close_stream(now.id);
+        }
+        else
+        {
+            reset_stream(now.id, NO_ERROR); // request body is not needed anymore
+        }
+        return true;
+    }
+
+    const char *at = conn->buffer + conn->buffer_start_use;
+    const size_t available = conn->buffer_used_len - conn->buffer_start_use;
+    if (!now.head_sent)
+    {
+        const size_t old_size = now.head.size();
+        now.head.append(at, available);
+        size_t head_end = now.head.find("\r\n\r\n");
+        if (head_end == std::string::npos)
+        {
+            conn->buffer_start_use = conn->buffer_used_len;
+            if (now.head.size() > max_header_block_size)
+            {
+                reset_stream(now.id, INTERNAL_ERROR);
+            }
+            return true;
+        }
+        now.head.resize(head_end + 4);
+        conn->buffer_start_use += now.head.size() - old_size;
+        if (!send_head(now))
+        {
+            reset_stream(now.id, INTERNAL_ERROR);
+        }
+        return true;
+    }
+
+    const int64_t window = now.send_window < m_send_window ? now.send_window : m_send_window;
+    if (window <= 0)
+    {
+        return false;
+    }
+    size_t len = available < m_peer_max_frame_size ? available : m_peer_max_frame_size;
+    len = (int64_t)len < window ? len : (size_t)window;
+    write_frame(DATA, 0, now.id, at, len);
+    now.send_window -= len;
+    m_send_window -= len;
+    conn->buffer_start_use += len;
+    return true;
+}
+
+bool http2_connection::send_head(stream &now)
+{
+    // HTTP/1.1 status line and header lines written by app
+    const std::string &head = now.head;
+    size_t line_end = head.find("\r\n");
+    if (head.compare(0, 5, "HTTP/") != 0 || line_end == std::string::npos)
+    {
+        return false;
+    }
+    size_t status_at = head.find(' ');
+    if (status_at == std::string::npos || status_at > line_end)
+    {
+        return false;
+    }
+    const int status = atoi(head.c_str() + status_at + 1);
+    if (status < 200 || status > 999)
+    {
+        return false;
+    }
+
+    std::string block;
+    hpack::encode_status(status, block);
+    std::string name;
+    size_t line_start = line_end + 2;
+    while ((line_end = head.find("\r\n", line_start)) != std::string::npos && line_end > line_start)
+    {
+        std::string_view line(head.data() + line_start, line_end - line_start);
+        line_start = line_end + 2;
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos)
+        {
+            continue;
+        }
+        name.assign(line.substr(0, colon));
+        for (char &c : name)
+        {
+            c = (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+        }
+        std::string_view value = line.substr(colon + 1);
+        while (!value.empty() && (value.front() == ' ' || value.front() == '\t'))
+        {
+            value.remove_prefix(1);
+        }
+        while (!value.empty() && (value.back() == ' ' || value.back() == '\t'))
+        {
+            value.remove_suffix(1);
+        }
+        if (!connection_specific(name))
+        {
+            hpack::encode(name, value, block);
+        }
+    }
+
+    size_t offset = 0;
+    do
+    {
+        size_t len = block.size() - offset < m_peer_max_frame_size ? block.size() - offset : m_peer_max_frame_size;
+        uint8_t flags = offset + len == block.size() ? END_HEADERS : 0;
+        write_frame(offset == 0 ? HEADERS : CONTINUATION, flags, now.id, block.data() + offset, len);
+        offset += len;
+    } while (offset < block.size());
+
+    now.head_sent = true;
+    std::string().swap(now.head);
+    return true;
+}
+
+void http2_connection::close_stream(uint32_t stream_id)
+{
+    auto iter = m_streams.find(stream_id);
+    if (iter == m_streams.end())
+    {
+        return;
+    }
+    http_connection *conn = iter->second.conn;
+    m_streams.erase(iter);
+    if (conn->destory_callback)
+    {
+        try
+        {
+            conn->destory_callback(*conn);
+        }
+        catch (const std::exception &e)
+        {
+            LOG_ERROR(e.what());
+        }
+    }
+    delete conn;
+}
+
+void http2_connection::reset_stream(uint32_t stream_id, error_code code)
+{
+    uint8_t payload[4];
+    put_u32(payload, code);
+    write_frame(RST_STREAM, 0, stream_id, payload, sizeof(payload));
+    close_stream(stream_id);
+}
+
+int http2_connection::connection_error(error_code code)
+{
+    if (!m_goaway_sent)
+    {
+        uint8_t payload[8];
+        put_u32(payload, m_last_stream_id);
+        put_u32(payload + 4, code);
+        write_frame(GOAWAY, 0, 0, payload, sizeof(payload));
+        m_goaway_sent = true;
+    }
+    LOG_ERROR("http2 connection error %d", (int)code);
+    m_failed = true;
+    return -1;
+}
+
+void http2_connection::write_frame(uint8_t type, uint8_t flags, uint32_t stream_id, const void *payload, size_t len)
+{
+    uint8_t header[frame_header_size];
+    header[0] = (uint8_t)(len >> 16);
+    header[1] = (uint8_t)(len >> 8);
+    header[2] = (uint8_t)len;
+    header[3] = type;
+    header[4] = flags;
+    put_u32(header + 5, stream_id & 0x7fffffff);
+    m_out.append((const char *)header, frame_header_size);
+    if (len > 0)
+    {
+        m_out.append((const char *)payload, len);
+    }
+}
+
+void http2_connection::write_window_update(uint32_t stream_id, uint32_t increment)
+{
+    uint8_t payload[4];
+    put_u32(payload, increment & 0x7fffffff);
+    write_frame(WINDOW_UPDATE, 0, stream_id, payload, sizeof(payload));
+}
@@ -0,0 +1,159 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <map>
+#include <functional>
+
+#include "utility/hpack.h"
+
+namespace tubekit
+{
+    namespace connection
+    {
+        class http_connection;
+
+        /**
+         * @brief HTTP/2 (RFC 9113) framing over one http_connection, each stream is an http_connection of its own
+         *        so http_app handles it like an HTTP/1.1 request, its HTTP/1.1 response is converted to frames
+         *
+         */
+        class http2_connection
+        {
+        public:
+            static constexpr std::string_view preface{"PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"};
+            static constexpr uint32_t max_concurrent_streams{32};
+            static constexpr uint32_t initial_window_size{1048576}; // receive window of each stream
+            static constexpr uint32_t connection_window_size{16777216};
+            static constexpr uint32_t window_update_threshold{16384}; // consumed bytes are credited back in batches of it
+            static constexpr uint32_t max_frame_size{16384};
+            static constexpr size_t max_header_block_size{65536};
+            static constexpr size_t out_limit{262144}; // stop framing responses when this much is not sent
+
+            enum error_code
+            {
+                NO_ERROR = 0x0,
+                PROTOCOL_ERROR = 0x1,
+                INTERNAL_ERROR = 0x2,
+                FLOW_CONTROL_ERROR = 0x3,
+                STREAM_CLOSED = 0x5,
+                FRAME_SIZE_ERROR = 0x6,
+                REFUSED_STREAM = 0x7,
+                CANCEL = 0x8,
+                COMPRESSION_ERROR = 0x9,
+                ENHANCE_YOUR_CALM = 0xb
+            };
+
+        public:
+            /**
+             * @brief server SETTINGS are queued in out
+             *
+             * @param owner connection of socket
+             */
+            http2_connection(http_connection &owner);
+            ~http2_connection();
+
+            /**
+             * @brief bytes received from socket, starting with the client preface
+             *
+             * @param data
+             * @param len
+             * @return int 0, -1 connection error, GOAWAY is queued
+             */
+            int on_recv(const char *data, size_t len);
+
+            /**
+             * @brief run app for complete requests and frame responses into out, round robin among streams
+             *
+             * @return true more frames can be produced once out is sent
+             * @return false
+             */
+            bool process();
+
+            /**
+             * @brief frames not sent yet
+             *
+             * @return std::string_view
+             */
+            std::string_view get_out() const;
+            void out_sent(size_t len);
+
+            /**
+             * @brief connection can be closed after out is sent
+             *
+             * @return true
+             * @return false
+             */
+            bool is_finished() const;
+
+        public:
+            // hooks into app, called for each stream
+            std::function<int(http_connection &stream)> on_stream_headers{nullptr};
+            std::function<int(http_connection &stream, const char *data, size_t len)> on_stream_body{nullptr};
+            std::function<void(http_connection &stream)> on_stream_process{nullptr};
+
+        private:
+            struct stream
+            {
+                uint32_t id{0};
+                http_connection *conn{nullptr};
+                int64_t send_window{0};
+                int64_t recv_window{0};   // bytes the client may still send
+                uint32_t recv_consumed{0}; // taken by app and not credited back yet
+                bool remote_closed{false};
+                bool local_closed{false};
+                bool head_sent{false};
+                std::string head{}; // HTTP/1.1 response head written by app, until blank line
+            };
+
+            int on_frame(uint8_t type, uint8_t flags, uint32_t stream_id, const uint8_t *payload, size_t len);
+            int on_headers(uint32_t stream_id, bool end_stream);
+            int on_data(stream &now, const char *data, size_t len, bool end_stream);
+            int on_settings(uint8_t flags, const uint8_t *payload, size_t len);
+
+            /**
+             * @brief credit consumed bytes back to the client, a stream is not credited while its app paused recv
+             *
+             * @param now nullptr for connection only
+             * @param force credit even less than window_update_threshold
+             */
+            void credit(stream *now, bool force);
+            /**
+             * @brief frame one step of stream response
+             *
+             * @param now
+             * @return true progress was made
+             * @return false blocked or nothing to send
+             */
+            bool pump(stream &now);
+            bool send_head(stream &now);
+            void close_stream(uint32_t stream_id);
+            void reset_stream(uint32_t stream_id, error_code code);
+            int connection_error(error_code code);
+            void write_frame(uint8_t type, uint8_t flags, uint32_t stream_id, const void *payload, size_t len);
+            void write_window_update(uint32_t stream_id, uint32_t increment);
+
+        private:
+            http_connection &m_owner;
+            utility::hpack m_hpack;
+            std::map<uint32_t, stream> m_streams{};
+            std::string m_in{};
+            std::string m_out{};
+            size_t m_out_sent{0};
+            size_t m_preface_matched{0};
+            bool m_settings_received{false};
+            std::string m_header_block{};
+            uint32_t m_header_stream_id{0}; // CONTINUATION expected when not 0
+            bool m_header_end_stream{false};
+            uint32_t m_last_stream_id{0};
+            int64_t m_send_window{65535};
+            int64_t m_recv_window{connection_window_size}; // bytes the client may still send on all streams
+            uint32_t m_recv_consumed{0};
+            int64_t m_peer_initial_window{65535};
+            uint32_t m_peer_max_frame_size{16384};
+            bool m_goaway_sent{false};
+            bool m_goaway_received{false};
+            bool m_failed{false};
+        };
+    }
+}
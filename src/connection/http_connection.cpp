@@ -1,3 +1,7 @@
+#include <unistd.h>
+#include <fcntl.h>
+#include <cstring>
+#include <tubekit-log/logger.h>
 #include "connection/http_connection.h"
 #include "utility/singleton.h"
 #include "socket/socket_handler.h"
@@ -21,6 +25,14 @@ http_connection::http_connection(tubekit::socket::socket *socket_ptr) : connecti
 
 http_connection::~http_connection()
 {
+    delete h2;
+    for (int pipe_fd : body_splice_pipe)
+    {
+        if (pipe_fd >= 0)
+        {
+            ::close(pipe_fd);
+        }
+    }
 }
 
 http_parser *http_connection::get_parser()
@@ -99,6 +111,111 @@ bool http_connection::get_everything_end()
     return everything_end;
 }
 
+void http_connection::set_sendfile(int fd, off_t offset, size_t count)
+{
+    this->sendfile_fd = fd;
+    this->sendfile_offset = offset;
+    this->sendfile_remaining = count;
+}
+
+bool http_connection::fill_buffer()
+{
+    buffer_start_use = 0;
+    buffer_used_len = 0;
+    if (0 != m_send_buffer.can_readable_size())
+    {
+        try
+        {
+            buffer_used_len = m_send_buffer.read(buffer, buffer_size - 1);
+        }
+        catch (const std::runtime_error &e)
+        {
+            LOG_ERROR(e.what());
+        }
+        buffer[buffer_used_len] = 0;
+        return buffer_used_len > 0;
+    }
+    if (!response.pending())
+    {
+        return false;
+    }
+    http_response::file_range file;
+    int len = response.read(buffer, buffer_size - 1, can_sendfile() ? &file : nullptr);
+    if (len < 0)
+    {
+        LOG_ERROR("response read file part errno %d", errno);
+        set_everything_end(true);
+        return false;
+    }
+    buffer_used_len = len;
+    buffer[buffer_used_len] = 0;
+    if (file.len > 0)
+    {
+        set_sendfile(file.fd, file.offset, file.len);
+        return true;
+    }
+    return buffer_used_len > 0;
+}
+
+bool http_connection::has_pending_send()
+{
+    return 0 != m_send_buffer.can_readable_size() || response.pending() || sendfile_remaining > 0;
+}
+
+bool http_connection::set_body_splice(int fd)
+{
+    if (framed)
+    {
+        return false;
+    }
+    if (body_splice_pipe[0] < 0 && 0 != ::pipe2(body_splice_pipe, O_CLOEXEC | O_NONBLOCK))
+    {
+        body_splice_pipe[0] = -1;
+        body_splice_pipe[1] = -1;
+        return false;
+    }
+    this->body_splice_fd = fd;
+    return true;
+}
+
+bool http_connection::can_sendfile()
+{
+    return !framed && socket_ptr && socket_ptr->can_sendfile();
+}
+
+void http_connection::pause_recv()
+{
+    this->recv_paused = true;
+}
+
+void http_connection::resume_recv()
+{
+    if (this->recv_paused.exchange(false))
+    {
+        singleton<socket_handler>::instance()->do_task(get_gid(), true, false);
+    }
+}
+
+bool http_connection::get_recv_paused()
+{
+    return recv_paused;
+}
+
+void http_connection::pause_send()
+{
+    this->send_paused = true;
+}
+
+void http_connection::resume_send()
+{
+    this->send_paused = false;
+}
+
+bool http_connection::get_send_paused()
+{
+    return send_paused;
+}
+
 ostream &operator<<(ostream &os, const http_connection &m_http_connection)
 {
     return os;
@@ -113,23 +230,81 @@ void http_connection::on_mark_close()
 void http_connection::reuse()
 {
     connection::reuse();
+    reset_request();
+    this->recv_buffer_used = 0;
+    this->recv_buffer_pinned = 0;
+    this->recv_buffer_parsed = 0;
+
+    constexpr uint64_t mem_buffer_size_max = 1048576; // 1MB
+    this->m_send_buffer.clear();                      // GC
+    this->m_send_buffer.set_limit_max(mem_buffer_size_max);
+    delete this->h2;
+    this->h2 = nullptr;
+    this->framed = false;
+}
+
+void http_connection::next_request()
+{
+    if (this->destory_callback)
+    {
+        try
+        {
+            this->destory_callback(*this);
+        }
+        catch (const std::exception &e)
+        {
+            LOG_ERROR(e.what());
+        }
+    }
+    // pipelined bytes of next request move to the front
+    const size_t left = this->recv_buffer_used - this->recv_buffer_parsed;
+    memmove(this->recv_buffer, this->recv_buffer + this->recv_buffer_parsed, left);
+    this->recv_buffer_used = left;
+    this->recv_buffer_pinned = 0;
+    this->recv_buffer_parsed = 0;
+    reset_request();
+}
+
+void http_connection::reset_request()
+{
+    this->request.reset();
+    this->response.reset();
+    this->headers_complete = false;
+    this->simd_parsed = false;
+    this->simd_unsupported = false;
+    this->simd_scanned = 0;
+    this->simd_body_remaining = 0;
     this->url.clear();
     this->method.clear();
     this->headers.clear();
     this->body.clear();
     this->chunks.clear();
     this->data.clear();
-
-    constexpr uint64_t mem_buffer_size_max = 1048576; // 1MB
-    this->m_send_buffer.clear();                      // GC
-    this->m_send_buffer.set_limit_max(mem_buffer_size_max);
     this->buffer_used_len = 0;
     this->buffer_start_use = 0;
     this->head_field_tmp.clear();
     this->process_callback = nullptr;
     this->write_end_callback = nullptr;
     this->destory_callback = nullptr;
+    this->event_callback = nullptr;
+    this->body_callback = nullptr;
     this->ptr = nullptr;
+    this->sendfile_fd = -1;
+    this->sendfile_offset = 0;
+    this->sendfile_remaining = 0;
+    this->body_splice_fd = -1;
+    this->body_splice_remaining = 0;
+    for (int &pipe_fd : this->body_splice_pipe)
+    {
+        if (pipe_fd >= 0)
+        {
+            ::close(pipe_fd);
+            pipe_fd = -1;
+        }
+    }
+    this->recv_paused = false;
+    this->send_paused = false;
+    this->keep_alive = false;
     this->recv_end = false;
     this->process_end = false;
     this->response_end = false;
@@ -5,10 +5,14 @@
 #include <map>
 #include <string>
 #include <functional>
+#include <atomic>
 #include <http-parser/http_parser.h>
 #include <tubekit-buffer/buffer.h>
 
 #include "connection/connection.h"
+#include "connection/http_request.h"
+#include "connection/http_response.h"
+#include "connection/http2_connection.h"
 #include "socket/socket.h"
 
 namespace tubekit
@@ -33,12 +37,104 @@ namespace tubekit
             bool get_response_end();
             bool set_everything_end(bool everything_end);
             bool get_everything_end();
+            /**
+             * @brief after buffer and m_send_buffer drained, send [offset,offset+count) of fd by sendfile,
+             *        fd is not owned by connection, write_end_callback is called when it finished
+             *
+             * @param fd
+             * @param offset
+             * @param count
+             */
+            void set_sendfile(int fd, off_t offset, size_t count);
+            /**
+             * @brief the rest of a Content-Length body not yet in recv_buffer is moved from socket into fd by splice,
+             *        body_callback still gets body bytes already received and chunked bodies, fd is not owned by connection
+             *
+             * @param fd
+             * @return true
+             * @return false pipe can not be created or HTTP/2 stream
+             */
+            bool set_body_splice(int fd);
+            /**
+             * @brief refill drained buffer from m_send_buffer, then from committed response parts,
+             *        a file part becomes set_sendfile when can_sendfile
+             *
+             * @return true buffer or sendfile has bytes to send
+             * @return false nothing left or error
+             */
+            bool fill_buffer();
+            /**
+             * @brief m_send_buffer, response parts or sendfile still has bytes after buffer
+             *
+             * @return true
+             * @return false
+             */
+            bool has_pending_send();
+            /**
+             * @brief whether a response body can be sent by set_sendfile
+             *
+             * @return true
+             * @return false ssl socket or HTTP/2 stream
+             */
+            bool can_sendfile();
+            /**
+             * @brief stop reading from socket and parsing, data passed to body_callback keeps valid until resume_recv
+             *
+             */
+            void pause_recv();
+            /**
+             * @brief continue reading after pause_recv, can be called in any thread
+             *
+             */
+            void resume_recv();
+            bool get_recv_paused();
+            /**
+             * @brief nothing to send for now and the connection is not waiting for writable, such as a response relayed from upstream,
+             *        the task of gid is driven by other sockets until resume_send
+             *
+             */
+            void pause_send();
+            /**
+             * @brief wait for writable again after pause_send, only in the task of this connection
+             *
+             */
+            void resume_send();
+            bool get_send_paused();
 
         public:
             virtual void on_mark_close() override;
             virtual void reuse() override;
 
+            /**
+             * @brief start over for the next request of a kept-alive HTTP/1.1 connection, destory_callback is called for the last one,
+             *        pipelined bytes after the last request stay in recv_buffer
+             *
+             */
+            void next_request();
+
         public:
+            /**
+             * @brief request line and headers, views into recv_buffer, valid until the connection is reused
+             *
+             */
+            http_request request;
+            /**
+             * @brief response builder, its bytes are sent after m_send_buffer
+             *
+             */
+            http_response response;
+            static constexpr size_t recv_buffer_size{8192};
+            char recv_buffer[recv_buffer_size]{0}; // request line and headers must fit in it
+            size_t recv_buffer_used{0};
+            size_t recv_buffer_pinned{0}; // [0,recv_buffer_pinned) is referenced by request
+            size_t recv_buffer_parsed{0}; // [recv_buffer_parsed,recv_buffer_used) is left by pause_recv
+            bool headers_complete{false};
+            bool simd_parsed{false};          // head parsed by http_simd_parser, Content-Length body is framed by simd_body_remaining
+            bool simd_unsupported{false};     // this request is left to http-parser
+            size_t simd_scanned{0};           // recv_buffer_used when the head was last found incomplete
+            uint64_t simd_body_remaining{0};
+
+            // legacy copies of request, filled only when server http_request_view is off
             std::string url{};
             std::string method{};
             std::map<std::string, std::vector<std::string>> headers{};
@@ -54,7 +150,31 @@ namespace tubekit
             std::function<void(http_connection &connection)> process_callback{nullptr};
             std::function<void(http_connection &connection)> write_end_callback{nullptr};
             std::function<void(http_connection &connection)> destory_callback{nullptr};
+            /**
+             * @brief called at the start of every task run of this connection or stream, before reading,
+             *        for work driven by sockets bound to gid such as upstream connections
+             *
+             */
+            std::function<void(http_connection &connection)> event_callback{nullptr};
+            /**
+             * @brief body chunks are passed to it as parsed instead of being accumulated in body,
+             *        return 0 to continue, -1 to reject the request
+             *
+             */
+            std::function<int(http_connection &connection, const char *data, size_t len)> body_callback{nullptr};
             void *ptr{nullptr};
+            int sendfile_fd{-1};
+            off_t sendfile_offset{0};
+            size_t sendfile_remaining{0};
+            http2_connection *h2{nullptr}; // not null after HTTP/2 is negotiated, streams are served by it
+            bool framed{false};            // HTTP/2 stream, its bytes are framed by parent's h2
+            bool keep_alive{false};        // set by app when the response is framed and the client may send another request
+            int body_splice_fd{-1};
+            uint64_t body_splice_remaining{0};
+            int body_splice_pipe[2]{-1, -1};
+
+        private:
+            void reset_request();
 
         private:
             http_parser m_http_parser;
@@ -62,6 +182,8 @@ namespace tubekit
             bool process_end{false};
             bool response_end{false};
             bool everything_end{false};
+            std::atomic<bool> recv_paused{false};
+            bool send_paused{false};
         };
     }
 }
@@ -0,0 +1,190 @@
+#include "connection/http_request.h"
+
+#include <strings.h>
+#include <cstring>
+#include <new>
+
+using tubekit::connection::http_request;
+
+http_request::http_request() : m_overflow_headers(nullptr),
+                               m_overflow_capacity(0),
+                               m_header_count(0),
+                               m_in_value(false),
+                               m_arena(1024)
+{
+}
+
+http_request::~http_request()
+{
+}
+
+void http_request::reset()
+{
+    method = std::string_view();
+    url = std::string_view();
+    m_overflow_headers = nullptr;
+    m_overflow_capacity = 0;
+    m_header_count = 0;
+    m_in_value = false;
+    m_arena.reset();
+}
+
+void http_request::extend(std::string_view &view, const char *at, size_t length)
+{
+    if (view.data() == nullptr || view.empty())
+    {
+        view = std::string_view(at, length);
+        return;
+    }
+    if (view.data() + view.size() == at)
+    {
+        view = std::string_view(view.data(), view.size() + length);
+        return;
+    }
+    // pieces are not adjacent in recv_buffer, join them in arena
+    char *joined = static_cast<char *>(m_arena.allocate(view.size() + length, 1));
+    if (!joined)
+    {
+        return;
+    }
+    memcpy(joined, view.data(), view.size());
+    memcpy(joined + view.size(), at, length);
+    view = std::string_view(joined, view.size() + length);
+}
+
+void http_request::on_url(const char *at, size_t length)
+{
+    extend(url, at, length);
+}
+
+void http_request::on_header_field(const char *at, size_t length)
+{
+    if (m_in_value || m_header_count == 0)
+    {
+        m_in_value = false;
+        if (!push_header())
+        {
+            return;
+        }
+    }
+    extend(get_header_ptr(m_header_count - 1)->key, at, length);
+}
+
+void http_request::on_header_value(const char *at, size_t length)
+{
+    if (m_header_count == 0)
+    {
+        return;
+    }
+    m_in_value = true;
+    extend(get_header_ptr(m_header_count - 1)->value, at, length);
+}
+
+void http_request::add_header(std::string_view key, std::string_view value)
+{
+    header *new_header = push_header();
+    if (!new_header)
+    {
+        return;
+    }
+    new_header->key = key;
+    new_header->value = value;
+    m_in_value = true;
+}
+
+http_request::header *http_request::get_header_ptr(size_t idx)
+{
+    if (idx < inline_headers)
+    {
+        return &m_inline_headers[idx];
+    }
+    return &m_overflow_headers[idx - inline_headers];
+}
+
+http_request::header *http_request::push_header()
+{
+    if (m_header_count >= inline_headers && m_header_count - inline_headers >= m_overflow_capacity)
+    {
+        size_t new_capacity = m_overflow_capacity == 0 ? inline_headers : m_overflow_capacity * 2;
+        header *new_headers = static_cast<header *>(m_arena.allocate(sizeof(header) * new_capacity, alignof(header)));
+        if (!new_headers)
+        {
+            return nullptr;
+        }
+        for (size_t i = 0; i < new_capacity; ++i)
+        {
+            new (&new_headers[i]) header;
+            if (i < m_overflow_capacity)
+            {
+                new_headers[i] = m_overflow_headers[i];
+            }
+        }
+        m_overflow_headers = new_headers;
+        m_overflow_capacity = new_capacity;
+    }
+    header *new_header = get_header_ptr(m_header_count++);
+    *new_header = header();
+    return new_header;
+}
+
+const http_request::header *http_request::find_header(std::string_view key) const
+{
+    for (size_t i = 0; i < m_header_count; ++i)
+    {
+        const header &item = get_header_at(i);
+        if (item.key.size() == key.size() && 0 == strncasecmp(item.key.data(), key.data(), key.size()))
+        {
+            return &item;
+        }
+    }
+    return nullptr;
+}
+
+std::string_view http_request::get_header(std::string_view key) const
+{
+    const header *item = find_header(key);
+    if (!item)
+    {
+        return std::string_view();
+    }
+    if (item->value.data() == nullptr)
+    {
+        return std::string_view("", 0); // exists but empty
+    }
+    return item->value;
+}
+
+size_t http_request::get_views_end(const char *recv_buffer, size_t recv_buffer_size) const
+{
+    size_t end = 0;
+    auto update = [&end, recv_buffer, recv_buffer_size](std::string_view view) -> void
+    {
+        // views joined in arena are not in recv_buffer
+        if (view.data() >= recv_buffer && view.data() + view.size() <= recv_buffer + recv_buffer_size)
+        {
+            size_t view_end = view.data() + view.size() - recv_buffer;
+            end = view_end > end ? view_end : end;
+        }
+    };
+    update(url);
+    for (size_t i = 0; i < m_header_count; ++i)
+    {
+        update(get_header_at(i).key);
+        update(get_header_at(i).value);
+    }
+    return end;
+}
+
+size_t http_request::get_header_count() const
+{
+    return m_header_count;
+}
+
+const http_request::header &http_request::get_header_at(size_t idx) const
+{
+    if (idx < inline_headers)
+    {
+        return m_inline_headers[idx];
+    }
+    return m_overflow_headers[idx - inline_headers];
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <cstddef>
+#include <string_view>
+
+#include "utility/arena.h"
+
+namespace tubekit
+{
+    namespace connection
+    {
+        /**
+         * @brief request line and headers as views into http_connection's recv_buffer,
+         *        nothing is allocated unless headers exceed inline_headers or a slice is not contiguous
+         *
+         */
+        class http_request
+        {
+        public:
+            struct header
+            {
+                std::string_view key{};
+                std::string_view value{};
+            };
+
+            static constexpr size_t inline_headers{32};
+
+        public:
+            http_request();
+            ~http_request();
+
+            /**
+             * @brief views become invalid, arena memory is returned
+             *
+             */
+            void reset();
+
+            // http_parser callbacks, a slice may come in several pieces
+            void on_url(const char *at, size_t length);
+            void on_header_field(const char *at, size_t length);
+            void on_header_value(const char *at, size_t length);
+
+            /**
+             * @brief a whole header at once, such as decoded from HTTP/2 HEADERS
+             *
+             * @param key
+             * @param value
+             */
+            void add_header(std::string_view key, std::string_view value);
+
+            /**
+             * @brief case-insensitive lookup, the first one if repeated
+             *
+             * @param key
+             * @return const header* nullptr when not found
+             */
+            const header *find_header(std::string_view key) const;
+
+            /**
+             * @brief case-insensitive lookup
+             *
+             * @param key
+             * @return std::string_view value, data() is nullptr when not found
+             */
+            std::string_view get_header(std::string_view key) const;
+
+            /**
+             * @brief the end of the highest byte referenced by url and headers in recv_buffer
+             *
+             * @param recv_buffer
+             * @param recv_buffer_size
+             * @return size_t offset in recv_buffer
+             */
+            size_t get_views_end(const char *recv_buffer, size_t recv_buffer_size) const;
+
+            size_t get_header_count() const;
+            const header &get_header_at(size_t idx) const;
+
+        public:
+            std::string_view method{};
+            std::string_view url{};
+
+        private:
+            header *get_header_ptr(size_t idx);
+            header *push_header();
+            void extend(std::string_view &view, const char *at, size_t length);
+
+        private:
+            header m_inline_headers[inline_headers]{};
+            header *m_overflow_headers{nullptr}; // in m_arena
+            size_t m_overflow_capacity{0};
+            size_t m_header_count{0};
+            bool m_in_value{false};
+            utility::arena m_arena;
+        };
+    }
+}
@@ -0,0 +1,299 @@
+#include <cstring>
+#include <ctime>
+#include <cerrno>
+#include <charconv>
+#include <unistd.h>
+
+#include "connection/http_response.h"
+
+using tubekit::connection::http_response;
+
+static constexpr std::string_view field_names[http_response::FIELD_COUNT] = {
+    "Content-Type: ",
+    "Content-Encoding: ",
+    "Content-Range: ",
+    "Accept-Ranges: ",
+    "Vary: ",
+    "ETag: ",
+    "Last-Modified: ",
+    "Connection: ",
+    "Location: ",
+    "Cache-Control: ",
+};
+
+static constexpr std::string_view server_line{"Server: tubekit\r\n"};
+
+http_response::http_response()
+{
+}
+
+http_response::~http_response()
+{
+}
+
+http_response &http_response::set_status(int status)
+{
+    m_head.clear();
+    m_head_sent = 0;
+    m_committed = false;
+    char code[16];
+    auto res = std::to_chars(code, code + sizeof(code), status);
+    m_head.append("HTTP/1.1 ");
+    m_head.append(code, res.ptr - code);
+    m_head.push_back(' ');
+    m_head.append(reason(status));
+    m_head.append("\r\n");
+    m_head.append(server_line);
+    m_head.append(date_line());
+    return *this;
+}
+
+http_response &http_response::add_header(std::string_view key, std::string_view value)
+{
+    m_head.append(key);
+    m_head.append(": ");
+    m_head.append(value);
+    m_head.append("\r\n");
+    return *this;
+}
+
+http_response &http_response::add_header(field key, std::string_view value)
+{
+    m_head.append(field_names[key]);
+    m_head.append(value);
+    m_head.append("\r\n");
+    return *this;
+}
+
+http_response &http_response::set_content_length(uint64_t length)
+{
+    char digits[24];
+    auto res = std::to_chars(digits, digits + sizeof(digits), length);
+    m_head.append("Content-Length: ");
+    m_head.append(digits, res.ptr - digits);
+    m_head.append("\r\n");
+    return *this;
+}
+
+http_response::part &http_response::push_part(part::type part_type)
+{
+    m_parts.emplace_back();
+    part &now = m_parts.back();
+    now.part_type = part_type;
+    return now;
+}
+
+http_response &http_response::add_body(std::string &&data)
+{
+    if (!data.empty())
+    {
+        part &now = push_part(part::OWNED);
+        now.remaining = data.size();
+        now.owned = std::move(data);
+    }
+    return *this;
+}
+
+http_response &http_response::add_body_view(std::string_view data)
+{
+    if (!data.empty())
+    {
+        part &now = push_part(part::VIEW);
+        now.view = data.data();
+        now.remaining = data.size();
+    }
+    return *this;
+}
+
+http_response &http_response::add_body(std::shared_ptr<const std::string> data, size_t offset, size_t len)
+{
+    if (data && len > 0 && offset + len <= data->size())
+    {
+        part &now = push_part(part::SHARED);
+        now.shared = std::move(data);
+        now.offset = offset;
+        now.remaining = len;
+    }
+    return *this;
+}
+
+http_response &http_response::add_file(int fd, uint64_t offset, uint64_t len)
+{
+    if (fd >= 0 && len > 0)
+    {
+        part &now = push_part(part::FILE);
+        now.fd = fd;
+        now.offset = offset;
+        now.remaining = len;
+    }
+    return *this;
+}
+
+void http_response::commit()
+{
+    m_head.append("\r\n");
+    m_committed = true;
+}
+
+bool http_response::pending() const
+{
+    return m_committed && (m_head_sent < m_head.size() || !m_parts.empty());
+}
+
+int http_response::read(char *buf, size_t size, file_range *file_out)
+{
+    if (!m_committed)
+    {
+        return 0;
+    }
+
+    size_t used = 0;
+    if (m_head_sent < m_head.size())
+    {
+        size_t len = m_head.size() - m_head_sent;
+        len = len < size ? len : size;
+        memcpy(buf, m_head.data() + m_head_sent, len);
+        m_head_sent += len;
+        used += len;
+    }
+
+    while (used < size && !m_parts.empty())
+    {
+        part &now = m_parts.front();
+        size_t len = size - used;
+        len = now.remaining < len ? now.remaining : len;
+        if (now.part_type == part::FILE)
+        {
+            if (file_out)
+            {
+                if (used > 0)
+                {
+                    break; // gathered bytes go first
+                }
+                file_out->fd = now.fd;
+                file_out->offset = now.offset;
+                file_out->len = now.remaining;
+                m_parts.pop_front();
+                return 0;
+            }
+            ssize_t read_len = ::pread(now.fd, buf + used, len, now.offset);
+            if (read_len == -1 && errno == EINTR)
+            {
+                continue;
+            }
+            if (read_len <= 0)
+            {
+                return -1;
+            }
+            len = read_len;
+        }
+        else
+        {
+            const char *base = now.part_type == part::VIEW ? now.view : (now.part_type == part::OWNED ? now.owned.data() : now.shared->data());
+            memcpy(buf + used, base + now.offset, len);
+        }
+        used += len;
+        now.offset += len;
+        now.remaining -= len;
+        if (0 == now.remaining)
+        {
+            m_parts.pop_front();
+        }
+    }
+    return used;
+}
+
+void http_response::reset()
+{
+    m_head.clear();
+    m_head_sent = 0;
+    m_committed = false;
+    m_parts.clear();
+}
+
+const char *http_response::reason(int status)
+{
+    switch (status)
+    {
+    case 100:
+        return "Continue";
+    case 101:
+        return "Switching Protocols";
+    case 200:
+        return "OK";
+    case 201:
+        return "Created";
+    case 202:
+        return "Accepted";
+    case 204:
+        return "No Content";
+    case 206:
+        return "Partial Content";
+    case 301:
+        return "Moved Permanently";
+    case 302:
+        return "Found";
+    case 304:
+        return "Not Modified";
+    case 307:
+        return "Temporary Redirect";
+    case 308:
+        return "Permanent Redirect";
+    case 400:
+        return "Bad Request";
+    case 401:
+        return "Unauthorized";
+    case 403:
+        return "Forbidden";
+    case 404:
+        return "Not Found";
+    case 405:
+        return "Method Not Allowed";
+    case 408:
+        return "Request Timeout";
+    case 409:
+        return "Conflict";
+    case 411:
+        return "Length Required";
+    case 413:
+        return "Content Too Large";
+    case 414:
+        return "URI Too Long";
+    case 415:
+        return "Unsupported Media Type";
+    case 416:
+        return "Range Not Satisfiable";
+    case 429:
+        return "Too Many Requests";
+    case 431:
+        return "Request Header Fields Too Large";
+    case 500:
+        return "Internal Server Error";
+    case 501:
+        return "Not Implemented";
+    case 502:
+        return "Bad Gateway";
+    case 503:
+        return "Service Unavailable";
+    case 504:
+        return "Gateway Timeout";
+    default:
+        return "Unknown";
+    }
+}
+
+std::string_view http_response::date_line()
+{
+    thread_local std::time_t cached_time{0};
+    thread_local char cached_line[64]{0};
+    thread_local size_t cached_len{0};
+    const std::time_t now = ::time(nullptr);
+    if (now != cached_time)
+    {
+        struct tm gmt;
+        gmtime_r(&now, &gmt);
+        cached_len = strftime(cached_line, sizeof(cached_line), "Date: %a, %d %b %Y %H:%M:%S GMT\r\n", &gmt);
+        cached_time = now;
+    }
+    return std::string_view(cached_line, cached_len);
+}
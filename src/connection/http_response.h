@@ -0,0 +1,155 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <deque>
+#include <memory>
+
+namespace tubekit
+{
+    namespace connection
+    {
+        /**
+         * @brief response builder of http_connection, status line and headers are serialized into one reused head,
+         *        body is a queue of parts (memory, shared buffer, file range) that are gathered into the send buffer
+         *        or sent by sendfile without intermediate strings
+         *
+         * usage: set_status, add_header..., set_content_length, add_body..., commit, add_body... later is allowed
+         */
+        class http_response
+        {
+        public:
+            // interned names of common headers
+            enum field
+            {
+                CONTENT_TYPE = 0,
+                CONTENT_ENCODING,
+                CONTENT_RANGE,
+                ACCEPT_RANGES,
+                VARY,
+                ETAG,
+                LAST_MODIFIED,
+                CONNECTION,
+                LOCATION,
+                CACHE_CONTROL,
+                FIELD_COUNT
+            };
+
+            struct file_range
+            {
+                int fd{-1};
+                uint64_t offset{0};
+                uint64_t len{0};
+            };
+
+        public:
+            http_response();
+            ~http_response();
+
+            /**
+             * @brief start a new head with status line, Server and cached Date
+             *
+             * @param status such as 200
+             * @return http_response&
+             */
+            http_response &set_status(int status);
+            http_response &add_header(std::string_view key, std::string_view value);
+            http_response &add_header(field key, std::string_view value);
+            http_response &set_content_length(uint64_t length);
+
+            /**
+             * @brief memory owned by response
+             *
+             * @param data moved in
+             * @return http_response&
+             */
+            http_response &add_body(std::string &&data);
+            /**
+             * @brief memory not owned, must be valid until sent, such as static text
+             *
+             * @param data
+             * @return http_response&
+             */
+            http_response &add_body_view(std::string_view data);
+            http_response &add_body(std::shared_ptr<const std::string> data, size_t offset, size_t len);
+            /**
+             * @brief file range, fd is not closed by response and must be open until sent
+             *
+             * @param fd
+             * @param offset
+             * @param len
+             * @return http_response&
+             */
+            http_response &add_file(int fd, uint64_t offset, uint64_t len);
+
+            /**
+             * @brief end of head, head and queued parts can be sent from now
+             *
+             */
+            void commit();
+
+            /**
+             * @brief bytes not sent yet
+             *
+             * @return true
+             * @return false
+             */
+            bool pending() const;
+
+            /**
+             * @brief move committed bytes into buf in order
+             *
+             * @param buf
+             * @param size
+             * @param file_out not nullptr when file parts can be sent by sendfile, the front file part is moved into it
+             *                 and nothing else is read
+             * @return int bytes in buf, -1 pread error
+             */
+            int read(char *buf, size_t size, file_range *file_out);
+
+            void reset();
+
+            /**
+             * @brief reason phrase
+             *
+             * @param status
+             * @return const char* "Unknown" for unknown status
+             */
+            static const char *reason(int status);
+
+            /**
+             * @brief "Date: ...\r\n" for now, formatted at most once per second in each thread
+             *
+             * @return std::string_view
+             */
+            static std::string_view date_line();
+
+        private:
+            struct part
+            {
+                enum type
+                {
+                    VIEW = 0,
+                    OWNED = 1,
+                    SHARED = 2,
+                    FILE = 3
+                };
+                type part_type{VIEW};
+                const char *view{nullptr};
+                std::string owned{};
+                std::shared_ptr<const std::string> shared{nullptr};
+                int fd{-1};
+                uint64_t offset{0};
+                uint64_t remaining{0};
+            };
+
+            part &push_part(part::type part_type);
+
+        private:
+            std::string m_head{}; // capacity is kept when reused
+            size_t m_head_sent{0};
+            bool m_committed{false};
+            std::deque<part> m_parts{};
+        };
+    }
+}
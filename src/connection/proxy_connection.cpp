@@ -0,0 +1,148 @@
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+#include <sys/socket.h>
+#include <tubekit-log/logger.h>
+#include "connection/proxy_connection.h"
+#include "utility/singleton.h"
+#include "socket/socket_handler.h"
+
+using tubekit::connection::proxy_connection;
+using tubekit::socket::socket_handler;
+using tubekit::utility::singleton;
+
+proxy_connection::proxy_connection(tubekit::socket::socket *socket_ptr) : connection(socket_ptr)
+{
+}
+
+proxy_connection::~proxy_connection()
+{
+    close_pipes();
+}
+
+uint64_t proxy_connection::get_bytes_up() const
+{
+    return up.bytes;
+}
+
+uint64_t proxy_connection::get_bytes_down() const
+{
+    return down.bytes;
+}
+
+bool proxy_connection::open_pipes()
+{
+    for (direction *dir : {&up, &down})
+    {
+        if (dir->pipe[0] >= 0)
+        {
+            continue;
+        }
+        if (0 != ::pipe2(dir->pipe, O_NONBLOCK | O_CLOEXEC))
+        {
+            LOG_ERROR("proxy_connection pipe2 errno %d", errno);
+            dir->pipe[0] = -1;
+            dir->pipe[1] = -1;
+            return false;
+        }
+        int pipe_size = ::fcntl(dir->pipe[1], F_GETPIPE_SZ);
+        dir->pipe_size = pipe_size > 0 ? pipe_size : 65536;
+    }
+    return true;
+}
+
+void proxy_connection::close_pipes()
+{
+    for (direction *dir : {&up, &down})
+    {
+        for (int &pipe_fd : dir->pipe)
+        {
+            if (pipe_fd >= 0)
+            {
+                ::close(pipe_fd);
+                pipe_fd = -1;
+            }
+        }
+    }
+}
+
+int proxy_connection::relay(direction &dir, tubekit::socket::socket *from, tubekit::socket::socket *to)
+{
+    dir.blocked = false;
+    while (true)
+    {
+        bool progress = false;
+        if (dir.pending > 0)
+        {
+            ssize_t moved = ::splice(dir.pipe[0], nullptr, to->get_fd(), nullptr, dir.pending, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            if (moved > 0)
+            {
+                dir.pending -= moved;
+                progress = true;
+            }
+            else if (moved == -1 && errno == EINTR)
+            {
+                continue;
+            }
+            else if (moved == -1 && errno == EAGAIN)
+            {
+                dir.blocked = true;
+            }
+            else
+            {
+                return -1; // destination reset
+            }
+        }
+        // pipe room is counted in bytes, a full pipe is not mistaken for an empty socket because pending is drained first
+        if (!dir.eof && dir.pending < dir.pipe_size)
+        {
+            int oper_errno = 0;
+            int moved = from->splice(dir.pipe[1], dir.pipe_size - dir.pending, oper_errno);
+            if (moved > 0)
+            {
+                dir.pending += moved;
+                dir.bytes += moved;
+                progress = true;
+            }
+            else if (moved == 0)
+            {
+                dir.eof = true;
+            }
+            else if (oper_errno == EINTR)
+            {
+                continue;
+            }
+            else if (oper_errno != EAGAIN)
+            {
+                return -1;
+            }
+        }
+        if (!progress)
+        {
+            break;
+        }
+    }
+
+    // half close is passed on after everything before it
+    if (dir.eof && 0 == dir.pending && !dir.shutdown)
+    {
+        ::shutdown(to->get_fd(), SHUT_WR);
+        dir.shutdown = true;
+    }
+    return 0;
+}
+
+void proxy_connection::on_mark_close()
+{
+    singleton<socket_handler>::instance()->do_task(get_gid(), false, true);
+}
+
+void proxy_connection::reuse()
+{
+    connection::reuse();
+    close_pipes();
+    upstream = nullptr;
+    connecting = false;
+    up = direction{};
+    down = direction{};
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include "connection/connection.h"
+#include "socket/socket.h"
+
+namespace tubekit
+{
+    namespace task
+    {
+        class proxy_task;
+    }
+
+    namespace connection
+    {
+        /**
+         * @brief raw TCP relay between an accepted client and an upstream connection,
+         *        bytes are moved socket -> pipe -> socket by splice and never enter user space
+         *
+         */
+        class proxy_connection : public connection
+        {
+        public:
+            friend class tubekit::task::proxy_task;
+
+            /**
+             * @brief one way of the relay, source and destination sockets are given to relay
+             *
+             */
+            struct direction
+            {
+                int pipe[2]{-1, -1};
+                size_t pipe_size{0};
+                size_t pending{0};    // bytes in pipe
+                uint64_t bytes{0};    // bytes read from source
+                bool eof{false};      // source shut its write side
+                bool shutdown{false}; // destination write side shut after eof was drained
+                bool blocked{false};  // destination is not writable
+            };
+
+        public:
+            proxy_connection(tubekit::socket::socket *socket_ptr);
+            ~proxy_connection();
+
+            /**
+             * @brief bytes relayed from client to upstream
+             *
+             * @return uint64_t
+             */
+            uint64_t get_bytes_up() const;
+            /**
+             * @brief bytes relayed from upstream to client
+             *
+             * @return uint64_t
+             */
+            uint64_t get_bytes_down() const;
+
+        private:
+            bool open_pipes();
+            void close_pipes();
+            /**
+             * @brief move bytes until source and destination would both block, shut destination after source eof drained
+             *
+             * @param dir
+             * @param from
+             * @param to
+             * @return int 0 success, -1 socket error
+             */
+            int relay(direction &dir, tubekit::socket::socket *from, tubekit::socket::socket *to);
+
+        public:
+            virtual void on_mark_close() override;
+            virtual void reuse() override;
+
+        public:
+            tubekit::socket::socket *upstream{nullptr};
+            bool connecting{false};
+            direction up{};   // client to upstream
+            direction down{}; // upstream to client
+        };
+    }
+}
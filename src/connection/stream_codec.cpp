@@ -0,0 +1,195 @@
+#include <cstring>
+#include <zlib/zlib.h>
+
+#include "connection/stream_codec.h"
+
+using tubekit::connection::stream_codec;
+
+static inline void write_uint32_be(char *out, uint32_t value)
+{
+    out[0] = (char)(value >> 24);
+    out[1] = (char)(value >> 16);
+    out[2] = (char)(value >> 8);
+    out[3] = (char)value;
+}
+
+static inline uint32_t read_uint32_be(const char *in)
+{
+    const unsigned char *bytes = (const unsigned char *)in;
+    return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) | ((uint32_t)bytes[2] << 8) | bytes[3];
+}
+
+stream_codec::stream_codec()
+{
+}
+
+stream_codec::~stream_codec()
+{
+}
+
+bool stream_codec::parse_prefix(const std::string &name, prefix &out)
+{
+    if (name.empty() || name == "varint")
+    {
+        out = prefix::VARINT;
+        return true;
+    }
+    if (name == "fixed32")
+    {
+        out = prefix::FIXED32;
+        return true;
+    }
+    if (name == "none")
+    {
+        out = prefix::NONE;
+        return true;
+    }
+    return false;
+}
+
+void stream_codec::init(prefix type, bool checksum, uint64_t max_frame)
+{
+    m_prefix = type;
+    m_checksum = checksum && type != prefix::NONE;
+    m_max_frame = max_frame;
+    reset();
+}
+
+void stream_codec::reset()
+{
+    m_head_len = 0;
+    m_payload_len = 0;
+}
+
+size_t stream_codec::head_size(uint64_t payload_len) const
+{
+    if (m_prefix == prefix::FIXED32)
+    {
+        return 4;
+    }
+    if (m_prefix == prefix::NONE)
+    {
+        return 0;
+    }
+    size_t size = 1;
+    while (payload_len >= 0x80)
+    {
+        payload_len >>= 7;
+        size++;
+    }
+    return size;
+}
+
+int stream_codec::next(const char *data, size_t len, size_t &consumed, std::string_view &payload)
+{
+    consumed = 0;
+    const size_t tail_len = m_checksum ? checksum_size : 0;
+
+    if (m_prefix == prefix::NONE)
+    {
+        if (len == 0)
+        {
+            return NEED_MORE;
+        }
+        if (len > m_max_frame)
+        {
+            return FAILED;
+        }
+        payload = std::string_view(data, len);
+        consumed = len;
+        return FRAME;
+    }
+
+    if (m_head_len == 0)
+    {
+        if (m_prefix == prefix::FIXED32)
+        {
+            if (len < 4)
+            {
+                return NEED_MORE;
+            }
+            m_payload_len = read_uint32_be(data);
+            m_head_len = 4;
+        }
+        else
+        {
+            uint64_t value = 0;
+            size_t i = 0;
+            for (; i < len && i < max_head_size; i++)
+            {
+                const uint8_t byte = data[i];
+                value |= (uint64_t)(byte & 0x7f) << (7 * i);
+                if (!(byte & 0x80))
+                {
+                    break;
+                }
+            }
+            if (i == max_head_size)
+            {
+                return FAILED;
+            }
+            if (i == len)
+            {
+                return NEED_MORE;
+            }
+            m_payload_len = value;
+            m_head_len = i + 1;
+        }
+        if (m_head_len + m_payload_len + tail_len > m_max_frame)
+        {
+            return FAILED;
+        }
+    }
+
+    // the head is not parsed again while the rest of frame arrives
+    const uint64_t frame_len = m_head_len + m_payload_len + tail_len;
+    if (len < frame_len)
+    {
+        return NEED_MORE;
+    }
+    payload = std::string_view(data + m_head_len, m_payload_len);
+    if (m_checksum && read_uint32_be(data + m_head_len + m_payload_len) != (uint32_t)crc32(0, (const Bytef *)payload.data(), payload.size()))
+    {
+        return FAILED;
+    }
+    consumed = frame_len;
+    reset();
+    return FRAME;
+}
+
+size_t stream_codec::begin_frame(std::string &out, uint64_t payload_len) const
+{
+    const size_t head_len = head_size(payload_len);
+    out.resize(head_len + payload_len + (m_checksum ? checksum_size : 0));
+    if (m_prefix == prefix::FIXED32)
+    {
+        write_uint32_be(&out[0], (uint32_t)payload_len);
+    }
+    else
+    {
+        for (size_t i = 0; i < head_len; i++)
+        {
+            out[i] = (char)((payload_len & 0x7f) | (i + 1 < head_len ? 0x80 : 0));
+            payload_len >>= 7;
+        }
+    }
+    return head_len;
+}
+
+void stream_codec::end_frame(std::string &out, size_t payload_offset, uint64_t payload_len) const
+{
+    if (m_checksum)
+    {
+        write_uint32_be(&out[payload_offset + payload_len], (uint32_t)crc32(0, (const Bytef *)out.data() + payload_offset, payload_len));
+    }
+}
+
+void stream_codec::encode(const char *data, size_t len, std::string &out) const
+{
+    const size_t offset = begin_frame(out, len);
+    if (len > 0)
+    {
+        memcpy(&out[offset], data, len);
+    }
+    end_frame(out, offset, len);
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace tubekit
+{
+    namespace connection
+    {
+        /**
+         * @brief length prefixed framing of stream_connection,
+         *        frame = length prefix + payload + optional crc32 of payload (4 bytes big endian),
+         *        the prefix is a protobuf style varint or 4 bytes big endian,
+         *        or none for packets written bare as before framing, where all readable bytes are one frame
+         *
+         * the prefix of a frame is parsed once, the frame is handed out only when all of it is in recv buffer
+         */
+        class stream_codec
+        {
+        public:
+            enum class prefix
+            {
+                VARINT,
+                FIXED32,
+                NONE
+            };
+
+            enum result
+            {
+                FAILED = -1, // bad prefix, too big or checksum mismatch, close the connection
+                NEED_MORE = 0,
+                FRAME = 1
+            };
+
+            static constexpr size_t max_head_size{5};
+            static constexpr size_t checksum_size{4};
+
+        public:
+            stream_codec();
+            ~stream_codec();
+
+            /**
+             * @brief
+             *
+             * @param name varint, fixed32 or none
+             * @param out
+             * @return true
+             * @return false unknown name
+             */
+            static bool parse_prefix(const std::string &name, prefix &out);
+
+            /**
+             * @brief
+             *
+             * @param type
+             * @param checksum ignored by prefix none
+             * @param max_frame bytes of a whole frame, head and checksum included
+             */
+            void init(prefix type, bool checksum, uint64_t max_frame);
+
+            /**
+             * @brief forget the frame being waited for
+             *
+             */
+            void reset();
+
+            /**
+             * @brief decode the next frame from data, which starts where the last frame ended
+             *
+             * @param data readable bytes of recv buffer
+             * @param len
+             * @param consumed bytes of the frame, drop them from recv buffer after payload is used
+             * @param payload view into data
+             * @return int result
+             */
+            int next(const char *data, size_t len, size_t &consumed, std::string_view &payload);
+
+            /**
+             * @brief resize out to a whole frame of payload_len and write its head, the caller fills payload and calls end_frame
+             *
+             * @param out
+             * @param payload_len
+             * @return size_t offset of payload in out
+             */
+            size_t begin_frame(std::string &out, uint64_t payload_len) const;
+            void end_frame(std::string &out, size_t payload_offset, uint64_t payload_len) const;
+
+            /**
+             * @brief frame of data
+             *
+             * @param data
+             * @param len
+             * @param out
+             */
+            void encode(const char *data, size_t len, std::string &out) const;
+
+            /**
+             * @brief
+             *
+             * @return true frames have a length prefix
+             * @return false prefix none, a frame may be a part of packet or more than one packet
+             */
+            inline bool framed() const
+            {
+                return m_prefix != prefix::NONE;
+            }
+
+        private:
+            size_t head_size(uint64_t payload_len) const;
+
+        private:
+            prefix m_prefix{prefix::VARINT};
+            bool m_checksum{false};
+            uint64_t m_max_frame{0};
+
+            // frame whose head is parsed, waiting for the rest
+            size_t m_head_len{0};
+            uint64_t m_payload_len{0};
+        };
+    }
+}
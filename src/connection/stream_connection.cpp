@@ -2,6 +2,7 @@
 #include "connection/stream_connection.h"
 #include "utility/singleton.h"
 #include "socket/socket_handler.h"
+#include "server/server.h"
 #include <stdexcept>
 
 using tubekit::connection::stream_connection;
@@ -196,6 +197,7 @@ bool stream_connection::buf2sock(bool &closed)
         }
         else
         {
+            should_send_idx += len;
             should_send_size -= len;
             if (should_send_size <= 0)
             {
@@ -230,7 +232,7 @@ bool stream_connection::send(const char *buffer, size_t buffer_size)
 
     if (get_gid() > 0)
     {
-        singleton<socket_handler>::instance()->do_task(get_gid(), false, true);
+        schedule_flush();
     }
     else
     {
@@ -253,8 +255,7 @@ void stream_connection::reuse()
 {
     connection::reuse();
 
-    constexpr uint64_t mem_buffer_size_max = inner_buffer_size + 2; // 2MB
-    m_send_buffer.clear();                                          // GC
+    m_send_buffer.clear(); // GC
     m_send_buffer.set_limit_max(mem_buffer_size_max);
     m_recv_buffer.clear(); // GC
     m_recv_buffer.set_limit_max(mem_buffer_size_max);
@@ -266,4 +267,15 @@ void stream_connection::reuse()
     this->sock2buf_data_len = 0;
 
     write_end_callback = nullptr;
+
+    init_codec(codec);
+}
+
+void stream_connection::init_codec(stream_codec &codec)
+{
+    // a frame must fit in recv buffer
+    tubekit::server::server *server_ptr = singleton<tubekit::server::server>::instance();
+    stream_codec::prefix prefix_type = stream_codec::prefix::VARINT;
+    stream_codec::parse_prefix(server_ptr->get_stream_frame(), prefix_type);
+    codec.init(prefix_type, server_ptr->get_stream_frame_checksum(), mem_buffer_size_max);
 }
\ No newline at end of file
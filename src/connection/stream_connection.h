@@ -3,6 +3,7 @@
 #include <tubekit-buffer/buffer.h>
 
 #include "connection/connection.h"
+#include "connection/stream_codec.h"
 #include "socket/socket.h"
 #include "task/stream_task.h"
 
@@ -39,17 +40,26 @@ namespace tubekit
             virtual void on_mark_close() override;
             virtual void reuse() override;
 
+            /**
+             * @brief set codec to the framing of stream connections configured for server
+             *
+             * @param codec
+             */
+            static void init_codec(stream_codec &codec);
+
         public:
             buffer::buffer m_send_buffer;
             buffer::buffer m_recv_buffer;
             buffer::buffer m_wating_send_pack;
             std::function<bool(stream_connection &connection)> write_end_callback{nullptr};
+            stream_codec codec;
 
         private:
             int should_send_idx{-1};
             int should_send_size{0};
 
             static constexpr size_t inner_buffer_size{1024000};
+            static constexpr uint64_t mem_buffer_size_max{inner_buffer_size + 2}; // 2MB
             char buf2sock_inner_buffer[inner_buffer_size]{0};
             char sock2buf_inner_buffer[inner_buffer_size]{0};
 
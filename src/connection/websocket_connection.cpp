@@ -1,6 +1,8 @@
 #include "connection/websocket_connection.h"
 #include "utility/singleton.h"
 #include "socket/socket_handler.h"
+#include "server/server.h"
+#include "thread/auto_lock.h"
 #include <tubekit-log/logger.h>
 #include <stdexcept>
 
@@ -48,8 +50,9 @@ void websocket_connection::reuse()
     this->everything_end = false;
     this->is_upgrade = false;
 
-    constexpr uint64_t mem_buffer_size_max = inner_buffer_size + 2; // 2MB
-    this->m_recv_buffer.clear();                                    // GC
+    // room for a payload waited in place and one more recv, so a partial frame never blocks sock2buf
+    constexpr uint64_t mem_buffer_size_max = inner_buffer_size * 2 + 16; // 2MB
+    this->m_recv_buffer.clear();                                         // GC
     this->m_recv_buffer.set_limit_max(mem_buffer_size_max);
 
     this->m_send_buffer.clear(); // GC
@@ -58,6 +61,10 @@ void websocket_connection::reuse()
     this->m_wating_send_pack.clear(); // GC
     this->m_wating_send_pack.set_limit_max(mem_buffer_size_max);
 
+    this->decoder.reset();
+    this->deflate.reset();
+    this->decoder.init(singleton<tubekit::server::server>::instance()->get_websocket_max_message(), inner_buffer_size);
+
     this->destory_callback = nullptr;
     this->write_end_callback = nullptr;
 
@@ -263,6 +270,7 @@ bool websocket_connection::buf2sock(bool &closed)
         }
         else
         {
+            should_send_idx += len;
             should_send_size -= len;
             if (should_send_size <= 0)
             {
@@ -301,7 +309,7 @@ bool websocket_connection::send(const char *buffer, size_t buffer_size, bool che
 
     if (get_gid() > 0)
     {
-        singleton<socket_handler>::instance()->do_task(get_gid(), false, true);
+        schedule_flush();
     }
     else
     {
@@ -310,4 +318,102 @@ bool websocket_connection::send(const char *buffer, size_t buffer_size, bool che
     }
 
     return true;
+}
+
+bool websocket_connection::send_message(uint8_t first_byte, const char *data, size_t data_len, frame_cache *cache /*= nullptr*/)
+{
+    if (!get_connected() || (data == nullptr && data_len > 0))
+    {
+        return false;
+    }
+
+    const bool compressible = deflate.get_enable() && !(first_byte & 0x08) &&
+                              data_len >= singleton<tubekit::server::server>::instance()->get_websocket_deflate_min_length();
+    if (compressible && deflate.get_params().server_no_context_takeover)
+    {
+        // every message is compressed alone, so the frame is the same for connections with the same window
+        const int window_bits = deflate.get_params().server_max_window_bits;
+        std::string compressed;
+        std::string *frame = cache ? &cache->compressed[window_bits] : &compressed;
+        if (cache)
+        {
+            // a built frame is not changed again, it is read without lock
+            cache->mutex.lock();
+        }
+        if (frame->empty() && !(cache && cache->compress_failed[window_bits]))
+        {
+            std::string payload;
+            // incompressible data is sent plain, no context has to follow it
+            if (websocket_deflate::compress_alone(data, data_len, window_bits, payload) && payload.size() < data_len)
+            {
+                build_frame(first_byte | 0x40, payload.data(), payload.size(), *frame);
+            }
+            else if (cache)
+            {
+                cache->compress_failed[window_bits] = true;
+            }
+        }
+        if (cache)
+        {
+            cache->mutex.unlock();
+        }
+        if (!frame->empty())
+        {
+            return send(frame->data(), frame->size());
+        }
+    }
+    else if (compressible)
+    {
+        // the frame is queued in the order of the shared compression context
+        auto_lock lock(deflate.get_mutex());
+        std::string payload;
+        if (deflate.compress(data, data_len, payload))
+        {
+            std::string frame;
+            build_frame(first_byte | 0x40, payload.data(), payload.size(), frame);
+            return send(frame.data(), frame.size());
+        }
+    }
+
+    std::string plain;
+    std::string *frame = cache ? &cache->plain : &plain;
+    if (cache)
+    {
+        cache->mutex.lock();
+    }
+    if (frame->empty())
+    {
+        build_frame(first_byte, data, data_len, *frame);
+    }
+    if (cache)
+    {
+        cache->mutex.unlock();
+    }
+    return send(frame->data(), frame->size());
+}
+
+void websocket_connection::build_frame(uint8_t first_byte, const char *data, size_t data_len, std::string &out)
+{
+    out.clear();
+    out.reserve(data_len + 10);
+    out.push_back((char)first_byte);
+    if (data_len <= 125)
+    {
+        out.push_back((char)data_len);
+    }
+    else if (data_len <= 0xFFFF)
+    {
+        out.push_back((char)126);
+        out.push_back((char)((data_len >> 8) & 0xFF));
+        out.push_back((char)(data_len & 0xFF));
+    }
+    else
+    {
+        out.push_back((char)127);
+        for (int i = 7; i >= 0; --i)
+        {
+            out.push_back((char)((data_len >> (8 * i)) & 0xFF));
+        }
+    }
+    out.append(data, data_len);
 }
\ No newline at end of file
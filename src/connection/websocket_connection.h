@@ -9,6 +9,8 @@
 #include <tubekit-buffer/buffer.h>
 
 #include "connection/connection.h"
+#include "connection/websocket_decoder.h"
+#include "connection/websocket_deflate.h"
 #include "socket/socket.h"
 #include "task/websocket_task.h"
 
@@ -60,6 +62,38 @@ namespace tubekit
              */
             bool send(const char *buffer, size_t buffer_size, bool check_connected = true);
 
+            // frames of one message to many connections, each is built at most once
+            struct frame_cache
+            {
+                tubekit::thread::mutex mutex; // connections are sent to by their own workers
+                std::string plain{};
+                std::string compressed[16]{}; // by server_max_window_bits, for connections without server context takeover
+                bool compress_failed[16]{false};
+            };
+
+            /**
+             * @brief thread safe, queue a whole message as one frame, text and binary messages are compressed
+             *        when permessage-deflate is agreed
+             *
+             * @param first_byte FIN and opcode
+             * @param data
+             * @param data_len
+             * @param cache not nullptr when the same message is sent to many connections
+             * @return true
+             * @return false
+             */
+            bool send_message(uint8_t first_byte, const char *data, size_t data_len, frame_cache *cache = nullptr);
+
+            /**
+             * @brief server frame without mask
+             *
+             * @param first_byte FIN, RSV and opcode
+             * @param data
+             * @param data_len
+             * @param out
+             */
+            static void build_frame(uint8_t first_byte, const char *data, size_t data_len, std::string &out);
+
         public:
             std::string url{};
             std::string method{};
@@ -77,6 +111,8 @@ namespace tubekit
             buffer::buffer m_recv_buffer;
             buffer::buffer m_send_buffer;
             buffer::buffer m_wating_send_pack;
+            websocket_decoder decoder;
+            websocket_deflate deflate;
 
             std::function<void(websocket_connection &connection)> destory_callback{nullptr};
             std::function<bool(websocket_connection &connection)> write_end_callback{nullptr};
@@ -0,0 +1,269 @@
+#include <cstring>
+#include <tubekit-log/logger.h>
+
+#include "connection/websocket_decoder.h"
+#include "utility/websocket_mask.h"
+#include "utility/singleton.h"
+#include "utility/object_pool.h"
+
+using tubekit::connection::websocket_decoder;
+using tubekit::utility::object_pool;
+using tubekit::utility::singleton;
+using tubekit::utility::websocket_mask;
+
+// a message buffer bigger than it is freed when returned to pool
+static constexpr size_t message_buffer_keep{256 * 1024};
+
+websocket_decoder::websocket_decoder()
+{
+}
+
+websocket_decoder::~websocket_decoder()
+{
+    // message buffer belongs to object_pool, which may be destroyed first at exit
+}
+
+void websocket_decoder::init(uint64_t max_message, uint64_t in_place_max)
+{
+    m_max_message = max_message;
+    m_in_place_max = in_place_max;
+}
+
+void websocket_decoder::set_deflate(websocket_deflate *deflate)
+{
+    m_deflate = deflate;
+}
+
+uint16_t websocket_decoder::get_close_code() const
+{
+    return m_close_code;
+}
+
+void websocket_decoder::reset()
+{
+    give_buffer();
+    m_close_code = 0;
+    m_stage = stage::HEAD;
+    m_fin = false;
+    m_opcode = 0;
+    m_payload_length = 0;
+    m_unmasked = 0;
+    m_in_place = false;
+    m_fragmented = false;
+    m_compressed = false;
+    m_message_opcode = 0;
+    m_deflate = nullptr;
+    m_utf8.reset();
+}
+
+void websocket_decoder::unmask(char *data, size_t len)
+{
+    // the key turns with the payload offset of data
+    const uint8_t phase = m_unmasked & 3;
+    const uint8_t key[4] = {m_key[phase], m_key[(phase + 1) & 3], m_key[(phase + 2) & 3], m_key[(phase + 3) & 3]};
+    websocket_mask::unmask(data, len, key);
+    m_unmasked += len;
+}
+
+bool websocket_decoder::take_buffer()
+{
+    m_buffer = singleton<object_pool<message_buffer>>::instance()->allocate();
+    if (!m_buffer)
+    {
+        LOG_ERROR("websocket message_buffer object_pool is empty");
+        return false;
+    }
+    m_buffer->data.clear();
+    return true;
+}
+
+void websocket_decoder::give_buffer()
+{
+    if (m_buffer)
+    {
+        if (m_buffer->data.capacity() > message_buffer_keep)
+        {
+            std::string().swap(m_buffer->data);
+        }
+        m_buffer->data.clear();
+        singleton<object_pool<message_buffer>>::instance()->release(m_buffer);
+        m_buffer = nullptr;
+    }
+}
+
+int websocket_decoder::next(char *data, size_t len, size_t &consumed, message &out)
+{
+    consumed = 0;
+    if (m_close_code != 0)
+    {
+        return FAILED;
+    }
+    // the last message handed out of message buffer is used
+    if (!m_fragmented)
+    {
+        give_buffer();
+    }
+
+    while (true)
+    {
+        if (m_stage == stage::HEAD)
+        {
+            if (len < 2)
+            {
+                return NEED_MORE;
+            }
+            const uint8_t first = data[0];
+            const uint8_t second = data[1];
+            const uint8_t length7 = second & 0x7f;
+            const bool masked = (second & 0x80) != 0;
+            size_t head_len = 2 + (length7 == 126 ? 2 : (length7 == 127 ? 8 : 0)) + (masked ? 4 : 0);
+            if (len < head_len)
+            {
+                return NEED_MORE;
+            }
+
+            m_fin = (first & 0x80) != 0;
+            m_opcode = first & 0x0f;
+            uint64_t payload_length = length7;
+            const unsigned char *pos = (const unsigned char *)data + 2;
+            if (length7 == 126)
+            {
+                payload_length = ((uint64_t)pos[0] << 8) | pos[1];
+                pos += 2;
+            }
+            else if (length7 == 127)
+            {
+                payload_length = 0;
+                for (int i = 0; i < 8; i++)
+                {
+                    payload_length = (payload_length << 8) | pos[i];
+                }
+                pos += 8;
+            }
+
+            const bool control = m_opcode & 0x08;
+            // RSV1 marks a compressed message on its first frame
+            const bool compressed = (first & 0x40) && m_deflate && (m_opcode == TEXT || m_opcode == BINARY);
+            bool valid = masked && (first & (compressed ? 0x30 : 0x70)) == 0 && !(payload_length >> 63);
+            if (control)
+            {
+                // a close body is empty or a 2 byte code with reason
+                valid = valid && m_fin && payload_length <= 125 && (m_opcode == CLOSE || m_opcode == PING || m_opcode == PONG);
+                valid = valid && !(m_opcode == CLOSE && payload_length == 1);
+            }
+            else if (m_opcode == CONTINUATION)
+            {
+                valid = valid && m_fragmented;
+            }
+            else
+            {
+                valid = valid && !m_fragmented && (m_opcode == TEXT || m_opcode == BINARY);
+            }
+            if (!valid)
+            {
+                m_close_code = CLOSE_PROTOCOL_ERROR;
+                return FAILED;
+            }
+            const uint64_t joined = m_fragmented ? m_buffer->data.size() : 0;
+            if (!control && (payload_length > m_max_message || joined + payload_length > m_max_message))
+            {
+                m_close_code = CLOSE_TOO_BIG;
+                return FAILED;
+            }
+
+            memcpy(m_key, pos, 4);
+            m_payload_length = payload_length;
+            m_unmasked = 0;
+            m_in_place = control || (m_fin && m_opcode != CONTINUATION && !compressed && payload_length <= m_in_place_max);
+            if (!m_in_place && m_opcode != CONTINUATION)
+            {
+                if (!take_buffer())
+                {
+                    m_close_code = CLOSE_TRY_AGAIN_LATER;
+                    return FAILED;
+                }
+                m_fragmented = true;
+                m_compressed = compressed;
+                m_message_opcode = m_opcode;
+                m_utf8.reset();
+            }
+            m_stage = stage::PAYLOAD;
+            data += head_len;
+            len -= head_len;
+            consumed += head_len;
+        }
+
+        if (m_in_place)
+        {
+            // wait the whole payload in recv buffer, bytes already unmasked are not touched again
+            const uint64_t arrived = len < m_payload_length ? len : m_payload_length;
+            if (arrived > m_unmasked)
+            {
+                unmask(data + m_unmasked, arrived - m_unmasked);
+            }
+            if (arrived < m_payload_length)
+            {
+                return NEED_MORE;
+            }
+            m_stage = stage::HEAD;
+            out.opcode = m_opcode;
+            out.payload = std::string_view(data, m_payload_length);
+            consumed += m_payload_length;
+            const bool text = m_opcode == TEXT || (m_opcode == CLOSE && m_payload_length > 2);
+            const size_t text_offset = m_opcode == CLOSE ? 2 : 0;
+            if (text && !tubekit::json::utf8_validator::validate(data + text_offset, m_payload_length - text_offset))
+            {
+                m_close_code = CLOSE_INVALID_PAYLOAD;
+                return FAILED;
+            }
+            return (m_opcode & 0x08) ? CONTROL : MESSAGE;
+        }
+
+        // append to message buffer as it arrives
+        const uint64_t left = m_payload_length - m_unmasked;
+        const size_t part = len < left ? len : left;
+        const size_t joined = m_buffer->data.size();
+        if (m_compressed)
+        {
+            unmask(data, part);
+            int res = m_deflate->decompress(data, part, m_fin && part == left, m_buffer->data, m_max_message);
+            if (res != websocket_deflate::INFLATE_OK)
+            {
+                m_close_code = res == websocket_deflate::INFLATE_TOO_BIG ? CLOSE_TOO_BIG : (res == websocket_deflate::INFLATE_NO_STREAM ? CLOSE_TRY_AGAIN_LATER : CLOSE_INVALID_PAYLOAD);
+                return FAILED;
+            }
+        }
+        else if (part > 0)
+        {
+            unmask(data, part);
+            m_buffer->data.append(data, part);
+        }
+        // fail fast on the bytes just joined, a character may go on in the next part
+        if (m_message_opcode == TEXT && !m_utf8.update(m_buffer->data.data() + joined, m_buffer->data.size() - joined))
+        {
+            m_close_code = CLOSE_INVALID_PAYLOAD;
+            return FAILED;
+        }
+        data += part;
+        len -= part;
+        consumed += part;
+        if (m_unmasked < m_payload_length)
+        {
+            return NEED_MORE;
+        }
+        m_stage = stage::HEAD;
+        if (m_fin)
+        {
+            if (m_message_opcode == TEXT && !m_utf8.finish())
+            {
+                m_close_code = CLOSE_INVALID_PAYLOAD;
+                return FAILED;
+            }
+            m_fragmented = false;
+            m_compressed = false;
+            out.opcode = m_message_opcode;
+            out.payload = m_buffer->data;
+            return MESSAGE;
+        }
+    }
+}
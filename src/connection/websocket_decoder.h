@@ -0,0 +1,136 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <tubekit-json/utf8.h>
+
+#include "connection/websocket_deflate.h"
+
+namespace tubekit
+{
+    namespace connection
+    {
+        /**
+         * @brief incremental websocket frame decoder of websocket_connection (RFC 6455 5.2),
+         *        a frame head is parsed once and dropped, payload is unmasked in place as it arrives,
+         *        an unfragmented message is handed out as a view into the recv buffer,
+         *        fragments are joined in a pooled message buffer, control frames may come between fragments,
+         *        compressed messages (RSV1 of permessage-deflate) are inflated into the message buffer as they arrive,
+         *        text messages and close reasons must be UTF-8, fragmented text is validated part by part
+         *
+         * usage: loop next() on the readable bytes of recv buffer, drop consumed bytes after each call
+         */
+        class websocket_decoder
+        {
+        public:
+            enum opcode
+            {
+                CONTINUATION = 0x0,
+                TEXT = 0x1,
+                BINARY = 0x2,
+                CLOSE = 0x8,
+                PING = 0x9,
+                PONG = 0xa
+            };
+
+            enum result
+            {
+                FAILED = -1, // close with get_close_code()
+                NEED_MORE = 0,
+                MESSAGE = 1, // whole text or binary message
+                CONTROL = 2  // close, ping or pong
+            };
+
+            // close status codes
+            static constexpr uint16_t CLOSE_NORMAL{1000};
+            static constexpr uint16_t CLOSE_PROTOCOL_ERROR{1002};
+            static constexpr uint16_t CLOSE_INVALID_PAYLOAD{1007};
+            static constexpr uint16_t CLOSE_TOO_BIG{1009};
+            static constexpr uint16_t CLOSE_TRY_AGAIN_LATER{1013};
+
+            struct message
+            {
+                uint8_t opcode{0};
+                std::string_view payload{};
+            };
+
+            // reassembly buffer of fragmented messages, taken from object_pool while a message is in progress
+            struct message_buffer
+            {
+                std::string data{};
+            };
+
+        public:
+            websocket_decoder();
+            ~websocket_decoder();
+
+            /**
+             * @brief
+             *
+             * @param max_message bytes of a whole message, bigger messages fail with CLOSE_TOO_BIG
+             * @param in_place_max bytes of the biggest payload waited for in recv buffer, bigger ones go to message buffer
+             */
+            void init(uint64_t max_message, uint64_t in_place_max);
+
+            /**
+             * @brief allow compressed messages after permessage-deflate is agreed
+             *
+             * @param deflate nullptr disallow
+             */
+            void set_deflate(websocket_deflate *deflate);
+
+            /**
+             * @brief decode from data, which starts where the last call stopped
+             *
+             * @param data readable bytes of recv buffer, payload is unmasked in place
+             * @param len
+             * @param consumed bytes to drop from recv buffer after out is used
+             * @param out valid until consumed bytes are dropped or next() is called again
+             * @return int result
+             */
+            int next(char *data, size_t len, size_t &consumed, message &out);
+
+            uint16_t get_close_code() const;
+
+            /**
+             * @brief back to the first frame, message buffer is returned to pool, compressed messages are disallowed
+             *
+             */
+            void reset();
+
+        private:
+            void unmask(char *data, size_t len);
+            bool take_buffer();
+            void give_buffer();
+
+        private:
+            enum class stage
+            {
+                HEAD,
+                PAYLOAD
+            };
+
+            uint64_t m_max_message{0};
+            uint64_t m_in_place_max{0};
+            uint16_t m_close_code{0};
+
+            // frame being decoded
+            stage m_stage{stage::HEAD};
+            bool m_fin{false};
+            uint8_t m_opcode{0};
+            uint8_t m_key[4]{0};
+            uint64_t m_payload_length{0};
+            uint64_t m_unmasked{0}; // payload bytes already unmasked
+            bool m_in_place{false};
+
+            // fragmented message
+            bool m_fragmented{false};
+            bool m_compressed{false};
+            uint8_t m_message_opcode{0};
+            message_buffer *m_buffer{nullptr};
+            websocket_deflate *m_deflate{nullptr};
+            tubekit::json::utf8_validator m_utf8;
+        };
+    }
+}
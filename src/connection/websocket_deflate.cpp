@@ -0,0 +1,370 @@
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+#include <tubekit-log/logger.h>
+
+#include "connection/websocket_deflate.h"
+#include "utility/singleton.h"
+#include "utility/object_pool.h"
+
+using tubekit::connection::websocket_deflate;
+using tubekit::utility::object_pool;
+using tubekit::utility::singleton;
+
+static const unsigned char deflate_tail[4] = {0x00, 0x00, 0xff, 0xff};
+
+static inline std::string_view trim(std::string_view str)
+{
+    while (!str.empty() && (str.front() == ' ' || str.front() == '\t'))
+    {
+        str.remove_prefix(1);
+    }
+    while (!str.empty() && (str.back() == ' ' || str.back() == '\t'))
+    {
+        str.remove_suffix(1);
+    }
+    return str;
+}
+
+// memory of a deflater is (1 << (window_bits + 2)) + (1 << (mem_level + 9)), a smaller window also uses a smaller hash
+static inline int mem_level_of(int window_bits)
+{
+    int mem_level = window_bits - 7;
+    return mem_level < 1 ? 1 : (mem_level > 8 ? 8 : mem_level);
+}
+
+websocket_deflate::stream::stream()
+{
+    memset(&z, 0, sizeof(z));
+}
+
+websocket_deflate::stream::~stream()
+{
+    end();
+}
+
+bool websocket_deflate::stream::prepare(bool deflater, int bits)
+{
+    if (inited && is_deflater == deflater && window_bits == bits)
+    {
+        return Z_OK == (deflater ? deflateReset(&z) : inflateReset(&z));
+    }
+    end();
+    memset(&z, 0, sizeof(z));
+    int ret = deflater ? deflateInit2(&z, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -bits, mem_level_of(bits), Z_DEFAULT_STRATEGY)
+                       : inflateInit2(&z, -bits);
+    if (ret != Z_OK)
+    {
+        LOG_ERROR("websocket_deflate zlib init return %d", ret);
+        return false;
+    }
+    inited = true;
+    is_deflater = deflater;
+    window_bits = bits;
+    return true;
+}
+
+void websocket_deflate::stream::end()
+{
+    if (inited)
+    {
+        is_deflater ? deflateEnd(&z) : inflateEnd(&z);
+        inited = false;
+    }
+}
+
+websocket_deflate::websocket_deflate()
+{
+}
+
+websocket_deflate::~websocket_deflate()
+{
+    // streams belong to object_pool, which may be destroyed first at exit
+}
+
+bool websocket_deflate::negotiate(std::string_view offers, int window_bits, bool no_context_takeover, params &out, std::string &response)
+{
+    while (!offers.empty())
+    {
+        size_t comma = offers.find(',');
+        std::string_view offer = offers.substr(0, comma);
+        offers = comma == std::string_view::npos ? std::string_view() : offers.substr(comma + 1);
+
+        size_t semicolon = offer.find(';');
+        if (trim(offer.substr(0, semicolon)) != "permessage-deflate")
+        {
+            continue;
+        }
+        offer = semicolon == std::string_view::npos ? std::string_view() : offer.substr(semicolon + 1);
+
+        params agreed;
+        agreed.server_max_window_bits = window_bits;
+        bool client_window_offered = false;
+        bool server_window_offered = false;
+        bool acceptable = true;
+        std::vector<std::string_view> seen;
+        while (acceptable && !offer.empty())
+        {
+            semicolon = offer.find(';');
+            std::string_view param = trim(offer.substr(0, semicolon));
+            offer = semicolon == std::string_view::npos ? std::string_view() : offer.substr(semicolon + 1);
+            size_t equal = param.find('=');
+            std::string_view name = trim(param.substr(0, equal));
+            std::string_view value = equal == std::string_view::npos ? std::string_view() : trim(param.substr(equal + 1));
+            if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
+            {
+                value = value.substr(1, value.size() - 2);
+            }
+            for (std::string_view name_seen : seen)
+            {
+                acceptable = acceptable && name_seen != name;
+            }
+            seen.push_back(name);
+
+            int bits = 0;
+            if (!value.empty())
+            {
+                bits = value.size() <= 2 ? atoi(std::string(value).c_str()) : 0;
+                // raw deflate of zlib can not use a window of 8
+                acceptable = acceptable && bits >= 8 && bits <= 15;
+            }
+            if (name == "server_no_context_takeover" && value.empty())
+            {
+                agreed.server_no_context_takeover = true;
+            }
+            else if (name == "client_no_context_takeover" && value.empty())
+            {
+                agreed.client_no_context_takeover = true;
+            }
+            else if (name == "server_max_window_bits" && !value.empty())
+            {
+                acceptable = acceptable && bits >= 9;
+                server_window_offered = true;
+                agreed.server_max_window_bits = bits < window_bits ? bits : window_bits;
+            }
+            else if (name == "client_max_window_bits")
+            {
+                client_window_offered = true;
+                agreed.client_max_window_bits = value.empty() ? 15 : (bits < 9 ? 9 : bits);
+            }
+            else
+            {
+                acceptable = false;
+            }
+        }
+        if (!acceptable)
+        {
+            continue;
+        }
+
+        // the server may always ask for smaller client window or no client context takeover
+        if (client_window_offered && window_bits < agreed.client_max_window_bits)
+        {
+            agreed.client_max_window_bits = window_bits;
+        }
+        if (no_context_takeover)
+        {
+            agreed.server_no_context_takeover = true;
+            agreed.client_no_context_takeover = true;
+        }
+
+        response = "permessage-deflate";
+        if (agreed.server_no_context_takeover)
+        {
+            response += "; server_no_context_takeover";
+        }
+        if (agreed.client_no_context_takeover)
+        {
+            response += "; client_no_context_takeover";
+        }
+        if (server_window_offered || agreed.server_max_window_bits < 15)
+        {
+            response += "; server_max_window_bits=" + std::to_string(agreed.server_max_window_bits);
+        }
+        if (client_window_offered)
+        {
+            response += "; client_max_window_bits=" + std::to_string(agreed.client_max_window_bits);
+        }
+        out = agreed;
+        return true;
+    }
+    return false;
+}
+
+bool websocket_deflate::compress_alone(const char *data, size_t len, int window_bits, std::string &out)
+{
+    stream *deflater = singleton<object_pool<stream>>::instance()->allocate();
+    if (!deflater)
+    {
+        return false;
+    }
+    bool res = deflater->prepare(true, window_bits) && deflate_into(deflater->z, data, len, out);
+    singleton<object_pool<stream>>::instance()->release(deflater);
+    return res;
+}
+
+void websocket_deflate::init(const params &agreed)
+{
+    reset();
+    m_params = agreed;
+    m_enable = true;
+}
+
+void websocket_deflate::reset()
+{
+    if (m_deflater)
+    {
+        singleton<object_pool<stream>>::instance()->release(m_deflater);
+        m_deflater = nullptr;
+    }
+    if (m_inflater)
+    {
+        singleton<object_pool<stream>>::instance()->release(m_inflater);
+        m_inflater = nullptr;
+    }
+    m_params = params{};
+    m_enable = false;
+}
+
+bool websocket_deflate::get_enable() const
+{
+    return m_enable;
+}
+
+const websocket_deflate::params &websocket_deflate::get_params() const
+{
+    return m_params;
+}
+
+tubekit::thread::mutex &websocket_deflate::get_mutex()
+{
+    return m_mutex;
+}
+
+bool websocket_deflate::compress(const char *data, size_t len, std::string &out)
+{
+    if (m_params.server_no_context_takeover)
+    {
+        return compress_alone(data, len, m_params.server_max_window_bits, out);
+    }
+    // the context lives as long as the connection
+    if (!m_deflater)
+    {
+        m_deflater = singleton<object_pool<stream>>::instance()->allocate();
+        if (!m_deflater)
+        {
+            return false;
+        }
+        if (!m_deflater->prepare(true, m_params.server_max_window_bits))
+        {
+            singleton<object_pool<stream>>::instance()->release(m_deflater);
+            m_deflater = nullptr;
+            return false;
+        }
+    }
+    if (!deflate_into(m_deflater->z, data, len, out))
+    {
+        // the shared context is broken, start a new one with the next message
+        singleton<object_pool<stream>>::instance()->release(m_deflater);
+        m_deflater = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool websocket_deflate::deflate_into(z_stream &z, const char *data, size_t len, std::string &out)
+{
+    out.resize(deflateBound(&z, len) + 16);
+    size_t used = 0;
+    z.next_in = (Bytef *)data;
+    z.avail_in = len;
+    while (true)
+    {
+        z.next_out = (Bytef *)&out[used];
+        z.avail_out = out.size() - used;
+        int ret = deflate(&z, Z_SYNC_FLUSH);
+        used = out.size() - z.avail_out;
+        if (ret != Z_OK && ret != Z_BUF_ERROR)
+        {
+            LOG_ERROR("websocket_deflate deflate return %d", ret);
+            return false;
+        }
+        if (z.avail_out > 0)
+        {
+            break; // flushed
+        }
+        out.resize(out.size() * 2);
+    }
+    out.resize(used);
+    if (out.size() < 4 || 0 != memcmp(out.data() + out.size() - 4, deflate_tail, 4))
+    {
+        return false;
+    }
+    out.resize(out.size() - 4);
+    return true;
+}
+
+int websocket_deflate::inflate_into(z_stream &z, const char *data, size_t len, std::string &out, uint64_t max_out)
+{
+    char chunk[16384];
+    z.next_in = (Bytef *)data;
+    z.avail_in = len;
+    do
+    {
+        z.next_out = (Bytef *)chunk;
+        z.avail_out = sizeof(chunk);
+        int ret = inflate(&z, Z_SYNC_FLUSH);
+        if (ret != Z_OK && ret != Z_BUF_ERROR && ret != Z_STREAM_END)
+        {
+            return INFLATE_ERROR;
+        }
+        size_t produced = sizeof(chunk) - z.avail_out;
+        if (out.size() + produced > max_out)
+        {
+            return INFLATE_TOO_BIG;
+        }
+        out.append(chunk, produced);
+        if (ret == Z_STREAM_END)
+        {
+            // a block with BFINAL ends the deflate stream, the rest of message is ignored
+            inflateReset(&z);
+            break;
+        }
+        if (ret == Z_BUF_ERROR && produced == 0)
+        {
+            break; // all input used
+        }
+    } while (z.avail_in > 0 || z.avail_out == 0);
+    return INFLATE_OK;
+}
+
+int websocket_deflate::decompress(const char *data, size_t len, bool end, std::string &out, uint64_t max_out)
+{
+    if (!m_inflater)
+    {
+        m_inflater = singleton<object_pool<stream>>::instance()->allocate();
+        if (!m_inflater)
+        {
+            LOG_ERROR("websocket_deflate stream object_pool is empty");
+            return INFLATE_NO_STREAM;
+        }
+        if (!m_inflater->prepare(false, m_params.client_max_window_bits))
+        {
+            singleton<object_pool<stream>>::instance()->release(m_inflater);
+            m_inflater = nullptr;
+            return INFLATE_ERROR;
+        }
+    }
+    int res = inflate_into(m_inflater->z, data, len, out, max_out);
+    if (res == INFLATE_OK && end)
+    {
+        res = inflate_into(m_inflater->z, (const char *)deflate_tail, sizeof(deflate_tail), out, max_out);
+    }
+    // a stream is kept between messages only for client context takeover
+    if (res != INFLATE_OK || (end && m_params.client_no_context_takeover))
+    {
+        singleton<object_pool<stream>>::instance()->release(m_inflater);
+        m_inflater = nullptr;
+    }
+    return res;
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <zlib/zlib.h>
+
+#include "thread/mutex.h"
+
+namespace tubekit
+{
+    namespace connection
+    {
+        /**
+         * @brief permessage-deflate (RFC 7692) of websocket_connection
+         *
+         * zlib streams come from a bounded object_pool and are initialized on first use, so memory is bounded by pool size,
+         * a direction without context takeover holds a stream only while one message is compressed or inflated
+         */
+        class websocket_deflate
+        {
+        public:
+            struct params
+            {
+                bool server_no_context_takeover{false};
+                bool client_no_context_takeover{false};
+                int server_max_window_bits{15}; // window of our deflater
+                int client_max_window_bits{15}; // window of our inflater
+            };
+
+            // pooled zlib stream
+            struct stream
+            {
+                stream();
+                ~stream();
+                /**
+                 * @brief (re)initialize for a raw deflate or inflate stream of window_bits, reset when already matching
+                 *
+                 * @param deflater
+                 * @param window_bits 9 to 15
+                 * @return true
+                 * @return false
+                 */
+                bool prepare(bool deflater, int window_bits);
+                void end();
+
+                z_stream z;
+                bool inited{false};
+                bool is_deflater{false};
+                int window_bits{0};
+            };
+
+            enum inflate_result
+            {
+                INFLATE_OK = 0,
+                INFLATE_ERROR = -1,
+                INFLATE_TOO_BIG = -2,
+                INFLATE_NO_STREAM = -3
+            };
+
+        public:
+            websocket_deflate();
+            ~websocket_deflate();
+
+            /**
+             * @brief pick the first acceptable permessage-deflate offer of Sec-WebSocket-Extensions
+             *
+             * @param offers joined values of Sec-WebSocket-Extensions
+             * @param window_bits biggest window of server, 9 to 15
+             * @param no_context_takeover ask both sides to compress each message alone
+             * @param out agreed params
+             * @param response value of Sec-WebSocket-Extensions in response
+             * @return true agreed
+             * @return false no acceptable offer
+             */
+            static bool negotiate(std::string_view offers, int window_bits, bool no_context_takeover, params &out, std::string &response);
+
+            /**
+             * @brief compress one message alone with a pooled stream, trailing 00 00 ff ff is removed
+             *
+             * @param data
+             * @param len
+             * @param window_bits
+             * @param out
+             * @return true
+             * @return false pool is empty or zlib error
+             */
+            static bool compress_alone(const char *data, size_t len, int window_bits, std::string &out);
+
+            void init(const params &agreed);
+            void reset();
+            bool get_enable() const;
+            const params &get_params() const;
+
+            /**
+             * @brief compress next message of this connection, trailing 00 00 ff ff is removed
+             *
+             * call with get_mutex() locked until the frame is queued, so messages leave in the order of the shared context
+             *
+             * @param data
+             * @param len
+             * @param out
+             * @return true
+             * @return false pool is empty or zlib error, send it uncompressed
+             */
+            bool compress(const char *data, size_t len, std::string &out);
+
+            /**
+             * @brief inflate part of a compressed message and append to out
+             *
+             * @param data
+             * @param len
+             * @param end last part of message
+             * @param out
+             * @param max_out out is not allowed bigger than it
+             * @return int inflate_result
+             */
+            int decompress(const char *data, size_t len, bool end, std::string &out, uint64_t max_out);
+
+            tubekit::thread::mutex &get_mutex();
+
+        private:
+            static bool deflate_into(z_stream &z, const char *data, size_t len, std::string &out);
+            static int inflate_into(z_stream &z, const char *data, size_t len, std::string &out, uint64_t max_out);
+
+        private:
+            bool m_enable{false};
+            params m_params{};
+            stream *m_deflater{nullptr};
+            stream *m_inflater{nullptr};
+            tubekit::thread::mutex m_mutex; // deflater may be used by the worker of any connection when broadcasting
+        };
+    }
+}
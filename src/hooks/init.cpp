@@ -4,6 +4,7 @@
 #include "app/http_app.h"
 #include "app/stream_app.h"
 #include "app/websocket_app.h"
+#include "app/proxy_app.h"
 #include "task/task_type.h"
 
 #include <iostream>
@@ -35,6 +36,10 @@ int init::run()
         {
             return websocket_app::on_init();
         }
+        case task::task_type::PROXY_TASK:
+        {
+            return proxy_app::on_init();
+        }
         default:
         {
             return -1;
@@ -4,6 +4,7 @@
 #include "app/http_app.h"
 #include "app/stream_app.h"
 #include "app/websocket_app.h"
+#include "app/proxy_app.h"
 #include "task/task_type.h"
 
 #include <iostream>
@@ -38,6 +39,11 @@ void stop::run()
             websocket_app::on_stop();
             break;
         }
+        case task::task_type::PROXY_TASK:
+        {
+            proxy_app::on_stop();
+            break;
+        }
         default:
             break;
         }
@@ -14,13 +14,19 @@
 #include "connection/http_connection.h"
 #include "connection/stream_connection.h"
 #include "connection/websocket_connection.h"
+#include "connection/proxy_connection.h"
+#include "connection/websocket_decoder.h"
+#include "connection/websocket_deflate.h"
 #include "connection/connection_mgr.h"
+#include "socket/admission.h"
 #include "task/http_task.h"
 #include "task/stream_task.h"
 #include "task/websocket_task.h"
+#include "task/proxy_task.h"
 #include "task/task_type.h"
 #include "task/task_mgr.h"
 #include "task/task_destory_impl.h"
+#include "socket/ssl_ticket_keys.h"
 
 using namespace std;
 using namespace tubekit::server;
@@ -86,11 +92,38 @@ void server::start()
             LOG_ERROR("SSL_CTX_use_PrivateKey_file error: %s", ERR_error_string(ERR_get_error(), nullptr));
             return;
         }
+
+        // HTTP/2 output buffer may grow and move between SSL_write retries
+        SSL_CTX_set_mode(m_ssl_context, SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+
+        if (get_ssl_ktls())
+        {
+#ifndef OPENSSL_NO_KTLS
+            SSL_CTX_set_options(m_ssl_context, SSL_OP_ENABLE_KTLS);
+#else
+            LOG_ERROR("ssl_ktls is not supported by %s", OpenSSL_version(OPENSSL_VERSION));
+#endif
+        }
+
+        if (0 != init_ssl_sessions())
+        {
+            return;
+        }
+
+        // ALPN, h2 is preferred when client offers it
+        if (get_task_type() == task::task_type::HTTP_TASK)
+        {
+            SSL_CTX_set_alpn_select_cb(m_ssl_context, alpn_select, this);
+        }
     }
 
     // worker pool
     worker_pool *m_worker_pool = singleton<worker_pool>::instance();
-    m_worker_pool->create(m_threads, new task_destory_impl());
+    m_worker_pool->create(m_threads,
+                          new task_destory_impl(),
+                          m_mailbox_size,
+                          m_overload_shedding ? m_overload_target * 1000 : 0,
+                          m_overload_interval * 1000);
 
     // socket object pool
     int iret = singleton<object_pool<socket::socket>>::instance()->init(m_connects, false);
@@ -122,6 +155,12 @@ void server::start()
     }
     case task::task_type::STREAM_TASK:
     {
+        connection::stream_codec::prefix stream_prefix;
+        if (!connection::stream_codec::parse_prefix(m_stream_frame, stream_prefix))
+        {
+            LOG_ERROR("unknown stream_frame %s", m_stream_frame.c_str());
+            return;
+        }
         iret = singleton<object_pool<connection::stream_connection>>::instance()->init(m_connects, false, nullptr);
         if (0 != iret)
         {
@@ -150,6 +189,34 @@ void server::start()
             LOG_ERROR("websocket_task object_pool init return %d", iret);
             return;
         }
+        iret = singleton<object_pool<connection::websocket_decoder::message_buffer>>::instance()->init(m_connects, false);
+        if (0 != iret)
+        {
+            LOG_ERROR("websocket_decoder::message_buffer object_pool init return %d", iret);
+            return;
+        }
+        iret = singleton<object_pool<connection::websocket_deflate::stream>>::instance()->init(m_websocket_deflate_streams, false);
+        if (0 != iret)
+        {
+            LOG_ERROR("websocket_deflate::stream object_pool init return %d", iret);
+            return;
+        }
+        break;
+    }
+    case task::task_type::PROXY_TASK:
+    {
+        iret = singleton<object_pool<connection::proxy_connection>>::instance()->init(m_connects, false, nullptr);
+        if (0 != iret)
+        {
+            LOG_ERROR("proxy_connection object_pool init return %d", iret);
+            return;
+        }
+        iret = singleton<object_pool<task::proxy_task>>::instance()->init(m_connects * 3, true, 0);
+        if (0 != iret)
+        {
+            LOG_ERROR("proxy_task object_pool init return %d", iret);
+            return;
+        }
         break;
     }
     default:
@@ -160,13 +227,24 @@ void server::start()
     }
 
     // connection_mgr
-    iret = singleton<connection::connection_mgr>::instance()->init(task_type, m_threads);
+    iret = singleton<connection::connection_mgr>::instance()->init(task_type, m_connects);
     if (0 != iret)
     {
         LOG_ERROR("connection_mgr init return %d", iret);
         return;
     }
 
+    // admission
+    if (m_admission)
+    {
+        iret = singleton<admission>::instance()->init(m_admission_options);
+        if (0 != iret)
+        {
+            LOG_ERROR("admission init return %d", iret);
+            return;
+        }
+    }
+
     // task_mgr
     iret = singleton<task::task_mgr>::instance()->init(task_type);
     if (0 != iret)
@@ -247,6 +325,10 @@ enum tubekit::task::task_type server::get_task_type()
     {
         return WEBSOCKET_TASK;
     }
+    else if (m_task_type == "PROXY_TASK")
+    {
+        return PROXY_TASK;
+    }
     return NONE;
 }
 
@@ -330,6 +412,74 @@ void server::to_stop()
     stop_flag = true;
 }
 
+int server::alpn_select(SSL *ssl, const unsigned char **out, unsigned char *outlen, const unsigned char *in, unsigned int inlen, void *arg)
+{
+    server *server_ptr = (server *)arg;
+    static const unsigned char h2_protos[] = "\x02h2\x08http/1.1";
+    static const unsigned char http1_protos[] = "\x08http/1.1";
+    const unsigned char *protos = server_ptr->get_http2() ? h2_protos : http1_protos;
+    const unsigned int protos_len = server_ptr->get_http2() ? sizeof(h2_protos) - 1 : sizeof(http1_protos) - 1;
+    if (OPENSSL_NPN_NEGOTIATED != SSL_select_next_proto((unsigned char **)out, outlen, protos, protos_len, in, inlen))
+    {
+        return SSL_TLSEXT_ERR_NOACK;
+    }
+    return SSL_TLSEXT_ERR_OK;
+}
+
+int server::init_ssl_sessions()
+{
+    // ECDHE key exchange and AEAD ciphers only
+    static const char intermediate_ciphers[] = "ECDHE-ECDSA-AES128-GCM-SHA256:ECDHE-RSA-AES128-GCM-SHA256:"
+                                               "ECDHE-ECDSA-AES256-GCM-SHA384:ECDHE-RSA-AES256-GCM-SHA384:"
+                                               "ECDHE-ECDSA-CHACHA20-POLY1305:ECDHE-RSA-CHACHA20-POLY1305";
+    static const char tls13_ciphersuites[] = "TLS_AES_128_GCM_SHA256:TLS_AES_256_GCM_SHA384:TLS_CHACHA20_POLY1305_SHA256";
+    const std::string &ciphers = get_ssl_ciphers();
+    if (ciphers == "modern" || ciphers == "intermediate")
+    {
+        const int min_version = ciphers == "modern" ? TLS1_3_VERSION : TLS1_2_VERSION;
+        if (1 != SSL_CTX_set_min_proto_version(m_ssl_context, min_version) ||
+            1 != SSL_CTX_set_ciphersuites(m_ssl_context, tls13_ciphersuites) ||
+            (min_version == TLS1_2_VERSION && 1 != SSL_CTX_set_cipher_list(m_ssl_context, intermediate_ciphers)) ||
+            1 != SSL_CTX_set1_groups_list(m_ssl_context, "X25519:P-256:P-384"))
+        {
+            LOG_ERROR("ssl_ciphers %s error: %s", ciphers.c_str(), ERR_error_string(ERR_get_error(), nullptr));
+            return -1;
+        }
+        SSL_CTX_set_options(m_ssl_context, SSL_OP_NO_COMPRESSION | SSL_OP_NO_RENEGOTIATION);
+    }
+    else if (!ciphers.empty())
+    {
+        LOG_ERROR("unknown ssl_ciphers %s", ciphers.c_str());
+        return -1;
+    }
+
+    if (get_ssl_release_buffers())
+    {
+        SSL_CTX_set_mode(m_ssl_context, SSL_MODE_RELEASE_BUFFERS);
+    }
+
+    // sessions are resumed by session id from the cache or by ticket without it
+    static const unsigned char session_id_context[] = "tubekit";
+    SSL_CTX_set_session_id_context(m_ssl_context, session_id_context, sizeof(session_id_context) - 1);
+    SSL_CTX_set_timeout(m_ssl_context, (long)get_ssl_session_timeout());
+    if (get_ssl_session_cache() > 0)
+    {
+        SSL_CTX_set_session_cache_mode(m_ssl_context, SSL_SESS_CACHE_SERVER);
+        SSL_CTX_sess_set_cache_size(m_ssl_context, (long)get_ssl_session_cache());
+    }
+    else
+    {
+        SSL_CTX_set_session_cache_mode(m_ssl_context, SSL_SESS_CACHE_OFF);
+    }
+
+    if (!get_ssl_session_tickets())
+    {
+        SSL_CTX_set_options(m_ssl_context, SSL_OP_NO_TICKET);
+        return 0;
+    }
+    return singleton<ssl_ticket_keys>::instance()->init(m_ssl_context, (time_t)get_ssl_ticket_key_rotate(), (time_t)get_ssl_session_timeout());
+}
+
 SSL_CTX *server::get_ssl_ctx()
 {
     return m_ssl_context;
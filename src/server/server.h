@@ -1,11 +1,13 @@
 #pragma once
 #include <string>
+#include <cstdint>
 
 #include <openssl/ssl.h>
 #include <openssl/err.h>
 #include <openssl/opensslv.h>
 
 #include "task/task_type.h"
+#include "socket/admission.h"
 
 namespace tubekit
 {
@@ -49,6 +51,290 @@ namespace tubekit
 
             SSL_CTX *get_ssl_ctx();
 
+            inline void set_http_request_view(bool http_request_view)
+            {
+                m_http_request_view = http_request_view;
+            }
+            inline bool get_http_request_view() const
+            {
+                return m_http_request_view;
+            }
+
+            inline void set_http_gzip(bool http_gzip)
+            {
+                m_http_gzip = http_gzip;
+            }
+            inline bool get_http_gzip() const
+            {
+                return m_http_gzip;
+            }
+            inline void set_http_gzip_min_length(size_t http_gzip_min_length)
+            {
+                m_http_gzip_min_length = http_gzip_min_length;
+            }
+            inline size_t get_http_gzip_min_length() const
+            {
+                return m_http_gzip_min_length;
+            }
+            inline void set_http_gzip_types(const std::string &http_gzip_types)
+            {
+                m_http_gzip_types = http_gzip_types;
+            }
+            inline const std::string &get_http_gzip_types() const
+            {
+                return m_http_gzip_types;
+            }
+            inline void set_http_gzip_cache_size(size_t http_gzip_cache_size)
+            {
+                m_http_gzip_cache_size = http_gzip_cache_size;
+            }
+            inline size_t get_http_gzip_cache_size() const
+            {
+                return m_http_gzip_cache_size;
+            }
+            inline void set_http_simd_parser(bool http_simd_parser)
+            {
+                m_http_simd_parser = http_simd_parser;
+            }
+            inline bool get_http_simd_parser() const
+            {
+                return m_http_simd_parser;
+            }
+            inline void set_http2(bool http2)
+            {
+                m_http2 = http2;
+            }
+            inline bool get_http2() const
+            {
+                return m_http2;
+            }
+            inline void set_http_upload_dir(const std::string &http_upload_dir)
+            {
+                m_http_upload_dir = http_upload_dir;
+            }
+            inline const std::string &get_http_upload_dir() const
+            {
+                return m_http_upload_dir;
+            }
+            inline void set_http_upload_max_size(uint64_t http_upload_max_size)
+            {
+                m_http_upload_max_size = http_upload_max_size;
+            }
+            inline uint64_t get_http_upload_max_size() const
+            {
+                return m_http_upload_max_size;
+            }
+            inline void set_http_proxy_pass(const std::string &http_proxy_pass)
+            {
+                m_http_proxy_pass = http_proxy_pass;
+            }
+            inline const std::string &get_http_proxy_pass() const
+            {
+                return m_http_proxy_pass;
+            }
+            inline void set_http_proxy_balance(const std::string &http_proxy_balance)
+            {
+                m_http_proxy_balance = http_proxy_balance;
+            }
+            inline const std::string &get_http_proxy_balance() const
+            {
+                return m_http_proxy_balance;
+            }
+            inline void set_http_proxy_keepalive(size_t http_proxy_keepalive)
+            {
+                m_http_proxy_keepalive = http_proxy_keepalive;
+            }
+            inline size_t get_http_proxy_keepalive() const
+            {
+                return m_http_proxy_keepalive;
+            }
+            inline void set_proxy_upstream(const std::string &proxy_upstream)
+            {
+                m_proxy_upstream = proxy_upstream;
+            }
+            inline const std::string &get_proxy_upstream() const
+            {
+                return m_proxy_upstream;
+            }
+            inline void set_stream_frame(const std::string &stream_frame)
+            {
+                m_stream_frame = stream_frame;
+            }
+            inline const std::string &get_stream_frame() const
+            {
+                return m_stream_frame;
+            }
+            inline void set_stream_frame_checksum(bool stream_frame_checksum)
+            {
+                m_stream_frame_checksum = stream_frame_checksum;
+            }
+            inline bool get_stream_frame_checksum() const
+            {
+                return m_stream_frame_checksum;
+            }
+            inline void set_websocket_max_message(uint64_t websocket_max_message)
+            {
+                m_websocket_max_message = websocket_max_message;
+            }
+            inline uint64_t get_websocket_max_message() const
+            {
+                return m_websocket_max_message;
+            }
+            inline void set_websocket_deflate(bool websocket_deflate)
+            {
+                m_websocket_deflate = websocket_deflate;
+            }
+            inline bool get_websocket_deflate() const
+            {
+                return m_websocket_deflate;
+            }
+            inline void set_websocket_deflate_window_bits(int websocket_deflate_window_bits)
+            {
+                m_websocket_deflate_window_bits = websocket_deflate_window_bits;
+            }
+            inline int get_websocket_deflate_window_bits() const
+            {
+                return m_websocket_deflate_window_bits;
+            }
+            inline void set_websocket_deflate_no_context_takeover(bool websocket_deflate_no_context_takeover)
+            {
+                m_websocket_deflate_no_context_takeover = websocket_deflate_no_context_takeover;
+            }
+            inline bool get_websocket_deflate_no_context_takeover() const
+            {
+                return m_websocket_deflate_no_context_takeover;
+            }
+            inline void set_websocket_deflate_streams(size_t websocket_deflate_streams)
+            {
+                m_websocket_deflate_streams = websocket_deflate_streams;
+            }
+            inline size_t get_websocket_deflate_streams() const
+            {
+                return m_websocket_deflate_streams;
+            }
+            inline void set_websocket_deflate_min_length(size_t websocket_deflate_min_length)
+            {
+                m_websocket_deflate_min_length = websocket_deflate_min_length;
+            }
+            inline size_t get_websocket_deflate_min_length() const
+            {
+                return m_websocket_deflate_min_length;
+            }
+
+            inline void set_mailbox_size(size_t mailbox_size)
+            {
+                m_mailbox_size = mailbox_size;
+            }
+            inline size_t get_mailbox_size() const
+            {
+                return m_mailbox_size;
+            }
+
+            inline void set_ssl_session_cache(size_t ssl_session_cache)
+            {
+                m_ssl_session_cache = ssl_session_cache;
+            }
+            inline size_t get_ssl_session_cache() const
+            {
+                return m_ssl_session_cache;
+            }
+            inline void set_ssl_session_timeout(size_t ssl_session_timeout)
+            {
+                m_ssl_session_timeout = ssl_session_timeout;
+            }
+            inline size_t get_ssl_session_timeout() const
+            {
+                return m_ssl_session_timeout;
+            }
+            inline void set_ssl_session_tickets(bool ssl_session_tickets)
+            {
+                m_ssl_session_tickets = ssl_session_tickets;
+            }
+            inline bool get_ssl_session_tickets() const
+            {
+                return m_ssl_session_tickets;
+            }
+            inline void set_ssl_ticket_key_rotate(size_t ssl_ticket_key_rotate)
+            {
+                m_ssl_ticket_key_rotate = ssl_ticket_key_rotate;
+            }
+            inline size_t get_ssl_ticket_key_rotate() const
+            {
+                return m_ssl_ticket_key_rotate;
+            }
+            inline void set_ssl_release_buffers(bool ssl_release_buffers)
+            {
+                m_ssl_release_buffers = ssl_release_buffers;
+            }
+            inline bool get_ssl_release_buffers() const
+            {
+                return m_ssl_release_buffers;
+            }
+            inline void set_ssl_ciphers(const std::string &ssl_ciphers)
+            {
+                m_ssl_ciphers = ssl_ciphers;
+            }
+            inline const std::string &get_ssl_ciphers() const
+            {
+                return m_ssl_ciphers;
+            }
+            inline void set_ssl_ktls(bool ssl_ktls)
+            {
+                m_ssl_ktls = ssl_ktls;
+            }
+            inline bool get_ssl_ktls() const
+            {
+                return m_ssl_ktls;
+            }
+            inline void set_admission(bool admission)
+            {
+                m_admission = admission;
+            }
+            inline bool get_admission() const
+            {
+                return m_admission;
+            }
+            inline void set_admission_options(const tubekit::socket::admission::options &admission_options)
+            {
+                m_admission_options = admission_options;
+            }
+            inline const tubekit::socket::admission::options &get_admission_options() const
+            {
+                return m_admission_options;
+            }
+            inline void set_overload_shedding(bool overload_shedding)
+            {
+                m_overload_shedding = overload_shedding;
+            }
+            inline bool get_overload_shedding() const
+            {
+                return m_overload_shedding;
+            }
+            inline void set_overload_target(size_t overload_target)
+            {
+                m_overload_target = overload_target;
+            }
+            inline size_t get_overload_target() const
+            {
+                return m_overload_target;
+            }
+            inline void set_overload_interval(size_t overload_interval)
+            {
+                m_overload_interval = overload_interval;
+            }
+            inline size_t get_overload_interval() const
+            {
+                return m_overload_interval;
+            }
+            inline void set_overload_status_path(const std::string &overload_status_path)
+            {
+                m_overload_status_path = overload_status_path;
+            }
+            inline const std::string &get_overload_status_path() const
+            {
+                return m_overload_status_path;
+            }
+
             void config(const std::string &ip,
                         int port,
                         size_t threads,
@@ -67,6 +353,20 @@ namespace tubekit
             void to_stop();
             bool is_stop();
 
+        private:
+            /**
+             * @brief SSL_CTX_set_alpn_select_cb callback, selects h2 or http/1.1
+             *
+             */
+            static int alpn_select(SSL *ssl, const unsigned char **out, unsigned char *outlen, const unsigned char *in, unsigned int inlen, void *arg);
+
+            /**
+             * @brief session cache, session tickets, buffers and ciphers of m_ssl_context by config
+             *
+             * @return int 0 ok
+             */
+            int init_ssl_sessions();
+
         private:
             std::string m_ip{};
             size_t m_port{0};
@@ -74,6 +374,20 @@ namespace tubekit
             size_t m_connects{0};
             size_t m_wait_time{0};
             size_t m_accept_per_tick{0};
+            size_t m_mailbox_size{0};
+            size_t m_ssl_session_cache{0};
+            size_t m_ssl_session_timeout{0};
+            bool m_ssl_session_tickets{true};
+            size_t m_ssl_ticket_key_rotate{0};
+            bool m_ssl_release_buffers{false};
+            std::string m_ssl_ciphers{};
+            bool m_ssl_ktls{false};
+            bool m_admission{false};
+            tubekit::socket::admission::options m_admission_options{};
+            bool m_overload_shedding{false};
+            size_t m_overload_target{0};   // ms
+            size_t m_overload_interval{0}; // ms
+            std::string m_overload_status_path{};
 
             std::string m_http_static_dir{};
             std::string m_lua_dir{};
@@ -85,6 +399,28 @@ namespace tubekit
             std::string m_key_pem{};
             volatile bool stop_flag{false};
             SSL_CTX *m_ssl_context{nullptr};
+
+            bool m_http_request_view{false};
+            bool m_http_simd_parser{false};
+            bool m_http_gzip{false};
+            size_t m_http_gzip_min_length{0};
+            std::string m_http_gzip_types{};
+            size_t m_http_gzip_cache_size{0};
+            bool m_http2{false};
+            std::string m_http_upload_dir{};
+            uint64_t m_http_upload_max_size{0};
+            std::string m_http_proxy_pass{};
+            std::string m_http_proxy_balance{};
+            size_t m_http_proxy_keepalive{0};
+            std::string m_proxy_upstream{};
+            std::string m_stream_frame{};
+            bool m_stream_frame_checksum{false};
+            uint64_t m_websocket_max_message{0};
+            bool m_websocket_deflate{false};
+            int m_websocket_deflate_window_bits{15};
+            bool m_websocket_deflate_no_context_takeover{true};
+            size_t m_websocket_deflate_streams{0};
+            size_t m_websocket_deflate_min_length{0};
         };
     }
 }
\ No newline at end of file
@@ -0,0 +1,280 @@
+#include <chrono>
+#include <cstring>
+#include <netinet/in.h>
+#include <tubekit-log/logger.h>
+
+#include "socket/admission.h"
+
+using tubekit::socket::admission;
+
+// longest probe of a key, a prefix that finds no slot within it is admitted untracked
+static constexpr uint32_t max_probe{64};
+// entries looked at by one sweep
+static constexpr uint32_t sweep_step{4096};
+
+static inline uint64_t mix(uint64_t value)
+{
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+static inline uint64_t prefix_mask(int bits)
+{
+    return bits <= 0 ? 0 : (bits >= 64 ? ~0ULL : ~0ULL << (64 - bits));
+}
+
+admission::admission()
+{
+}
+
+admission::~admission()
+{
+    if (m_entries)
+    {
+        delete[] m_entries;
+    }
+}
+
+int admission::init(const options &opts)
+{
+    m_options = opts;
+    uint32_t size = 1024;
+    while (size < opts.table_size)
+    {
+        size <<= 1;
+    }
+    m_entries = new entry[size];
+    for (uint32_t i = 0; i < size; i++)
+    {
+        m_entries[i].slot_state = EMPTY;
+    }
+    m_mask = size - 1;
+    m_start_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    m_enable = true;
+    return 0;
+}
+
+bool admission::get_enable() const
+{
+    return m_enable;
+}
+
+uint32_t admission::now_ms() const
+{
+    const uint64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    return (uint32_t)(now - m_start_ms);
+}
+
+bool admission::make_key(const sockaddr_storage &peer, uint64_t key[2]) const
+{
+    const uint8_t *bytes = nullptr;
+    if (peer.ss_family == AF_INET)
+    {
+        const sockaddr_in *addr = (const sockaddr_in *)&peer;
+        const uint32_t ip = ntohl(addr->sin_addr.s_addr);
+        key[0] = 0;
+        key[1] = (0xffffULL << 32) | ((uint64_t)ip & (prefix_mask(m_options.ipv4_prefix) >> 32));
+        return true;
+    }
+    if (peer.ss_family != AF_INET6)
+    {
+        return false;
+    }
+    bytes = ((const sockaddr_in6 *)&peer)->sin6_addr.s6_addr;
+    uint64_t high = 0;
+    uint64_t low = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        high = (high << 8) | bytes[i];
+        low = (low << 8) | bytes[i + 8];
+    }
+    // IPv4-mapped addresses share entries with IPv4
+    if (high == 0 && (low >> 32) == 0xffff)
+    {
+        key[0] = 0;
+        key[1] = (0xffffULL << 32) | (low & 0xffffffff & (prefix_mask(m_options.ipv4_prefix) >> 32));
+        return true;
+    }
+    key[0] = high & prefix_mask(m_options.ipv6_prefix);
+    key[1] = low & prefix_mask(m_options.ipv6_prefix - 64);
+    return true;
+}
+
+bool admission::take_token(uint32_t &tokens, uint32_t &last, uint32_t now, uint32_t rate, uint32_t burst)
+{
+    uint64_t value = tokens + (uint64_t)(uint32_t)(now - last) * rate;
+    const uint64_t cap = (uint64_t)burst * 1000;
+    value = value > cap ? cap : value;
+    last = now;
+    if (value < 1000)
+    {
+        tokens = (uint32_t)value;
+        return false;
+    }
+    tokens = (uint32_t)(value - 1000);
+    return true;
+}
+
+bool admission::is_full(uint32_t tokens, uint32_t last, uint32_t now, uint32_t rate, uint32_t burst)
+{
+    return rate == 0 || tokens + (uint64_t)(uint32_t)(now - last) * rate >= (uint64_t)burst * 1000;
+}
+
+int32_t admission::admit(const sockaddr_storage &peer)
+{
+    uint64_t key[2];
+    if (!make_key(peer, key))
+    {
+        return untracked;
+    }
+
+    const uint32_t now = now_ms();
+    uint32_t index = (uint32_t)mix(key[0] ^ mix(key[1])) & m_mask;
+    int64_t free_index = -1;
+    entry *found = nullptr;
+    for (uint32_t probe = 0; probe < max_probe; probe++, index = (index + 1) & m_mask)
+    {
+        entry &item = m_entries[index];
+        if (item.slot_state == EMPTY)
+        {
+            if (free_index < 0)
+            {
+                free_index = index;
+            }
+            break;
+        }
+        if (item.slot_state == DELETED)
+        {
+            if (free_index < 0)
+            {
+                free_index = index;
+            }
+            continue;
+        }
+        if (item.key[0] == key[0] && item.key[1] == key[1])
+        {
+            found = &item;
+            break;
+        }
+    }
+
+    if (!found)
+    {
+        if (free_index < 0)
+        {
+            m_untracked++;
+            return untracked;
+        }
+        index = (uint32_t)free_index;
+        found = &m_entries[index];
+        found->key[0] = key[0];
+        found->key[1] = key[1];
+        found->connections = 0;
+        found->conn_tokens = m_options.conn_burst * 1000;
+        found->conn_time = now;
+        found->request_bucket.store(((uint64_t)m_options.request_burst * 1000 << 32) | now, std::memory_order_relaxed);
+        found->slot_state = USED;
+    }
+    else
+    {
+        index = (uint32_t)(found - m_entries);
+    }
+
+    if (m_options.max_conn > 0 && found->connections >= m_options.max_conn)
+    {
+        m_rejected_conn++;
+        return rejected;
+    }
+    if (m_options.conn_rate > 0 && !take_token(found->conn_tokens, found->conn_time, now, m_options.conn_rate, m_options.conn_burst))
+    {
+        m_rejected_rate++;
+        return rejected;
+    }
+    found->connections++;
+    return (int32_t)index;
+}
+
+void admission::release(int32_t index)
+{
+    if (index < 0 || (uint32_t)index > m_mask)
+    {
+        return;
+    }
+    entry &item = m_entries[index];
+    if (item.slot_state == USED && item.connections > 0)
+    {
+        item.connections--;
+    }
+}
+
+bool admission::allow_request(int32_t index)
+{
+    if (m_options.request_rate == 0 || index < 0 || (uint32_t)index > m_mask)
+    {
+        return true;
+    }
+    entry &item = m_entries[index];
+    const uint32_t now = now_ms();
+    uint64_t bucket = item.request_bucket.load(std::memory_order_relaxed);
+    while (true)
+    {
+        uint32_t tokens = (uint32_t)(bucket >> 32);
+        uint32_t last = (uint32_t)bucket;
+        const bool allowed = take_token(tokens, last, now, m_options.request_rate, m_options.request_burst);
+        const uint64_t next = ((uint64_t)tokens << 32) | last;
+        if (item.request_bucket.compare_exchange_weak(bucket, next, std::memory_order_relaxed))
+        {
+            if (!allowed)
+            {
+                m_rejected_request.fetch_add(1, std::memory_order_relaxed);
+            }
+            return allowed;
+        }
+    }
+}
+
+void admission::sweep()
+{
+    if (!m_enable)
+    {
+        return;
+    }
+    const uint32_t now = now_ms();
+    for (uint32_t step = 0; step < sweep_step && step <= m_mask; step++)
+    {
+        const uint32_t index = m_sweep_cursor;
+        m_sweep_cursor = (m_sweep_cursor + 1) & m_mask;
+        entry &item = m_entries[index];
+        if (item.slot_state != USED || item.connections > 0)
+        {
+            continue;
+        }
+        const uint64_t bucket = item.request_bucket.load(std::memory_order_relaxed);
+        if (!is_full(item.conn_tokens, item.conn_time, now, m_options.conn_rate, m_options.conn_burst) ||
+            !is_full((uint32_t)(bucket >> 32), (uint32_t)bucket, now, m_options.request_rate, m_options.request_burst))
+        {
+            continue;
+        }
+        item.slot_state = DELETED;
+        // tombstones before an empty slot end no probe
+        uint32_t back = index;
+        while (m_entries[back].slot_state == DELETED && m_entries[(back + 1) & m_mask].slot_state == EMPTY)
+        {
+            m_entries[back].slot_state = EMPTY;
+            back = (back - 1) & m_mask;
+        }
+    }
+
+    const uint64_t rejected_request = m_rejected_request.exchange(0, std::memory_order_relaxed);
+    if (m_rejected_conn || m_rejected_rate || rejected_request || m_untracked)
+    {
+        LOG_ERROR("admission rejected max_conn %llu conn_rate %llu request_rate %llu, untracked %llu", m_rejected_conn, m_rejected_rate, rejected_request, m_untracked);
+        m_rejected_conn = 0;
+        m_rejected_rate = 0;
+        m_untracked = 0;
+    }
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <sys/socket.h>
+
+namespace tubekit
+{
+    namespace socket
+    {
+        /**
+         * @brief admission of accepted connections by source address prefix,
+         *        each prefix has a cap of concurrent connections and token buckets of new connections and requests
+         *
+         * the table is open addressing with a fixed size, entries are added, released and swept by the main thread,
+         * workers only take request tokens of the entry their socket holds, which is not swept while the socket is alive
+         */
+        class admission
+        {
+        public:
+            struct options
+            {
+                int ipv4_prefix{32};
+                int ipv6_prefix{64};
+                uint32_t max_conn{0};      // 0 for unlimited
+                uint32_t conn_rate{0};     // new connections per second, 0 for unlimited
+                uint32_t conn_burst{0};
+                uint32_t request_rate{0};  // requests per second, 0 for unlimited
+                uint32_t request_burst{0};
+                uint32_t table_size{0};
+            };
+
+            static constexpr int32_t untracked{-1};
+            static constexpr int32_t rejected{-2};
+
+        public:
+            admission();
+            ~admission();
+
+            /**
+             * @brief not thread safe
+             *
+             * @param opts
+             * @return int 0 ok
+             */
+            int init(const options &opts);
+
+            bool get_enable() const;
+
+            /**
+             * @brief main thread only, before any socket or connection is allocated for the peer
+             *
+             * @param peer
+             * @return int32_t entry of the prefix, untracked when the table is full, or rejected
+             */
+            int32_t admit(const sockaddr_storage &peer);
+
+            /**
+             * @brief main thread only, connection of entry is closed
+             *
+             * @param index
+             */
+            void release(int32_t index);
+
+            /**
+             * @brief thread safe, takes a request token of entry
+             *
+             * @param index
+             * @return true
+             * @return false no token, the request is refused
+             */
+            bool allow_request(int32_t index);
+
+            /**
+             * @brief main thread only, forgets a part of idle entries every call,
+             *        an entry is idle without connections and with full buckets
+             *
+             */
+            void sweep();
+
+        private:
+            enum state : uint8_t
+            {
+                EMPTY,
+                USED,
+                DELETED
+            };
+
+            struct entry
+            {
+                uint64_t key[2];
+                uint32_t connections;
+                uint32_t conn_tokens; // 1/1000 token
+                uint32_t conn_time;   // ms
+                state slot_state;
+                std::atomic<uint64_t> request_bucket; // tokens << 32 | ms
+            };
+
+            bool make_key(const sockaddr_storage &peer, uint64_t key[2]) const;
+            uint32_t now_ms() const;
+            static bool take_token(uint32_t &tokens, uint32_t &last, uint32_t now, uint32_t rate, uint32_t burst);
+            static bool is_full(uint32_t tokens, uint32_t last, uint32_t now, uint32_t rate, uint32_t burst);
+
+        private:
+            bool m_enable{false};
+            options m_options{};
+            entry *m_entries{nullptr};
+            uint32_t m_mask{0};
+            uint32_t m_sweep_cursor{0};
+            uint64_t m_start_ms{0};
+
+            // main thread, logged by sweep
+            uint64_t m_rejected_conn{0};
+            uint64_t m_rejected_rate{0};
+            uint64_t m_untracked{0};
+            std::atomic<uint64_t> m_rejected_request{0};
+        };
+    }
+}
@@ -1,4 +1,5 @@
 #include <sys/socket.h>
+#include <sys/sendfile.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
@@ -130,6 +131,87 @@ bool socket::connect(const string &ip, int port)
     return true;
 }
 
+int socket::connect_non_blocking(const string &ip, int port)
+{
+    close();
+    m_sockfd = create_tcp_socket(ip);
+    if (m_sockfd <= 0)
+    {
+        m_sockfd = 0;
+        return -1;
+    }
+    m_ip = ip;
+    m_port = port;
+    if (!set_non_blocking())
+    {
+        return -1;
+    }
+
+    struct sockaddr_storage addr;
+    memset(&addr, 0, sizeof(addr));
+    socklen_t addr_len = 0;
+    if (is_ipv6(ip))
+    {
+        struct sockaddr_in6 *sockaddr6 = (struct sockaddr_in6 *)&addr;
+        sockaddr6->sin6_family = AF_INET6;
+        sockaddr6->sin6_port = htons(port);
+        if (inet_pton(AF_INET6, ip.c_str(), &sockaddr6->sin6_addr) <= 0)
+        {
+            LOG_ERROR("Invalid IPV6 address %s", ip.c_str());
+            return -1;
+        }
+        addr_len = sizeof(struct sockaddr_in6);
+    }
+    else
+    {
+        struct sockaddr_in *sockaddr4 = (struct sockaddr_in *)&addr;
+        sockaddr4->sin_family = AF_INET;
+        sockaddr4->sin_port = htons(port);
+        if (inet_pton(AF_INET, ip.c_str(), &sockaddr4->sin_addr) <= 0)
+        {
+            LOG_ERROR("Invalid IPV4 address %s", ip.c_str());
+            return -1;
+        }
+        addr_len = sizeof(struct sockaddr_in);
+    }
+
+    while (::connect(m_sockfd, (struct sockaddr *)&addr, addr_len) < 0)
+    {
+        if (errno == EINTR)
+        {
+            continue;
+        }
+        if (errno == EINPROGRESS)
+        {
+            return 1;
+        }
+        LOG_ERROR("socket connect %s:%d error: errno=%d errstr=%s", ip.c_str(), port, errno, strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+int socket::get_connect_error()
+{
+    int err = 0;
+    socklen_t err_len = sizeof(err);
+    if (getsockopt(m_sockfd, SOL_SOCKET, SO_ERROR, &err, &err_len) < 0)
+    {
+        return errno;
+    }
+    if (err != 0)
+    {
+        return err;
+    }
+    struct sockaddr_storage addr;
+    socklen_t addr_len = sizeof(addr);
+    if (getpeername(m_sockfd, (struct sockaddr *)&addr, &addr_len) < 0)
+    {
+        return errno == ENOTCONN ? EINPROGRESS : errno;
+    }
+    return 0;
+}
+
 bool socket::close()
 {
     if (close_callback)
@@ -151,6 +233,8 @@ bool socket::close()
         m_ssl_instance = nullptr;
     }
     m_ssl_accepted = false;
+    m_ktls_send = false;
+    m_ktls_recv = false;
 
     if (m_sockfd > 0)
     {
@@ -160,6 +244,8 @@ bool socket::close()
     close_callback = nullptr;
     m_ip.clear();
     m_port = 0;
+    m_upstream = false;
+    m_admission = -1;
 
     return true;
 }
@@ -175,6 +261,17 @@ int socket::accept()
     return sockfd;
 }
 
+int socket::accept(sockaddr_storage &peer)
+{
+    socklen_t len = sizeof(peer);
+    int sockfd = ::accept(m_sockfd, (sockaddr *)&peer, &len);
+    if (sockfd < 0)
+    {
+        sockfd = -1;
+    }
+    return sockfd;
+}
+
 int socket::recv(char *buf, size_t len, int &oper_errno)
 {
     if (m_ssl_instance && !m_ssl_accepted)
@@ -229,10 +326,10 @@ int socket::send(const char *buf, size_t len, int &oper_errno)
         LOG_ERROR("socket m_ssl_instance but m_ssl_accepted is false, can not to send");
         return -1;
     }
-    // NO OPENSSL
+    // NO OPENSSL, or kernel TLS makes records of plain writes
     {
         // write data to m_sockfd
-        if (!m_ssl_instance)
+        if (!m_ssl_instance || m_ktls_send)
         {
             int result = ::send(m_sockfd, buf, len, 0);
             if (result == -1)
@@ -268,6 +365,54 @@ int socket::send(const char *buf, size_t len, int &oper_errno)
     }
 }
 
+int socket::sendfile(int in_fd, off_t &offset, size_t count, int &oper_errno)
+{
+    if (!can_sendfile())
+    {
+        LOG_ERROR("socket can not sendfile");
+        oper_errno = EINVAL;
+        return -1;
+    }
+    constexpr size_t sendfile_max = 0x7ffff000; // linux transfers at most this bytes once
+    if (count > sendfile_max)
+    {
+        count = sendfile_max;
+    }
+    ssize_t result = ::sendfile(m_sockfd, in_fd, &offset, count);
+    if (result == -1)
+    {
+        oper_errno = errno;
+    }
+    return result;
+}
+
+bool socket::can_sendfile()
+{
+    return m_ssl_instance == nullptr || m_ktls_send;
+}
+
+int socket::splice(int pipe_fd, size_t count, int &oper_errno)
+{
+    if (!can_splice())
+    {
+        LOG_ERROR("socket can not splice");
+        oper_errno = EINVAL;
+        return -1;
+    }
+    ssize_t result = ::splice(m_sockfd, nullptr, pipe_fd, nullptr, count, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    if (result == -1)
+    {
+        oper_errno = errno;
+    }
+    return result;
+}
+
+bool socket::can_splice()
+{
+    // recv keeps SSL_read on kernel TLS, alerts and handshake records arrive as control messages that only OpenSSL reads
+    return m_ssl_instance == nullptr;
+}
+
 bool socket::set_non_blocking()
 {
     int flags = fcntl(m_sockfd, F_GETFL, 0);
@@ -437,6 +582,25 @@ bool socket::get_ssl_accepted()
 void socket::set_ssl_accepted(bool accepted)
 {
     m_ssl_accepted = accepted;
+    m_ktls_send = false;
+    m_ktls_recv = false;
+#ifndef OPENSSL_NO_KTLS
+    if (accepted && m_ssl_instance)
+    {
+        m_ktls_send = BIO_get_ktls_send(SSL_get_wbio(m_ssl_instance));
+        m_ktls_recv = BIO_get_ktls_recv(SSL_get_rbio(m_ssl_instance));
+    }
+#endif
+}
+
+bool socket::get_ktls_send()
+{
+    return m_ktls_send;
+}
+
+bool socket::get_ktls_recv()
+{
+    return m_ktls_recv;
 }
 
 void socket::set_gid(uint64_t gid)
@@ -447,4 +611,24 @@ void socket::set_gid(uint64_t gid)
 uint64_t socket::get_gid()
 {
     return this->gid;
+}
+
+void socket::set_upstream(bool upstream)
+{
+    this->m_upstream = upstream;
+}
+
+bool socket::get_upstream()
+{
+    return this->m_upstream;
+}
+
+void socket::set_admission(int32_t admission)
+{
+    this->m_admission = admission;
+}
+
+int32_t socket::get_admission()
+{
+    return this->m_admission;
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 #include <string>
 #include <functional>
+#include <sys/types.h>
+#include <sys/socket.h>
 #include <openssl/ssl.h>
 
 namespace tubekit
@@ -29,10 +31,64 @@ namespace tubekit
             bool listen(int backlog);
 
             bool connect(const string &ip, int port);
+            /**
+             * @brief create a non-blocking tcp socket and start connecting to ip:port
+             *
+             * @param ip
+             * @param port
+             * @return int 0 connected, 1 in progress and writable when finished, -1 error
+             */
+            int connect_non_blocking(const string &ip, int port);
+            /**
+             * @brief result of connect_non_blocking in progress
+             *
+             * @return int 0 connected, EINPROGRESS not finished yet, others errno of failure
+             */
+            int get_connect_error();
             bool close();
             int accept();
+            /**
+             * @brief accept and fill the address of peer
+             *
+             * @param peer
+             * @return int fd of new connection, -1 none
+             */
+            int accept(sockaddr_storage &peer);
             int recv(char *buf, size_t len, int &oper_errno);
             int send(const char *buf, size_t len, int &oper_errno);
+            /**
+             * @brief send file content with sendfile(2), data never enter user space
+             *
+             * @param in_fd
+             * @param offset file offset, be advanced by bytes sent
+             * @param count
+             * @param oper_errno
+             * @return int
+             */
+            int sendfile(int in_fd, off_t &offset, size_t count, int &oper_errno);
+            /**
+             * @brief whether plain sendfile(2) can be used on this socket
+             *
+             * @return true
+             * @return false
+             */
+            bool can_sendfile();
+            /**
+             * @brief move bytes from socket into a pipe with splice(2), data never enter user space
+             *
+             * @param pipe_fd write end of pipe
+             * @param count
+             * @param oper_errno
+             * @return int
+             */
+            int splice(int pipe_fd, size_t count, int &oper_errno);
+            /**
+             * @brief whether splice(2) can be used to receive from this socket
+             *
+             * @return true
+             * @return false
+             */
+            bool can_splice();
             bool set_non_blocking();
             bool set_blocking();
             bool set_send_buffer(size_t size);
@@ -52,10 +108,43 @@ namespace tubekit
             SSL *get_ssl_instance();
             void set_ssl_instance(SSL *ssl_instance);
             bool get_ssl_accepted();
+            /**
+             * @brief after the handshake, finds whether OpenSSL moved record encryption or decryption into kernel TLS
+             *
+             * @param accepted
+             */
             void set_ssl_accepted(bool accepted);
+            /**
+             * @brief records are encrypted by the kernel, plain send(2) and sendfile(2) write TLS application data
+             *
+             * @return true
+             * @return false
+             */
+            bool get_ktls_send();
+            /**
+             * @brief records are decrypted by the kernel
+             *
+             * @return true
+             * @return false
+             */
+            bool get_ktls_recv();
 
             void set_gid(uint64_t gid);
             uint64_t get_gid();
+            /**
+             * @brief outbound connection owned by the connection of gid, its HUP and ERR are delivered as task instead of closing gid
+             *
+             * @param upstream
+             */
+            void set_upstream(bool upstream);
+            bool get_upstream();
+            /**
+             * @brief entry of peer in admission, released when the socket is removed
+             *
+             * @param admission
+             */
+            void set_admission(int32_t admission);
+            int32_t get_admission();
 
         protected:
             string m_ip{};
@@ -63,7 +152,11 @@ namespace tubekit
             int m_sockfd{0};
             SSL *m_ssl_instance{nullptr};
             bool m_ssl_accepted{false};
+            bool m_ktls_send{false};
+            bool m_ktls_recv{false};
             uint64_t gid{0};
+            bool m_upstream{false};
+            int32_t m_admission{-1};
 
         public:
             std::function<void()> close_callback{nullptr};
@@ -2,6 +2,7 @@
 
 #include "socket/socket_handler.h"
 #include "socket/server_socket.h"
+#include "socket/admission.h"
 #include "thread/auto_lock.h"
 #include "utility/singleton.h"
 #include "thread/worker_pool.h"
@@ -17,6 +18,7 @@
 #include "task/http_task.h"
 #include "task/stream_task.h"
 #include "task/websocket_task.h"
+#include "task/proxy_task.h"
 #include "utility/time.h"
 
 using namespace std;
@@ -47,7 +49,7 @@ socket_handler::~socket_handler()
     }
 }
 
-int socket_handler::attach(socket *m_socket, bool listen_send /*= false*/)
+int socket_handler::attach(socket *m_socket, bool listen_send /*= false*/, bool listen_recv /*= true*/)
 {
     if (!m_init)
     {
@@ -61,7 +63,11 @@ int socket_handler::attach(socket *m_socket, bool listen_send /*= false*/)
         return 0;
     }
     // m_socket not in epoll
-    if (listen_send)
+    if (!listen_recv)
+    {
+        target_events = (EPOLLONESHOT | EPOLLOUT | EPOLLHUP | EPOLLERR);
+    }
+    else if (listen_send)
     {
         target_events = (EPOLLONESHOT | EPOLLIN | EPOLLOUT | EPOLLHUP | EPOLLERR | EPOLLRDHUP);
     }
@@ -109,6 +115,7 @@ int socket_handler::remove(socket *m_socket)
     {
         // LOG_ERROR("detach(m_socket) return %d", iret);
     }
+    singleton<admission>::instance()->release(m_socket->get_admission());
     m_socket->close();
 
     // return back to socket object poll
@@ -138,7 +145,7 @@ void socket_handler::push_wait_remove(socket *m_socket)
     m_remove_mutex.unlock();
 }
 
-void socket_handler::update_wait_remove(std::set<socket *> &removed_socket)
+void socket_handler::update_wait_remove()
 {
     if (!m_init)
     {
@@ -149,10 +156,8 @@ void socket_handler::update_wait_remove(std::set<socket *> &removed_socket)
     m_read_remove_list = (m_read_remove_list == &m_remove_list1) ? &m_remove_list2 : &m_remove_list1;
     m_remove_mutex.unlock();
 
-    removed_socket.clear();
     for (auto item : *m_read_remove_list)
     {
-        removed_socket.insert(item);
         remove(item);
     }
     m_read_remove_list->clear();
@@ -193,21 +198,23 @@ void socket_handler::handle()
     }
 
     const size_t accept_per_tick = singleton<tubekit::server::server>::instance()->get_accept_per_tick();
+    const task::task_type task_type = singleton<tubekit::server::server>::instance()->get_task_type();
+    admission *const admission_ptr = singleton<admission>::instance();
+    const bool admission_enable = admission_ptr->get_enable();
+    const bool overload_shedding = singleton<tubekit::server::server>::instance()->get_overload_shedding();
 
     time::time socket_handler_time;
     socket_handler_time.update();
     uint64_t lastest_tick_time = socket_handler_time.get_seconds();
-    uint64_t gid_seq = 0;
-
-    std::set<socket *> removed_socket;
 
     // main thread loop
     while (true)
     {
-        int num = m_epoll->wait(m_wait_time);
+        // sockets are closed before waiting, so every event is of an open socket,
+        // an event of a connection removed meanwhile has a gid no longer in connection_mgr
+        update_wait_remove();
 
-        removed_socket.clear();
-        update_wait_remove(removed_socket);
+        int num = m_epoll->wait(m_wait_time);
 
         // tick time update
         socket_handler_time.update();
@@ -222,7 +229,8 @@ void socket_handler::handle()
                 break; // main process to exit
             }
 
-            gid_seq = 0;
+            admission_ptr->sweep();
+
             lastest_tick_time = now_tick_time;
         }
 
@@ -255,32 +263,42 @@ void socket_handler::handle()
                 continue;
             }
 
-            if (removed_socket.find(now_loop_socket) != removed_socket.end())
-            {
-                continue;
-            }
-
             // There is a new socket connection
             if (m_server == now_loop_socket)
             {
                 for (size_t accept_loop_idx = 0; accept_loop_idx < accept_per_tick; accept_loop_idx++)
                 {
-                    int socket_fd = m_server->accept(); // Gets the socket_fd for the new connection
+                    sockaddr_storage peer{};
+                    int socket_fd = m_server->accept(peer); // Gets the socket_fd for the new connection
                     if (socket_fd <= 0)
                     {
                         break; // stop accept
                     }
+
+                    // refused before any socket, ssl or connection is made for it, reset instead of FIN
+                    int32_t admission_index = admission::untracked;
+                    if (admission_enable)
+                    {
+                        admission_index = admission_ptr->admit(peer);
+                        if (admission::rejected == admission_index)
+                        {
+                            struct linger reset_linger = {1, 0};
+                            ::setsockopt(socket_fd, SOL_SOCKET, SO_LINGER, &reset_linger, sizeof(reset_linger));
+                            ::close(socket_fd);
+                            continue;
+                        }
+                    }
+
                     socket *socket_object = alloc_socket();
                     if (socket_object == nullptr)
                     {
+                        admission_ptr->release(admission_index);
                         ::close(socket_fd);
                         break; // stop accept
                     }
-                    ++gid_seq;
-                    // Almost impossible to process 4294967295 connections in one second
-                    uint64_t loop_gid = (lastest_tick_time << 32) + gid_seq;
                     socket_object->m_sockfd = socket_fd;
-                    socket_object->set_gid(loop_gid);
+                    socket_object->set_admission(admission_index);
+                    socket_object->set_gid(0);
                     socket_object->close_callback = nullptr;
                     socket_object->set_non_blocking();
                     socket_object->set_linger(false, 0);
@@ -324,19 +342,11 @@ void socket_handler::handle()
                     {
                         p_connection->reuse();
                         p_connection->set_socket_ptr(socket_object);
-                        p_connection->set_gid(loop_gid);
                     }
 
-                    bool res = false;
-                    singleton<connection_mgr>::instance()->insert(
-                        loop_gid, {socket_object, p_connection},
-                        [&res](uint64_t key, std::pair<tubekit::socket::socket *, tubekit::connection::connection *> value)
-                        {
-                            res = true;
-                        },
-                        nullptr);
-
-                    if (false == res)
+                    // gid is given to socket and connection
+                    const uint64_t loop_gid = singleton<connection_mgr>::instance()->insert({socket_object, p_connection});
+                    if (0 == loop_gid)
                     {
                         LOG_ERROR("singleton<connection_mgr>::instance()->insert error");
                         singleton<connection_mgr>::instance()->release(p_connection);
@@ -344,6 +354,22 @@ void socket_handler::handle()
                         continue;
                     }
 
+                    // the worker of gid is shedding load, existing connections of it keep being served,
+                    // new ones other than HTTP are refused before any task or hook of them, HTTP requests get 503 there
+                    if (task_type != task::task_type::HTTP_TASK && overload_shedding)
+                    {
+                        codel &worker_codel = singleton<worker_pool>::instance()->get_codel(loop_gid);
+                        if (worker_codel.get_overloaded())
+                        {
+                            worker_codel.on_shed();
+                            singleton<connection_mgr>::instance()->discard(loop_gid);
+                            singleton<connection_mgr>::instance()->release(p_connection);
+                            socket_object->set_linger(true, 0);
+                            push_wait_remove(socket_object);
+                            continue;
+                        }
+                    }
+
                     // on_new_connection hook will be executed when it's get_ssl_accepted status first
                     // if not using openssl
                     if (!singleton<server::server>::instance()->get_use_ssl())
@@ -362,6 +388,23 @@ void socket_handler::handle()
                 uint32_t events = m_epoll->m_events[i].events;
                 detach(now_loop_socket);
 
+                // upstream of a connection, its owner task finds out the failure by recv or send
+                if (now_loop_socket->get_upstream())
+                {
+                    if (0 != now_loop_socket->get_gid())
+                    {
+                        do_task(now_loop_socket->get_gid(), true, true);
+                    }
+                    continue;
+                }
+
+                // PROXY_TASK passes half close on, its task finds out the failure by recv or send
+                if (task_type == task::task_type::PROXY_TASK)
+                {
+                    do_task(now_loop_socket->get_gid(), true, true);
+                    continue;
+                }
+
                 if ((events & EPOLLHUP) || (events & EPOLLERR) || (events & EPOLLRDHUP))
                 {
                     // using connection_mgr mark_close,to prevent connection already free
@@ -415,6 +458,14 @@ void socket_handler::do_task(uint64_t gid, bool recv_event, bool send_event)
             // auto websocket_task_ptr = (websocket_task *)new_task;
         }
         break;
+    case task_type::PROXY_TASK:
+        if (new_task)
+        {
+            auto proxy_task_ptr = (proxy_task *)new_task;
+            proxy_task_ptr->reason_recv = recv_event;
+            proxy_task_ptr->reason_send = send_event;
+        }
+        break;
     default:
         break;
     }
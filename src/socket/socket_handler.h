@@ -24,9 +24,10 @@ namespace tubekit
              *
              * @param m_socket
              * @param listen_send true: listen EPOLLOUT|EPOLLIN false: listen EPOLLIN
+             * @param listen_recv false: EPOLLIN|EPOLLRDHUP are not listened, for a socket whose reading side is already closed
              * @return int
              */
-            int attach(socket *m_socket, bool listen_send = false);
+            int attach(socket *m_socket, bool listen_send = false, bool listen_recv = true);
 
             /**
              * @brief Remove from epoll
@@ -50,7 +51,7 @@ namespace tubekit
 
         public:
             void push_wait_remove(socket *m_socket);
-            void update_wait_remove(std::set<socket *> &removed_socket);
+            void update_wait_remove();
 
         public:
             void on_tick();
@@ -0,0 +1,118 @@
+#include <cstring>
+#include <openssl/rand.h>
+#include <openssl/core_names.h>
+#include <tubekit-log/logger.h>
+
+#include "socket/ssl_ticket_keys.h"
+#include "thread/auto_lock.h"
+#include "utility/singleton.h"
+
+using tubekit::socket::ssl_ticket_keys;
+using tubekit::thread::auto_lock;
+using tubekit::utility::singleton;
+
+ssl_ticket_keys::ssl_ticket_keys()
+{
+}
+
+ssl_ticket_keys::~ssl_ticket_keys()
+{
+    for (auto &ticket_key : m_keys)
+    {
+        OPENSSL_cleanse(&ticket_key, sizeof(ticket_key));
+    }
+}
+
+int ssl_ticket_keys::init(SSL_CTX *ssl_context, time_t rotate, time_t lifetime)
+{
+    m_rotate = rotate;
+    m_lifetime = lifetime;
+    if (!this->rotate(time(nullptr)))
+    {
+        LOG_ERROR("ssl ticket key RAND_bytes error");
+        return -1;
+    }
+    if (1 != SSL_CTX_set_tlsext_ticket_key_evp_cb(ssl_context, ticket_key_callback))
+    {
+        LOG_ERROR("SSL_CTX_set_tlsext_ticket_key_evp_cb error");
+        return -1;
+    }
+    return 0;
+}
+
+bool ssl_ticket_keys::rotate(time_t now)
+{
+    if (m_keys.empty() || m_keys.front().created + m_rotate <= now)
+    {
+        key ticket_key;
+        if (1 != RAND_bytes(ticket_key.name, sizeof(ticket_key.name)) ||
+            1 != RAND_bytes(ticket_key.aes_key, sizeof(ticket_key.aes_key)) ||
+            1 != RAND_bytes(ticket_key.hmac_key, sizeof(ticket_key.hmac_key)))
+        {
+            return false;
+        }
+        ticket_key.created = now;
+        m_keys.push_front(ticket_key);
+    }
+    // the newest ticket of a key stops encrypting at created + rotate and expires lifetime later
+    while (m_keys.size() > 1 && m_keys.back().created + m_rotate + m_lifetime <= now)
+    {
+        OPENSSL_cleanse(&m_keys.back(), sizeof(key));
+        m_keys.pop_back();
+    }
+    return true;
+}
+
+bool ssl_ticket_keys::init_mac(EVP_MAC_CTX *mac_ctx, const key &ticket_key)
+{
+    OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY, (void *)ticket_key.hmac_key, sizeof(ticket_key.hmac_key)),
+        OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, (char *)"SHA256", 0),
+        OSSL_PARAM_construct_end()};
+    return 1 == EVP_MAC_CTX_set_params(mac_ctx, params);
+}
+
+int ssl_ticket_keys::ticket_key_callback(SSL *ssl, unsigned char *key_name, unsigned char *iv, EVP_CIPHER_CTX *cipher_ctx, EVP_MAC_CTX *mac_ctx, int enc)
+{
+    ssl_ticket_keys *keys = singleton<ssl_ticket_keys>::instance();
+    auto_lock lock(keys->m_mutex);
+
+    if (enc)
+    {
+        // a key failed to rotate keeps encrypting, the ticket is still valid
+        keys->rotate(time(nullptr));
+        const key &ticket_key = keys->m_keys.front();
+        const int iv_len = EVP_CIPHER_get_iv_length(EVP_aes_256_cbc());
+        if (1 != RAND_bytes(iv, iv_len))
+        {
+            return -1;
+        }
+        memcpy(key_name, ticket_key.name, sizeof(ticket_key.name));
+        if (1 != EVP_EncryptInit_ex(cipher_ctx, EVP_aes_256_cbc(), nullptr, ticket_key.aes_key, iv) || !init_mac(mac_ctx, ticket_key))
+        {
+            return -1;
+        }
+        return 1;
+    }
+
+    for (size_t i = 0; i < keys->m_keys.size(); i++)
+    {
+        const key &ticket_key = keys->m_keys[i];
+        if (0 != memcmp(key_name, ticket_key.name, sizeof(ticket_key.name)))
+        {
+            continue;
+        }
+        if (ticket_key.created + keys->m_rotate + keys->m_lifetime <= time(nullptr))
+        {
+            break;
+        }
+        if (1 != EVP_DecryptInit_ex(cipher_ctx, EVP_aes_256_cbc(), nullptr, ticket_key.aes_key, iv) || !init_mac(mac_ctx, ticket_key))
+        {
+            return -1;
+        }
+        // a ticket of an old key is replaced by one of the current key
+        return i == 0 ? 1 : 2;
+    }
+    // unknown or expired key, full handshake
+    return 0;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <openssl/ssl.h>
+#include <openssl/evp.h>
+
+#include "thread/mutex.h"
+
+namespace tubekit
+{
+    namespace socket
+    {
+        /**
+         * @brief TLS session ticket keys of the server, a new key encrypts tickets every rotate seconds,
+         *        old keys only decrypt tickets until those tickets expire, then are forgotten,
+         *        keys live in memory only, tickets of the last process are not resumed after restart
+         */
+        class ssl_ticket_keys
+        {
+        public:
+            ssl_ticket_keys();
+            ~ssl_ticket_keys();
+
+            /**
+             * @brief thread not safe, call before handshakes
+             *
+             * @param ssl_context its tickets are encrypted by keys here
+             * @param rotate seconds a key encrypts tickets
+             * @param lifetime seconds a ticket is accepted
+             * @return int 0 ok
+             */
+            int init(SSL_CTX *ssl_context, time_t rotate, time_t lifetime);
+
+        private:
+            struct key
+            {
+                unsigned char name[16];
+                unsigned char aes_key[32];
+                unsigned char hmac_key[32];
+                time_t created;
+            };
+
+            /**
+             * @brief SSL_CTX_set_tlsext_ticket_key_evp_cb callback
+             *
+             * @return int 1 ok, 2 ok and ticket should be renewed, 0 unknown key, -1 error
+             */
+            static int ticket_key_callback(SSL *ssl, unsigned char *key_name, unsigned char *iv, EVP_CIPHER_CTX *cipher_ctx, EVP_MAC_CTX *mac_ctx, int enc);
+
+            // new key in front when the current one is too old, expired keys are dropped
+            bool rotate(time_t now);
+
+            static bool init_mac(EVP_MAC_CTX *mac_ctx, const key &ticket_key);
+
+        private:
+            tubekit::thread::mutex m_mutex;
+            std::deque<key> m_keys{};
+            time_t m_rotate{0};
+            time_t m_lifetime{0};
+        };
+    }
+}
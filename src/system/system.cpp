@@ -45,6 +45,56 @@ void system::init()
     const string crt_pem = (*ini)["server"]["crt.pem"];
     const string key_pem = (*ini)["server"]["key.pem"];
     const int daemon = (*ini)["server"]["daemon"];
+    const string log_level = (*ini)["server"]["log_level"];
+    const int log_async = (*ini)["server"]["log_async"];
+    const int log_buffer_kb = (*ini)["server"]["log_buffer_kb"];
+    const string log_full_policy = (*ini)["server"]["log_full_policy"];
+    const string log_format = (*ini)["server"]["log_format"];
+    const int log_binary_rotate_mb = (*ini)["server"]["log_binary_rotate_mb"];
+    const int log_binary_keep = (*ini)["server"]["log_binary_keep"];
+
+    const int http_request_view = (*ini)["server"]["http_request_view"];
+    const int http_simd_parser = (*ini)["server"]["http_simd_parser"];
+    const int http_gzip = (*ini)["server"]["http_gzip"];
+    const int http_gzip_min_length = (*ini)["server"]["http_gzip_min_length"];
+    const string http_gzip_types = (*ini)["server"]["http_gzip_types"];
+    const int http_gzip_cache_mb = (*ini)["server"]["http_gzip_cache_mb"];
+    const int http2 = (*ini)["server"]["http2"];
+    const string http_upload_dir = (*ini)["server"]["http_upload_dir"];
+    const int http_upload_max_mb = (*ini)["server"]["http_upload_max_mb"];
+    const string http_proxy_pass = (*ini)["server"]["http_proxy_pass"];
+    const string http_proxy_balance = (*ini)["server"]["http_proxy_balance"];
+    const int http_proxy_keepalive = (*ini)["server"]["http_proxy_keepalive"];
+    const string proxy_upstream = (*ini)["server"]["proxy_upstream"];
+    const string stream_frame = (*ini)["server"]["stream_frame"];
+    const int stream_frame_checksum = (*ini)["server"]["stream_frame_checksum"];
+    const int websocket_max_message_kb = (*ini)["server"]["websocket_max_message_kb"];
+    const int websocket_deflate = (*ini)["server"]["websocket_deflate"];
+    const int websocket_deflate_window_bits = (*ini)["server"]["websocket_deflate_window_bits"];
+    const int websocket_deflate_no_context_takeover = (*ini)["server"]["websocket_deflate_no_context_takeover"];
+    const int websocket_deflate_streams = (*ini)["server"]["websocket_deflate_streams"];
+    const int websocket_deflate_min_length = (*ini)["server"]["websocket_deflate_min_length"];
+    const int mailbox_size = (*ini)["server"]["mailbox_size"];
+    const int ssl_session_cache = (*ini)["server"]["ssl_session_cache"];
+    const int ssl_session_timeout = (*ini)["server"]["ssl_session_timeout"];
+    const int ssl_session_tickets = (*ini)["server"]["ssl_session_tickets"];
+    const int ssl_ticket_key_rotate = (*ini)["server"]["ssl_ticket_key_rotate"];
+    const int ssl_release_buffers = (*ini)["server"]["ssl_release_buffers"];
+    const string ssl_ciphers = (*ini)["server"]["ssl_ciphers"];
+    const int ssl_ktls = (*ini)["server"]["ssl_ktls"];
+    const int admission = (*ini)["server"]["admission"];
+    const int admission_ipv4_prefix = (*ini)["server"]["admission_ipv4_prefix"];
+    const int admission_ipv6_prefix = (*ini)["server"]["admission_ipv6_prefix"];
+    const int admission_max_conn = (*ini)["server"]["admission_max_conn"];
+    const int admission_conn_rate = (*ini)["server"]["admission_conn_rate"];
+    const int admission_conn_burst = (*ini)["server"]["admission_conn_burst"];
+    const int admission_request_rate = (*ini)["server"]["admission_request_rate"];
+    const int admission_request_burst = (*ini)["server"]["admission_request_burst"];
+    const int admission_table_size = (*ini)["server"]["admission_table_size"];
+    const int overload_shedding = (*ini)["server"]["overload_shedding"];
+    const int overload_target_ms = (*ini)["server"]["overload_target_ms"];
+    const int overload_interval_ms = (*ini)["server"]["overload_interval_ms"];
+    const string overload_status_path = (*ini)["server"]["overload_status_path"];
 
     // daemon
     if (daemon)
@@ -69,7 +119,26 @@ void system::init()
     {
         closedir(dp);
     }
-    logger::instance().open(m_root_path + "/log/tubekit.log");
+    logger::flag level = logger::DEBUG;
+    if (!log_level.empty() && !logger::parse_level(log_level, level))
+    {
+        printf("unknown log_level %s\n", log_level.c_str());
+    }
+    logger::instance().set_level(level);
+    logger::instance().set_async(log_async != 0,
+                                 (size_t)(log_buffer_kb > 0 ? log_buffer_kb : 1024) * 1024,
+                                 log_full_policy == "block" ? logger::BLOCK : logger::DROP);
+    if (log_format == "binary")
+    {
+        logger::instance().set_binary(true,
+                                      (uint64_t)(log_binary_rotate_mb > 0 ? log_binary_rotate_mb : 0) * 1024 * 1024,
+                                      log_binary_keep > 0 ? log_binary_keep : 0);
+        logger::instance().open(m_root_path + "/log/tubekit.blog");
+    }
+    else
+    {
+        logger::instance().open(m_root_path + "/log/tubekit.log");
+    }
 
     // server
     LOG_ERROR("Listen IP: %s", ip.c_str());
@@ -87,6 +156,53 @@ void system::init()
                      crt_pem,
                      key_pem,
                      use_ssl);
+    m_server->set_mailbox_size(mailbox_size > 0 ? mailbox_size : 16384);
+    m_server->set_ssl_session_cache(ssl_session_cache > 0 ? ssl_session_cache : 0);
+    m_server->set_ssl_session_timeout(ssl_session_timeout > 0 ? ssl_session_timeout : 3600);
+    m_server->set_ssl_session_tickets(ssl_session_tickets != 0);
+    m_server->set_ssl_ticket_key_rotate(ssl_ticket_key_rotate > 0 ? ssl_ticket_key_rotate : 3600);
+    m_server->set_ssl_release_buffers(ssl_release_buffers != 0);
+    m_server->set_ssl_ciphers(ssl_ciphers);
+    m_server->set_ssl_ktls(ssl_ktls != 0);
+    m_server->set_http_request_view(http_request_view);
+    m_server->set_http_simd_parser(http_simd_parser);
+    m_server->set_http_gzip(http_gzip);
+    m_server->set_http_gzip_min_length(http_gzip_min_length);
+    m_server->set_http_gzip_types(http_gzip_types);
+    m_server->set_http_gzip_cache_size((size_t)http_gzip_cache_mb * 1024 * 1024);
+    m_server->set_http2(http2);
+    m_server->set_http_upload_dir(http_upload_dir);
+    m_server->set_http_upload_max_size((uint64_t)http_upload_max_mb * 1024 * 1024);
+    m_server->set_http_proxy_pass(http_proxy_pass);
+    m_server->set_http_proxy_balance(http_proxy_balance);
+    m_server->set_http_proxy_keepalive(http_proxy_keepalive > 0 ? http_proxy_keepalive : 0);
+    m_server->set_proxy_upstream(proxy_upstream);
+    m_server->set_stream_frame(stream_frame);
+    m_server->set_stream_frame_checksum(stream_frame_checksum != 0);
+    m_server->set_websocket_max_message((uint64_t)(websocket_max_message_kb > 0 ? websocket_max_message_kb : 512) * 1024);
+    m_server->set_websocket_deflate(websocket_deflate != 0);
+    m_server->set_websocket_deflate_window_bits(websocket_deflate_window_bits >= 9 && websocket_deflate_window_bits <= 15 ? websocket_deflate_window_bits : 15);
+    m_server->set_websocket_deflate_no_context_takeover(websocket_deflate_no_context_takeover != 0);
+    m_server->set_websocket_deflate_streams(websocket_deflate_streams > 0 ? websocket_deflate_streams : 1024);
+    m_server->set_websocket_deflate_min_length(websocket_deflate_min_length > 0 ? websocket_deflate_min_length : 0);
+    m_server->set_admission(admission != 0);
+    {
+        tubekit::socket::admission::options admission_options;
+        admission_options.ipv4_prefix = admission_ipv4_prefix > 0 && admission_ipv4_prefix <= 32 ? admission_ipv4_prefix : 32;
+        admission_options.ipv6_prefix = admission_ipv6_prefix > 0 && admission_ipv6_prefix <= 128 ? admission_ipv6_prefix : 64;
+        admission_options.max_conn = admission_max_conn > 0 ? admission_max_conn : 0;
+        admission_options.conn_rate = admission_conn_rate > 0 ? admission_conn_rate : 0;
+        // a bucket holds at least the tokens of one second
+        admission_options.conn_burst = admission_conn_burst > admission_conn_rate ? admission_conn_burst : admission_options.conn_rate;
+        admission_options.request_rate = admission_request_rate > 0 ? admission_request_rate : 0;
+        admission_options.request_burst = admission_request_burst > admission_request_rate ? admission_request_burst : admission_options.request_rate;
+        admission_options.table_size = admission_table_size > 0 ? admission_table_size : 65536;
+        m_server->set_admission_options(admission_options);
+    }
+    m_server->set_overload_shedding(overload_shedding != 0);
+    m_server->set_overload_target(overload_target_ms > 0 ? overload_target_ms : 50);
+    m_server->set_overload_interval(overload_interval_ms > 0 ? overload_interval_ms : 500);
+    m_server->set_overload_status_path(overload_status_path);
 
     int ret = singleton<hooks::init>::instance()->run();
     if (ret != 0)
@@ -7,6 +7,8 @@
 #include <algorithm>
 #include <tubekit-log/logger.h>
 #include <stdexcept>
+#include <fcntl.h>
+#include <climits>
 
 #include "task/http_task.h"
 #include "socket/socket_handler.h"
@@ -15,6 +17,7 @@
 #include "app/http_app.h"
 #include "connection/connection_mgr.h"
 #include "server/server.h"
+#include "utility/http_simd_parser.h"
 
 using namespace tubekit::task;
 using namespace tubekit::socket;
@@ -25,6 +28,167 @@ using namespace tubekit::server;
 
 http_parser_settings *http_task::settings = nullptr;
 
+// app hooks shared by HTTP/1.1 and HTTP/2 streams
+
+static int app_headers_complete(tubekit::connection::http_connection &m_http_connection)
+{
+    int iret = 0;
+    try
+    {
+        iret = http_app::on_headers_complete(m_http_connection);
+    }
+    catch (const std::exception &e)
+    {
+        iret = -1;
+        LOG_ERROR(e.what());
+    }
+    return iret;
+}
+
+static int app_body(tubekit::connection::http_connection &m_http_connection, const char *at, size_t length)
+{
+    int iret = 0;
+    try
+    {
+        if (m_http_connection.body_callback)
+        {
+            iret = m_http_connection.body_callback(m_http_connection, at, length);
+        }
+        else
+        {
+            m_http_connection.add_to_body(at, length);
+            iret = http_app::on_body(m_http_connection);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        iret = -1;
+        LOG_ERROR(e.what());
+    }
+    return iret;
+}
+
+static void app_process(tubekit::connection::http_connection &m_http_connection)
+{
+    // app loader,loading process_callback for m_http_connection
+    try
+    {
+        http_app::process_connection(m_http_connection);
+        if (m_http_connection.process_callback)
+        {
+            m_http_connection.process_callback(m_http_connection);
+        }
+        else
+        {
+            m_http_connection.set_everything_end(true);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        LOG_ERROR(e.what());
+        m_http_connection.set_everything_end(true);
+    }
+}
+
+static void app_event(tubekit::connection::http_connection &m_http_connection)
+{
+    if (!m_http_connection.event_callback || m_http_connection.get_everything_end())
+    {
+        return;
+    }
+    try
+    {
+        m_http_connection.event_callback(m_http_connection);
+    }
+    catch (const std::exception &e)
+    {
+        LOG_ERROR(e.what());
+        m_http_connection.set_everything_end(true);
+    }
+}
+
+// request head by http_simd_parser, Content-Length body is passed to app without http-parser
+// return 1 progress, 0 more bytes needed, -1 left to http-parser, -2 rejected by app
+static int simd_parse(tubekit::connection::http_connection &m_http_connection)
+{
+    if (!m_http_connection.headers_complete)
+    {
+        if (m_http_connection.simd_scanned == m_http_connection.recv_buffer_used)
+        {
+            return 0;
+        }
+        http_simd_parser::request head;
+        int head_len = http_simd_parser::parse(m_http_connection.recv_buffer + m_http_connection.recv_buffer_parsed, m_http_connection.recv_buffer_used - m_http_connection.recv_buffer_parsed, head);
+        if (head_len == http_simd_parser::INCOMPLETE)
+        {
+            m_http_connection.simd_scanned = m_http_connection.recv_buffer_used;
+            return 0;
+        }
+        if (head_len < 0)
+        {
+            return -1;
+        }
+
+        m_http_connection.request.method = head.method;
+        m_http_connection.request.url = head.url;
+        for (size_t i = 0; i < head.header_count; i++)
+        {
+            m_http_connection.request.add_header(head.headers[i].key, head.headers[i].value);
+        }
+        if (!singleton<tubekit::server::server>::instance()->get_http_request_view())
+        {
+            m_http_connection.url.assign(head.url.data(), head.url.size());
+            m_http_connection.method.assign(head.method.data(), head.method.size());
+            for (size_t i = 0; i < head.header_count; i++)
+            {
+                m_http_connection.add_header(std::string(head.headers[i].key), std::string(head.headers[i].value));
+            }
+        }
+        // app reads framing from parser like requests parsed by http-parser
+        http_parser *parser = m_http_connection.get_parser();
+        parser->http_major = 1;
+        parser->http_minor = head.http_minor;
+        parser->content_length = head.content_length == http_simd_parser::no_content_length ? ULLONG_MAX : head.content_length;
+
+        m_http_connection.simd_parsed = true;
+        m_http_connection.simd_body_remaining = head.content_length == http_simd_parser::no_content_length ? 0 : head.content_length;
+        m_http_connection.headers_complete = true;
+        m_http_connection.recv_buffer_parsed += head_len;
+        m_http_connection.recv_buffer_pinned = m_http_connection.request.get_views_end(m_http_connection.recv_buffer, m_http_connection.recv_buffer_size);
+        if (0 != app_headers_complete(m_http_connection))
+        {
+            return -2;
+        }
+        if (0 == m_http_connection.simd_body_remaining)
+        {
+            m_http_connection.set_recv_end(true);
+        }
+        return 1;
+    }
+
+    size_t body_len = m_http_connection.recv_buffer_used - m_http_connection.recv_buffer_parsed;
+    if (body_len > m_http_connection.simd_body_remaining)
+    {
+        body_len = m_http_connection.simd_body_remaining;
+    }
+    if (0 == body_len)
+    {
+        return 0;
+    }
+    const char *body_at = m_http_connection.recv_buffer + m_http_connection.recv_buffer_parsed;
+    m_http_connection.recv_buffer_parsed += body_len;
+    m_http_connection.simd_body_remaining -= body_len;
+    if (0 != app_body(m_http_connection, body_at, body_len))
+    {
+        return -2;
+    }
+    if (0 == m_http_connection.simd_body_remaining)
+    {
+        m_http_connection.set_recv_end(true);
+    }
+    return 1;
+}
+
 http_task::http_task(uint64_t gid) : task(gid),
                                      reason_recv(false),
                                      reason_send(false)
@@ -34,16 +198,20 @@ http_task::http_task(uint64_t gid) : task(gid),
         settings = new http_parser_settings;
         settings->on_message_begin = [](http_parser *parser) -> auto
         {
-            connection::http_connection *t_http_connection = static_cast<connection::http_connection *>(parser->data);
-            http_method method = (http_method)parser->method;
-            t_http_connection->method = http_method_str(method);
             return 0;
         };
 
         settings->on_url = [](http_parser *parser, const char *at, size_t length) -> auto
         {
             connection::http_connection *t_http_connection = static_cast<connection::http_connection *>(parser->data);
-            t_http_connection->url = std::string(at, length);
+            t_http_connection->request.on_url(at, length);
+            // method is not parsed yet when on_message_begin
+            t_http_connection->request.method = http_method_str((http_method)parser->method);
+            if (!singleton<server::server>::instance()->get_http_request_view())
+            {
+                t_http_connection->url.append(at, length);
+                t_http_connection->method = http_method_str((http_method)parser->method);
+            }
             return 0; // allowed
             // return -1;// reject this connection
         };
@@ -57,36 +225,48 @@ http_task::http_task(uint64_t gid) : task(gid),
         settings->on_header_field = [](http_parser *parser, const char *at, size_t length) -> auto
         {
             connection::http_connection *t_http_connection = static_cast<connection::http_connection *>(parser->data);
-            t_http_connection->head_field_tmp = std::string(at, length);
+            t_http_connection->request.on_header_field(at, length);
+            if (!singleton<server::server>::instance()->get_http_request_view())
+            {
+                t_http_connection->head_field_tmp = std::string(at, length);
+            }
             return 0;
         };
 
         settings->on_header_value = [](http_parser *parser, const char *at, size_t length) -> auto
         {
             connection::http_connection *t_http_connection = static_cast<connection::http_connection *>(parser->data);
-            std::string value(at, length);
-            t_http_connection->add_header(t_http_connection->head_field_tmp, value);
+            t_http_connection->request.on_header_value(at, length);
+            if (!singleton<server::server>::instance()->get_http_request_view())
+            {
+                std::string value(at, length);
+                t_http_connection->add_header(t_http_connection->head_field_tmp, value);
+            }
             return 0;
         };
 
         settings->on_headers_complete = [](http_parser *parser) -> auto
         {
-            return 0;
+            connection::http_connection *t_http_connection = static_cast<connection::http_connection *>(parser->data);
+            t_http_connection->headers_complete = true;
+            // following body bytes are consumed by on_body, their space in recv_buffer can be reused
+            t_http_connection->recv_buffer_pinned = t_http_connection->request.get_views_end(t_http_connection->recv_buffer, t_http_connection->recv_buffer_size);
+            int iret = app_headers_complete(*t_http_connection);
+            // app already responded, the rest of request is not read
+            if (0 == iret && t_http_connection->get_recv_end())
+            {
+                http_parser_pause(parser, 1);
+            }
+            return iret;
         };
 
         settings->on_body = [](http_parser *parser, const char *at, size_t length) -> auto
         {
             connection::http_connection *t_http_connection = static_cast<connection::http_connection *>(parser->data);
-            t_http_connection->add_to_body(at, length);
-            int iret = 0;
-            try
-            {
-                iret = http_app::on_body(*t_http_connection);
-            }
-            catch (const std::exception &e)
+            int iret = app_body(*t_http_connection, at, length);
+            if (0 == iret && (t_http_connection->get_recv_paused() || t_http_connection->get_recv_end()))
             {
-                iret = -1;
-                LOG_ERROR(e.what());
+                http_parser_pause(parser, 1);
             }
 
             return iret;
@@ -96,6 +276,8 @@ http_task::http_task(uint64_t gid) : task(gid),
         {
             connection::http_connection *t_http_connection = static_cast<connection::http_connection *>(parser->data);
             t_http_connection->set_recv_end(true);
+            // pipelined bytes after it belong to the next request of a kept-alive connection
+            http_parser_pause(parser, 1);
             return 0;
         };
 
@@ -141,8 +323,7 @@ void http_task::run()
             socket_ptr = value.first;
             conn_ptr = value.second;
             found = true;
-        },
-        nullptr);
+        });
 
     if (false == found)
     {
@@ -173,14 +354,16 @@ void http_task::run()
                 LOG_ERROR(e.what());
             }
         }
+        // streams release their app state now, not when the connection is reused
+        delete t_http_connection->h2;
+        t_http_connection->h2 = nullptr;
         singleton<connection_mgr>::instance()->remove(
             get_gid(),
             [](uint64_t key, std::pair<tubekit::socket::socket *, tubekit::connection::connection *> value)
             {
                 singleton<connection_mgr>::instance()->release(value.second);
                 singleton<socket_handler>::instance()->push_wait_remove(value.first);
-            },
-            nullptr);
+            });
         return;
     }
 
@@ -195,6 +378,13 @@ void http_task::run()
             socket_ptr->set_ssl_accepted(true);
             // triger new connection hook
             singleton<connection_mgr>::instance()->on_new_connection(get_gid());
+            const unsigned char *alpn = nullptr;
+            unsigned int alpn_len = 0;
+            SSL_get0_alpn_selected(socket_ptr->get_ssl_instance(), &alpn, &alpn_len);
+            if (alpn_len == 2 && 0 == memcmp(alpn, "h2", 2))
+            {
+                start_http2(t_http_connection);
+            }
         }
         else if (0 == ssl_status)
         {
@@ -226,75 +416,223 @@ void http_task::run()
         }
     }
 
+    if (t_http_connection->h2)
+    {
+        run_http2(socket_ptr, t_http_connection);
+        return;
+    }
+
+    app_event(*t_http_connection);
+
     // read from socket
     if (!t_http_connection->get_recv_end() && !t_http_connection->get_everything_end())
     {
-        t_http_connection->buffer_used_len = 0;
-
-        while (true)
+        if (!t_http_connection->get_recv_paused())
         {
-            int oper_errno = 0;
-            t_http_connection->buffer_used_len = socket_ptr->recv(t_http_connection->buffer, t_http_connection->buffer_size, oper_errno);
-            if (t_http_connection->buffer_used_len == -1 && oper_errno == EAGAIN)
+            http_parser_pause(t_http_connection->get_parser(), 0);
+        }
+        while (!t_http_connection->get_recv_paused())
+        {
+            // body moved from socket into file by splice, bypass recv_buffer and parser
+            if (t_http_connection->body_splice_remaining > 0)
             {
-                t_http_connection->buffer_used_len = 0;
-                break;
+                int oper_errno = 0;
+                constexpr uint64_t splice_max = 65536; // default pipe capacity
+                size_t splice_len = t_http_connection->body_splice_remaining > splice_max ? splice_max : t_http_connection->body_splice_remaining;
+                int spliced = socket_ptr->splice(t_http_connection->body_splice_pipe[1], splice_len, oper_errno);
+                if (spliced == -1 && oper_errno == EAGAIN)
+                {
+                    break;
+                }
+                else if (spliced == -1 && oper_errno == EINTR)
+                {
+                    continue;
+                }
+                else if (spliced <= 0)
+                {
+                    t_http_connection->set_everything_end(true);
+                    break;
+                }
+                int drained = 0;
+                while (drained < spliced)
+                {
+                    ssize_t moved = ::splice(t_http_connection->body_splice_pipe[0], nullptr, t_http_connection->body_splice_fd, nullptr, spliced - drained, SPLICE_F_MOVE);
+                    if (moved == -1 && errno == EINTR)
+                    {
+                        continue;
+                    }
+                    else if (moved <= 0)
+                    {
+                        LOG_ERROR("splice body to fd %d errno %d", t_http_connection->body_splice_fd, errno);
+                        break;
+                    }
+                    drained += moved;
+                }
+                if (drained < spliced)
+                {
+                    t_http_connection->set_everything_end(true);
+                    break;
+                }
+                t_http_connection->body_splice_remaining -= spliced;
+                if (0 == t_http_connection->body_splice_remaining)
+                {
+                    t_http_connection->set_recv_end(true);
+                    break;
+                }
+                continue;
             }
-            else if (t_http_connection->buffer_used_len == -1 && oper_errno == EINTR) // error interupt
+
+            // prior knowledge h2c, client starts with the HTTP/2 preface instead of a request line
+            bool preface_partial = false;
+            if (0 == t_http_connection->recv_buffer_parsed && t_http_connection->recv_buffer_used > 0 && singleton<server::server>::instance()->get_http2() && !socket_ptr->get_ssl_instance())
             {
-                t_http_connection->buffer_used_len = 0;
-                continue;
+                const std::string_view preface = connection::http2_connection::preface;
+                const size_t compare_len = std::min(preface.size(), t_http_connection->recv_buffer_used);
+                if (0 == memcmp(t_http_connection->recv_buffer, preface.data(), compare_len))
+                {
+                    if (compare_len == preface.size())
+                    {
+                        start_http2(t_http_connection);
+                        t_http_connection->h2->on_recv(t_http_connection->recv_buffer, t_http_connection->recv_buffer_used);
+                        break;
+                    }
+                    preface_partial = true;
+                }
             }
-            else if (t_http_connection->buffer_used_len > 0)
+
+            // request head and Content-Length body by http_simd_parser, other requests by http-parser
+            bool head_partial = false;
+            if (!preface_partial && t_http_connection->recv_buffer_parsed < t_http_connection->recv_buffer_used && !t_http_connection->simd_unsupported && singleton<server::server>::instance()->get_http_simd_parser())
             {
-                int nparsed = http_parser_execute(t_http_connection->get_parser(), settings, t_http_connection->buffer, t_http_connection->buffer_used_len);
-                if (t_http_connection->get_parser()->upgrade)
+                int iret = simd_parse(*t_http_connection);
+                if (-2 == iret)
+                {
+                    t_http_connection->set_everything_end(true);
+                    break;
+                }
+                else if (-1 == iret)
+                {
+                    t_http_connection->simd_unsupported = true;
+                    continue;
+                }
+                else if (0 == iret)
                 {
+                    head_partial = true;
                 }
-                else if (nparsed != t_http_connection->buffer_used_len) // error
+                else
                 {
-                    LOG_ERROR("nparsed != t_http_connection->buffer_used_len");
-                    t_http_connection->buffer_used_len = 0;
+                    if (t_http_connection->get_recv_end())
+                    {
+                        break;
+                    }
+                    // the rest of Content-Length body goes to body_splice_fd directly
+                    if (t_http_connection->body_splice_fd >= 0 && t_http_connection->recv_buffer_parsed == t_http_connection->recv_buffer_used && t_http_connection->simd_body_remaining > 0 && socket_ptr->can_splice())
+                    {
+                        t_http_connection->body_splice_remaining = t_http_connection->simd_body_remaining;
+                        t_http_connection->simd_body_remaining = 0;
+                    }
+                    continue;
+                }
+            }
+
+            // bytes left by pause_recv are parsed before reading more
+            if (!preface_partial && !head_partial && t_http_connection->recv_buffer_parsed < t_http_connection->recv_buffer_used)
+            {
+                char *parse_at = t_http_connection->recv_buffer + t_http_connection->recv_buffer_parsed;
+                size_t parse_len = t_http_connection->recv_buffer_used - t_http_connection->recv_buffer_parsed;
+                http_parser *parser = t_http_connection->get_parser();
+                size_t nparsed = http_parser_execute(parser, settings, parse_at, parse_len);
+                t_http_connection->recv_buffer_parsed += nparsed;
+                if (parser->upgrade)
+                {
+                    t_http_connection->recv_buffer_parsed = t_http_connection->recv_buffer_used;
+                }
+                else if (HTTP_PARSER_ERRNO(parser) == HPE_PAUSED)
+                {
+                    // paused by body consumer or app responded in on_headers_complete
+                }
+                else if (nparsed != parse_len) // error
+                {
+                    LOG_ERROR("nparsed != recv_len");
                     t_http_connection->set_everything_end(true);
                     break;
                 }
+                if (t_http_connection->get_recv_end())
+                {
+                    break;
+                }
+                // the rest of Content-Length body goes to body_splice_fd directly
+                if (t_http_connection->body_splice_fd >= 0 && t_http_connection->recv_buffer_parsed == t_http_connection->recv_buffer_used && t_http_connection->headers_complete && !(parser->flags & F_CHUNKED) && parser->content_length > 0 && parser->content_length != ULLONG_MAX && socket_ptr->can_splice())
+                {
+                    t_http_connection->body_splice_remaining = parser->content_length;
+                }
+                continue;
+            }
+
+            if (t_http_connection->recv_buffer_used >= t_http_connection->recv_buffer_size)
+            {
+                if (!t_http_connection->headers_complete)
+                {
+                    LOG_ERROR("request line and headers oversize %llu bytes", t_http_connection->recv_buffer_size);
+                    const char *response = "HTTP/1.1 431 Request Header Fields Too Large\r\nServer: tubekit\r\nContent-Length: 0\r\n\r\n";
+                    try
+                    {
+                        t_http_connection->m_send_buffer.write(response, strlen(response));
+                    }
+                    catch (const std::runtime_error &e)
+                    {
+                        LOG_ERROR(e.what());
+                    }
+                    t_http_connection->set_recv_end(true);
+                    t_http_connection->set_process_end(true);
+                    t_http_connection->set_response_end(true);
+                    break;
+                }
+                t_http_connection->recv_buffer_used = t_http_connection->recv_buffer_pinned;
+                t_http_connection->recv_buffer_parsed = t_http_connection->recv_buffer_pinned;
+            }
+
+            int oper_errno = 0;
+            char *recv_at = t_http_connection->recv_buffer + t_http_connection->recv_buffer_used;
+            int recv_len = socket_ptr->recv(recv_at, t_http_connection->recv_buffer_size - t_http_connection->recv_buffer_used, oper_errno);
+            if (recv_len == -1 && oper_errno == EAGAIN)
+            {
+                break;
+            }
+            else if (recv_len == -1 && oper_errno == EINTR) // error interupt
+            {
+                continue;
+            }
+            else if (recv_len > 0)
+            {
+                t_http_connection->recv_buffer_used += recv_len;
             }
             else
             {
-                // 1. t_http_connection->buffer_used_len == 0 client closed
+                // 1. recv_len == 0 client closed
                 t_http_connection->set_everything_end(true);
                 break;
             }
         } // while(1)
     }
 
+    if (t_http_connection->h2)
+    {
+        run_http2(socket_ptr, t_http_connection);
+        return;
+    }
+
     // process http connection
     if (!t_http_connection->get_everything_end() && t_http_connection->get_recv_end() && !t_http_connection->get_process_end())
     {
         t_http_connection->set_process_end(true);
-        // app loader,loading process_callback for t_http_connection
-        try
-        {
-            app::http_app::process_connection(*t_http_connection);
-            if (t_http_connection->process_callback)
-            {
-                t_http_connection->process_callback(*t_http_connection);
-            }
-            else
-            {
-                t_http_connection->set_everything_end(true);
-            }
-        }
-        catch (const std::exception &e)
-        {
-            LOG_ERROR(e.what());
-            t_http_connection->set_everything_end(true);
-        }
+        app_process(*t_http_connection);
     }
 
     // write
     if (!t_http_connection->get_everything_end() && t_http_connection->get_process_end())
     {
+        t_http_connection->resume_send();
         while (t_http_connection->buffer_used_len > t_http_connection->buffer_start_use)
         {
             int oper_errno = 0;
@@ -327,8 +665,41 @@ void http_task::run()
                 t_http_connection->buffer_start_use += sended;
             }
         }
+        // zero-copy file range, after everything queued before it has been sent
+        while (!t_http_connection->get_everything_end() && t_http_connection->sendfile_remaining > 0 && t_http_connection->buffer_start_use == t_http_connection->buffer_used_len && 0 == t_http_connection->m_send_buffer.can_readable_size())
+        {
+            int oper_errno = 0;
+            int sended = socket_ptr->sendfile(t_http_connection->sendfile_fd, t_http_connection->sendfile_offset, t_http_connection->sendfile_remaining, oper_errno);
+            if (0 > sended)
+            {
+                if (oper_errno == EINTR)
+                {
+                    continue;
+                }
+                else if (oper_errno == EAGAIN)
+                {
+                    break;
+                }
+                else // error
+                {
+                    t_http_connection->set_response_end(true);
+                    t_http_connection->set_everything_end(true);
+                    break;
+                }
+            }
+            else if (0 == sended) // file was truncated
+            {
+                LOG_ERROR("sendfile return 0, remaining %llu", t_http_connection->sendfile_remaining);
+                t_http_connection->set_everything_end(true);
+                break;
+            }
+            else
+            {
+                t_http_connection->sendfile_remaining -= sended;
+            }
+        }
         //  Notify the user that the content sent last time has been sent to the client
-        if (t_http_connection->buffer_start_use == t_http_connection->buffer_used_len && 0 == t_http_connection->m_send_buffer.can_readable_size() && !t_http_connection->get_response_end())
+        if (t_http_connection->buffer_start_use == t_http_connection->buffer_used_len && !t_http_connection->has_pending_send() && !t_http_connection->get_response_end())
         {
             try
             {
@@ -348,26 +719,42 @@ void http_task::run()
                 t_http_connection->set_everything_end(true);
             }
         }
-        if (t_http_connection->buffer_start_use == t_http_connection->buffer_used_len && 0 != t_http_connection->m_send_buffer.can_readable_size())
+        if (t_http_connection->buffer_start_use == t_http_connection->buffer_used_len && 0 == t_http_connection->sendfile_remaining)
         {
-            // read from m_buffer to buffer for next write
-            try
-            {
-                t_http_connection->buffer_used_len = t_http_connection->m_send_buffer.read(t_http_connection->buffer, t_http_connection->buffer_size - 1);
-            }
-            catch (const std::runtime_error &e)
-            {
-                LOG_ERROR(e.what());
-            }
-            t_http_connection->buffer[t_http_connection->buffer_used_len] = 0;
-            t_http_connection->buffer_start_use = 0;
+            // read from m_send_buffer or response parts to buffer for next write
+            t_http_connection->fill_buffer();
         }
-        if (t_http_connection->buffer_start_use == t_http_connection->buffer_used_len && 0 == t_http_connection->m_send_buffer.can_readable_size() && t_http_connection->get_response_end())
+        if (t_http_connection->buffer_start_use == t_http_connection->buffer_used_len && !t_http_connection->has_pending_send() && t_http_connection->get_response_end())
         {
+            if (t_http_connection->keep_alive && t_http_connection->get_recv_end())
+            {
+                t_http_connection->next_request();
+                if (t_http_connection->recv_buffer_used > 0)
+                {
+                    singleton<socket_handler>::instance()->do_task(get_gid(), true, false); // a pipelined request is in recv_buffer
+                }
+                else
+                {
+                    singleton<socket_handler>::instance()->attach(socket_ptr);
+                }
+                return;
+            }
             t_http_connection->set_everything_end(true);
         }
     }
 
+    // read interest comes back by resume_recv
+    if (!t_http_connection->get_everything_end() && !t_http_connection->get_recv_end() && t_http_connection->get_recv_paused())
+    {
+        return;
+    }
+
+    // write interest comes back when the task is driven by other sockets again
+    if (!t_http_connection->get_everything_end() && t_http_connection->get_recv_end() && t_http_connection->get_send_paused())
+    {
+        return;
+    }
+
     // continue to epoll_wait
     if (!t_http_connection->get_everything_end() && !t_http_connection->get_recv_end()) // next loop for reading
     {
@@ -384,3 +771,96 @@ void http_task::run()
     t_http_connection->set_everything_end(true);
     t_http_connection->mark_close();
 }
+
+void http_task::start_http2(connection::http_connection *http_connection_ptr)
+{
+    connection::http2_connection *h2 = new connection::http2_connection(*http_connection_ptr);
+    h2->on_stream_headers = app_headers_complete;
+    h2->on_stream_body = app_body;
+    h2->on_stream_process = app_process;
+    http_connection_ptr->h2 = h2;
+}
+
+void http_task::run_http2(socket::socket *socket_ptr, connection::http_connection *http_connection_ptr)
+{
+    connection::http2_connection *h2 = http_connection_ptr->h2;
+
+    // read frames, recv_buffer is only a staging area here
+    while (!http_connection_ptr->get_everything_end() && !h2->is_finished())
+    {
+        int oper_errno = 0;
+        int recv_len = socket_ptr->recv(http_connection_ptr->recv_buffer, http_connection_ptr->recv_buffer_size, oper_errno);
+        if (recv_len == -1 && oper_errno == EAGAIN)
+        {
+            break;
+        }
+        else if (recv_len == -1 && oper_errno == EINTR)
+        {
+            continue;
+        }
+        else if (recv_len > 0)
+        {
+            if (0 != h2->on_recv(http_connection_ptr->recv_buffer, recv_len))
+            {
+                break;
+            }
+        }
+        else
+        {
+            http_connection_ptr->set_everything_end(true);
+            break;
+        }
+    }
+
+    // run streams and write frames until socket is full or nothing is left
+    bool blocked = false;
+    while (!http_connection_ptr->get_everything_end() && !blocked)
+    {
+        const bool more = h2->process();
+        std::string_view out = h2->get_out();
+        while (!out.empty())
+        {
+            int oper_errno = 0;
+            int sended = socket_ptr->send(out.data(), out.size(), oper_errno);
+            if (0 > sended)
+            {
+                if (oper_errno == EINTR)
+                {
+                    continue;
+                }
+                else if (oper_errno == EAGAIN)
+                {
+                    blocked = true;
+                    break;
+                }
+                http_connection_ptr->set_everything_end(true);
+                break;
+            }
+            else if (0 == sended)
+            {
+                http_connection_ptr->set_everything_end(true);
+                break;
+            }
+            h2->out_sent(sended);
+            out = h2->get_out();
+        }
+        if (!more)
+        {
+            break;
+        }
+    }
+
+    if (!http_connection_ptr->get_everything_end() && !h2->get_out().empty())
+    {
+        singleton<socket_handler>::instance()->attach(socket_ptr, true); // wait write
+        return;
+    }
+    if (!http_connection_ptr->get_everything_end() && !h2->is_finished())
+    {
+        singleton<socket_handler>::instance()->attach(socket_ptr); // streams wait for frames
+        return;
+    }
+
+    http_connection_ptr->set_everything_end(true);
+    http_connection_ptr->mark_close();
+}
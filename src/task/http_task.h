@@ -22,6 +22,15 @@ namespace tubekit
              */
             void destroy() override;
 
+        private:
+            /**
+             * @brief switch connection to HTTP/2, streams are handed to http_app
+             *
+             * @param http_connection_ptr
+             */
+            static void start_http2(connection::http_connection *http_connection_ptr);
+            void run_http2(socket::socket *socket_ptr, connection::http_connection *http_connection_ptr);
+
         public:
             static http_parser_settings *settings;
             // flag:why create task
@@ -0,0 +1,150 @@
+#include "task/proxy_task.h"
+
+#include <string>
+#include <cerrno>
+#include <cstring>
+#include <tubekit-log/logger.h>
+
+#include "socket/socket_handler.h"
+#include "utility/singleton.h"
+#include "connection/proxy_connection.h"
+#include "connection/connection_mgr.h"
+#include "app/proxy_app.h"
+
+using namespace tubekit::task;
+using namespace tubekit::socket;
+using namespace tubekit::utility;
+using namespace tubekit::connection;
+using namespace tubekit::app;
+
+proxy_task::proxy_task(uint64_t gid) : task(gid)
+{
+    reason_send = false;
+    reason_recv = false;
+}
+
+proxy_task::~proxy_task()
+{
+    destroy();
+}
+
+void proxy_task::destroy()
+{
+}
+
+void proxy_task::run()
+{
+    if (0 == get_gid())
+    {
+        return;
+    }
+    socket::socket *socket_ptr = nullptr;
+    connection::connection *conn_ptr = nullptr;
+    bool found = false;
+
+    singleton<connection_mgr>::instance()->if_exist(
+        get_gid(),
+        [&socket_ptr, &conn_ptr, &found](uint64_t key, std::pair<tubekit::socket::socket *, tubekit::connection::connection *> value)
+        {
+            socket_ptr = value.first;
+            conn_ptr = value.second;
+            found = true;
+        });
+
+    if (false == found)
+    {
+        return;
+    }
+
+    connection::proxy_connection *t_proxy_connection = (connection::proxy_connection *)conn_ptr;
+
+    // connection is close
+    if (t_proxy_connection->is_close())
+    {
+        singleton<connection_mgr>::instance()->remove(
+            get_gid(),
+            [](uint64_t key, std::pair<tubekit::socket::socket *, tubekit::connection::connection *> value)
+            {
+                connection::proxy_connection *closed_connection = (connection::proxy_connection *)value.second;
+                if (closed_connection->upstream)
+                {
+                    closed_connection->upstream->set_gid(0);
+                    singleton<socket_handler>::instance()->push_wait_remove(closed_connection->upstream);
+                    closed_connection->upstream = nullptr;
+                }
+                closed_connection->close_pipes();
+                singleton<connection_mgr>::instance()->release(value.second);
+                singleton<socket_handler>::instance()->push_wait_remove(value.first);
+            });
+        return;
+    }
+
+    // upstream is connected by the first task of connection
+    if (!t_proxy_connection->upstream)
+    {
+        std::string ip;
+        int port = 0;
+        socket::socket *upstream = nullptr;
+        if (!proxy_app::choose_upstream(ip, port) || !t_proxy_connection->open_pipes() || nullptr == (upstream = singleton<socket_handler>::instance()->alloc_socket()))
+        {
+            t_proxy_connection->mark_close();
+            return;
+        }
+        t_proxy_connection->upstream = upstream;
+        int iret = upstream->connect_non_blocking(ip, port);
+        upstream->set_gid(get_gid());
+        upstream->set_upstream(true);
+        if (iret < 0)
+        {
+            t_proxy_connection->mark_close();
+            return;
+        }
+        t_proxy_connection->connecting = iret == 1;
+    }
+
+    if (t_proxy_connection->connecting)
+    {
+        int err = t_proxy_connection->upstream->get_connect_error();
+        if (err == EINPROGRESS)
+        {
+            singleton<socket_handler>::instance()->attach(t_proxy_connection->upstream, true, false);
+            return;
+        }
+        if (err != 0)
+        {
+            LOG_ERROR("proxy_task connect upstream errno=%d errstr=%s", err, strerror(err));
+            t_proxy_connection->mark_close();
+            return;
+        }
+        t_proxy_connection->connecting = false;
+    }
+
+    socket::socket *upstream = t_proxy_connection->upstream;
+    if (0 != t_proxy_connection->relay(t_proxy_connection->up, socket_ptr, upstream) ||
+        0 != t_proxy_connection->relay(t_proxy_connection->down, upstream, socket_ptr))
+    {
+        t_proxy_connection->mark_close();
+        return;
+    }
+
+    // both ways are shut
+    if (t_proxy_connection->up.shutdown && t_proxy_connection->down.shutdown)
+    {
+        t_proxy_connection->mark_close();
+        return;
+    }
+
+    // a source is read only when its destination takes bytes, so a full pipe never spins on a readable source
+    const bool client_recv = !t_proxy_connection->up.eof && !t_proxy_connection->up.blocked;
+    const bool client_send = t_proxy_connection->down.blocked;
+    const bool upstream_recv = !t_proxy_connection->down.eof && !t_proxy_connection->down.blocked;
+    const bool upstream_send = t_proxy_connection->up.blocked;
+    if (client_recv || client_send)
+    {
+        singleton<socket_handler>::instance()->attach(socket_ptr, client_send, client_recv);
+    }
+    if (upstream_recv || upstream_send)
+    {
+        singleton<socket_handler>::instance()->attach(upstream, upstream_send, upstream_recv);
+    }
+}
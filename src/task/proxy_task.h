@@ -0,0 +1,28 @@
+#pragma once
+
+#include "thread/task.h"
+#include "socket/socket.h"
+
+namespace tubekit
+{
+    namespace task
+    {
+        class proxy_task : public tubekit::thread::task
+        {
+        public:
+            proxy_task(uint64_t gid);
+            ~proxy_task();
+            void run();
+            /**
+             * @brief Manual destruction,execute in ~proxy_task
+             *
+             */
+            void destroy();
+
+        public:
+            // flag:why create task
+            bool reason_recv{false};
+            bool reason_send{false};
+        };
+    }
+}
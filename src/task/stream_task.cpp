@@ -54,8 +54,7 @@ void stream_task::run()
             socket_ptr = value.first;
             conn_ptr = value.second;
             found = true;
-        },
-        nullptr);
+        });
 
     if (false == found)
     {
@@ -82,8 +81,7 @@ void stream_task::run()
             {
                 singleton<connection_mgr>::instance()->release(value.second);
                 singleton<socket_handler>::instance()->push_wait_remove(value.first);
-            },
-            nullptr);
+            });
         return;
     }
 
@@ -148,8 +146,9 @@ void stream_task::run()
         }
     }
 
-    // process data
+    // process data, replies are flushed together below
     {
+        t_stream_connection->cork();
         try
         {
             stream_app::process_connection(*t_stream_connection);
@@ -157,9 +156,11 @@ void stream_task::run()
         catch (const std::exception &e)
         {
             LOG_ERROR(e.what());
+            t_stream_connection->uncork();
             t_stream_connection->mark_close();
             return;
         }
+        t_stream_connection->uncork();
     }
 
     bool b_send = false, b_closed = false;
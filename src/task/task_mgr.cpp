@@ -3,6 +3,7 @@
 #include "task/stream_task.h"
 #include "task/http_task.h"
 #include "task/websocket_task.h"
+#include "task/proxy_task.h"
 #include "utility/singleton.h"
 #include "utility/object_pool.h"
 #include <tubekit-log/logger.h>
@@ -39,6 +40,11 @@ tubekit::thread::task *task_mgr::create(uint64_t gid)
         task_ptr = tubekit::utility::singleton<tubekit::utility::object_pool<websocket_task>>::instance()->allocate();
         break;
     }
+    case PROXY_TASK:
+    {
+        task_ptr = tubekit::utility::singleton<tubekit::utility::object_pool<proxy_task>>::instance()->allocate();
+        break;
+    }
     default:
         break;
     }
@@ -75,6 +81,11 @@ void task_mgr::release(tubekit::thread::task *task_ptr)
         // LOG_DEBUG("task space:%d", tubekit::utility::singleton<tubekit::utility::object_pool<websocket_task>>::instance()->space());
         break;
     }
+    case PROXY_TASK:
+    {
+        tubekit::utility::singleton<tubekit::utility::object_pool<proxy_task>>::instance()->release(dynamic_cast<proxy_task *>(task_ptr));
+        break;
+    }
     default:
         break;
     }
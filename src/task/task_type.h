@@ -7,6 +7,7 @@ namespace tubekit::task
         HTTP_TASK = 0,
         STREAM_TASK,
         WEBSOCKET_TASK,
+        PROXY_TASK,
         NONE
     };
 }
\ No newline at end of file
@@ -11,6 +11,7 @@
 #include "utility/base64.h"
 #include "server/server.h"
 #include <stdexcept>
+#include <strings.h>
 
 using namespace tubekit::task;
 using namespace tubekit::socket;
@@ -122,8 +123,7 @@ void websocket_task::run()
             socket_ptr = value.first;
             conn_ptr = value.second;
             found = true;
-        },
-        nullptr);
+        });
 
     if (false == found)
     {
@@ -152,8 +152,7 @@ void websocket_task::run()
             {
                 singleton<connection_mgr>::instance()->release(value.second);
                 singleton<socket_handler>::instance()->push_wait_remove(value.first);
-            },
-            nullptr);
+            });
         return;
     }
 
@@ -266,6 +265,7 @@ void websocket_task::run()
     // process connect protocol
     if (t_websocket_connection->get_connected() == false && t_websocket_connection->http_processed && t_websocket_connection->everything_end == false)
     {
+        std::string extensions;
         for (auto &header : t_websocket_connection->headers)
         {
             if (header.first == "Sec-WebSocket-Key" && header.second.size() >= 1)
@@ -276,6 +276,13 @@ void websocket_task::run()
             {
                 t_websocket_connection->sec_websocket_version = header.second[0];
             }
+            if (0 == strcasecmp(header.first.c_str(), "Sec-WebSocket-Extensions"))
+            {
+                for (const auto &value : header.second)
+                {
+                    extensions += extensions.empty() ? value : "," + value;
+                }
+            }
         }
         if (t_websocket_connection->sec_websocket_key.empty() || t_websocket_connection->sec_websocket_version != "13")
         {
@@ -296,7 +303,24 @@ void websocket_task::run()
             std::string response = "HTTP/1.1 101 Switching Protocols\r\n";
             response += "Upgrade: websocket\r\n";
             response += "Connection: Upgrade\r\n";
-            response += "Sec-WebSocket-Accept: " + base64_encoded + "\r\n\r\n";
+            response += "Sec-WebSocket-Accept: " + base64_encoded + "\r\n";
+
+            // permessage-deflate
+            server::server *server_ptr = singleton<server::server>::instance();
+            websocket_deflate::params deflate_params;
+            std::string deflate_response;
+            if (server_ptr->get_websocket_deflate() &&
+                websocket_deflate::negotiate(extensions,
+                                             server_ptr->get_websocket_deflate_window_bits(),
+                                             server_ptr->get_websocket_deflate_no_context_takeover(),
+                                             deflate_params,
+                                             deflate_response))
+            {
+                t_websocket_connection->deflate.init(deflate_params);
+                t_websocket_connection->decoder.set_deflate(&t_websocket_connection->deflate);
+                response += "Sec-WebSocket-Extensions: " + deflate_response + "\r\n";
+            }
+            response += "\r\n";
 
             t_websocket_connection->send(response.c_str(), response.size(), false);
             t_websocket_connection->set_connected(true);
@@ -320,8 +344,9 @@ void websocket_task::run()
                 singleton<socket_handler>::instance()->do_task(get_gid(), true, true);
             }
         }
-        // process data
+        // process data, replies are flushed together below
         {
+            t_websocket_connection->cork();
             try
             {
                 websocket_app::process_connection(*t_websocket_connection);
@@ -329,9 +354,11 @@ void websocket_task::run()
             catch (const std::exception &e)
             {
                 LOG_ERROR(e.what());
+                t_websocket_connection->uncork();
                 t_websocket_connection->mark_close();
                 return;
             }
+            t_websocket_connection->uncork();
         }
         // send data
         {
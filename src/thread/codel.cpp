@@ -0,0 +1,86 @@
+#include <tubekit-log/logger.h>
+
+#include "thread/codel.h"
+
+using tubekit::thread::codel;
+
+codel::codel()
+{
+}
+
+codel::~codel()
+{
+}
+
+void codel::init(uint64_t target_us, uint64_t interval_us)
+{
+    m_target = target_us;
+    m_interval = interval_us;
+}
+
+void codel::on_dequeue(uint64_t sojourn_us, uint64_t now_us, bool drained)
+{
+    m_sojourn.store(sojourn_us, std::memory_order_relaxed);
+    if (m_target == 0)
+    {
+        return;
+    }
+
+    if (sojourn_us < m_target || drained)
+    {
+        // a standing queue is gone
+        m_first_above_time = 0;
+        if (m_overloaded.load(std::memory_order_relaxed))
+        {
+            m_overloaded.store(false, std::memory_order_relaxed);
+            LOG_ERROR("worker recovered from overload, shed %llu", (unsigned long long)get_shed());
+        }
+        return;
+    }
+
+    if (m_first_above_time == 0)
+    {
+        m_first_above_time = now_us + m_interval;
+    }
+    else if (now_us >= m_first_above_time && !m_overloaded.load(std::memory_order_relaxed))
+    {
+        m_overloaded.store(true, std::memory_order_relaxed);
+        m_overloads.fetch_add(1, std::memory_order_relaxed);
+        LOG_ERROR("worker overloaded, sojourn %llu us above target %llu us for %llu us", (unsigned long long)sojourn_us, (unsigned long long)m_target, (unsigned long long)m_interval);
+    }
+}
+
+void codel::on_shed()
+{
+    m_shed.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool codel::get_overloaded() const
+{
+    return m_overloaded.load(std::memory_order_relaxed);
+}
+
+uint64_t codel::get_sojourn() const
+{
+    return m_sojourn.load(std::memory_order_relaxed);
+}
+
+uint64_t codel::get_overloads() const
+{
+    return m_overloads.load(std::memory_order_relaxed);
+}
+
+uint64_t codel::get_shed() const
+{
+    return m_shed.load(std::memory_order_relaxed);
+}
+
+uint64_t codel::get_target() const
+{
+    return m_target;
+}
+
+uint64_t codel::get_interval() const
+{
+    return m_interval;
+}
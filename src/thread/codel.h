@@ -0,0 +1,85 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+namespace tubekit::thread
+{
+    /**
+     * @brief CoDel state of a worker queue, overloaded after the time tasks waited in queue stayed above target for a whole interval,
+     *        back to normal when a task waited less than target or the queue is drained
+     *
+     * tasks are never dropped, while overloaded new requests and connections of the worker are refused by their owners
+     */
+    class codel
+    {
+    public:
+        codel();
+        ~codel();
+
+        /**
+         * @brief not thread safe, call before the worker starts
+         *
+         * @param target_us 0 disables, never overloaded
+         * @param interval_us
+         */
+        void init(uint64_t target_us, uint64_t interval_us);
+
+        /**
+         * @brief worker thread only, a task is taken from queue
+         *
+         * @param sojourn_us time the task waited in queue
+         * @param now_us
+         * @param drained queue is empty after it
+         */
+        void on_dequeue(uint64_t sojourn_us, uint64_t now_us, bool drained);
+
+        /**
+         * @brief thread safe, a request or connection is refused because of overload
+         *
+         */
+        void on_shed();
+
+        /**
+         * @brief thread safe
+         *
+         * @return true
+         * @return false
+         */
+        bool get_overloaded() const;
+
+        /**
+         * @brief thread safe, sojourn of the last task taken from queue
+         *
+         * @return uint64_t us
+         */
+        uint64_t get_sojourn() const;
+
+        /**
+         * @brief thread safe, times the queue became overloaded
+         *
+         * @return uint64_t
+         */
+        uint64_t get_overloads() const;
+
+        /**
+         * @brief thread safe, requests and connections refused
+         *
+         * @return uint64_t
+         */
+        uint64_t get_shed() const;
+
+        uint64_t get_target() const;
+        uint64_t get_interval() const;
+
+    private:
+        uint64_t m_target{0};
+        uint64_t m_interval{0};
+        // worker thread only, 0 when sojourn is below target
+        uint64_t m_first_above_time{0};
+
+        std::atomic<bool> m_overloaded{false};
+        std::atomic<uint64_t> m_sojourn{0};
+        std::atomic<uint64_t> m_overloads{0};
+        std::atomic<uint64_t> m_shed{0};
+    };
+}
@@ -0,0 +1,158 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace tubekit
+{
+    namespace thread
+    {
+        /**
+         * @brief bounded lock free queue of many producers and one consumer,
+         *        every slot carries a sequence telling whether it is free for the producer of a round or full for the consumer
+         *
+         * @tparam T movable
+         */
+        template <typename T>
+        class mailbox
+        {
+        public:
+            mailbox() = default;
+            ~mailbox();
+
+            mailbox(const mailbox &) = delete;
+            mailbox &operator=(const mailbox &) = delete;
+
+            /**
+             * @brief not thread safe, call before the first push
+             *
+             * @param capacity rounded up to power of 2
+             */
+            void init(size_t capacity);
+
+            /**
+             * @brief thread safe
+             *
+             * @param item moved into the mailbox when true returned
+             * @return true
+             * @return false full
+             */
+            bool push(T &&item);
+
+            /**
+             * @brief consumer thread only
+             *
+             * @param out
+             * @return true
+             * @return false empty
+             */
+            bool pop(T &out);
+
+            /**
+             * @brief consumer thread only
+             *
+             * @return true
+             * @return false
+             */
+            bool empty() const;
+
+            size_t capacity() const;
+
+        private:
+            struct slot
+            {
+                std::atomic<size_t> sequence{0};
+                T item{};
+            };
+
+            slot *m_slots{nullptr};
+            size_t m_mask{0};
+            // producers and the consumer do not share a cache line
+            alignas(64) std::atomic<size_t> m_tail{0};
+            alignas(64) size_t m_head{0};
+        };
+
+        template <typename T>
+        mailbox<T>::~mailbox()
+        {
+            delete[] m_slots;
+        }
+
+        template <typename T>
+        void mailbox<T>::init(size_t capacity)
+        {
+            size_t size = 2;
+            while (size < capacity)
+            {
+                size <<= 1;
+            }
+            delete[] m_slots;
+            m_slots = new slot[size];
+            for (size_t i = 0; i < size; i++)
+            {
+                m_slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+            m_mask = size - 1;
+            m_tail.store(0, std::memory_order_relaxed);
+            m_head = 0;
+        }
+
+        template <typename T>
+        bool mailbox<T>::push(T &&item)
+        {
+            size_t pos = m_tail.load(std::memory_order_relaxed);
+            while (true)
+            {
+                slot &cell = m_slots[pos & m_mask];
+                const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                const intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+                if (diff == 0)
+                {
+                    if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        cell.item = std::move(item);
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    // the consumer has not taken the item of last round
+                    return false;
+                }
+                else
+                {
+                    pos = m_tail.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        template <typename T>
+        bool mailbox<T>::pop(T &out)
+        {
+            slot &cell = m_slots[m_head & m_mask];
+            if (cell.sequence.load(std::memory_order_acquire) != m_head + 1)
+            {
+                return false;
+            }
+            out = std::move(cell.item);
+            cell.item = T{};
+            cell.sequence.store(m_head + m_mask + 1, std::memory_order_release);
+            m_head++;
+            return true;
+        }
+
+        template <typename T>
+        bool mailbox<T>::empty() const
+        {
+            return m_slots[m_head & m_mask].sequence.load(std::memory_order_acquire) != m_head + 1;
+        }
+
+        template <typename T>
+        size_t mailbox<T>::capacity() const
+        {
+            return m_mask + 1;
+        }
+    }
+}
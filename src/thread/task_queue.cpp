@@ -1,3 +1,5 @@
+#include <chrono>
+
 #include "thread/task_queue.h"
 
 using tubekit::thread::task;
@@ -11,13 +13,19 @@ task_queue::~task_queue()
 {
 }
 
+uint64_t task_queue::now_us()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 bool task_queue::push(task *task_ptr)
 {
+    const uint64_t enqueue_us = now_us();
     auto_lock lock(m_mutex);
 
     if (nullptr == task_ptr)
     {
-        m_task.push_back(task_ptr);
+        m_task.emplace_back(task_ptr, enqueue_us);
         m_condition.broadcast();
         return true;
     }
@@ -29,7 +37,7 @@ bool task_queue::push(task *task_ptr)
         return false;
     }
 
-    m_task.push_back(task_ptr);
+    m_task.emplace_back(task_ptr, enqueue_us);
     m_in_task.insert(task_ptr->get_gid());
     m_condition.broadcast();
 
@@ -37,14 +45,23 @@ bool task_queue::push(task *task_ptr)
 }
 
 task *task_queue::pop()
+{
+    uint64_t enqueue_us = 0;
+    bool drained = false;
+    return pop(enqueue_us, drained);
+}
+
+task *task_queue::pop(uint64_t &enqueue_us, bool &drained)
 {
     auto_lock lock(m_mutex);
     while (m_task.empty())
     {
         m_condition.wait(&m_mutex);
     }
-    task *task_ptr = m_task.front();
+    task *task_ptr = m_task.front().first;
+    enqueue_us = m_task.front().second;
     m_task.pop_front();
+    drained = m_task.empty();
 
     if (task_ptr)
     {
@@ -1,4 +1,5 @@
 #include <list>
+#include <utility>
 #include <unordered_set>
 #include "thread/mutex.h"
 #include "thread/condition.h"
@@ -14,11 +15,26 @@ namespace tubekit::thread
         ~task_queue();
         bool push(task *task_ptr);
         task *pop();
+        /**
+         * @brief waits for a task
+         *
+         * @param enqueue_us steady clock time the task was pushed
+         * @param drained no task is left after it
+         * @return task*
+         */
+        task *pop(uint64_t &enqueue_us, bool &drained);
+
+        /**
+         * @brief steady clock
+         *
+         * @return uint64_t us
+         */
+        static uint64_t now_us();
 
     private:
         mutex m_mutex;
         condition m_condition;
-        std::list<task *> m_task{};
+        std::list<std::pair<task *, uint64_t>> m_task{};
         std::unordered_set<uint64_t> m_in_task{};
     };
 }
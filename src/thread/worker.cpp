@@ -11,10 +11,15 @@ using namespace tubekit::thread;
 using namespace tubekit::log;
 using namespace tubekit::utility;
 
-worker::worker(task_destory *destory_ptr) : thread(),
-                                            m_destory_ptr(destory_ptr),
-                                            m_stoped(true)
+thread_local worker *worker::m_current{nullptr};
+
+worker::worker(task_destory *destory_ptr, size_t mailbox_size, uint64_t codel_target_us, uint64_t codel_interval_us) : thread(),
+                                                                                                                     m_destory_ptr(destory_ptr),
+                                                                                                                     m_stoped(true),
+                                                                                                                     m_mailbox_task(this)
 {
+    m_mailbox.init(mailbox_size);
+    m_codel.init(codel_target_us, codel_interval_us);
 }
 
 worker::~worker()
@@ -32,6 +37,7 @@ void worker::run()
 {
     LOG_ERROR("worker[%x]::run() begin", this);
     m_stoped = false;
+    m_current = this;
     sigset_t mask;
     // sigfillset(sigset_t *set)调用该函数后，set指向的信号集中将包含linux支持的64种信号
     if (0 != sigfillset(&mask))
@@ -61,12 +67,16 @@ void worker::run()
 
     while (true) // 线程将会一直运行，to process task
     {
-        task *will_run_task = m_task_queue.pop();
+        uint64_t enqueue_us = 0;
+        bool drained = false;
+        task *will_run_task = m_task_queue.pop(enqueue_us, drained);
         if (will_run_task == nullptr || stop_flag)
         {
             m_stoped = true;
             break;
         }
+        const uint64_t now_us = task_queue::now_us();
+        m_codel.on_dequeue(now_us > enqueue_us ? now_us - enqueue_us : 0, now_us, drained);
         // int rc = 0;
         int old_state = 0;
         // rc =
@@ -82,8 +92,11 @@ void worker::run()
         // 执行任务
         will_run_task->run();
 
-        // destory task
-        m_destory_ptr->execute(will_run_task);
+        // destory task, mailbox task belongs to worker
+        if (will_run_task != &m_mailbox_task)
+        {
+            m_destory_ptr->execute(will_run_task);
+        }
 
         will_run_task = nullptr;
 
@@ -132,4 +145,71 @@ void worker::stop()
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
     LOG_ERROR("okay sleep_for worker[%x] m_stoped", this);
-}
\ No newline at end of file
+}
+
+worker *worker::current()
+{
+    return m_current;
+}
+
+codel &worker::get_codel()
+{
+    return m_codel;
+}
+
+bool worker::post(letter &&item)
+{
+    if (stop_flag || !m_mailbox.push(std::move(item)))
+    {
+        return false;
+    }
+    // one mailbox task in queue at most
+    if (false == m_mailbox_scheduled.exchange(true))
+    {
+        if (false == m_task_queue.push(&m_mailbox_task))
+        {
+            m_mailbox_scheduled = false;
+        }
+    }
+    return true;
+}
+
+worker::mailbox_task::mailbox_task(worker *owner) : task(mailbox_gid),
+                                                    m_owner(owner)
+{
+}
+
+worker::mailbox_task::~mailbox_task()
+{
+}
+
+void worker::mailbox_task::destroy()
+{
+}
+
+void worker::mailbox_task::run()
+{
+    letter item;
+    size_t count = 0;
+    while (count < mailbox_batch && m_owner->m_mailbox.pop(item))
+    {
+        if (item.deliver)
+        {
+            item.deliver(item);
+        }
+        item = letter{};
+        count++;
+    }
+    if (count == mailbox_batch)
+    {
+        // tasks of connections run before the next batch
+        m_owner->m_task_queue.push(this);
+        return;
+    }
+    m_owner->m_mailbox_scheduled = false;
+    // a letter posted before the flag was cleared did not schedule this task
+    if (!m_owner->m_mailbox.empty() && false == m_owner->m_mailbox_scheduled.exchange(true))
+    {
+        m_owner->m_task_queue.push(this);
+    }
+}
@@ -1,18 +1,36 @@
 #pragma once
 #include <pthread.h>
 #include <signal.h>
+#include <atomic>
+#include <memory>
+#include <string>
 
 #include "thread/thread.h"
 #include "thread/task_queue.h"
 #include "thread/task.h"
 #include "thread/task_destory.h"
+#include "thread/mailbox.h"
+#include "thread/codel.h"
 
 namespace tubekit::thread
 {
+    /**
+     * @brief message for the connection of gid, delivered on the worker owning gid
+     *
+     */
+    struct letter
+    {
+        uint64_t gid{0};
+        void (*deliver)(letter &item){nullptr};
+        std::string data{};
+        std::shared_ptr<void> shared{}; // shared by letters of the same message
+        uint8_t flag{0};
+    };
+
     class worker : public thread
     {
     public:
-        worker(task_destory *destory_ptr);
+        worker(task_destory *destory_ptr, size_t mailbox_size, uint64_t codel_target_us, uint64_t codel_interval_us);
         virtual ~worker();
         virtual void run();
 
@@ -20,12 +38,64 @@ namespace tubekit::thread
         void push(task *task_ptr);
         void stop();
 
+        /**
+         * @brief thread safe, item is delivered later by this worker, letters of the same sender keep their order
+         *
+         * @param item
+         * @return true
+         * @return false mailbox is full
+         */
+        bool post(letter &&item);
+
+        /**
+         * @brief worker of the calling thread
+         *
+         * @return worker* nullptr when not a worker thread
+         */
+        static worker *current();
+
+        /**
+         * @brief overload state of task queue, thread safe to read
+         *
+         * @return codel&
+         */
+        codel &get_codel();
+
     public:
         static void cleanup(void *ptr);
 
+    private:
+        /**
+         * @brief queued like tasks of connections, delivers a batch of letters each run
+         *
+         */
+        class mailbox_task : public task
+        {
+        public:
+            mailbox_task(worker *owner);
+            virtual ~mailbox_task();
+            virtual void run();
+            virtual void destroy();
+
+        private:
+            worker *m_owner{nullptr};
+        };
+
+        // not a gid of connection
+        static constexpr uint64_t mailbox_gid{UINT64_MAX};
+        static constexpr size_t mailbox_batch{1024};
+
     private:
         task_queue m_task_queue;
         task_destory *m_destory_ptr{nullptr};
         volatile bool m_stoped{true};
+
+        mailbox<letter> m_mailbox;
+        mailbox_task m_mailbox_task;
+        std::atomic<bool> m_mailbox_scheduled{false};
+
+        codel m_codel;
+
+        static thread_local worker *m_current;
     };
 }
@@ -19,11 +19,11 @@ size_t worker_pool::get_size()
     return worker_map.size();
 }
 
-void worker_pool::create(size_t size, task_destory *destory_ptr)
+void worker_pool::create(size_t size, task_destory *destory_ptr, size_t mailbox_size, uint64_t codel_target_us, uint64_t codel_interval_us)
 {
     for (size_t i = 0; i < size; i++)
     {
-        worker *new_worker = new worker(destory_ptr);
+        worker *new_worker = new worker(destory_ptr, mailbox_size, codel_target_us, codel_interval_us);
         LOG_ERROR("create worker thread %x", new_worker);
         worker_map[i] = new_worker;
         new_worker->start();
@@ -37,6 +37,22 @@ void worker_pool::assign(task *m_task, uint64_t hash_key)
     worker_map[hash_key]->push(m_task);
 }
 
+bool worker_pool::post(letter &&item)
+{
+    worker *owner = worker_map[item.gid % worker_map.size()];
+    if (owner == worker::current())
+    {
+        item.deliver(item);
+        return true;
+    }
+    return owner->post(std::move(item));
+}
+
+codel &worker_pool::get_codel(uint64_t hash_key)
+{
+    return worker_map[hash_key % worker_map.size()]->get_codel();
+}
+
 void worker_pool::stop()
 {
     for (auto m_pair : worker_map)
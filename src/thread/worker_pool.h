@@ -16,12 +16,39 @@ namespace tubekit::thread
         worker_pool();
         ~worker_pool();
 
-        void create(size_t size, task_destory *destory_ptr);
+        /**
+         * @brief
+         *
+         * @param size
+         * @param destory_ptr
+         * @param mailbox_size
+         * @param codel_target_us worker is overloaded when its tasks waited longer than it for codel_interval_us, 0 disables
+         * @param codel_interval_us
+         */
+        void create(size_t size, task_destory *destory_ptr, size_t mailbox_size, uint64_t codel_target_us, uint64_t codel_interval_us);
 
         size_t get_size();
 
         void assign(task *m_task, uint64_t hash_key);
 
+        /**
+         * @brief thread safe, item is delivered by the worker of its gid,
+         *        at once when called on that worker
+         *
+         * @param item
+         * @return true
+         * @return false mailbox of the worker is full
+         */
+        bool post(letter &&item);
+
+        /**
+         * @brief overload state of the worker of hash_key
+         *
+         * @param hash_key
+         * @return codel&
+         */
+        codel &get_codel(uint64_t hash_key);
+
         void stop();
 
     private:
@@ -0,0 +1,95 @@
+#include "utility/arena.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+using tubekit::utility::arena;
+
+arena::arena(size_t block_size /*= 4096*/) : m_block_size(block_size),
+                                             m_head(nullptr),
+                                             m_used(0)
+{
+}
+
+arena::~arena()
+{
+    while (m_head)
+    {
+        block *next = m_head->next;
+        ::free(m_head);
+        m_head = next;
+    }
+}
+
+arena::block *arena::new_block(size_t size)
+{
+    void *mem = ::malloc(sizeof(block) + size);
+    if (!mem)
+    {
+        return nullptr;
+    }
+    block *new_block = new (mem) block;
+    new_block->size = size;
+    new_block->next = m_head;
+    m_head = new_block;
+    return new_block;
+}
+
+void *arena::allocate(size_t size, size_t align /*= alignof(std::max_align_t)*/)
+{
+    if (m_head)
+    {
+        uintptr_t begin = reinterpret_cast<uintptr_t>(m_head->data()) + m_head->used;
+        uintptr_t aligned = (begin + align - 1) & ~(uintptr_t)(align - 1);
+        size_t need = aligned - begin + size;
+        if (m_head->used + need <= m_head->size)
+        {
+            m_head->used += need;
+            m_used += size;
+            return reinterpret_cast<void *>(aligned);
+        }
+    }
+
+    size_t block_size = size + align > m_block_size ? size + align : m_block_size;
+    if (!new_block(block_size))
+    {
+        return nullptr;
+    }
+    uintptr_t begin = reinterpret_cast<uintptr_t>(m_head->data());
+    uintptr_t aligned = (begin + align - 1) & ~(uintptr_t)(align - 1);
+    m_head->used = aligned - begin + size;
+    m_used += size;
+    return reinterpret_cast<void *>(aligned);
+}
+
+char *arena::copy(const char *data, size_t len)
+{
+    char *dest = static_cast<char *>(allocate(len, 1));
+    if (dest && len > 0)
+    {
+        memcpy(dest, data, len);
+    }
+    return dest;
+}
+
+void arena::reset()
+{
+    // free all blocks but the first one
+    while (m_head && m_head->next)
+    {
+        block *next = m_head->next;
+        ::free(m_head);
+        m_head = next;
+    }
+    if (m_head)
+    {
+        m_head->used = 0;
+    }
+    m_used = 0;
+}
+
+size_t arena::get_used() const
+{
+    return m_used;
+}
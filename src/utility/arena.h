@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace tubekit::utility
+{
+    /**
+     * @brief bump allocator, memory is released all at once by reset
+     *
+     */
+    class arena
+    {
+    public:
+        arena(size_t block_size = 4096);
+        ~arena();
+        arena(const arena &) = delete;
+        arena &operator=(const arena &) = delete;
+
+        /**
+         * @brief allocate size bytes aligned to align
+         *
+         * @param size
+         * @param align power of 2
+         * @return void* nullptr when malloc failed
+         */
+        void *allocate(size_t size, size_t align = alignof(std::max_align_t));
+
+        /**
+         * @brief copy len bytes into arena
+         *
+         * @param data
+         * @param len
+         * @return char*
+         */
+        char *copy(const char *data, size_t len);
+
+        /**
+         * @brief all allocated memory become invalid, the first block is kept for reusing
+         *
+         */
+        void reset();
+
+        size_t get_used() const;
+
+    private:
+        struct block
+        {
+            block *next{nullptr};
+            size_t size{0};
+            size_t used{0};
+            char *data()
+            {
+                return reinterpret_cast<char *>(this + 1);
+            }
+        };
+
+        block *new_block(size_t size);
+
+    private:
+        size_t m_block_size{0};
+        block *m_head{nullptr}; // current block, the first block is at the end of list
+        size_t m_used{0};
+    };
+}
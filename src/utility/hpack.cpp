@@ -0,0 +1,447 @@
+#include "utility/hpack.h"
+
+using tubekit::utility::hpack;
+
+// RFC 7541 Appendix A
+static const std::pair<std::string_view, std::string_view> static_table[] = {
+    {":authority", ""},
+    {":method", "GET"},
+    {":method", "POST"},
+    {":path", "/"},
+    {":path", "/index.html"},
+    {":scheme", "http"},
+    {":scheme", "https"},
+    {":status", "200"},
+    {":status", "204"},
+    {":status", "206"},
+    {":status", "304"},
+    {":status", "400"},
+    {":status", "404"},
+    {":status", "500"},
+    {"accept-charset", ""},
+    {"accept-encoding", "gzip, deflate"},
+    {"accept-language", ""},
+    {"accept-ranges", ""},
+    {"accept", ""},
+    {"access-control-allow-origin", ""},
+    {"age", ""},
+    {"allow", ""},
+    {"authorization", ""},
+    {"cache-control", ""},
+    {"content-disposition", ""},
+    {"content-encoding", ""},
+    {"content-language", ""},
+    {"content-length", ""},
+    {"content-location", ""},
+    {"content-range", ""},
+    {"content-type", ""},
+    {"cookie", ""},
+    {"date", ""},
+    {"etag", ""},
+    {"expect", ""},
+    {"expires", ""},
+    {"from", ""},
+    {"host", ""},
+    {"if-match", ""},
+    {"if-modified-since", ""},
+    {"if-none-match", ""},
+    {"if-range", ""},
+    {"if-unmodified-since", ""},
+    {"last-modified", ""},
+    {"link", ""},
+    {"location", ""},
+    {"max-forwards", ""},
+    {"proxy-authenticate", ""},
+    {"proxy-authorization", ""},
+    {"range", ""},
+    {"referer", ""},
+    {"refresh", ""},
+    {"retry-after", ""},
+    {"server", ""},
+    {"set-cookie", ""},
+    {"strict-transport-security", ""},
+    {"transfer-encoding", ""},
+    {"user-agent", ""},
+    {"vary", ""},
+    {"via", ""},
+    {"www-authenticate", ""},
+};
+
+// RFC 7541 Appendix B, code and bit length of each symbol, 256 is EOS
+static const uint32_t huffman_codes[257] = {
+    0x1ff8, 0x7fffd8, 0xfffffe2, 0xfffffe3, 0xfffffe4, 0xfffffe5, 0xfffffe6, 0xfffffe7,
+    0xfffffe8, 0xffffea, 0x3ffffffc, 0xfffffe9, 0xfffffea, 0x3ffffffd, 0xfffffeb, 0xfffffec,
+    0xfffffed, 0xfffffee, 0xfffffef, 0xffffff0, 0xffffff1, 0xffffff2, 0x3ffffffe, 0xffffff3,
+    0xffffff4, 0xffffff5, 0xffffff6, 0xffffff7, 0xffffff8, 0xffffff9, 0xffffffa, 0xffffffb,
+    0x14, 0x3f8, 0x3f9, 0xffa, 0x1ff9, 0x15, 0xf8, 0x7fa,
+    0x3fa, 0x3fb, 0xf9, 0x7fb, 0xfa, 0x16, 0x17, 0x18,
+    0x0, 0x1, 0x2, 0x19, 0x1a, 0x1b, 0x1c, 0x1d,
+    0x1e, 0x1f, 0x5c, 0xfb, 0x7ffc, 0x20, 0xffb, 0x3fc,
+    0x1ffa, 0x21, 0x5d, 0x5e, 0x5f, 0x60, 0x61, 0x62,
+    0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a,
+    0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72,
+    0xfc, 0x73, 0xfd, 0x1ffb, 0x7fff0, 0x1ffc, 0x3ffc, 0x22,
+    0x7ffd, 0x3, 0x23, 0x4, 0x24, 0x5, 0x25, 0x26,
+    0x27, 0x6, 0x74, 0x75, 0x28, 0x29, 0x2a, 0x7,
+    0x2b, 0x76, 0x2c, 0x8, 0x9, 0x2d, 0x77, 0x78,
+    0x79, 0x7a, 0x7b, 0x7ffe, 0x7fc, 0x3ffd, 0x1ffd, 0xffffffc,
+    0xfffe6, 0x3fffd2, 0xfffe7, 0xfffe8, 0x3fffd3, 0x3fffd4, 0x3fffd5, 0x7fffd9,
+    0x3fffd6, 0x7fffda, 0x7fffdb, 0x7fffdc, 0x7fffdd, 0x7fffde, 0xffffeb, 0x7fffdf,
+    0xffffec, 0xffffed, 0x3fffd7, 0x7fffe0, 0xffffee, 0x7fffe1, 0x7fffe2, 0x7fffe3,
+    0x7fffe4, 0x1fffdc, 0x3fffd8, 0x7fffe5, 0x3fffd9, 0x7fffe6, 0x7fffe7, 0xffffef,
+    0x3fffda, 0x1fffdd, 0xfffe9, 0x3fffdb, 0x3fffdc, 0x7fffe8, 0x7fffe9, 0x1fffde,
+    0x7fffea, 0x3fffdd, 0x3fffde, 0xfffff0, 0x1fffdf, 0x3fffdf, 0x7fffeb, 0x7fffec,
+    0x1fffe0, 0x1fffe1, 0x3fffe0, 0x1fffe2, 0x7fffed, 0x3fffe1, 0x7fffee, 0x7fffef,
+    0xfffea, 0x3fffe2, 0x3fffe3, 0x3fffe4, 0x7ffff0, 0x3fffe5, 0x3fffe6, 0x7ffff1,
+    0x3ffffe0, 0x3ffffe1, 0xfffeb, 0x7fff1, 0x3fffe7, 0x7ffff2, 0x3fffe8, 0x1ffffec,
+    0x3ffffe2, 0x3ffffe3, 0x3ffffe4, 0x7ffffde, 0x7ffffdf, 0x3ffffe5, 0xfffff1, 0x1ffffed,
+    0x7fff2, 0x1fffe3, 0x3ffffe6, 0x7ffffe0, 0x7ffffe1, 0x3ffffe7, 0x7ffffe2, 0xfffff2,
+    0x1fffe4, 0x1fffe5, 0x3ffffe8, 0x3ffffe9, 0xffffffd, 0x7ffffe3, 0x7ffffe4, 0x7ffffe5,
+    0xfffec, 0xfffff3, 0xfffed, 0x1fffe6, 0x3fffe9, 0x1fffe7, 0x1fffe8, 0x7ffff3,
+    0x3fffea, 0x3fffeb, 0x1ffffee, 0x1ffffef, 0xfffff4, 0xfffff5, 0x3ffffea, 0x7ffff4,
+    0x3ffffeb, 0x7ffffe6, 0x3ffffec, 0x3ffffed, 0x7ffffe7, 0x7ffffe8, 0x7ffffe9, 0x7ffffea,
+    0x7ffffeb, 0xffffffe, 0x7ffffec, 0x7ffffed, 0x7ffffee, 0x7ffffef, 0x7fffff0, 0x3ffffee,
+    0x3fffffff,
+};
+
+static const uint8_t huffman_code_lens[257] = {
+    13, 23, 28, 28, 28, 28, 28, 28, 28, 24, 30, 28, 28, 30, 28, 28,
+    28, 28, 28, 28, 28, 28, 30, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    6, 10, 10, 12, 13, 6, 8, 11, 10, 10, 8, 11, 8, 6, 6, 6,
+    5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 7, 8, 15, 6, 12, 10,
+    13, 6, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 8, 7, 8, 13, 19, 13, 14, 6,
+    15, 5, 6, 5, 6, 5, 6, 6, 6, 5, 7, 7, 6, 6, 6, 5,
+    6, 7, 6, 5, 5, 6, 7, 7, 7, 7, 7, 15, 11, 14, 13, 28,
+    20, 22, 20, 20, 22, 22, 22, 23, 22, 23, 23, 23, 23, 23, 24, 23,
+    24, 24, 22, 23, 24, 23, 23, 23, 23, 21, 22, 23, 22, 23, 23, 24,
+    22, 21, 20, 22, 22, 23, 23, 21, 23, 22, 22, 24, 21, 22, 23, 23,
+    21, 21, 22, 21, 23, 22, 23, 23, 20, 22, 22, 22, 23, 22, 22, 23,
+    26, 26, 20, 19, 22, 23, 22, 25, 26, 26, 26, 27, 27, 26, 24, 25,
+    19, 21, 26, 27, 27, 26, 27, 24, 21, 21, 26, 26, 28, 27, 27, 27,
+    20, 24, 20, 21, 22, 21, 21, 23, 22, 22, 25, 25, 24, 24, 26, 23,
+    26, 27, 26, 26, 27, 27, 27, 27, 27, 28, 27, 27, 27, 27, 27, 26,
+    30,
+};
+
+static constexpr size_t static_table_size = sizeof(static_table) / sizeof(static_table[0]);
+static constexpr size_t entry_overhead = 32; // RFC 7541 4.1
+
+/**
+ * @brief binary tree of huffman codes, built once
+ *
+ */
+struct huffman_tree
+{
+    static constexpr int max_nodes = 513;
+    int16_t children[max_nodes][2];
+    int16_t symbols[max_nodes];
+    int16_t count{1};
+
+    huffman_tree()
+    {
+        for (int i = 0; i < max_nodes; i++)
+        {
+            children[i][0] = -1;
+            children[i][1] = -1;
+            symbols[i] = -1;
+        }
+        for (int symbol = 0; symbol < 257; symbol++)
+        {
+            int node = 0;
+            for (int bit = huffman_code_lens[symbol] - 1; bit >= 0; bit--)
+            {
+                int branch = (huffman_codes[symbol] >> bit) & 1;
+                if (children[node][branch] < 0)
+                {
+                    children[node][branch] = count++;
+                }
+                node = children[node][branch];
+            }
+            symbols[node] = symbol;
+        }
+    }
+};
+
+static const huffman_tree &get_huffman_tree()
+{
+    static const huffman_tree tree;
+    return tree;
+}
+
+hpack::hpack()
+{
+}
+
+hpack::~hpack()
+{
+}
+
+void hpack::set_max_table_size(size_t max_size)
+{
+    m_settings_max_size = max_size;
+    if (m_table_max_size > max_size)
+    {
+        m_table_max_size = max_size;
+        evict(max_size);
+    }
+}
+
+int hpack::decode_integer(const uint8_t *&pos, const uint8_t *end, int prefix_bits, uint64_t &value)
+{
+    if (pos >= end)
+    {
+        return -1;
+    }
+    const uint64_t mask = (1u << prefix_bits) - 1;
+    value = *pos++ & mask;
+    if (value < mask)
+    {
+        return 0;
+    }
+    int shift = 0;
+    while (pos < end)
+    {
+        uint8_t byte = *pos++;
+        if (shift > 56)
+        {
+            return -1;
+        }
+        value += (uint64_t)(byte & 0x7f) << shift;
+        shift += 7;
+        if (!(byte & 0x80))
+        {
+            return 0;
+        }
+    }
+    return -1;
+}
+
+void hpack::encode_integer(uint64_t value, int prefix_bits, uint8_t first_byte, std::string &out)
+{
+    const uint64_t mask = (1u << prefix_bits) - 1;
+    if (value < mask)
+    {
+        out.push_back((char)(first_byte | value));
+        return;
+    }
+    out.push_back((char)(first_byte | mask));
+    value -= mask;
+    while (value >= 128)
+    {
+        out.push_back((char)((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back((char)value);
+}
+
+bool hpack::huffman_decode(const uint8_t *data, size_t len, std::string &out)
+{
+    const huffman_tree &tree = get_huffman_tree();
+    int node = 0;
+    int pending_bits = 0;
+    bool pending_ones = true;
+    for (size_t i = 0; i < len; i++)
+    {
+        for (int bit = 7; bit >= 0; bit--)
+        {
+            int branch = (data[i] >> bit) & 1;
+            node = tree.children[node][branch];
+            if (node < 0)
+            {
+                return false;
+            }
+            pending_bits++;
+            pending_ones = pending_ones && branch;
+            if (tree.symbols[node] >= 0)
+            {
+                if (tree.symbols[node] == 256) // EOS in string is an error
+                {
+                    return false;
+                }
+                out.push_back((char)tree.symbols[node]);
+                node = 0;
+                pending_bits = 0;
+                pending_ones = true;
+            }
+        }
+    }
+    // padding is the most significant bits of EOS, shorter than a byte
+    return pending_bits < 8 && pending_ones;
+}
+
+int hpack::decode_string(const uint8_t *&pos, const uint8_t *end, std::string &out)
+{
+    if (pos >= end)
+    {
+        return -1;
+    }
+    const bool huffman = *pos & 0x80;
+    uint64_t len = 0;
+    if (0 != decode_integer(pos, end, 7, len) || len > (uint64_t)(end - pos))
+    {
+        return -1;
+    }
+    out.clear();
+    if (huffman)
+    {
+        if (!huffman_decode(pos, len, out))
+        {
+            return -1;
+        }
+    }
+    else
+    {
+        out.assign((const char *)pos, len);
+    }
+    pos += len;
+    return 0;
+}
+
+bool hpack::get_indexed(uint64_t index, std::string_view &name, std::string_view &value) const
+{
+    if (index == 0)
+    {
+        return false;
+    }
+    if (index <= static_table_size)
+    {
+        name = static_table[index - 1].first;
+        value = static_table[index - 1].second;
+        return true;
+    }
+    index -= static_table_size + 1;
+    if (index >= m_dynamic_table.size())
+    {
+        return false;
+    }
+    name = m_dynamic_table[index].first;
+    value = m_dynamic_table[index].second;
+    return true;
+}
+
+void hpack::evict(size_t target_size)
+{
+    while (m_table_size > target_size && !m_dynamic_table.empty())
+    {
+        const auto &oldest = m_dynamic_table.back();
+        m_table_size -= oldest.first.size() + oldest.second.size() + entry_overhead;
+        m_dynamic_table.pop_back();
+    }
+}
+
+void hpack::add_entry(std::string_view name, std::string_view value)
+{
+    const size_t entry_size = name.size() + value.size() + entry_overhead;
+    if (entry_size > m_table_max_size)
+    {
+        evict(0); // RFC 7541 4.4, table is emptied
+        return;
+    }
+    evict(m_table_max_size - entry_size);
+    m_dynamic_table.emplace_front(std::string(name), std::string(value));
+    m_table_size += entry_size;
+}
+
+int hpack::decode(const uint8_t *data, size_t len, const header_callback &on_header)
+{
+    const uint8_t *pos = data;
+    const uint8_t *end = data + len;
+    std::string name_literal;
+    std::string value_literal;
+    while (pos < end)
+    {
+        const uint8_t first = *pos;
+        uint64_t index = 0;
+        if (first & 0x80) // indexed header field
+        {
+            std::string_view name, value;
+            if (0 != decode_integer(pos, end, 7, index) || !get_indexed(index, name, value))
+            {
+                return -1;
+            }
+            if (!on_header(name, value))
+            {
+                return -2;
+            }
+            continue;
+        }
+        if ((first & 0xe0) == 0x20) // dynamic table size update
+        {
+            if (0 != decode_integer(pos, end, 5, index) || index > m_settings_max_size)
+            {
+                return -1;
+            }
+            m_table_max_size = index;
+            evict(m_table_max_size);
+            continue;
+        }
+
+        // literal, with incremental indexing or without indexing or never indexed
+        const bool indexing = (first & 0xc0) == 0x40;
+        if (0 != decode_integer(pos, end, indexing ? 6 : 4, index))
+        {
+            return -1;
+        }
+        if (index > 0)
+        {
+            std::string_view name, value;
+            if (!get_indexed(index, name, value))
+            {
+                return -1;
+            }
+            name_literal.assign(name); // entry may be evicted by add_entry
+        }
+        else if (0 != decode_string(pos, end, name_literal))
+        {
+            return -1;
+        }
+        if (0 != decode_string(pos, end, value_literal))
+        {
+            return -1;
+        }
+        if (indexing)
+        {
+            add_entry(name_literal, value_literal);
+        }
+        if (!on_header(name_literal, value_literal))
+        {
+            return -2;
+        }
+    }
+    return 0;
+}
+
+void hpack::encode(std::string_view name, std::string_view value, std::string &out)
+{
+    size_t index = 0;
+    for (size_t i = 0; i < static_table_size; i++)
+    {
+        if (static_table[i].first == name)
+        {
+            index = i + 1;
+            break;
+        }
+    }
+    encode_integer(index, 4, 0x00, out);
+    if (index == 0)
+    {
+        encode_integer(name.size(), 7, 0x00, out);
+        out.append(name);
+    }
+    encode_integer(value.size(), 7, 0x00, out);
+    out.append(value);
+}
+
+void hpack::encode_status(int status, std::string &out)
+{
+    for (size_t i = 7; i < 14; i++) // :status entries
+    {
+        if (static_table[i].second == std::to_string(status))
+        {
+            encode_integer(i + 1, 7, 0x80, out);
+            return;
+        }
+    }
+    encode(":status", std::to_string(status), out);
+}
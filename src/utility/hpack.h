@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <deque>
+#include <functional>
+#include <utility>
+
+namespace tubekit
+{
+    namespace utility
+    {
+        /**
+         * @brief HPACK (RFC 7541) header compression for one HTTP/2 connection,
+         *        decoder keeps the peer's dynamic table, encoder never indexes so it needs no state
+         *
+         */
+        class hpack
+        {
+        public:
+            using header_callback = std::function<bool(std::string_view name, std::string_view value)>;
+
+        public:
+            hpack();
+            ~hpack();
+
+            /**
+             * @brief decode a complete header block
+             *
+             * @param data
+             * @param len
+             * @param on_header views are valid only during the call, return false to stop
+             * @return int 0 success, -1 compression error, -2 stopped by on_header
+             */
+            int decode(const uint8_t *data, size_t len, const header_callback &on_header);
+
+            /**
+             * @brief SETTINGS_HEADER_TABLE_SIZE sent to peer, upper bound of dynamic table size updates
+             *
+             * @param max_size
+             */
+            void set_max_table_size(size_t max_size);
+
+            /**
+             * @brief literal without indexing, name is referenced from static table when possible
+             *
+             * @param name lowercase
+             * @param value
+             * @param out appended
+             */
+            static void encode(std::string_view name, std::string_view value, std::string &out);
+
+            /**
+             * @brief :status, indexed when in static table
+             *
+             * @param status
+             * @param out appended
+             */
+            static void encode_status(int status, std::string &out);
+
+            static void encode_integer(uint64_t value, int prefix_bits, uint8_t first_byte, std::string &out);
+            static int decode_integer(const uint8_t *&pos, const uint8_t *end, int prefix_bits, uint64_t &value);
+            static bool huffman_decode(const uint8_t *data, size_t len, std::string &out);
+
+        private:
+            int decode_string(const uint8_t *&pos, const uint8_t *end, std::string &out);
+            bool get_indexed(uint64_t index, std::string_view &name, std::string_view &value) const;
+            void add_entry(std::string_view name, std::string_view value);
+            void evict(size_t target_size);
+
+        private:
+            std::deque<std::pair<std::string, std::string>> m_dynamic_table{}; // newest at front
+            size_t m_table_size{0};
+            size_t m_table_max_size{4096};
+            size_t m_settings_max_size{4096};
+        };
+    }
+}
@@ -0,0 +1,142 @@
+#include "utility/http_range.h"
+
+using tubekit::utility::http_range;
+
+static inline bool parse_uint64(std::string_view str, size_t begin, size_t end, uint64_t &out)
+{
+    if (begin >= end)
+    {
+        return false;
+    }
+    uint64_t n = 0;
+    for (size_t i = begin; i < end; ++i)
+    {
+        char ch = str[i];
+        if (ch < '0' || ch > '9')
+        {
+            return false;
+        }
+        if (n > (UINT64_MAX - (ch - '0')) / 10)
+        {
+            return false; // overflow
+        }
+        n = n * 10 + (ch - '0');
+    }
+    out = n;
+    return true;
+}
+
+http_range::parse_result http_range::parse(std::string_view value, uint64_t size, size_t max_ranges, std::vector<range> &out)
+{
+    out.clear();
+
+    constexpr const char *unit = "bytes=";
+    constexpr size_t unit_len = 6;
+    if (value.compare(0, unit_len, unit) != 0)
+    {
+        return IGNORE;
+    }
+
+    size_t spec_count = 0;
+    size_t pos = unit_len;
+    while (pos <= value.size())
+    {
+        size_t comma = value.find(',', pos);
+        if (comma == std::string_view::npos)
+        {
+            comma = value.size();
+        }
+
+        // trim OWS
+        size_t begin = pos, end = comma;
+        while (begin < end && (value[begin] == ' ' || value[begin] == '\t'))
+        {
+            ++begin;
+        }
+        while (end > begin && (value[end - 1] == ' ' || value[end - 1] == '\t'))
+        {
+            --end;
+        }
+        pos = comma + 1;
+
+        if (begin == end)
+        {
+            if (comma == value.size())
+            {
+                break;
+            }
+            continue; // empty list element is allowed
+        }
+
+        if (++spec_count > max_ranges)
+        {
+            out.clear();
+            return IGNORE;
+        }
+
+        size_t dash = value.find('-', begin);
+        if (dash == std::string_view::npos || dash >= end)
+        {
+            out.clear();
+            return IGNORE;
+        }
+
+        uint64_t first = 0, last = 0;
+        if (dash == begin) // suffix-byte-range-spec "-N"
+        {
+            uint64_t suffix = 0;
+            if (!parse_uint64(value, dash + 1, end, suffix))
+            {
+                out.clear();
+                return IGNORE;
+            }
+            if (suffix == 0 || size == 0)
+            {
+                continue; // unsatisfiable
+            }
+            first = suffix >= size ? 0 : size - suffix;
+            last = size - 1;
+        }
+        else
+        {
+            if (!parse_uint64(value, begin, dash, first))
+            {
+                out.clear();
+                return IGNORE;
+            }
+            if (dash + 1 == end) // "N-"
+            {
+                last = size == 0 ? 0 : size - 1;
+            }
+            else if (!parse_uint64(value, dash + 1, end, last) || last < first)
+            {
+                out.clear();
+                return IGNORE;
+            }
+            if (first >= size)
+            {
+                continue; // unsatisfiable
+            }
+            if (last >= size)
+            {
+                last = size - 1;
+            }
+        }
+        out.push_back({first, last});
+
+        if (comma == value.size())
+        {
+            break;
+        }
+    }
+
+    if (spec_count == 0)
+    {
+        return IGNORE;
+    }
+    if (out.empty())
+    {
+        return NOT_SATISFIABLE;
+    }
+    return OK;
+}
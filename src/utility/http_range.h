@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace tubekit::utility
+{
+    class http_range
+    {
+    public:
+        /**
+         * @brief inclusive byte range [first, last]
+         *
+         */
+        using range = std::pair<uint64_t, uint64_t>;
+
+        enum parse_result
+        {
+            OK = 0,
+            IGNORE = -1,          // syntax error, unknown unit or too many ranges, serve the whole resource
+            NOT_SATISFIABLE = -2, // response 416
+        };
+
+        /**
+         * @brief parse Range header value, such as "bytes=0-99,200-,-50"
+         *
+         * @param value Range header value
+         * @param size resource size
+         * @param max_ranges more ranges than this will be ignored
+         * @param out satisfiable ranges, in request order
+         * @return parse_result
+         */
+        static parse_result parse(std::string_view value, uint64_t size, size_t max_ranges, std::vector<range> &out);
+    };
+}
@@ -0,0 +1,365 @@
+#include <cstring>
+#include <climits>
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TUBEKIT_HTTP_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+#include "utility/http_simd_parser.h"
+
+using tubekit::utility::http_simd_parser;
+
+// a scan returns the first byte that ends the slice, or end
+using scan_func = const char *(*)(const char *pos, const char *end);
+
+struct scanners
+{
+    scan_func url;   // stops at CTL, SP, DEL
+    scan_func name;  // stops at CTL, SP, ':', DEL and non-ASCII
+    scan_func value; // stops at CTL except HTAB, DEL
+};
+
+enum scan_kind
+{
+    SCAN_URL,
+    SCAN_NAME,
+    SCAN_VALUE
+};
+
+static constexpr bool is_stop(scan_kind kind, unsigned char c)
+{
+    switch (kind)
+    {
+    case SCAN_URL:
+        return c <= 0x20 || c == 0x7f;
+    case SCAN_NAME:
+        return c <= 0x20 || c == ':' || c >= 0x7f;
+    default:
+        return (c < 0x20 && c != '\t') || c == 0x7f;
+    }
+}
+
+template <scan_kind kind>
+static const char *scan_scalar(const char *pos, const char *end)
+{
+    while (pos < end && !is_stop(kind, static_cast<unsigned char>(*pos)))
+    {
+        pos++;
+    }
+    return pos;
+}
+
+#ifdef TUBEKIT_HTTP_SIMD_X86
+
+template <scan_kind kind>
+__attribute__((target("sse4.2"))) static inline const char *scan_sse42(const char *pos, const char *end)
+{
+    // byte ranges that stop the scan, pairs of [low, high]
+    __m128i ranges;
+    int ranges_len;
+    if (kind == SCAN_URL)
+    {
+        ranges = _mm_setr_epi8(0x00, 0x20, 0x7f, 0x7f, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+        ranges_len = 4;
+    }
+    else if (kind == SCAN_NAME)
+    {
+        ranges = _mm_setr_epi8(0x00, 0x20, ':', ':', 0x7f, static_cast<char>(0xff), 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+        ranges_len = 6;
+    }
+    else
+    {
+        ranges = _mm_setr_epi8(0x00, 0x08, 0x0a, 0x1f, 0x7f, 0x7f, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+        ranges_len = 6;
+    }
+    while (end - pos >= 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos));
+        int idx = _mm_cmpestri(ranges, ranges_len, block, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_LEAST_SIGNIFICANT);
+        if (idx != 16)
+        {
+            return pos + idx;
+        }
+        pos += 16;
+    }
+    return scan_scalar<kind>(pos, end);
+}
+
+template <scan_kind kind>
+__attribute__((target("avx2"))) static const char *scan_avx2(const char *pos, const char *end)
+{
+    const __m256i x1f = _mm256_set1_epi8(0x1f);
+    const __m256i x20 = _mm256_set1_epi8(0x20);
+    const __m256i x7f = _mm256_set1_epi8(0x7f);
+    const __m256i colon = _mm256_set1_epi8(':');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    while (end - pos >= 32)
+    {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pos));
+        __m256i stop;
+        if (kind == SCAN_URL)
+        {
+            // unsigned block <= 0x20 when max(block, 0x20) == 0x20
+            stop = _mm256_or_si256(_mm256_cmpeq_epi8(_mm256_max_epu8(block, x20), x20), _mm256_cmpeq_epi8(block, x7f));
+        }
+        else if (kind == SCAN_NAME)
+        {
+            stop = _mm256_or_si256(_mm256_cmpeq_epi8(_mm256_max_epu8(block, x20), x20), _mm256_cmpeq_epi8(block, colon));
+            stop = _mm256_or_si256(stop, _mm256_cmpeq_epi8(_mm256_max_epu8(block, x7f), block));
+        }
+        else
+        {
+            stop = _mm256_andnot_si256(_mm256_cmpeq_epi8(block, tab), _mm256_cmpeq_epi8(_mm256_max_epu8(block, x1f), x1f));
+            stop = _mm256_or_si256(stop, _mm256_cmpeq_epi8(block, x7f));
+        }
+        unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(stop));
+        if (mask != 0)
+        {
+            return pos + __builtin_ctz(mask);
+        }
+        pos += 32;
+    }
+    return scan_sse42<kind>(pos, end);
+}
+
+#endif
+
+static const scanners scalar_scanners{scan_scalar<SCAN_URL>, scan_scalar<SCAN_NAME>, scan_scalar<SCAN_VALUE>};
+#ifdef TUBEKIT_HTTP_SIMD_X86
+static const scanners sse42_scanners{scan_sse42<SCAN_URL>, scan_sse42<SCAN_NAME>, scan_sse42<SCAN_VALUE>};
+static const scanners avx2_scanners{scan_avx2<SCAN_URL>, scan_avx2<SCAN_NAME>, scan_avx2<SCAN_VALUE>};
+#endif
+
+static bool equals_lower(std::string_view text, std::string_view lower)
+{
+    if (text.size() != lower.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        char c = text[i];
+        if (c >= 'A' && c <= 'Z')
+        {
+            c = c - 'A' + 'a';
+        }
+        if (c != lower[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int parse_head(const char *data, size_t len, http_simd_parser::request &out, const scanners &scan)
+{
+    if (len > INT_MAX)
+    {
+        len = INT_MAX;
+    }
+    const char *pos = data;
+    const char *end = data + len;
+    out.header_count = 0;
+    out.content_length = http_simd_parser::no_content_length;
+
+    // empty lines before request line are ignored like http-parser does
+    while (end - pos >= 2 && pos[0] == '\r' && pos[1] == '\n')
+    {
+        pos += 2;
+    }
+    if (pos == end || (pos[0] == '\r' && end - pos == 1))
+    {
+        return http_simd_parser::INCOMPLETE;
+    }
+
+    // method
+    const char *method_start = pos;
+    while (pos < end && ((*pos >= 'A' && *pos <= 'Z') || *pos == '-'))
+    {
+        pos++;
+    }
+    if (pos == end)
+    {
+        return http_simd_parser::INCOMPLETE;
+    }
+    if (*pos != ' ' || pos == method_start)
+    {
+        return http_simd_parser::UNSUPPORTED;
+    }
+    out.method = std::string_view(method_start, pos - method_start);
+    if (out.method == "CONNECT")
+    {
+        return http_simd_parser::UNSUPPORTED;
+    }
+    pos++;
+
+    // url
+    const char *url_start = pos;
+    pos = scan.url(pos, end);
+    if (pos == end)
+    {
+        return http_simd_parser::INCOMPLETE;
+    }
+    if (*pos != ' ' || pos == url_start)
+    {
+        return http_simd_parser::UNSUPPORTED;
+    }
+    out.url = std::string_view(url_start, pos - url_start);
+    pos++;
+
+    // version
+    constexpr std::string_view version_prefix{"HTTP/1."};
+    if (end - pos < 10)
+    {
+        const size_t compare_len = std::min(version_prefix.size(), static_cast<size_t>(end - pos));
+        return 0 == memcmp(pos, version_prefix.data(), compare_len) ? http_simd_parser::INCOMPLETE : http_simd_parser::UNSUPPORTED;
+    }
+    if (0 != memcmp(pos, version_prefix.data(), version_prefix.size()) || pos[7] < '0' || pos[7] > '9' || pos[8] != '\r' || pos[9] != '\n')
+    {
+        return http_simd_parser::UNSUPPORTED;
+    }
+    out.http_minor = pos[7] - '0';
+    pos += 10;
+
+    // headers
+    while (true)
+    {
+        if (pos == end)
+        {
+            return http_simd_parser::INCOMPLETE;
+        }
+        if (*pos == '\r')
+        {
+            if (end - pos == 1)
+            {
+                return http_simd_parser::INCOMPLETE;
+            }
+            if (pos[1] != '\n')
+            {
+                return http_simd_parser::UNSUPPORTED;
+            }
+            pos += 2;
+            break;
+        }
+        if (out.header_count == http_simd_parser::max_headers)
+        {
+            return http_simd_parser::UNSUPPORTED;
+        }
+
+        // a line starting with SP or HTAB (obs-fold) stops here too
+        const char *name_start = pos;
+        pos = scan.name(pos, end);
+        if (pos == end)
+        {
+            return http_simd_parser::INCOMPLETE;
+        }
+        if (*pos != ':' || pos == name_start)
+        {
+            return http_simd_parser::UNSUPPORTED;
+        }
+        std::string_view key(name_start, pos - name_start);
+        pos++;
+
+        while (pos < end && (*pos == ' ' || *pos == '\t'))
+        {
+            pos++;
+        }
+        const char *value_start = pos;
+        pos = scan.value(pos, end);
+        if (pos == end || (*pos == '\r' && end - pos == 1))
+        {
+            return http_simd_parser::INCOMPLETE;
+        }
+        if (*pos != '\r' || pos[1] != '\n')
+        {
+            return http_simd_parser::UNSUPPORTED;
+        }
+        const char *value_end = pos;
+        while (value_end > value_start && (value_end[-1] == ' ' || value_end[-1] == '\t'))
+        {
+            value_end--;
+        }
+        std::string_view value(value_start, value_end - value_start);
+        pos += 2;
+
+        // headers that change how the message is framed
+        if (key.size() == 14 && equals_lower(key, "content-length"))
+        {
+            if (out.content_length != http_simd_parser::no_content_length || value.empty())
+            {
+                return http_simd_parser::UNSUPPORTED;
+            }
+            uint64_t content_length = 0;
+            for (char c : value)
+            {
+                if (c < '0' || c > '9' || content_length > (UINT64_MAX - 10) / 10)
+                {
+                    return http_simd_parser::UNSUPPORTED;
+                }
+                content_length = content_length * 10 + (c - '0');
+            }
+            out.content_length = content_length;
+        }
+        else if ((key.size() == 17 && equals_lower(key, "transfer-encoding")) || (key.size() == 7 && equals_lower(key, "upgrade")))
+        {
+            return http_simd_parser::UNSUPPORTED;
+        }
+
+        out.headers[out.header_count].key = key;
+        out.headers[out.header_count].value = value;
+        out.header_count++;
+    }
+    return static_cast<int>(pos - data);
+}
+
+int http_simd_parser::parse(const char *data, size_t len, request &out)
+{
+    static const level best_level = get_level();
+    return parse(data, len, out, best_level);
+}
+
+int http_simd_parser::parse(const char *data, size_t len, request &out, level use_level)
+{
+#ifdef TUBEKIT_HTTP_SIMD_X86
+    if (use_level == level::AVX2)
+    {
+        return parse_head(data, len, out, avx2_scanners);
+    }
+    if (use_level == level::SSE42)
+    {
+        return parse_head(data, len, out, sse42_scanners);
+    }
+#endif
+    return parse_head(data, len, out, scalar_scanners);
+}
+
+http_simd_parser::level http_simd_parser::get_level()
+{
+#ifdef TUBEKIT_HTTP_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return level::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.2"))
+    {
+        return level::SSE42;
+    }
+#endif
+    return level::SCALAR;
+}
+
+const char *http_simd_parser::level_name(level use_level)
+{
+    switch (use_level)
+    {
+    case level::AVX2:
+        return "avx2";
+    case level::SSE42:
+        return "sse4.2";
+    default:
+        return "scalar";
+    }
+}
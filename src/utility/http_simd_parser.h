@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+namespace tubekit
+{
+    namespace utility
+    {
+        /**
+         * @brief HTTP/1.x request line and headers parser, delimiters are searched 16 or 32 bytes at a time
+         *        with SSE4.2 or AVX2 chosen by runtime CPU detection, scalar on other CPUs,
+         *        slices are views into the input so one pass yields the whole head
+         *
+         * requests it does not handle (chunked, upgrade, CONNECT, obs-fold, bare LF, too many headers)
+         * are reported as unsupported so the caller can use http-parser for them
+         */
+        class http_simd_parser
+        {
+        public:
+            enum class level
+            {
+                SCALAR = 0,
+                SSE42 = 1,
+                AVX2 = 2
+            };
+
+            struct header
+            {
+                std::string_view key{};
+                std::string_view value{};
+            };
+
+            static constexpr size_t max_headers{64};
+            static constexpr uint64_t no_content_length{UINT64_MAX};
+
+            struct request
+            {
+                std::string_view method{};
+                std::string_view url{};
+                int http_minor{1};
+                header headers[max_headers]{};
+                size_t header_count{0};
+                uint64_t content_length{no_content_length};
+            };
+
+            enum result
+            {
+                INCOMPLETE = -1,
+                UNSUPPORTED = -2, // malformed or a feature left to http-parser
+            };
+
+        public:
+            /**
+             * @brief parse request line and headers
+             *
+             * @param data
+             * @param len
+             * @param out
+             * @return int length of head including the blank line, INCOMPLETE or UNSUPPORTED
+             */
+            static int parse(const char *data, size_t len, request &out);
+            static int parse(const char *data, size_t len, request &out, level use_level);
+
+            /**
+             * @brief the best level supported by this CPU
+             *
+             * @return level
+             */
+            static level get_level();
+            static const char *level_name(level use_level);
+        };
+    }
+}
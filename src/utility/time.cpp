@@ -15,4 +15,13 @@ uint64_t time::get_seconds()
 void time::update()
 {
     m_time = std::chrono::system_clock::now();
-}
\ No newline at end of file
+}
+
+std::string time::http_date(std::time_t t)
+{
+    struct tm gmt;
+    gmtime_r(&t, &gmt);
+    char buf[64]{0};
+    size_t len = strftime(buf, sizeof(buf), "%a, %d %b %Y %H:%M:%S GMT", &gmt);
+    return std::string(buf, len);
+}
@@ -1,5 +1,8 @@
+#pragma once
 #include <cstdint>
 #include <chrono>
+#include <ctime>
+#include <string>
 
 namespace tubekit::utility::time
 {
@@ -10,5 +13,14 @@ namespace tubekit::utility::time
         uint64_t get_seconds();
         void update();
         std::chrono::system_clock::time_point m_time;
+
+    public:
+        /**
+         * @brief format as IMF-fixdate, like "Sun, 06 Nov 1994 08:49:37 GMT"
+         *
+         * @param t
+         * @return std::string
+         */
+        static std::string http_date(std::time_t t);
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,166 @@
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TUBEKIT_WEBSOCKET_MASK_X86 1
+#include <immintrin.h>
+#endif
+
+#include "utility/websocket_mask.h"
+
+using tubekit::utility::websocket_mask;
+
+// every block is a multiple of 4 bytes, so the key lines up with data at the start of each block
+
+static inline size_t unmask_scalar(char *data, size_t len, uint32_t key32)
+{
+    const uint64_t key64 = (static_cast<uint64_t>(key32) << 32) | key32;
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8)
+    {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        word ^= key64;
+        memcpy(data + i, &word, 8);
+    }
+    return i;
+}
+
+#ifdef TUBEKIT_WEBSOCKET_MASK_X86
+
+__attribute__((target("sse2"))) static size_t unmask_sse2(char *data, size_t len, uint32_t key32)
+{
+    const __m128i key = _mm_set1_epi32(static_cast<int>(key32));
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + 16));
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + 32));
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + 48));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(data + i), _mm_xor_si128(a, key));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(data + i + 16), _mm_xor_si128(b, key));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(data + i + 32), _mm_xor_si128(c, key));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(data + i + 48), _mm_xor_si128(d, key));
+    }
+    for (; i + 16 <= len; i += 16)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(data + i), _mm_xor_si128(a, key));
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) static size_t unmask_avx2(char *data, size_t len, uint32_t key32)
+{
+    const __m256i key = _mm256_set1_epi32(static_cast<int>(key32));
+    size_t i = 0;
+    for (; i + 128 <= len; i += 128)
+    {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + 32));
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + 64));
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + 96));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(data + i), _mm256_xor_si256(a, key));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(data + i + 32), _mm256_xor_si256(b, key));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(data + i + 64), _mm256_xor_si256(c, key));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(data + i + 96), _mm256_xor_si256(d, key));
+    }
+    for (; i + 32 <= len; i += 32)
+    {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(data + i), _mm256_xor_si256(a, key));
+    }
+    return i;
+}
+
+__attribute__((target("avx512f"))) static size_t unmask_avx512(char *data, size_t len, uint32_t key32)
+{
+    const __m512i key = _mm512_set1_epi32(static_cast<int>(key32));
+    size_t i = 0;
+    for (; i + 256 <= len; i += 256)
+    {
+        __m512i a = _mm512_loadu_si512(data + i);
+        __m512i b = _mm512_loadu_si512(data + i + 64);
+        __m512i c = _mm512_loadu_si512(data + i + 128);
+        __m512i d = _mm512_loadu_si512(data + i + 192);
+        _mm512_storeu_si512(data + i, _mm512_xor_si512(a, key));
+        _mm512_storeu_si512(data + i + 64, _mm512_xor_si512(b, key));
+        _mm512_storeu_si512(data + i + 128, _mm512_xor_si512(c, key));
+        _mm512_storeu_si512(data + i + 192, _mm512_xor_si512(d, key));
+    }
+    for (; i + 64 <= len; i += 64)
+    {
+        __m512i a = _mm512_loadu_si512(data + i);
+        _mm512_storeu_si512(data + i, _mm512_xor_si512(a, key));
+    }
+    return i;
+}
+
+#endif
+
+void websocket_mask::unmask(char *data, size_t len, const uint8_t key[4])
+{
+    static const level best_level = get_level();
+    unmask(data, len, key, best_level);
+}
+
+void websocket_mask::unmask(char *data, size_t len, const uint8_t key[4], level use_level)
+{
+    uint32_t key32;
+    memcpy(&key32, key, 4); // byte order of memory, same as data
+    size_t done = 0;
+#ifdef TUBEKIT_WEBSOCKET_MASK_X86
+    if (use_level == level::AVX512)
+    {
+        done = unmask_avx512(data, len, key32);
+    }
+    else if (use_level == level::AVX2)
+    {
+        done = unmask_avx2(data, len, key32);
+    }
+    else if (use_level == level::SSE2)
+    {
+        done = unmask_sse2(data, len, key32);
+    }
+#endif
+    done += unmask_scalar(data + done, len - done, key32);
+    for (; done < len; done++)
+    {
+        data[done] ^= key[done & 3];
+    }
+}
+
+websocket_mask::level websocket_mask::get_level()
+{
+#ifdef TUBEKIT_WEBSOCKET_MASK_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        return level::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return level::AVX2;
+    }
+    if (__builtin_cpu_supports("sse2"))
+    {
+        return level::SSE2;
+    }
+#endif
+    return level::SCALAR;
+}
+
+const char *websocket_mask::level_name(level use_level)
+{
+    switch (use_level)
+    {
+    case level::AVX512:
+        return "avx512";
+    case level::AVX2:
+        return "avx2";
+    case level::SSE2:
+        return "sse2";
+    default:
+        return "scalar";
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+namespace tubekit
+{
+    namespace utility
+    {
+        /**
+         * @brief in place XOR of websocket payload with the 4 byte masking key (RFC 6455 5.3),
+         *        16/32/64 bytes at a time with SSE2, AVX2 or AVX-512 chosen by runtime CPU detection,
+         *        8 bytes at a time on other CPUs
+         */
+        class websocket_mask
+        {
+        public:
+            enum class level
+            {
+                SCALAR = 0,
+                SSE2 = 1,
+                AVX2 = 2,
+                AVX512 = 3
+            };
+
+        public:
+            /**
+             * @brief unmask data in place, data[0] is the first byte of payload
+             *
+             * @param data
+             * @param len
+             * @param key masking key
+             */
+            static void unmask(char *data, size_t len, const uint8_t key[4]);
+            static void unmask(char *data, size_t len, const uint8_t key[4], level use_level);
+
+            /**
+             * @brief the best level supported by this CPU
+             *
+             * @return level
+             */
+            static level get_level();
+            static const char *level_name(level use_level);
+        };
+    }
+}
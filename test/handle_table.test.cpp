@@ -0,0 +1,93 @@
+#include <iostream>
+#include <set>
+#include <tubekit-log/logger.h>
+#include "connection/connection_mgr.h"
+#include "connection/http_connection.h"
+#include "socket/socket.h"
+
+using namespace std;
+using tubekit::connection::connection;
+using tubekit::connection::handle_table;
+using tubekit::connection::http_connection;
+using tubekit::log::logger;
+
+typedef pair<tubekit::socket::socket *, connection *> handle_value;
+
+// sets the generation of a slot, 2^32 inserts are not needed to wrap it
+class handle_table_probe : public handle_table
+{
+public:
+    void set_generation(uint32_t index, uint32_t generation)
+    {
+        m_slots[index].generation = generation;
+    }
+};
+
+static handle_value value_of(tubekit::socket::socket &socket_obj, http_connection &connection_obj)
+{
+    return {&socket_obj, &connection_obj};
+}
+
+// found, and found with the pointers it was inserted with
+static string found(const handle_table &table, uint64_t gid, const handle_value &value)
+{
+    handle_value out{nullptr, nullptr};
+    bool res = table.find(gid, out);
+    return to_string(res) + to_string(res && out == value);
+}
+
+int main(int argc, char **argv)
+{
+    logger::instance().open("handle_table.test.log");
+    tubekit::socket::socket socket_a, socket_b, socket_c;
+    http_connection connection_a(&socket_a), connection_b(&socket_b), connection_c(&socket_c);
+    const auto a = value_of(socket_a, connection_a);
+    const auto b = value_of(socket_b, connection_b);
+    const auto c = value_of(socket_c, connection_c);
+    handle_value out;
+
+    // insert gives gid to socket and connection, 0 when every slot is used
+    handle_table table;
+    table.init(2);
+    const uint64_t gid_a = table.insert(a);
+    const uint64_t gid_b = table.insert(b);
+    const uint64_t full = table.insert(c);
+    cout << "insert " << (gid_a != 0) << (gid_b != 0) << (gid_a != gid_b) << full << (socket_a.get_gid() == gid_a) << (connection_a.get_gid() == gid_a) << endl; // insert 111011
+    cout << "find " << found(table, gid_a, a) << found(table, gid_b, b) << found(table, 0, a) << found(table, gid_a | 0xffff, a) << endl; // find 11110000
+
+    // an erased gid is not found, not erased again, and its slot waits for free
+    bool erased = table.erase(gid_a, out);
+    bool erased_again = table.erase(gid_a, out);
+    cout << "erase " << erased << (out == a) << erased_again << found(table, gid_a, a) << table.insert(c) << endl; // erase 110000
+    table.free(gid_a);
+
+    // the slot is used again with a new generation, the stale gid never matches it
+    const uint64_t gid_c = table.insert(c);
+    cout << "reuse " << ((gid_c & 0xffffffff) == (gid_a & 0xffffffff)) << (gid_c != gid_a) << found(table, gid_a, c) << found(table, gid_c, c) << table.erase(gid_a, out) << found(table, gid_c, c) << endl; // reuse 110011011
+
+    // freed slots are recycled when the table is full, every gid is new
+    set<uint64_t> gids{gid_a, gid_b, gid_c};
+    uint64_t last = gid_c;
+    size_t recycled = 0;
+    for (int i = 0; i < 1000; i++)
+    {
+        table.erase(last, out);
+        table.free(last);
+        last = table.insert(i % 2 ? a : c);
+        recycled += last != 0 && table.insert(b) == 0 && gids.insert(last).second;
+    }
+    cout << "recycle " << recycled << " " << found(table, gid_b, b) << endl; // recycle 1000 11
+
+    // the generation after 0xffffffff is 1, 0 would make gid 0 of slot 0
+    handle_table_probe probe;
+    probe.init(1);
+    probe.set_generation(0, 0xfffffffe);
+    const uint64_t gid_max = probe.insert(a);
+    probe.erase(gid_max, out);
+    probe.free(gid_max);
+    const uint64_t gid_wrap = probe.insert(a);
+    cout << "wrap " << hex << gid_max << " " << gid_wrap << dec << " " << found(probe, gid_max, a) << found(probe, gid_wrap, a) << endl; // wrap ffffffff00000000 100000000 0011
+    return 0;
+}
+// g++ $(find ../src -name '*.cpp' ! -name main.cpp) ../protocol/proto_res/*.pb.cc handle_table.test.cpp -I../src -I../protocol -I../external -L../external -o handle_table.test.exe --std=c++17 -pthread -ldl -lstdc++fs -lprotobuf -lssl -lcrypto -ltubekit-http-parser -ltubekit-inifile -ltubekit-log -ltubekit-timer -ltubekit-xml -ltubekit-buffer -ltubekit-lua -ltubekit-zlib -ltubekit-json
+// LD_LIBRARY_PATH=../external ./handle_table.test.exe
@@ -0,0 +1,43 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../src/utility/hpack.h"
+
+using namespace std;
+using tubekit::utility::hpack;
+
+static void decode(hpack &decoder, const vector<uint8_t> &block)
+{
+    int res = decoder.decode(block.data(), block.size(), [](string_view name, string_view value) -> bool
+                             {
+                                 cout << "  " << name << ": " << value << endl;
+                                 return true; });
+    cout << "res " << res << endl;
+}
+
+int main(int argc, char **argv)
+{
+    // RFC 7541 C.4, requests with huffman coding, one decoder for the dynamic table
+    hpack decoder;
+    decode(decoder, {0x82, 0x86, 0x84, 0x41, 0x8c, 0xf1, 0xe3, 0xc2, 0xe5, 0xf2, 0x3a, 0x6b, 0xa0, 0xab, 0x90, 0xf4, 0xff});
+    decode(decoder, {0x82, 0x86, 0x84, 0xbe, 0x58, 0x86, 0xa8, 0xeb, 0x10, 0x64, 0x9c, 0xbf});
+    // :method GET :scheme https :path /index.html :authority www.example.com custom-key: custom-value
+    decode(decoder, {0x82, 0x87, 0x85, 0xbf, 0x40, 0x88, 0x25, 0xa8, 0x49, 0xe9, 0x5b, 0xa9, 0x7d, 0x7f, 0x89, 0x25, 0xa8, 0x49, 0xe9, 0x5b, 0xb8, 0xe8, 0xb4, 0xbf});
+
+    // errors
+    decode(decoder, {0x80});       // -1 : index 0
+    decode(decoder, {0xff, 0x80}); // -1 : truncated integer
+    decode(decoder, {0x3f, 0xe2, 0x1f}); // -1 : table size update 4097 over settings
+
+    // encoder output is readable by decoder
+    string block;
+    hpack::encode_status(200, block);
+    hpack::encode_status(418, block);
+    hpack::encode("content-type", "text/plain", block);
+    hpack::encode("x-tubekit", string(200, 'a'), block);
+    hpack other;
+    decode(other, vector<uint8_t>(block.begin(), block.end()));
+    return 0;
+}
+// g++ ../src/utility/hpack.cpp hpack.test.cpp -I../src -o hpack.test.exe --std=c++17
+// ./hpack.test.exe
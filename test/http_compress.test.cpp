@@ -0,0 +1,37 @@
+#include <iostream>
+#include <string>
+#include "../src/app/http_compress.h"
+
+using namespace std;
+using tubekit::app::http_compress;
+
+static void print(const char *value)
+{
+    cout << "[" << (value ? value : "no header") << "] " << http_compress::encoding_name(http_compress::choose(value ? string_view(value) : string_view())) << endl;
+}
+
+int main(int argc, char **argv)
+{
+    print(nullptr);                       // identity
+    print("");                            // identity
+    print("gzip");                        // gzip
+    print("x-gzip");                      // gzip
+    print("deflate");                     // deflate
+    print("gzip, deflate");               // gzip : tie
+    print("deflate;q=1, gzip;q=1");       // gzip : tie
+    print("gzip;q=0.5, deflate;q=0.8");   // deflate
+    print("gzip;q=0");                    // identity
+    print("gzip;q=0, deflate;q=0");       // identity
+    print("*");                           // gzip
+    print("*;q=0");                       // identity
+    print("gzip;q=0, *");                 // deflate : named q=0 is not overridden by *
+    print("gzip;q=0, deflate;q=0, *");    // identity
+    print("deflate;q=0.5, *;q=0.8");      // gzip : * covers gzip only
+    print("*, gzip;q=0.2, deflate;q=0.4"); // deflate
+    print("br, identity");                // identity
+    print("GZIP ; q=0.9 , Deflate");      // deflate
+    return 0;
+}
+// gcc -c ../external/zlib/*.c
+// g++ ../src/app/http_compress.cpp ../src/thread/mutex.cpp ../src/thread/auto_lock.cpp ../external/tubekit-log/*.cpp http_compress.test.cpp *.o -I../src -I../external -o http_compress.test.exe --std=c++17 -pthread
+// ./http_compress.test.exe
@@ -0,0 +1,265 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <tubekit-log/logger.h>
+#include "app/http_proxy.h"
+#include "socket/socket_handler.h"
+#include "utility/object_pool.h"
+#include "utility/singleton.h"
+
+using namespace std;
+using tubekit::app::http_proxy;
+using tubekit::app::http_proxy_session;
+using tubekit::connection::http_connection;
+using tubekit::log::logger;
+using tubekit::socket::socket_handler;
+using tubekit::utility::object_pool;
+using tubekit::utility::singleton;
+
+// client side of a proxied request, a connection accepted by the test itself
+class client_socket : public tubekit::socket::socket
+{
+public:
+    explicit client_socket(int fd)
+    {
+        m_sockfd = fd;
+    }
+};
+
+static mutex heads_mutex;
+static vector<string> heads; // request heads seen by upstream
+
+static int listen_local(int &port)
+{
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    ::bind(fd, (sockaddr *)&addr, sizeof(addr));
+    ::listen(fd, 16);
+    getsockname(fd, (sockaddr *)&addr, &len);
+    port = ntohs(addr.sin_port);
+    return fd;
+}
+
+static void send_all(int fd, const string &data)
+{
+    ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+}
+
+// one upstream connection, replies by path
+static void upstream_connection(int fd)
+{
+    string in;
+    size_t served = 0;
+    while (true)
+    {
+        size_t head_end;
+        while ((head_end = in.find("\r\n\r\n")) == string::npos)
+        {
+            char buf[4096];
+            ssize_t len = ::recv(fd, buf, sizeof(buf), 0);
+            if (len <= 0)
+            {
+                ::close(fd);
+                return;
+            }
+            in.append(buf, len);
+        }
+        const string head = in.substr(0, head_end + 4);
+        in.erase(0, head_end + 4);
+        {
+            lock_guard<mutex> lock(heads_mutex);
+            heads.push_back(head);
+        }
+        const string path = head.substr(head.find(' ') + 1, head.find(' ', head.find(' ') + 1) - head.find(' ') - 1);
+        if (path == "/hop")
+        {
+            send_all(fd, "HTTP/1.1 200 OK\r\nContent-Length: 2\r\nKeep-Alive: timeout=5\r\nConnection: keep-alive\r\nX-Up: 1\r\n\r\nok");
+        }
+        else if (path == "/retry" && served > 0)
+        {
+            // a kept-alive connection closed by upstream before it responds
+            ::close(fd);
+            return;
+        }
+        else if (path == "/retry")
+        {
+            send_all(fd, "HTTP/1.1 200 OK\r\nContent-Length: 7\r\n\r\nretried");
+        }
+        else if (path == "/length")
+        {
+            send_all(fd, "HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nhello");
+        }
+        else if (path == "/chunked")
+        {
+            send_all(fd, "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nhel\r\n2\r\nlo\r\n0\r\n\r\n");
+        }
+        else
+        {
+            // body without length, ends by close
+            send_all(fd, "HTTP/1.1 200 OK\r\n\r\nuntil close");
+            ::close(fd);
+            return;
+        }
+        served++;
+    }
+}
+
+// a connected pair, the accepted side is the client connection of proxy
+struct client_pair
+{
+    client_pair()
+    {
+        static int listen_fd = -1;
+        static int listen_port = 0;
+        if (listen_fd < 0)
+        {
+            listen_fd = listen_local(listen_port);
+        }
+        peer = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(listen_port);
+        ::connect(peer, (sockaddr *)&addr, sizeof(addr));
+        client = new client_socket(::accept(listen_fd, nullptr, nullptr));
+        connection = new http_connection(client);
+        connection->set_gid(1);
+    }
+    ~client_pair()
+    {
+        delete connection;
+        delete client;
+        ::close(peer);
+    }
+    int peer{-1};
+    client_socket *client{nullptr};
+    http_connection *connection{nullptr};
+};
+
+// one HTTP/1.1 request on connection, views of request point into these
+static string method = "GET";
+static vector<string> request_url;
+static vector<pair<string, string>> request_headers;
+
+static string request(http_connection &connection, const string &url, const vector<pair<string, string>> &headers)
+{
+    request_url.push_back(url);
+    connection.request.method = method;
+    connection.request.url = request_url.back();
+    for (const auto &header : headers)
+    {
+        connection.request.add_header(header.first, header.second);
+    }
+    connection.get_parser()->http_major = 1;
+    connection.get_parser()->http_minor = 1;
+
+    http_proxy *proxy = singleton<http_proxy>::instance();
+    http_proxy_session *session = new http_proxy_session(*proxy->choose(*proxy->match(url)));
+    if (session->start(connection))
+    {
+        session->on_request_end(connection);
+    }
+    // upstream events are polled here instead of by socket_handler
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(3);
+    while (!connection.get_response_end() && chrono::steady_clock::now() < deadline)
+    {
+        this_thread::sleep_for(chrono::milliseconds(1));
+        session->pump(connection);
+    }
+    string response(connection.m_send_buffer.can_readable_size(), '\0');
+    connection.m_send_buffer.read(&response[0], response.size());
+    delete session;
+    singleton<socket_handler>::instance()->update_wait_remove();
+    singleton<socket_handler>::instance()->update_wait_remove();
+    return response;
+}
+
+static string request(const string &url, const vector<pair<string, string>> &headers)
+{
+    client_pair pair;
+    return request(*pair.connection, url, headers);
+}
+
+static bool has(const string &text, const string &part)
+{
+    return string::npos != text.find(part);
+}
+
+int main(int argc, char **argv)
+{
+    logger::instance().open("http_proxy.test.log");
+    singleton<object_pool<tubekit::socket::socket>>::instance()->init(64, false);
+    int upstream_port = 0;
+    int upstream_fd = listen_local(upstream_port);
+    // socket_handler is initialized for upstream sockets, its loop never runs
+    singleton<socket_handler>::instance()->init("127.0.0.1", 0, 64, 10);
+    singleton<http_proxy>::instance()->init("/=127.0.0.1:" + to_string(upstream_port), "round_robin", 4);
+    thread([upstream_fd]()
+           {
+               while (true)
+               {
+                   int fd = ::accept(upstream_fd, nullptr, nullptr);
+                   if (fd < 0)
+                   {
+                       return;
+                   }
+                   thread(upstream_connection, fd).detach();
+               } })
+        .detach();
+
+    // hop-by-hop headers and those listed in Connection are stripped both ways
+    string response = request("/hop", {{"Connection", "close, X-Drop"},
+                                       {"Keep-Alive", "300"},
+                                       {"TE", "trailers"},
+                                       {"Upgrade", "h2c"},
+                                       {"Proxy-Connection", "keep-alive"},
+                                       {"Expect", "100-continue"},
+                                       {"X-Drop", "1"},
+                                       {"X-Keep", "1"},
+                                       {"X-Forwarded-For", "10.0.0.1"}});
+    string head = heads.back();
+    cout << "request kept " << has(head, "X-Keep: 1") << has(head, "X-Forwarded-For: 10.0.0.1, 127.0.0.1") << has(head, "Connection: keep-alive\r\n") << endl; // 111
+    cout << "request stripped " << has(head, "close") << has(head, "Keep-Alive") << has(head, "TE:") << has(head, "Upgrade") << has(head, "Proxy-Connection") << has(head, "Expect") << has(head, "X-Drop") << endl; // 0000000
+    cout << "response " << has(response, "200 OK") << has(response, "X-Up: 1") << has(response, "Keep-Alive") << has(response, "Connection: keep-alive") << has(response, "Connection: close") << has(response, "\r\n\r\nok") << endl; // 110011
+
+    // the kept-alive connection of /hop is closed by upstream after taking the request, it is sent again on a new one
+    const size_t heads_before = heads.size();
+    response = request("/retry", {});
+    cout << "retry " << has(response, "200 OK") << has(response, "\r\n\r\nretried") << " sent " << heads.size() - heads_before << endl; // 11 sent 2
+
+    // chunked body is chunked again, the client connection is kept
+    response = request("/chunked", {});
+    cout << "chunked " << has(response, "200 OK") << has(response, "Transfer-Encoding: chunked") << has(response, "Content-Length") << has(response, "Connection: close") << has(response, "\r\n\r\n3\r\nhel\r\n2\r\nlo\r\n0\r\n\r\n") << endl; // 11001
+
+    // body without length ends when upstream closes, so does the client connection
+    response = request("/close", {});
+    cout << "until close " << has(response, "200 OK") << has(response, "Connection: close") << has(response, "\r\n\r\nuntil close") << endl; // 111
+
+    // requests one after another on one client connection, kept while bodies are framed
+    client_pair pair;
+    http_connection &connection = *pair.connection;
+    response = request(connection, "/length", {});
+    cout << "keep-alive 1 " << has(response, "Content-Length: 5\r\n") << has(response, "Connection") << has(response, "\r\n\r\nhello") << " " << connection.keep_alive << endl; // 101 1
+    connection.next_request();
+    response = request(connection, "/chunked", {});
+    cout << "keep-alive 2 " << has(response, "Transfer-Encoding: chunked") << has(response, "Connection") << has(response, "0\r\n\r\n") << " " << connection.keep_alive << endl; // 101 1
+    connection.next_request();
+    response = request(connection, "/length", {{"Connection", "close"}});
+    cout << "keep-alive 3 " << has(response, "Connection: close") << has(response, "\r\n\r\nhello") << " " << connection.keep_alive << endl; // 11 0
+    connection.next_request();
+    response = request(connection, "/close", {});
+    cout << "keep-alive 4 " << has(response, "Connection: close") << has(response, "\r\n\r\nuntil close") << " " << connection.keep_alive << endl; // 11 0
+    return 0;
+}
+// g++ $(find ../src -name '*.cpp' ! -name main.cpp) ../protocol/proto_res/*.pb.cc http_proxy.test.cpp -I../src -I../protocol -I../external -L../external -o http_proxy.test.exe --std=c++17 -pthread -ldl -lstdc++fs -lprotobuf -lssl -lcrypto -ltubekit-http-parser -ltubekit-inifile -ltubekit-log -ltubekit-timer -ltubekit-xml -ltubekit-buffer -ltubekit-lua -ltubekit-zlib -ltubekit-json
+// LD_LIBRARY_PATH=../external ./http_proxy.test.exe
@@ -0,0 +1,36 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../src/utility/http_range.h"
+
+using namespace std;
+using tubekit::utility::http_range;
+
+static void print(const string &value, uint64_t size)
+{
+    vector<http_range::range> ranges;
+    int res = http_range::parse(value, size, 4, ranges);
+    cout << "[" << value << "] size " << size << " res " << res << " :";
+    for (const auto &range : ranges)
+    {
+        cout << " " << range.first << "-" << range.second;
+    }
+    cout << endl;
+}
+
+int main(int argc, char **argv)
+{
+    print("bytes=0-499", 1000);         // 0 : 0-499
+    print("bytes=500-", 1000);          // 0 : 500-999
+    print("bytes=-200", 1000);          // 0 : 800-999
+    print("bytes=-2000", 1000);         // 0 : 0-999
+    print("bytes=0-0, 10-20 ,-1", 1000); // 0 : 0-0 10-20 999-999
+    print("bytes=900-5000", 1000);      // 0 : 900-999
+    print("bytes=1000-", 1000);         // -2 :
+    print("bytes=5-1", 1000);           // -1 :
+    print("items=0-1", 1000);           // -1 :
+    print("bytes=0-1,2-3,4-5,6-7,8-9", 1000); // -1 : too many
+    return 0;
+}
+// g++ ../src/utility/http_range.cpp http_range.test.cpp -I../src -o http_range.test.exe --std=c++17
+// ./http_range.test.exe
@@ -0,0 +1,83 @@
+#include <iostream>
+#include <string>
+#include "../src/app/http_router.h"
+
+using namespace std;
+using tubekit::app::http_router;
+
+static http_router router;
+
+// handler of a test route, the matched route is read by target() without calling it
+struct route_pattern
+{
+    string pattern;
+    void operator()(tubekit::connection::http_connection &, const http_router::params &) const
+    {
+    }
+};
+
+static void add(const string &method, const string &pattern, http_router &router = ::router)
+{
+    bool res = router.add(method, pattern, route_pattern{pattern});
+    cout << "add " << method << " " << pattern << " " << res << endl;
+}
+
+static void find(const string &method, const string &path)
+{
+    http_router::params params;
+    const http_router::handler *handler = router.find(method, path, params);
+    cout << method << " " << path << " => ";
+    if (!handler)
+    {
+        cout << "null" << endl;
+        return;
+    }
+    cout << handler->target<route_pattern>()->pattern;
+    for (size_t i = 0; i < params.size(); i++)
+    {
+        cout << " " << params.at(i).first << "=" << params.at(i).second;
+    }
+    cout << endl;
+}
+
+int main(int argc, char **argv)
+{
+    add("GET", "/");
+    add("GET", "/users");
+    add("GET", "/users/new");
+    add("GET", "/users/:id");
+    add("DELETE", "/users/:id");
+    add("GET", "/users/:id/posts/:post");
+    add("GET", "/user");
+    add("*", "/static/*file");
+    add("GET", "/bad*x");         // 0
+    add("GET", "/*file/x");       // 0
+    cout << "compile " << router.compile() << endl; // 1
+    add("GET", "/late"); // 0
+
+    find("GET", "/");                      // /
+    find("GET", "/users");                 // /users
+    find("GET", "/user");                  // /user
+    find("GET", "/users/new");             // /users/new
+    find("GET", "/users/42");              // /users/:id id=42
+    find("DELETE", "/users/new");          // /users/:id id=new
+    find("GET", "/users/new/posts/7");     // /users/:id/posts/:post id=new post=7
+    find("POST", "/users/42");             // null
+    find("GET", "/users/");                // null
+    find("HEAD", "/static/css/a.css");     // /static/*file file=css/a.css
+    find("GET", "/static/");               // /static/*file file=
+    find("GET", "/nothing");               // null
+
+    http_router conflict_param;
+    add("GET", "/users/:id", conflict_param);
+    add("GET", "/users/:name/x", conflict_param);
+    cout << "compile " << conflict_param.compile() << endl; // 0 : conflict param name
+
+    http_router duplicate;
+    add("GET", "/users", duplicate);
+    add("GET", "/users", duplicate);
+    cout << "compile " << duplicate.compile() << endl; // 0 : duplicate route
+    return 0;
+}
+// g++ ../src/app/http_router.cpp http_router.test.cpp -I../src -o http_router.test.exe --std=c++17
+// ./http_router.test.exe
@@ -0,0 +1,106 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include "../src/utility/http_simd_parser.h"
+
+using namespace std;
+using tubekit::utility::http_simd_parser;
+
+static const http_simd_parser::level levels[] = {http_simd_parser::level::SCALAR, http_simd_parser::level::SSE42, http_simd_parser::level::AVX2};
+
+static string dump(const string &text, size_t len, http_simd_parser::level lv)
+{
+    http_simd_parser::request req;
+    int ret = http_simd_parser::parse(text.data(), len, req, lv);
+    string res = to_string(ret);
+    if (ret > 0)
+    {
+        res += " " + string(req.method) + " " + string(req.url) + " 1." + to_string(req.http_minor);
+        for (size_t i = 0; i < req.header_count; i++)
+        {
+            res += " [" + string(req.headers[i].key) + "=" + string(req.headers[i].value) + "]";
+        }
+        if (req.content_length != http_simd_parser::no_content_length)
+        {
+            res += " cl=" + to_string(req.content_length);
+        }
+    }
+    return res;
+}
+
+// every level gives the same answer as scalar, a truncated input is incomplete unless the head is already whole
+static bool check(const string &text)
+{
+    const string expect = dump(text, text.size(), http_simd_parser::level::SCALAR);
+    for (http_simd_parser::level lv : levels)
+    {
+        if (lv > http_simd_parser::get_level())
+        {
+            continue;
+        }
+        for (size_t len = 0; len <= text.size(); len++)
+        {
+            const string res = dump(text, len, lv);
+            const bool ok = res == expect || (len < text.size() && res == to_string(http_simd_parser::INCOMPLETE));
+            if (!ok)
+            {
+                cout << "FAIL level " << http_simd_parser::level_name(lv) << " len " << len << " " << res << endl;
+                return false;
+            }
+        }
+    }
+    cout << expect << endl;
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    cout << "cpu level " << http_simd_parser::level_name(http_simd_parser::get_level()) << endl;
+
+    check("GET / HTTP/1.1\r\n\r\n");                                                                                     // 18 GET / 1.1
+    check("\r\nGET /a?b=c HTTP/1.0\r\nHost: example.com\r\nAccept:*/*\r\n\r\nbody");                                    // 56 GET /a?b=c 1.0 [Host=example.com] [Accept=*/*]
+    check("POST /upload HTTP/1.1\r\nContent-Length: 12\r\nX-Long-Header-Name-For-Simd-Paths: value with\ttab  \r\n\r\n"); // cl=12, trailing OWS trimmed
+    check("GET /" + string(200, 'x') + " HTTP/1.1\r\nUser-Agent: " + string(100, 'y') + "\r\n\r\n");                     // long slices cross 16 and 32 byte blocks
+    check("M-SEARCH * HTTP/1.1\r\n\r\n");                                                                                // 23
+    check("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n");                                                      // -2 left to http-parser
+    check("GET / HTTP/1.1\r\nUpgrade: websocket\r\n\r\n");                                                               // -2
+    check("CONNECT a:443 HTTP/1.1\r\n\r\n");                                                                             // -2
+    check("GET / HTTP/1.1\r\nContent-Length: 1\r\nContent-Length: 1\r\n\r\n");                                          // -2
+    check("GET / HTTP/1.1\r\nContent-Length: 1x\r\n\r\n");                                                               // -2
+    check("GET / HTTP/1.1\nHost: a\n\n");                                                                                // -2 bare LF
+    check("GET / HTTP/1.1\r\nHost: a\r\n folded\r\n\r\n");                                                               // -2 obs-fold
+    check("GET / HTTP/1.1\r\nBad Name: a\r\n\r\n");                                                                      // -2
+    check("GET / HTTP/1.1\r\nX: a\x01" "b\r\n\r\n");                                                                     // -2 control char in value
+    check("GET / HTTP/2.0\r\n\r\n");                                                                                     // -2
+    check("GET / HTTP/1.1\r\nHost: a\r\n");                                                                              // -1
+
+    string many = "GET / HTTP/1.1\r\n";
+    for (int i = 0; i <= 64; i++)
+    {
+        many += "h" + to_string(i) + ": v\r\n";
+    }
+    check(many + "\r\n"); // -2 over max_headers
+
+    // throughput of a typical small GET
+    const string small = "GET /index.html?from=bench HTTP/1.1\r\nHost: www.example.com\r\nUser-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0 Safari/537.36\r\nAccept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\nAccept-Language: en-US,en;q=0.5\r\nAccept-Encoding: gzip, deflate, br\r\nConnection: keep-alive\r\nCookie: session=0123456789abcdef0123456789abcdef\r\n\r\n";
+    for (http_simd_parser::level lv : levels)
+    {
+        if (lv > http_simd_parser::get_level())
+        {
+            continue;
+        }
+        constexpr int rounds = 1000000;
+        http_simd_parser::request req;
+        size_t total = 0;
+        auto begin = chrono::steady_clock::now();
+        for (int i = 0; i < rounds; i++)
+        {
+            total += http_simd_parser::parse(small.data(), small.size(), req, lv);
+        }
+        auto used = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - begin).count();
+        cout << http_simd_parser::level_name(lv) << " " << used / rounds << " ns/request " << (total == small.size() * rounds) << endl;
+    }
+    return 0;
+}
+// g++ ../src/utility/http_simd_parser.cpp http_simd_parser.test.cpp -I../src -o http_simd_parser.test.exe --std=c++17 -O2
+// ./http_simd_parser.test.exe
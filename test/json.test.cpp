@@ -15,4 +15,4 @@ int main(int argc, char **argv)
     std::cout << json_obj.to_string() << std::endl;
     return 0;
 }
-// g++ ../external/tubekit-json/json.cpp ../external/tubekit-json/parser.cpp json.test.cpp -o json.test.exe --std=c++17
\ No newline at end of file
+// g++ ../external/tubekit-json/json.cpp ../external/tubekit-json/parser.cpp ../external/tubekit-json/utf8.cpp json.test.cpp -o json.test.exe --std=c++17
\ No newline at end of file
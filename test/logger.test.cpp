@@ -0,0 +1,111 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../external/tubekit-log/logger.h"
+
+using namespace std;
+using tubekit::log::binary_log;
+using tubekit::log::logger;
+
+static size_t count_lines(const string &path, const string &text)
+{
+    ifstream in(path);
+    string line;
+    size_t count = 0;
+    while (getline(in, line))
+    {
+        count += string::npos != line.find(text);
+    }
+    return count;
+}
+
+static void flood(size_t threads, size_t lines)
+{
+    vector<thread> workers;
+    for (size_t i = 0; i < threads; i++)
+    {
+        workers.emplace_back([i, lines]()
+                             {
+                                 for (size_t j = 0; j < lines; j++)
+                                 {
+                                     LOG_ERROR("flood thread %zu line %zu %s", i, j, string(100, 'x').c_str());
+                                 } });
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+int main(int argc, char **argv)
+{
+    // block: every line is written, rings of exited threads are drained
+    remove("logger.block.log");
+    logger::instance().set_async(true, 4096, logger::BLOCK);
+    logger::instance().open("logger.block.log");
+    flood(4, 10000);
+    LOG_DEBUG("debug line");
+    logger::instance().set_level(logger::INFO);
+    LOG_DEBUG("skipped debug line");
+    logger::instance().close();
+    cout << "block flood " << count_lines("logger.block.log", "flood thread") << " of 40000" << endl;
+    cout << "debug " << count_lines("logger.block.log", "debug line") << " of 1" << endl;
+
+    // drop: lines are dropped when the ring is full and the count is written
+    remove("logger.drop.log");
+    logger::instance().set_level(logger::DEBUG);
+    logger::instance().set_async(true, 4096, logger::DROP);
+    logger::instance().open("logger.drop.log");
+    flood(4, 10000);
+    LOG_FATAL("fatal line");
+    cout << "fatal before close " << count_lines("logger.drop.log", "fatal line") << " of 1" << endl;
+    logger::instance().close();
+    cout << "drop flood " << count_lines("logger.drop.log", "flood thread") << " written, dropped lines noted " << count_lines("logger.drop.log", "lines dropped") << endl;
+
+    // sync
+    remove("logger.sync.log");
+    logger::instance().set_async(false);
+    logger::instance().open("logger.sync.log");
+    flood(2, 1000);
+    cout << "sync flood " << count_lines("logger.sync.log", "flood thread") << " of 2000" << endl;
+    logger::instance().close();
+
+    // binary: raw arguments are formatted by the decoder like printf, rotated files are decoded alone
+    remove("logger.blog");
+    for (int i = 1; i <= 8; i++)
+    {
+        remove(("logger.blog." + to_string(i)).c_str());
+    }
+    logger::instance().set_async(true, 4096, logger::BLOCK);
+    logger::instance().set_binary(true, 1024 * 1024, 8);
+    logger::instance().open("logger.blog");
+    flood(4, 10000);
+    const string dynamic_format = "dynamic %d";
+    LOG_INFO(dynamic_format.c_str(), 7);
+    LOG_INFO("mixed %c|%5d|%-4u|%lld|%zu|%x|%.2f|%e|%*d|%.*s|%.3s|%s|%p|%%", 'a', -12, 3u, -1234567890123LL, (size_t)99, 255, 3.14159, 1e-5, 6, 42, 3, "abcdef", "xyz123", (const char *)nullptr, (void *)0x10);
+    logger::instance().close();
+    logger::instance().set_binary(false);
+    logger::instance().set_async(false);
+
+    char expected[256];
+    snprintf(expected, sizeof(expected), "mixed %c|%5d|%-4u|%lld|%zu|%x|%.2f|%e|%*d|%.*s|%.3s|%s|%p|%%", 'a', -12, 3u, -1234567890123LL, (size_t)99, 255, 3.14159, 1e-5, 6, 42, 3, "abcdef", "xyz123", "(null)", (void *)0x10);
+    FILE *out = fopen("logger.blog.txt", "w");
+    for (int i = 8; i >= 0; i--)
+    {
+        const string path = i > 0 ? "logger.blog." + to_string(i) : "logger.blog";
+        FILE *in = fopen(path.c_str(), "rb");
+        if (in)
+        {
+            cout << path << " decoded " << binary_log::decode_file(in, out) << endl;
+            fclose(in);
+        }
+    }
+    fclose(out);
+    cout << "binary flood " << count_lines("logger.blog.txt", "flood thread") << " of 40000" << endl;
+    cout << "binary dynamic " << count_lines("logger.blog.txt", "dynamic 7") << " of 1" << endl;
+    cout << "binary mixed " << count_lines("logger.blog.txt", expected) << " of 1" << endl;
+    return 0;
+}
+// g++ ../external/tubekit-log/logger.cpp ../external/tubekit-log/binary_log.cpp logger.test.cpp -o logger.test.exe --std=c++17 -pthread
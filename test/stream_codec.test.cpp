@@ -0,0 +1,150 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "connection/stream_codec.h"
+
+using namespace std;
+using tubekit::connection::stream_codec;
+
+/**
+ * @brief decode stream arriving in parts like a recv buffer, consumed bytes are dropped after each frame
+ *
+ * each frame is written as its payload or its size, the stream ends with failed or the bytes left over
+ */
+static string decode(stream_codec &codec, const string &stream, const vector<size_t> &cuts)
+{
+    codec.reset();
+    string result;
+    string buffer;
+    size_t from = 0;
+    for (size_t i = 0; i <= cuts.size(); i++)
+    {
+        const size_t to = i < cuts.size() ? cuts[i] : stream.size();
+        buffer.append(stream, from, to - from);
+        from = to;
+        while (true)
+        {
+            size_t consumed = 0;
+            string_view payload;
+            int res = codec.next(buffer.data(), buffer.size(), consumed, payload);
+            if (res == stream_codec::FAILED)
+            {
+                return result + "failed";
+            }
+            if (res == stream_codec::NEED_MORE)
+            {
+                break;
+            }
+            result += (payload.size() > 16 ? to_string(payload.size()) + "B" : string(payload)) + " ";
+            buffer.erase(0, consumed);
+        }
+    }
+    return result + "left " + to_string(buffer.size());
+}
+
+// the stream split in two at every offset and fed byte by byte gives the same result as fed whole
+static void check(const string &name, stream_codec &codec, const string &stream)
+{
+    const string whole = decode(codec, stream, {});
+    size_t same = 0;
+    for (size_t offset = 0; offset <= stream.size(); offset++)
+    {
+        same += decode(codec, stream, {offset}) == whole;
+    }
+    vector<size_t> bytes;
+    for (size_t offset = 1; offset < stream.size(); offset++)
+    {
+        bytes.push_back(offset);
+    }
+    const bool byte_by_byte = decode(codec, stream, bytes) == whole;
+    cout << name << " [" << whole << "] splits " << (same == stream.size() + 1) << byte_by_byte << endl;
+}
+
+static string frames(const stream_codec &codec, const vector<string> &payloads)
+{
+    string stream;
+    for (const string &payload : payloads)
+    {
+        string frame;
+        codec.encode(payload.data(), payload.size(), frame);
+        stream += frame;
+    }
+    return stream;
+}
+
+int main(int argc, char **argv)
+{
+    const string big(300, 'b');
+    stream_codec varint, fixed32, varint_crc, fixed32_crc, none;
+    varint.init(stream_codec::prefix::VARINT, false, 1024);
+    fixed32.init(stream_codec::prefix::FIXED32, false, 1024);
+    varint_crc.init(stream_codec::prefix::VARINT, true, 1024);
+    fixed32_crc.init(stream_codec::prefix::FIXED32, true, 1024);
+    none.init(stream_codec::prefix::NONE, true, 1024);
+
+    // names of stream_frame
+    stream_codec::prefix prefix;
+    bool known[] = {stream_codec::parse_prefix("", prefix) && prefix == stream_codec::prefix::VARINT,
+                    stream_codec::parse_prefix("fixed32", prefix) && prefix == stream_codec::prefix::FIXED32,
+                    stream_codec::parse_prefix("none", prefix) && prefix == stream_codec::prefix::NONE,
+                    stream_codec::parse_prefix("varint32", prefix)};
+    cout << "prefix " << known[0] << known[1] << known[2] << known[3] << endl; // prefix 1110
+
+    // heads, a 300 byte payload takes two varint bytes
+    string frame;
+    varint.encode(big.data(), big.size(), frame);
+    cout << "varint head " << frame.size() - big.size() << " " << hex << (int)(uint8_t)frame[0] << " " << (int)(uint8_t)frame[1] << dec << endl; // varint head 2 ac 2
+    fixed32_crc.encode("abc", 3, frame);
+    cout << "fixed32 crc " << frame.size() << " " << (int)frame[3] << endl; // fixed32 crc 11 3
+    none.encode("abc", 3, frame);
+    cout << "none " << frame << " " << none.framed() << varint.framed() << endl; // none abc 01
+
+    // back to back frames in one buffer, empty payloads included
+    check("varint", varint, frames(varint, {"hello", "", big, "x"}));
+    // varint [hello  300B x left 0] splits 11
+    check("fixed32", fixed32, frames(fixed32, {"hello", "", big, "x"}));
+    // fixed32 [hello  300B x left 0] splits 11
+    check("varint crc", varint_crc, frames(varint_crc, {"hello", "", big}));
+    // varint crc [hello  300B left 0] splits 11
+    check("fixed32 crc", fixed32_crc, frames(fixed32_crc, {"hello", "", big}));
+    // fixed32 crc [hello  300B left 0] splits 11
+
+    // an unfinished frame waits in the buffer
+    check("varint part", varint, frames(varint, {"hello", big}).substr(0, 100));
+    // varint part [hello left 94] splits 11
+
+    // a varint of max_head_size bytes all with the continuation bit fails, shorter ones wait
+    check("varint long", varint, frames(varint, {"ok"}) + string(stream_codec::max_head_size, (char)0x80) + "\x01");
+    // varint long [ok failed] splits 11
+    check("varint 4 bytes", varint, string(stream_codec::max_head_size - 1, (char)0x80));
+    // varint 4 bytes [left 4] splits 11
+
+    // frames over max_frame fail from their head, head and checksum counted
+    check("varint max", varint, frames(varint, {string(1021, 'm'), string(1023, 'm')}).substr(0, 1023 + 2));
+    // varint max [1021B failed] splits 11
+    check("fixed32 max", fixed32, frames(fixed32, {string(1020, 'm')}) + string("\x7f\xff\xff\xff", 4));
+    // fixed32 max [1020B failed] splits 11
+    check("fixed32 crc max", fixed32_crc, frames(fixed32_crc, {string(1016, 'm'), string(1017, 'm')}).substr(0, 1024 + 4));
+    // fixed32 crc max [1016B failed] splits 11
+
+    // a flipped payload or checksum byte fails for both prefixes
+    string corrupt = frames(varint_crc, {"hello", "world"});
+    corrupt[3] ^= 1;
+    check("varint bad payload", varint_crc, corrupt);
+    // varint bad payload [failed] splits 11
+    corrupt = frames(varint_crc, {"hello", "world"});
+    corrupt[10 + 6 + 3] ^= 1;
+    check("varint bad crc", varint_crc, corrupt);
+    // varint bad crc [hello failed] splits 11
+    corrupt = frames(fixed32_crc, {"hello", "world"});
+    corrupt[4] ^= 1;
+    check("fixed32 bad payload", fixed32_crc, corrupt);
+    // fixed32 bad payload [failed] splits 11
+    corrupt = frames(fixed32_crc, {"hello", "world"});
+    corrupt[13 + 12] ^= 1;
+    check("fixed32 bad crc", fixed32_crc, corrupt);
+    // fixed32 bad crc [hello failed] splits 11
+    return 0;
+}
+// g++ ../src/connection/stream_codec.cpp stream_codec.test.cpp -I../src -I../external -L../external -o stream_codec.test.exe --std=c++17 -ltubekit-zlib
+// LD_LIBRARY_PATH=../external ./stream_codec.test.exe
@@ -0,0 +1,155 @@
+#include <iostream>
+#include <string>
+#include <random>
+#include <chrono>
+#include "../external/tubekit-json/utf8.h"
+
+using namespace std;
+using tubekit::json::utf8_validator;
+
+static const utf8_validator::level levels[] = {utf8_validator::level::SCALAR, utf8_validator::level::SSE4, utf8_validator::level::AVX2};
+
+// decode every character, slow and plain
+static bool reference(const string &str)
+{
+    size_t i = 0;
+    while (i < str.size())
+    {
+        unsigned char c = str[i];
+        size_t n = c < 0x80 ? 1 : (c >= 0xc2 && c <= 0xdf ? 2 : (c >= 0xe0 && c <= 0xef ? 3 : (c >= 0xf0 && c <= 0xf4 ? 4 : 0)));
+        if (n == 0 || i + n > str.size())
+        {
+            return false;
+        }
+        uint32_t cp = n == 1 ? c : (c & (0xff >> (n + 1)));
+        for (size_t k = 1; k < n; k++)
+        {
+            unsigned char cc = str[i + k];
+            if ((cc & 0xc0) != 0x80)
+            {
+                return false;
+            }
+            cp = (cp << 6) | (cc & 0x3f);
+        }
+        static const uint32_t min_cp[5] = {0, 0, 0x80, 0x800, 0x10000};
+        if (cp < min_cp[n] || cp > 0x10ffff || (cp >= 0xd800 && cp <= 0xdfff))
+        {
+            return false;
+        }
+        i += n;
+    }
+    return true;
+}
+
+static void append_code_point(string &out, uint32_t cp)
+{
+    if (cp < 0x80)
+    {
+        out += (char)cp;
+    }
+    else if (cp < 0x800)
+    {
+        out += (char)(0xc0 | (cp >> 6));
+        out += (char)(0x80 | (cp & 0x3f));
+    }
+    else if (cp < 0x10000)
+    {
+        out += (char)(0xe0 | (cp >> 12));
+        out += (char)(0x80 | ((cp >> 6) & 0x3f));
+        out += (char)(0x80 | (cp & 0x3f));
+    }
+    else
+    {
+        out += (char)(0xf0 | (cp >> 18));
+        out += (char)(0x80 | ((cp >> 12) & 0x3f));
+        out += (char)(0x80 | ((cp >> 6) & 0x3f));
+        out += (char)(0x80 | (cp & 0x3f));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    cout << "cpu level " << utf8_validator::level_name(utf8_validator::get_level()) << endl;
+    mt19937 rng(12345);
+    const string edge[] = {"\xc0\xaf", "\xe0\x80\xaf", "\xed\xa0\x80", "\xf4\x90\x80\x80", "\xf5\x80\x80\x80", "\xc2", "\x80", "\xef\xbf\xbf", "\xf0\x90\x80\x80", "\xf4\x8f\xbf\xbf", "\xed\x9f\xbf"};
+
+    size_t cases = 0;
+    size_t failed = 0;
+    for (int round = 0; round < 20000; round++)
+    {
+        // valid text of random code points, sometimes broken by a random byte or an edge case
+        string str;
+        size_t chars = rng() % 200;
+        for (size_t i = 0; i < chars; i++)
+        {
+            uint32_t kind = rng() % 4;
+            uint32_t cp = kind == 0 ? rng() % 0x80 : (kind == 1 ? rng() % 0x800 : (kind == 2 ? rng() % 0x10000 : rng() % 0x110000));
+            if (cp >= 0xd800 && cp <= 0xdfff)
+            {
+                cp = 'x';
+            }
+            append_code_point(str, cp);
+        }
+        if (round % 3 == 1 && !str.empty())
+        {
+            str[rng() % str.size()] = (char)(rng() & 0xff);
+        }
+        if (round % 3 == 2)
+        {
+            str.insert(str.empty() ? 0 : rng() % str.size(), edge[rng() % (sizeof(edge) / sizeof(edge[0]))]);
+        }
+        const bool expect = reference(str);
+        for (utf8_validator::level lv : levels)
+        {
+            if (lv > utf8_validator::get_level())
+            {
+                continue;
+            }
+            cases++;
+            if (utf8_validator::validate(str.data(), str.size(), lv) != expect)
+            {
+                failed++;
+            }
+        }
+        // the same text given in random parts
+        utf8_validator validator;
+        size_t pos = 0;
+        bool ok = true;
+        while (pos < str.size() && ok)
+        {
+            size_t part = 1 + rng() % 100;
+            part = part > str.size() - pos ? str.size() - pos : part;
+            ok = validator.update(str.data() + pos, part);
+            pos += part;
+        }
+        cases++;
+        if ((ok && validator.finish()) != expect)
+        {
+            failed++;
+        }
+    }
+    cout << "cases " << cases << " failed " << failed << endl;
+
+    // throughput on mostly ASCII text with some multi byte characters
+    string text;
+    while (text.size() < 64 * 1024 * 1024)
+    {
+        text += "tubekit websocket message ";
+        append_code_point(text, 0x4e2d);
+        append_code_point(text, 0x1f600);
+    }
+    for (utf8_validator::level lv : levels)
+    {
+        if (lv > utf8_validator::get_level())
+        {
+            continue;
+        }
+        auto start = chrono::steady_clock::now();
+        bool ok = utf8_validator::validate(text.data(), text.size(), lv);
+        auto ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+        cout << utf8_validator::level_name(lv) << " " << ok << " " << ms << "ms" << endl;
+    }
+    return failed == 0 ? 0 : 1;
+}
+// g++ ../external/tubekit-json/utf8.cpp utf8.test.cpp -o utf8.test.exe --std=c++17 -O2
+// ./utf8.test.exe
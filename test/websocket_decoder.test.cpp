@@ -0,0 +1,170 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <tubekit-log/logger.h>
+#include "connection/websocket_decoder.h"
+#include "utility/object_pool.h"
+#include "utility/singleton.h"
+
+using namespace std;
+using tubekit::connection::websocket_decoder;
+using tubekit::log::logger;
+using tubekit::utility::object_pool;
+using tubekit::utility::singleton;
+
+static const uint8_t key[4] = {0x37, 0xfa, 0x21, 0x3d};
+
+// client frame, masked unless told not to
+static string frame(uint8_t first_byte, const string &payload, bool masked = true)
+{
+    string out(1, static_cast<char>(first_byte));
+    const char mask_bit = masked ? 0x80 : 0;
+    if (payload.size() < 126)
+    {
+        out += static_cast<char>(mask_bit | payload.size());
+    }
+    else if (payload.size() < 65536)
+    {
+        out += static_cast<char>(mask_bit | 126);
+        out += static_cast<char>(payload.size() >> 8);
+        out += static_cast<char>(payload.size() & 0xff);
+    }
+    else
+    {
+        out += static_cast<char>(mask_bit | 127);
+        for (int i = 7; i >= 0; i--)
+        {
+            out += static_cast<char>((uint64_t)payload.size() >> (i * 8));
+        }
+    }
+    if (!masked)
+    {
+        return out + payload;
+    }
+    out.append((const char *)key, 4);
+    for (size_t i = 0; i < payload.size(); i++)
+    {
+        out += static_cast<char>(payload[i] ^ key[i & 3]);
+    }
+    return out;
+}
+
+/**
+ * @brief decode stream arriving in parts like a recv buffer, consumed bytes are dropped after each call
+ *
+ * each message is written as opcode, i (payload in recv buffer) or p (payload in pooled buffer) and payload or its size,
+ * a close payload starts with its code, the stream ends with the close code of decoder
+ */
+static string decode(websocket_decoder &decoder, const string &stream, const vector<size_t> &cuts)
+{
+    decoder.reset();
+    decoder.init(1024, 16);
+    string result;
+    string buffer;
+    size_t from = 0;
+    for (size_t i = 0; i <= cuts.size(); i++)
+    {
+        const size_t to = i < cuts.size() ? cuts[i] : stream.size();
+        buffer.append(stream, from, to - from);
+        from = to;
+        while (true)
+        {
+            size_t consumed = 0;
+            websocket_decoder::message out;
+            int res = decoder.next(&buffer[0], buffer.size(), consumed, out);
+            if (res == websocket_decoder::FAILED)
+            {
+                return result + "close " + to_string(decoder.get_close_code());
+            }
+            if (res != websocket_decoder::NEED_MORE)
+            {
+                const bool in_place = out.payload.data() >= buffer.data() && out.payload.data() <= buffer.data() + buffer.size();
+                string payload = out.payload.size() > 16 ? to_string(out.payload.size()) + "B" : string(out.payload);
+                if (out.opcode == websocket_decoder::CLOSE && out.payload.size() >= 2)
+                {
+                    payload = to_string((uint8_t)out.payload[0] << 8 | (uint8_t)out.payload[1]) + payload.substr(2);
+                }
+                result += to_string(out.opcode) + (in_place ? "i" : "p") + ":" + payload + " ";
+            }
+            buffer.erase(0, consumed);
+            if (res == websocket_decoder::NEED_MORE)
+            {
+                break;
+            }
+        }
+    }
+    return result + "close " + to_string(decoder.get_close_code());
+}
+
+// the stream split in two at every offset and fed byte by byte gives the same result as fed whole
+static void check(const string &name, const string &stream)
+{
+    websocket_decoder decoder;
+    const string whole = decode(decoder, stream, {});
+    size_t same = 0;
+    for (size_t offset = 0; offset <= stream.size(); offset++)
+    {
+        same += decode(decoder, stream, {offset}) == whole;
+    }
+    vector<size_t> bytes;
+    for (size_t offset = 1; offset < stream.size(); offset++)
+    {
+        bytes.push_back(offset);
+    }
+    const bool byte_by_byte = decode(decoder, stream, bytes) == whole;
+    cout << name << " [" << whole << "] splits " << (same == stream.size() + 1) << byte_by_byte << endl;
+}
+
+int main(int argc, char **argv)
+{
+    logger::instance().open("websocket_decoder.test.log");
+    singleton<object_pool<websocket_decoder::message_buffer>>::instance()->init(4, false);
+
+    const string big(300, 'b');
+    const string close_payload = string("\x03\xe8", 2) + "bye";
+
+    // whole messages up to in_place_max stay in recv buffer, bigger ones are copied into a pooled buffer
+    check("single", frame(0x81, "hello") + frame(0x82, "") + frame(0x82, big) + frame(0x88, close_payload));
+    // 1i:hello 2i: 2p:300B 8i:1000bye close 0 splits 11
+
+    // control frames may come between fragments, the message is reassembled in a pooled buffer
+    check("fragmented", frame(0x01, "Hel") + frame(0x89, "p") + frame(0x00, "lo ") + frame(0x8a, "") + frame(0x80, "world"));
+    // 9i:p 10i: 1p:Hello world close 0 splits 11
+
+    // 64 bit length form, the header alone is enough to refuse it
+    check("length 127", frame(0x82, string(70000, 'x')).substr(0, 14));
+    // close 1009 splits 11
+
+    // messages over max_message close with 1009, whole or joined from fragments
+    check("too big", frame(0x82, string(1025, 'x')));
+    // close 1009 splits 11
+    check("too big joined", frame(0x02, string(600, 'x')) + frame(0x80, string(600, 'x')));
+    // close 1009 splits 11
+
+    // protocol errors close with 1002, messages before them are still delivered
+    check("unmasked", frame(0x81, "ok") + frame(0x81, "no mask", false));
+    // 1i:ok close 1002 splits 11
+    check("fragmented ping", frame(0x09, "p"));
+    // close 1002 splits 11
+    check("big ping", frame(0x89, string(126, 'p')));
+    // close 1002 splits 11
+    check("close 1 byte", frame(0x88, "\x03"));
+    // close 1002 splits 11
+    check("bad continuation", frame(0x80, "lost"));
+    // close 1002 splits 11
+    check("text in fragments", frame(0x01, "a") + frame(0x81, "b"));
+    // close 1002 splits 11
+    check("rsv without deflate", frame(0xc1, "x"));
+    // close 1002 splits 11
+    check("unknown opcode", frame(0x83, "x"));
+    // close 1002 splits 11
+
+    // invalid utf8 closes with 1007 in place and in pooled buffer
+    check("bad utf8", frame(0x81, "\xc3\x28"));
+    // close 1007 splits 11
+    check("bad utf8 joined", frame(0x01, "ok") + frame(0x80, "\xff"));
+    // close 1007 splits 11
+    return 0;
+}
+// g++ ../src/connection/websocket_decoder.cpp ../src/connection/websocket_deflate.cpp ../src/utility/websocket_mask.cpp ../src/thread/mutex.cpp ../src/thread/auto_lock.cpp ../src/thread/condition.cpp websocket_decoder.test.cpp -I../src -I../external -L../external -o websocket_decoder.test.exe --std=c++17 -pthread -ltubekit-log -ltubekit-json -ltubekit-zlib
+// LD_LIBRARY_PATH=../external ./websocket_decoder.test.exe
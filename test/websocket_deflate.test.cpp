@@ -0,0 +1,215 @@
+#include <iostream>
+#include <string>
+#include <tubekit-log/logger.h>
+#include "connection/websocket_connection.h"
+#include "connection/websocket_decoder.h"
+#include "connection/websocket_deflate.h"
+#include "utility/object_pool.h"
+#include "utility/singleton.h"
+
+using namespace std;
+using tubekit::connection::websocket_connection;
+using tubekit::connection::websocket_decoder;
+using tubekit::connection::websocket_deflate;
+using tubekit::log::logger;
+using tubekit::utility::object_pool;
+using tubekit::utility::singleton;
+
+static const string text = "tubekit websocket permessage-deflate, tubekit websocket permessage-deflate, tubekit websocket";
+
+static void negotiate(const string &offers, int window_bits, bool no_context_takeover)
+{
+    websocket_deflate::params agreed;
+    string response;
+    bool res = websocket_deflate::negotiate(offers, window_bits, no_context_takeover, agreed, response);
+    cout << res << " [" << (res ? response : "") << "]";
+    if (res)
+    {
+        cout << " " << agreed.server_no_context_takeover << agreed.client_no_context_takeover << " " << agreed.server_max_window_bits << " " << agreed.client_max_window_bits;
+    }
+    cout << endl;
+}
+
+// payload of a server frame, which has no mask
+static string payload_of(const string &frame, bool &rsv1)
+{
+    rsv1 = frame[0] & 0x40;
+    size_t length7 = frame[1] & 0x7f;
+    size_t head_len = 2 + (length7 == 126 ? 2 : (length7 == 127 ? 8 : 0));
+    return frame.substr(head_len);
+}
+
+// all queued by send_message
+static string queued(websocket_connection &connection)
+{
+    string data(connection.m_wating_send_pack.can_readable_size(), '\0');
+    connection.m_wating_send_pack.read(&data[0], data.size());
+    return data;
+}
+
+// inflater of a client receiving what compress made with the given params
+static void as_receiver(websocket_deflate &receiver, const websocket_deflate::params &sender)
+{
+    websocket_deflate::params params;
+    params.client_no_context_takeover = sender.server_no_context_takeover;
+    params.client_max_window_bits = sender.server_max_window_bits;
+    receiver.init(params);
+}
+
+static string inflate(websocket_deflate &receiver, const string &payload, int &res, uint64_t max_out = 1 << 20)
+{
+    string out;
+    res = receiver.decompress(payload.data(), payload.size(), true, out, max_out);
+    return out;
+}
+
+// client frame of compressed message to decoder
+static string masked(const string &payload)
+{
+    static const uint8_t key[4] = {0x11, 0x22, 0x33, 0x44};
+    string frame(1, (char)0xc1);
+    frame += (char)(0x80 | 126);
+    frame += (char)(payload.size() >> 8);
+    frame += (char)(payload.size() & 0xff);
+    frame.append((const char *)key, 4);
+    for (size_t i = 0; i < payload.size(); i++)
+    {
+        frame += (char)(payload[i] ^ key[i & 3]);
+    }
+    return frame;
+}
+
+static void decode(const string &frame, uint64_t max_message)
+{
+    websocket_deflate deflate;
+    deflate.init(websocket_deflate::params{});
+    websocket_decoder decoder;
+    decoder.init(max_message, 16);
+    decoder.set_deflate(&deflate);
+    string buffer = frame;
+    size_t consumed = 0;
+    websocket_decoder::message out;
+    int res = decoder.next(&buffer[0], buffer.size(), consumed, out);
+    cout << res << " " << (res == websocket_decoder::MESSAGE && out.payload == text) << " close " << decoder.get_close_code() << endl;
+    decoder.reset();
+    deflate.reset();
+}
+
+int main(int argc, char **argv)
+{
+    logger::instance().open("websocket_deflate.test.log");
+    singleton<object_pool<websocket_deflate::stream>>::instance()->init(8, false);
+    singleton<object_pool<websocket_decoder::message_buffer>>::instance()->init(4, false);
+
+    // negotiate
+    negotiate("permessage-deflate", 15, false);
+    // 1 [permessage-deflate] 00 15 15
+    negotiate("permessage-deflate; client_max_window_bits", 10, false);
+    // 1 [permessage-deflate; server_max_window_bits=10; client_max_window_bits=10] 00 10 10
+    negotiate("permessage-deflate; client_max_window_bits=\"12\"; server_max_window_bits=11", 15, false);
+    // 1 [permessage-deflate; server_max_window_bits=11; client_max_window_bits=12] 00 11 12
+    negotiate("permessage-deflate; client_max_window_bits=8", 15, false);
+    // 1 [permessage-deflate; client_max_window_bits=9] 00 15 9
+    negotiate("permessage-deflate", 15, true);
+    // 1 [permessage-deflate; server_no_context_takeover; client_no_context_takeover] 11 15 15
+    negotiate("permessage-deflate; server_max_window_bits=8, permessage-deflate; server_no_context_takeover", 15, false);
+    // 1 [permessage-deflate; server_no_context_takeover] 10 15 15
+    negotiate("permessage-deflate; server_no_context_takeover; server_no_context_takeover", 15, false);
+    // 0 []
+    negotiate("permessage-deflate; client_max_window_bits=16", 15, false);
+    // 0 []
+    negotiate("permessage-deflate; server_max_window_bits", 15, false);
+    // 0 []
+    negotiate("permessage-deflate; mystery", 15, false);
+    // 0 []
+    negotiate("x-webkit-deflate-frame", 15, false);
+    // 0 []
+
+    // the connections are never flushed, frames stay in their send pack
+    websocket_connection *a = new websocket_connection(nullptr);
+    websocket_connection *b = new websocket_connection(nullptr);
+    websocket_connection *c = new websocket_connection(nullptr);
+    websocket_connection *connections[] = {a, b, c};
+    for (int i = 0; i < 3; i++)
+    {
+        connections[i]->set_gid(i + 1);
+        connections[i]->set_connected(true);
+    }
+
+    // without context takeover a message is compressed alone once per window by frame_cache, any fresh inflater takes it
+    websocket_deflate::params alone;
+    alone.server_no_context_takeover = true;
+    alone.server_max_window_bits = 10;
+    a->deflate.init(alone);
+    b->deflate.init(alone);
+    websocket_connection::frame_cache cache;
+    a->cork();
+    a->send_message(0x81, text.data(), text.size(), &cache);
+    b->cork();
+    b->send_message(0x81, text.data(), text.size(), &cache);
+    a->cork();
+    a->send_message(0x81, text.data(), text.size(), &cache);
+    string frames_a = queued(*a);
+    string frame_b = queued(*b);
+    cout << "cache " << !cache.compressed[10].empty() << cache.compressed[15].empty() << cache.plain.empty() << (frame_b == cache.compressed[10]) << (frames_a == frame_b + frame_b) << endl; // cache 11111
+    bool rsv1 = false;
+    string payload = payload_of(frame_b, rsv1);
+    websocket_deflate receiver;
+    as_receiver(receiver, alone);
+    int res1 = 0, res2 = 0;
+    string first = inflate(receiver, payload, res1);
+    string second = inflate(receiver, payload, res2);
+    cout << "alone " << rsv1 << (payload.size() < text.size()) << " " << res1 << res2 << (first == text) << (second == text) << endl; // alone 11 0011
+    string compressed;
+    cout << "compress_alone " << websocket_deflate::compress_alone(text.data(), text.size(), 10, compressed) << (compressed == payload) << endl; // compress_alone 11
+    receiver.reset();
+
+    // with context takeover the second message refers to the first, only the inflater that saw the first takes it
+    websocket_deflate::params takeover;
+    c->deflate.init(takeover);
+    c->cork();
+    c->send_message(0x81, text.data(), text.size(), &cache);
+    string frame1 = queued(*c);
+    c->cork();
+    c->send_message(0x81, text.data(), text.size(), &cache);
+    string frame2 = queued(*c);
+    string payload1 = payload_of(frame1, rsv1);
+    string payload2 = payload_of(frame2, rsv1);
+    as_receiver(receiver, takeover);
+    first = inflate(receiver, payload1, res1);
+    second = inflate(receiver, payload2, res2);
+    cout << "takeover " << rsv1 << (payload2.size() < payload1.size()) << " " << res1 << res2 << (first == text) << (second == text) << endl; // takeover 11 0011
+    receiver.reset();
+    as_receiver(receiver, takeover);
+    inflate(receiver, payload2, res2);
+    cout << "takeover fresh " << res2 << endl; // takeover fresh -1
+    receiver.reset();
+
+    // inflated message over max_out and corrupt input
+    as_receiver(receiver, alone);
+    inflate(receiver, payload, res1, text.size() - 1);
+    inflate(receiver, payload, res2, text.size());
+    cout << "max_out " << res1 << " " << res2 << endl; // max_out -2 0
+    string corrupt = payload;
+    corrupt[0] = (char)0xff;
+    inflate(receiver, corrupt, res1);
+    cout << "corrupt " << res1 << endl; // corrupt -1
+    receiver.reset();
+
+    // decoder closes with 1009 and 1007 for them
+    decode(masked(payload), 1024);
+    // 1 1 close 0
+    decode(masked(payload), text.size() - 1);
+    // -1 0 close 1009
+    decode(masked(corrupt), 1024);
+    // -1 0 close 1007
+
+    for (websocket_connection *connection : connections)
+    {
+        connection->deflate.reset();
+        delete connection;
+    }
+    return 0;
+}
+// g++ $(find ../src -name '*.cpp' ! -name main.cpp) ../protocol/proto_res/*.pb.cc websocket_deflate.test.cpp -I../src -I../protocol -I../external -L../external -o websocket_deflate.test.exe --std=c++17 -pthread -ldl -lstdc++fs -lprotobuf -lssl -lcrypto -ltubekit-http-parser -ltubekit-inifile -ltubekit-log -ltubekit-timer -ltubekit-xml -ltubekit-buffer -ltubekit-lua -ltubekit-zlib -ltubekit-json
+// LD_LIBRARY_PATH=../external ./websocket_deflate.test.exe
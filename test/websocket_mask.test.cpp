@@ -0,0 +1,87 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include "../src/utility/websocket_mask.h"
+
+using namespace std;
+using tubekit::utility::websocket_mask;
+
+static const websocket_mask::level levels[] = {websocket_mask::level::SCALAR, websocket_mask::level::SSE2, websocket_mask::level::AVX2, websocket_mask::level::AVX512};
+
+int main(int argc, char **argv)
+{
+    cout << "cpu level " << websocket_mask::level_name(websocket_mask::get_level()) << endl;
+    const uint8_t key[4] = {0x37, 0xfa, 0x21, 0x3d};
+
+    // every length and start offset gives the same bytes as the byte by byte loop
+    string source(1200, '\0');
+    for (size_t i = 0; i < source.size(); i++)
+    {
+        source[i] = static_cast<char>(i * 131 + 7);
+    }
+    for (websocket_mask::level lv : levels)
+    {
+        if (lv > websocket_mask::get_level())
+        {
+            continue;
+        }
+        bool ok = true;
+        for (size_t offset = 0; offset < 8 && ok; offset++)
+        {
+            for (size_t len = 0; len + offset <= source.size() && ok; len++)
+            {
+                string expect = source;
+                for (size_t i = 0; i < len; i++)
+                {
+                    expect[offset + i] ^= key[i % 4];
+                }
+                string data = source;
+                websocket_mask::unmask(&data[offset], len, key, lv);
+                if (data != expect)
+                {
+                    cout << "FAIL level " << websocket_mask::level_name(lv) << " offset " << offset << " len " << len << endl;
+                    ok = false;
+                }
+            }
+        }
+        cout << websocket_mask::level_name(lv) << (ok ? " ok" : " fail") << endl;
+    }
+
+    // throughput of 64KB binary frames
+    string frame(65536, 'x');
+    for (websocket_mask::level lv : levels)
+    {
+        if (lv > websocket_mask::get_level())
+        {
+            continue;
+        }
+        constexpr int rounds = 20000;
+        auto begin = chrono::steady_clock::now();
+        for (int i = 0; i < rounds; i++)
+        {
+            websocket_mask::unmask(&frame[0], frame.size(), key, lv);
+        }
+        auto used = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - begin).count();
+        cout << websocket_mask::level_name(lv) << " " << used / rounds << " ns/frame " << (frame == string(65536, 'x')) << endl;
+    }
+
+    // the loop it replaces
+    {
+        constexpr int rounds = 2000;
+        auto begin = chrono::steady_clock::now();
+        for (int i = 0; i < rounds; i++)
+        {
+            string payload_data(frame.data(), frame.size());
+            for (size_t j = 0; j < payload_data.size(); ++j)
+            {
+                payload_data[j] ^= key[j % 4];
+            }
+            frame[i % frame.size()] = payload_data[0];
+        }
+        auto used = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - begin).count();
+        cout << "copy+bytewise " << used / rounds << " ns/frame" << endl;
+    }
+    return 0;
+}
+// g++ ../src/utility/websocket_mask.cpp websocket_mask.test.cpp -I../src -o websocket_mask.test.exe --std=c++17 -O2
+// ./websocket_mask.test.exe